@@ -0,0 +1,89 @@
+/*******************************************************************************************
+*
+*   C-volley - agent plug-in ABI
+*
+*   An agent is a shared library exporting one function, AGENT_ENTRY_POINT:
+*
+*       const AgentApi *AgentGetApi(void);
+*
+*   The host checks abiVersion and obsSize before using anything else, so an agent built
+*   against another version of this header is refused instead of misreading observations.
+*
+*   decideBatch() answers n observations at once: the batch simulator collects every lane
+*   that needs a decision on a tick and makes one call per agent, the game calls it with n = 1.
+*   One handle from create() is only ever used by one thread at a time; multi-threaded hosts
+*   create one per thread. Observations of a match carry its match id and tick, agents that
+*   keep memory between ticks key it by match (the batch position of a match changes).
+*
+*   Agents setting AGENT_FLAG_CANONICAL always play the left side: the host mirrors every
+*   observation of the right side around the net (x -> AGENT_COURT_WIDTH - x, horizontal
+*   velocities negated, blob 0 and 1 swapped, servingSide 0 when the agent's side serves) and mirrors
+*   the returned LEFT/RIGHT bits back, so one policy or lookup table plays both sides. The
+*   side field keeps the real side. Mirrored x is the same float expression the built-in AI
+*   uses, exact for x >= AGENT_NET_X and within half a float ulp (3e-5) below it.
+*
+*   Plain C with fixed-size fields, like the bot protocol (botlink.h), and no other includes:
+*   agents build with just this header.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef AGENT_H
+#define AGENT_H
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define AGENT_ABI_VERSION 2
+#define AGENT_ENTRY_POINT "AgentGetApi"
+
+// Action bitfield, same values as the game's ACTION_* flags
+#define AGENT_ACTION_LEFT  0x01
+#define AGENT_ACTION_RIGHT 0x02
+#define AGENT_ACTION_JUMP  0x04
+
+// AgentApi.flags
+#define AGENT_FLAG_CANONICAL 0x01       // Observations in the "my side is left" frame
+
+// Court, same as the game (sim.h)
+#define AGENT_COURT_WIDTH 1024.0f
+#define AGENT_GROUND_LEVEL 718.0f
+#define AGENT_NET_X 512.0f
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// What an agent sees on one tick, side 0 is left, side 1 is right
+typedef struct AgentObs {
+    uint32_t match;             // Unique per match within a run
+    uint32_t tick;              // Frames since the match started
+    float ballX, ballY;
+    float ballVX, ballVY;
+    float blobX[2], blobY[2];
+    float blobVX[2], blobVY[2];
+    uint8_t onGround[2];
+    uint8_t score[2];
+    uint8_t side;               // Side to decide for (the real one, also in the canonical frame)
+    uint8_t servingSide;
+    uint8_t reserved[2];
+} AgentObs;
+
+typedef uint8_t AgentAction;    // AGENT_ACTION_* bits
+
+typedef struct AgentApi {
+    uint32_t abiVersion;        // AGENT_ABI_VERSION the agent was built with
+    uint32_t obsSize;           // sizeof(AgentObs) the agent was built with
+    uint32_t flags;             // AGENT_FLAG_*
+    const char *name;
+
+    void *(*create)(int maxBatch, uint64_t seed);       // NULL on failure
+    void (*destroy)(void *agent);
+    void (*decideBatch)(void *agent, const AgentObs *obs, AgentAction *actions, int n);
+} AgentApi;
+
+typedef const AgentApi *(*AgentGetApiFunc)(void);
+
+#endif // AGENT_H
@@ -0,0 +1,226 @@
+/*******************************************************************************************
+*
+*   C-volley - agent plug-in decision cost
+*
+*   Usage:
+*     agent_bench PLUGIN [decisions]
+*
+*   Collects observations from scripted matches, then times the plug-in's decideBatch() on
+*   them at batch sizes 1 (the game's case) up to 4096 (the batch simulator's), next to the
+*   built-in SimUpdateAI() on the same states, and reports nanoseconds per decision.
+*
+*   Also times the side-canonical frame (AgentCanonicalizeBatch() against the scalar
+*   AgentCanonicalize(), AgentMirrorActions()) in nanoseconds per observation and checks it
+*   is exact: the batch kernel bit-identical to the scalar one, a canonical observation
+*   bit-identical to the left side's observation of the SimMirror() state, and actions
+*   mirrored twice unchanged. Canonical agents are timed on observations canonicalized once.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "agentplugin.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define OBSERVATIONS 65536
+#define MAX_BATCH 4096
+
+#define CANONICAL_BATCH 1024         // 64 KB of observations
+
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec/1e9;
+}
+
+// Live rally states of scripted matches, alternating sides
+static void CollectStates(SimState *states, AgentObs *obs, int count)
+{
+    SimState sim;
+    SimScript script[2];
+    int match = 0;
+
+    SimInit(&sim, 1000u);
+    SimScriptInit(&script[0], 1);
+    SimScriptInit(&script[1], 2);
+
+    for (int i = 0; i < count; )
+    {
+        unsigned char actions[2] = { 0, 0 };
+        if (sim.scoreDelay == 0)
+        {
+            actions[0] = SimScriptAction(&script[0], &sim, 0);
+            actions[1] = SimScriptAction(&script[1], &sim, 1);
+
+            states[i] = sim;
+            AgentObserve(&sim, i%2, (uint32_t)match, &obs[i]);
+            i++;
+        }
+
+        SimStep(&sim, actions);
+
+        if (sim.gameOver)
+        {
+            match++;
+            SimInit(&sim, 1000u + match);
+        }
+    }
+}
+
+// Canonical frame against the scalar reference and SimMirror(), returns mismatches
+static int CheckCanonical(const SimState *states, const AgentObs *obs, int count)
+{
+    AgentObs *scalar = (AgentObs *)malloc(count*sizeof(AgentObs));
+    AgentObs *batch = (AgentObs *)malloc(count*sizeof(AgentObs));
+    int mismatches = 0;
+
+    memcpy(scalar, obs, count*sizeof(AgentObs));
+    memcpy(batch, obs, count*sizeof(AgentObs));
+    for (int i = 0; i < count; i++) AgentCanonicalize(&scalar[i]);
+    AgentCanonicalizeBatch(batch, count);
+
+    for (int i = 0; i < count; i++)
+    {
+        SimState mirrored;
+        AgentObs expected;
+
+        if (obs[i].side == 1) SimMirror(&states[i], &mirrored);
+        else mirrored = states[i];
+        AgentObserve(&mirrored, 0, obs[i].match, &expected);
+        expected.side = obs[i].side;
+
+        if ((memcmp(&scalar[i], &batch[i], sizeof(AgentObs)) != 0) || (memcmp(&scalar[i], &expected, sizeof(AgentObs)) != 0)) mismatches++;
+    }
+
+    for (int a = 0; a < 256; a++)
+    {
+        AgentAction action = (AgentAction)a;
+        AgentObs right = { .side = 1 };
+        AgentMirrorActions(&right, &action, 1);
+        if (action != SimMirrorAction((unsigned char)a)) mismatches++;
+        AgentMirrorActions(&right, &action, 1);
+        if (action != a) mismatches++;
+    }
+
+    free(scalar);
+    free(batch);
+
+    return mismatches;
+}
+
+// ns per observation of canonicalization passes over one cache resident batch, in place (the
+// frame flips back and forth), the cost a host pays next to the agent's own
+static double TimeCanonical(AgentObs *batch, int decisions, bool scalar)
+{
+    int calls = decisions/CANONICAL_BATCH;
+
+    double start = NowSeconds();
+    for (int c = 0; c < calls; c++)
+    {
+        if (scalar) for (int i = 0; i < CANONICAL_BATCH; i++) AgentCanonicalize(&batch[i]);
+        else AgentCanonicalizeBatch(batch, CANONICAL_BATCH);
+    }
+
+    return (NowSeconds() - start)*1e9/((double)calls*CANONICAL_BATCH);
+}
+
+int main(int argc, char *argv[])
+{
+    int decisions = 4*1024*1024;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s PLUGIN [decisions]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2) decisions = atoi(argv[2]);
+    if (decisions < MAX_BATCH) decisions = MAX_BATCH;
+
+    AgentPlugin plugin;
+    if (!AgentPluginLoad(&plugin, argv[1])) return 1;
+
+    SimState *states = (SimState *)malloc(OBSERVATIONS*sizeof(SimState));
+    AgentObs *obs = (AgentObs *)malloc(OBSERVATIONS*sizeof(AgentObs));
+    AgentAction *actions = (AgentAction *)malloc(OBSERVATIONS*sizeof(AgentAction));
+    void *agent = plugin.api->create(MAX_BATCH, 0);
+    if ((states == NULL) || (obs == NULL) || (actions == NULL) || (agent == NULL))
+    {
+        fprintf(stderr, "agent_bench: out of memory\n");
+        return 1;
+    }
+
+    CollectStates(states, obs, OBSERVATIONS);
+
+    int mismatches = CheckCanonical(states, obs, OBSERVATIONS);
+    printf("canonical frame: %s (%d mismatches)\n", (mismatches == 0) ? "exact" : "NOT EXACT", mismatches);
+
+    AgentObs *scratch = (AgentObs *)malloc(OBSERVATIONS*sizeof(AgentObs));
+    if (scratch == NULL) return 1;
+    memcpy(scratch, obs, OBSERVATIONS*sizeof(AgentObs));
+    double scalarNs = TimeCanonical(scratch, decisions, true);
+    memcpy(scratch, obs, OBSERVATIONS*sizeof(AgentObs));
+    double batchNs = TimeCanonical(scratch, decisions, false);
+
+    double start = NowSeconds();
+    for (int c = 0; c < decisions/CANONICAL_BATCH; c++) AgentMirrorActions(obs, actions, CANONICAL_BATCH);
+    double actionNs = (NowSeconds() - start)*1e9/((double)(decisions/CANONICAL_BATCH)*CANONICAL_BATCH);
+    free(scratch);
+
+    printf("canonicalize: scalar %.2f ns/obs, batch %.2f ns/obs (%s), mirror actions %.2f ns/action\n", scalarNs, batchNs,
+#if defined(__SSE2__)
+           "SSE2",
+#else
+           "scalar",
+#endif
+           actionNs);
+    printf("BENCH agent.canonicalize.ns_per_obs %.3f lower\n", batchNs);     // For benchgate
+
+    bool canonical = (plugin.api->flags & AGENT_FLAG_CANONICAL) != 0;
+    if (canonical) AgentCanonicalizeBatch(obs, OBSERVATIONS);
+
+    printf("%s (ABI %u%s), %d decisions per batch size\n", plugin.api->name, plugin.api->abiVersion,
+           canonical ? ", canonical" : "", decisions);
+    printf("batch  ns/decision\n");
+
+    unsigned int checksum = 0;
+
+    for (int batch = 1; batch <= MAX_BATCH; batch *= 4)
+    {
+        int calls = decisions/batch;
+
+        double start = NowSeconds();
+        for (int c = 0; c < calls; c++)
+        {
+            int first = (int)(((long long)c*batch)%(OBSERVATIONS - batch + 1));
+            plugin.api->decideBatch(agent, &obs[first], &actions[first], batch);
+            checksum += actions[first];
+        }
+        double ns = (NowSeconds() - start)*1e9/((double)calls*batch);
+
+        printf("%5d  %11.2f\n", batch, ns);
+        printf("BENCH agent.%s.batch%d.ns_per_decision %.3f lower\n", plugin.api->name, batch, ns);     // For benchgate
+    }
+
+    // Built-in AI for comparison, on copies since it moves the blob itself
+    start = NowSeconds();
+    for (int c = 0; c < decisions; c++)
+    {
+        SimState sim = states[c%OBSERVATIONS];
+        SimUpdateAI(&sim, c%2);
+        checksum += (unsigned int)sim.blobs[c%2].position.x;
+    }
+    printf("built-in SimUpdateAI(): %.2f ns/decision (checksum %u)\n", (NowSeconds() - start)*1e9/decisions, checksum);
+
+    plugin.api->destroy(agent);
+    AgentPluginUnload(&plugin);
+    free(states);
+    free(obs);
+    free(actions);
+
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+/*******************************************************************************************
+*
+*   C-volley - reference agent plug-in: the built-in AI heuristic
+*
+*   Build:
+*     cc -O2 -shared -fPIC agent_heuristic.c -o agent_heuristic.so
+*
+*   SimUpdateAI() ported to actions: return to the middle of its side when the ball is away,
+*   otherwise walk under the ball and jump at it when it is close, missing one jump in five.
+*   The built-in AI moves and jumps the blob itself (0.8 of the walking speed, 0.9 of the
+*   jump force, 30 frames jump cooldown); actions can only walk and jump at full strength,
+*   and a full jump lasts as long as the cooldown, so being on the ground stands in for it.
+*
+*   Side-canonical (AGENT_FLAG_CANONICAL): the host hands it every observation as the left
+*   side, so it only knows one side of the court; blob 0 is always its own.
+*
+*   Stateless: the miss chance is drawn from a hash of (seed, match, tick, side), so decisions
+*   do not depend on batch order or size and every match replays the same way.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "agent.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define AI_REACTION_DISTANCE 150.0f
+#define AI_JUMP_THRESHOLD 60.0f
+#define AI_POSITION_TOLERANCE 20.0f
+#define AI_MISS_PERCENT 20
+
+typedef struct Heuristic {
+    uint64_t seed;
+} Heuristic;
+
+static uint32_t Hash(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+
+    return (uint32_t)x;
+}
+
+// Always the left side, blob 0
+static AgentAction Decide(const Heuristic *heuristic, const AgentObs *obs)
+{
+    AgentAction action = 0;
+
+    bool ballComingToward = ((obs->ballVX < 0) && (obs->ballX > AGENT_NET_X)) || (obs->ballX <= AGENT_NET_X);
+
+    if (!ballComingToward)
+    {
+        float targetX = AGENT_NET_X/2;
+        if (obs->blobX[0] < targetX - AI_POSITION_TOLERANCE) action |= AGENT_ACTION_RIGHT;
+        else if (obs->blobX[0] > targetX + AI_POSITION_TOLERANCE) action |= AGENT_ACTION_LEFT;
+    }
+    else
+    {
+        float distanceX = obs->ballX - obs->blobX[0];
+        if (distanceX < -AI_POSITION_TOLERANCE) action |= AGENT_ACTION_LEFT;
+        else if (distanceX > AI_POSITION_TOLERANCE) action |= AGENT_ACTION_RIGHT;
+
+        float distanceY = obs->blobY[0] - obs->ballY;
+        bool shouldJump = (fabsf(distanceX) < AI_REACTION_DISTANCE) && (distanceY > -AI_JUMP_THRESHOLD) &&
+                          (distanceY < 100.0f) && obs->onGround[0];
+
+        // The real side, so both sides of a match draw different misses
+        uint64_t key = heuristic->seed ^ ((uint64_t)obs->match << 32) ^ ((uint64_t)obs->tick << 1) ^ (uint64_t)obs->side;
+        if (shouldJump && ((int)(Hash(key)%100) >= AI_MISS_PERCENT)) action |= AGENT_ACTION_JUMP;
+    }
+
+    return action;
+}
+
+static void *Create(int maxBatch, uint64_t seed)
+{
+    (void)maxBatch;
+
+    Heuristic *heuristic = (Heuristic *)malloc(sizeof(Heuristic));
+    if (heuristic != NULL) heuristic->seed = seed;
+
+    return heuristic;
+}
+
+static void Destroy(void *agent)
+{
+    free(agent);
+}
+
+static void DecideBatch(void *agent, const AgentObs *obs, AgentAction *actions, int n)
+{
+    const Heuristic *heuristic = (const Heuristic *)agent;
+
+    for (int i = 0; i < n; i++) actions[i] = Decide(heuristic, &obs[i]);
+}
+
+static const AgentApi api = {
+    .abiVersion = AGENT_ABI_VERSION,
+    .obsSize = sizeof(AgentObs),
+    .flags = AGENT_FLAG_CANONICAL,
+    .name = "heuristic",
+    .create = Create,
+    .destroy = Destroy,
+    .decideBatch = DecideBatch,
+};
+
+__attribute__((visibility("default"))) const AgentApi *AgentGetApi(void)
+{
+    return &api;
+}
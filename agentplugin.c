@@ -0,0 +1,192 @@
+/*******************************************************************************************
+*
+*   C-volley - agent plug-in host side
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "agentplugin.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    #include <dlfcn.h>
+    #define AGENT_PLUGINS_SUPPORTED
+#endif
+
+_Static_assert((AGENT_ACTION_LEFT == ACTION_LEFT) && (AGENT_ACTION_RIGHT == ACTION_RIGHT) && (AGENT_ACTION_JUMP == ACTION_JUMP),
+               "agent actions must match the simulation's");
+_Static_assert((AGENT_COURT_WIDTH == SCREEN_WIDTH) && (AGENT_GROUND_LEVEL == GROUND_LEVEL) && (AGENT_NET_X == NET_X),
+               "agent court must match the simulation's");
+_Static_assert(sizeof(AgentObs) == 64, "the SSE2 canonicalization works on four 16 byte rows");
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool AgentPluginLoad(AgentPlugin *plugin, const char *path)
+{
+    memset(plugin, 0, sizeof(AgentPlugin));
+
+#if defined(AGENT_PLUGINS_SUPPORTED)
+    plugin->library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (plugin->library == NULL)
+    {
+        fprintf(stderr, "AGENT: %s\n", dlerror());
+        return false;
+    }
+
+    AgentGetApiFunc getApi;
+    *(void **)&getApi = dlsym(plugin->library, AGENT_ENTRY_POINT);
+    const AgentApi *api = (getApi != NULL) ? getApi() : NULL;
+
+    if ((api == NULL) || (api->abiVersion != AGENT_ABI_VERSION) || (api->obsSize != sizeof(AgentObs)) ||
+        (api->create == NULL) || (api->destroy == NULL) || (api->decideBatch == NULL))
+    {
+        if (api == NULL) fprintf(stderr, "AGENT: %s does not export %s\n", path, AGENT_ENTRY_POINT);
+        else fprintf(stderr, "AGENT: %s built for ABI %u (observation %u bytes), expected %d (%d bytes)\n", path,
+                     api->abiVersion, api->obsSize, AGENT_ABI_VERSION, (int)sizeof(AgentObs));
+
+        dlclose(plugin->library);
+        plugin->library = NULL;
+        return false;
+    }
+
+    plugin->api = api;
+    return true;
+#else
+    fprintf(stderr, "AGENT: plug-ins not supported on this platform (%s)\n", path);
+    return false;
+#endif
+}
+
+void AgentPluginUnload(AgentPlugin *plugin)
+{
+#if defined(AGENT_PLUGINS_SUPPORTED)
+    if (plugin->library != NULL) dlclose(plugin->library);
+#endif
+    memset(plugin, 0, sizeof(AgentPlugin));
+}
+
+void AgentObserve(const SimState *sim, int side, uint32_t match, AgentObs *obs)
+{
+    memset(obs, 0, sizeof(AgentObs));
+
+    obs->match = match;
+    obs->tick = (uint32_t)sim->tick;
+    obs->ballX = sim->ball.position.x;
+    obs->ballY = sim->ball.position.y;
+    obs->ballVX = sim->ball.velocity.x;
+    obs->ballVY = sim->ball.velocity.y;
+
+    for (int i = 0; i < 2; i++)
+    {
+        const SimBlob *blob = &sim->blobs[i];
+        obs->blobX[i] = blob->position.x;
+        obs->blobY[i] = blob->position.y;
+        obs->blobVX[i] = blob->velocity.x;
+        obs->blobVY[i] = blob->velocity.y;
+        obs->onGround[i] = blob->onGround;
+        obs->score[i] = (uint8_t)blob->score;
+    }
+
+    obs->side = (uint8_t)side;
+    obs->servingSide = (uint8_t)sim->servingSide;
+}
+
+void AgentDecide(const AgentPlugin *plugin, void *agent, AgentObs *obs, AgentAction *actions, int n)
+{
+    bool canonical = (plugin->api->flags & AGENT_FLAG_CANONICAL) != 0;
+
+    if (canonical) AgentCanonicalizeBatch(obs, n);
+    plugin->api->decideBatch(agent, obs, actions, n);
+    if (canonical) AgentMirrorActions(obs, actions, n);
+}
+
+void AgentCanonicalize(AgentObs *obs)
+{
+    if (obs->side != 1) return;
+
+    // Same expression as SimUpdateAI() mirroring the left side
+    obs->ballX = AGENT_COURT_WIDTH - obs->ballX;
+    obs->ballVX = -obs->ballVX;
+
+    float blobX0 = obs->blobX[0], blobY0 = obs->blobY[0], blobVX0 = obs->blobVX[0], blobVY0 = obs->blobVY[0];
+    obs->blobX[0] = AGENT_COURT_WIDTH - obs->blobX[1];
+    obs->blobX[1] = AGENT_COURT_WIDTH - blobX0;
+    obs->blobY[0] = obs->blobY[1];
+    obs->blobY[1] = blobY0;
+    obs->blobVX[0] = -obs->blobVX[1];
+    obs->blobVX[1] = -blobVX0;
+    obs->blobVY[0] = obs->blobVY[1];
+    obs->blobVY[1] = blobVY0;
+
+    uint8_t onGround0 = obs->onGround[0], score0 = obs->score[0];
+    obs->onGround[0] = obs->onGround[1];
+    obs->onGround[1] = onGround0;
+    obs->score[0] = obs->score[1];
+    obs->score[1] = score0;
+
+    obs->servingSide ^= 1;
+}
+
+void AgentCanonicalizeBatch(AgentObs *obs, int n)
+{
+#if defined(__SSE2__)
+    // One observation is four rows:
+    //   0: match, tick, ballX, ballY
+    //   1: ballVX, ballVY, blobX[0], blobX[1]
+    //   2: blobY[0], blobY[1], blobVX[0], blobVX[1]
+    //   3: blobVY[0], blobVY[1], onGround[2] score[2], side servingSide reserved[2]
+    // Batches are runs of one side or alternate sides, the branch on the side predicts well
+    const __m128 width = _mm_set1_ps(AGENT_COURT_WIDTH);
+    const __m128 row0Mirror = _mm_castsi128_ps(_mm_set_epi32(0, -1, 0, 0));
+    const __m128 row1Negate = _mm_castsi128_ps(_mm_set_epi32(0, 0, 0, (int)0x80000000));
+    const __m128 row1Mirror = _mm_castsi128_ps(_mm_set_epi32(-1, -1, 0, 0));
+    const __m128 row2Negate = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, (int)0x80000000, 0, 0));
+    const __m128i row3Pairs = _mm_set_epi32(0, -1, 0, 0);
+    const __m128i row3Serving = _mm_set_epi8(0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    for (int i = 0; i < n; i++)
+    {
+        if (obs[i].side != 1) continue;
+
+        float *row = (float *)&obs[i];
+
+        __m128 r0 = _mm_loadu_ps(row);
+        __m128 r1 = _mm_shuffle_ps(_mm_loadu_ps(row + 4), _mm_loadu_ps(row + 4), _MM_SHUFFLE(2, 3, 1, 0));
+        __m128 r2 = _mm_loadu_ps(row + 8);
+        __m128i r3 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(row + 12)), _MM_SHUFFLE(3, 2, 0, 1));
+
+        __m128 m0 = _mm_or_ps(_mm_and_ps(row0Mirror, _mm_sub_ps(width, r0)), _mm_andnot_ps(row0Mirror, r0));
+        __m128 m1 = _mm_or_ps(_mm_and_ps(row1Mirror, _mm_sub_ps(width, r1)), _mm_andnot_ps(row1Mirror, _mm_xor_ps(r1, row1Negate)));
+        __m128 m2 = _mm_xor_ps(_mm_shuffle_ps(r2, r2, _MM_SHUFFLE(2, 3, 0, 1)), row2Negate);
+
+        __m128i swapped = _mm_or_si128(_mm_slli_epi16(r3, 8), _mm_srli_epi16(r3, 8));
+        __m128i m3 = _mm_or_si128(_mm_and_si128(row3Pairs, swapped), _mm_andnot_si128(row3Pairs, r3));
+
+        _mm_storeu_ps(row, m0);
+        _mm_storeu_ps(row + 4, m1);
+        _mm_storeu_ps(row + 8, m2);
+        _mm_storeu_si128((__m128i *)(row + 12), _mm_xor_si128(m3, row3Serving));
+    }
+#else
+    for (int i = 0; i < n; i++) AgentCanonicalize(&obs[i]);
+#endif
+}
+
+void AgentMirrorActions(const AgentObs *obs, AgentAction *actions, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        AgentAction action = actions[i];
+        AgentAction swapped = (AgentAction)((action & ~(AGENT_ACTION_LEFT | AGENT_ACTION_RIGHT)) |
+                                            ((action & AGENT_ACTION_LEFT) ? AGENT_ACTION_RIGHT : 0) |
+                                            ((action & AGENT_ACTION_RIGHT) ? AGENT_ACTION_LEFT : 0));
+        actions[i] = (obs[i].side == 1) ? swapped : action;
+    }
+}
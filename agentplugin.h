@@ -0,0 +1,42 @@
+/*******************************************************************************************
+*
+*   C-volley - agent plug-in host side
+*
+*   Loads an agent shared library (agent.h) with dlopen() and turns simulation states into
+*   its observations. POSIX only, AgentPluginLoad() fails gracefully elsewhere.
+*
+*   AgentDecide() is the call hosts make: for AGENT_FLAG_CANONICAL agents it mirrors the
+*   right side's observations into the left side's frame and the actions back.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef AGENTPLUGIN_H
+#define AGENTPLUGIN_H
+
+#include "agent.h"
+#include "sim.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct AgentPlugin {
+    void *library;
+    const AgentApi *api;
+} AgentPlugin;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool AgentPluginLoad(AgentPlugin *plugin, const char *path);        // Logs why it failed to stderr
+void AgentPluginUnload(AgentPlugin *plugin);
+
+void AgentObserve(const SimState *sim, int side, uint32_t match, AgentObs *obs);
+void AgentDecide(const AgentPlugin *plugin, void *agent, AgentObs *obs, AgentAction *actions, int n);    // May canonicalize obs in place
+
+// Side-canonical frame, observations of side 0 are left untouched
+void AgentCanonicalize(AgentObs *obs);                              // Scalar reference
+void AgentCanonicalizeBatch(AgentObs *obs, int n);                  // SSE2 when available, bit-identical to AgentCanonicalize()
+void AgentMirrorActions(const AgentObs *obs, AgentAction *actions, int n);     // Swaps LEFT/RIGHT where side is 1
+
+#endif // AGENTPLUGIN_H
@@ -0,0 +1,247 @@
+/*******************************************************************************************
+*
+*   C-volley - agent decisions on a worker thread
+*
+*   Two single-slot mailboxes, no locks:
+*     - request:  game -> worker, both sides' observations behind a sequence lock (odd while
+*                 the game writes it); the worker always takes the newest one
+*     - response: worker -> game, one 64-bit word: request number and both actions
+*   The worker sleeps on a futex on the request sequence, the game only makes the wake call
+*   when the worker said it is about to sleep. A request the worker could not answer in time
+*   is simply never matched: the game checks the request number of the response.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "agentworker.h"
+#include "raylib.h"
+
+#include <string.h>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static AgentPlugin workerPlugins[2];
+static void *workerAgents[2] = { NULL, NULL };
+static pthread_t workerThread;
+static bool workerRunning = false;
+
+// Request mailbox, written by the game thread only
+static uint32_t requestSequence = 0;    // Odd while being written, also the futex word
+static uint32_t requestNumber = 0;
+static AgentObs requestObs[2];
+static uint32_t workerWaiting = 0;
+
+// Response mailbox, written by the worker only: request number << 32 | right << 8 | left
+static uint64_t response = 0;
+
+static unsigned char lastActions[2] = { 0 };    // Game thread
+static uint32_t matchRequest = 0;               // Game thread: last request of the previous match
+static AgentWorkerStats stats = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+static uint64_t NowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static inline void CpuRelax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Game side: publish a new request and wake the worker if it sleeps
+static void PostRequest(const AgentObs obs[2])
+{
+    __atomic_store_n(&requestSequence, requestSequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy(requestObs, obs, sizeof(requestObs));
+    requestNumber++;
+
+    __atomic_store_n(&requestSequence, requestSequence + 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&workerWaiting, __ATOMIC_SEQ_CST))
+    {
+        syscall(SYS_futex, &requestSequence, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
+
+// Worker side: sleep until the sequence moves past seen
+static void WaitRequest(uint32_t seen)
+{
+    __atomic_store_n(&workerWaiting, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&requestSequence, __ATOMIC_SEQ_CST) == seen)
+    {
+        syscall(SYS_futex, &requestSequence, FUTEX_WAIT_PRIVATE, seen, NULL, NULL, 0);
+    }
+
+    __atomic_store_n(&workerWaiting, 0, __ATOMIC_RELAXED);
+}
+
+static void *WorkerThread(void *arg)
+{
+    (void)arg;
+    uint32_t seen = 0;
+
+    while (__atomic_load_n(&workerRunning, __ATOMIC_ACQUIRE))
+    {
+        uint32_t sequence = __atomic_load_n(&requestSequence, __ATOMIC_ACQUIRE);
+
+        if (sequence == seen)
+        {
+            WaitRequest(seen);
+            continue;
+        }
+
+        if (sequence & 1)
+        {
+            CpuRelax();
+            continue;
+        }
+
+        // Copy, then make sure the game did not start the next request meanwhile
+        AgentObs obs[2];
+        memcpy(obs, requestObs, sizeof(obs));
+        uint32_t number = requestNumber;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&requestSequence, __ATOMIC_RELAXED) != sequence) continue;
+
+        seen = sequence;
+        if (!__atomic_load_n(&workerRunning, __ATOMIC_ACQUIRE)) break;
+
+        uint64_t start = NowNs();
+        AgentAction actions[2] = { 0, 0 };
+
+        for (int side = 0; side < 2; side++)
+        {
+            if (workerAgents[side] != NULL) AgentDecide(&workerPlugins[side], workerAgents[side], &obs[side], &actions[side], 1);
+        }
+
+        uint64_t decideNs = NowNs() - start;
+        stats.decisions++;
+        stats.decideSumNs += decideNs;
+        if (decideNs > stats.decideMaxNs) stats.decideMaxNs = decideNs;
+
+        __atomic_store_n(&response, ((uint64_t)number << 32) | ((uint64_t)actions[1] << 8) | actions[0], __ATOMIC_RELEASE);
+    }
+
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool InitAgentWorker(const AgentPlugin plugins[2], void *const agents[2])
+{
+    if (workerRunning || ((agents[0] == NULL) && (agents[1] == NULL))) return false;
+
+    for (int side = 0; side < 2; side++)
+    {
+        workerPlugins[side] = plugins[side];
+        workerAgents[side] = agents[side];
+        lastActions[side] = 0;
+    }
+
+    requestSequence = requestNumber = matchRequest = 0;
+    response = 0;
+    memset(&stats, 0, sizeof(stats));
+
+    workerRunning = true;
+    if (pthread_create(&workerThread, NULL, WorkerThread, NULL) != 0)
+    {
+        workerRunning = false;
+        TraceLog(LOG_WARNING, "AGENT: Could not start the decision worker, agents decide inline");
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "AGENT: Decisions on a worker thread, one tick behind");
+    return true;
+}
+
+void CloseAgentWorker(void)
+{
+    if (!workerRunning) return;
+
+    // A request that is never copied, only there to get the worker out of its wait
+    __atomic_store_n(&workerRunning, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&requestSequence, requestSequence + 2, __ATOMIC_SEQ_CST);
+    syscall(SYS_futex, &requestSequence, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    pthread_join(workerThread, NULL);
+
+    if (stats.exchanges > 0)
+    {
+        TraceLog(LOG_INFO, "AGENT: Worker: %llu ticks, %llu late (previous action repeated), decide avg %.3f ms, max %.3f ms",
+                 stats.exchanges, stats.late, (stats.decisions > 0) ? (double)stats.decideSumNs/stats.decisions/1000000.0 : 0.0,
+                 stats.decideMaxNs/1000000.0);
+    }
+}
+
+void AgentWorkerExchange(const SimState *sim, uint32_t match, unsigned char actions[2])
+{
+    if (!workerRunning) return;
+
+    // Answer to the request posted last tick, none on the first tick of a match
+    uint64_t answer = __atomic_load_n(&response, __ATOMIC_ACQUIRE);
+    bool asked = (requestNumber > matchRequest);
+    bool ready = asked && ((uint32_t)(answer >> 32) == requestNumber);
+
+    if (asked && !ready) stats.late++;
+
+    AgentObs obs[2];
+    memset(obs, 0, sizeof(obs));
+
+    for (int side = 0; side < 2; side++)
+    {
+        if (workerAgents[side] == NULL) continue;
+
+        if (ready) lastActions[side] = (unsigned char)(answer >> (8*side));
+        actions[side] = lastActions[side];
+
+        AgentObserve(sim, side, match, &obs[side]);
+    }
+
+    stats.exchanges++;
+    PostRequest(obs);
+}
+
+void AgentWorkerReset(void)
+{
+    if (!workerRunning) return;
+
+    // The answer still outstanding was decided from the previous match's last state
+    matchRequest = requestNumber;
+    lastActions[0] = lastActions[1] = 0;
+}
+
+AgentWorkerStats GetAgentWorkerStats(void)
+{
+    return stats;
+}
+
+#else
+
+bool InitAgentWorker(const AgentPlugin plugins[2], void *const agents[2]) { (void)plugins; (void)agents; return false; }
+void CloseAgentWorker(void) { }
+void AgentWorkerExchange(const SimState *sim, uint32_t match, unsigned char actions[2]) { (void)sim; (void)match; (void)actions; }
+void AgentWorkerReset(void) { }
+AgentWorkerStats GetAgentWorkerStats(void) { AgentWorkerStats stats = { 0 }; return stats; }
+
+#endif
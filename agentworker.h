@@ -0,0 +1,51 @@
+/*******************************************************************************************
+*
+*   C-volley - agent decisions on a worker thread
+*
+*   A search or network agent can take longer per decision than a frame leaves for it. The
+*   worker decides for the agent plug-in sides off the game thread, from the observation of
+*   the previous tick: the action applied on tick T was decided from the state after tick
+*   T - 2 instead of T - 1. The latency is always exactly one tick, whatever the agent costs
+*   and however the threads are scheduled, so the game plays the same as long as the worker
+*   keeps up. When it does not, the side repeats its previous action and the late decision is
+*   dropped; replays record the actions that were applied, so they stay exact either way.
+*
+*   Linux only (futex); InitAgentWorker() returns false elsewhere and agents decide inline.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef AGENTWORKER_H
+#define AGENTWORKER_H
+
+#include "agentplugin.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct AgentWorkerStats {
+    unsigned long long exchanges;       // Ticks the worker was asked for
+    unsigned long long late;            // Previous action repeated, decision not ready in time
+    uint64_t decideSumNs;               // Time in the agents, worker side
+    uint64_t decideMaxNs;
+    unsigned long long decisions;       // Requests the worker answered (late ones included)
+} AgentWorkerStats;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+// Starts the worker for the sides whose agent is not NULL, plug-ins stay owned by the caller
+bool InitAgentWorker(const AgentPlugin plugins[2], void *const agents[2]);
+void CloseAgentWorker(void);            // Before the agents are destroyed, logs the stats
+
+// Once per simulated tick, before SimStep(): actions for this tick (decided from the state one
+// tick ago) for the worker's sides, then posts the current state for the next tick
+void AgentWorkerExchange(const SimState *sim, uint32_t match, unsigned char actions[2]);
+void AgentWorkerReset(void);            // When a match starts: no action carries over from the last one
+
+AgentWorkerStats GetAgentWorkerStats(void);
+
+#endif // AGENTWORKER_H
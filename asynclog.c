@@ -0,0 +1,427 @@
+/*******************************************************************************************
+*
+*   C-volley - asynchronous logging
+*
+*   The ring is a bounded multi-producer queue with a sequence number per slot (Vyukov):
+*   a producer claims a slot with one compare-and-swap on the tail, fills it and publishes
+*   it by storing the slot's sequence; the single writer thread consumes in order. The
+*   writer polls (ASYNC_LOG_POLL_MS) instead of being woken, so producers never make a
+*   system call.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "asynclog.h"
+#include "raylib.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__) && !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #include <time.h>
+    #define ASYNC_LOG_SUPPORTED
+#endif
+
+#define ASYNC_LOG_RECORD_BYTES 512
+#define ASYNC_LOG_MAX_ARGS 16
+#define ASYNC_LOG_POLL_MS 5
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// One argument, the conversion in the format says which member
+typedef union LogArg {
+    long long i;
+    unsigned long long u;
+    double d;
+    const void *p;
+    unsigned int offset;        // %s: into LogRecord.text
+} LogArg;
+
+#define ASYNC_LOG_TEXT_BYTES (ASYNC_LOG_RECORD_BYTES - 16 - ASYNC_LOG_MAX_ARGS*(int)sizeof(LogArg))
+
+// One TraceLog() call: the format string, then the %s arguments, all zero terminated
+typedef struct LogRecord {
+    uint64_t sequence;          // Ring slot state, see file header
+    uint8_t level;
+    uint8_t argCount;
+    uint16_t textLength;
+    uint32_t reserved;
+    LogArg args[ASYNC_LOG_MAX_ARGS];
+    char text[ASYNC_LOG_TEXT_BYTES];
+} LogRecord;
+
+_Static_assert(sizeof(LogRecord) == ASYNC_LOG_RECORD_BYTES, "log records are fixed size");
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+#if defined(ASYNC_LOG_SUPPORTED)
+static LogRecord *ring = NULL;
+static uint64_t ringMask = 0;
+static uint64_t ringTail = 0;           // Next slot to claim, producers
+static uint64_t ringHead = 0;           // Next slot to write out, writer thread only
+static uint64_t droppedRecords = 0;
+static uint64_t reportedDrops = 0;      // Writer thread only
+static bool writerRunning = false;
+static pthread_t writerThread;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+
+// Length of the conversion spec starting at '%', including the conversion character
+static int SpecLength(const char *spec)
+{
+    int n = 1;
+    while ((spec[n] != '\0') && (strchr("-+ #0123456789.*hlLqjzt", spec[n]) != NULL)) n++;
+
+    return (spec[n] != '\0') ? n + 1 : n;
+}
+
+#if defined(ASYNC_LOG_SUPPORTED)
+static const char *LevelPrefix(int level)
+{
+    switch (level)
+    {
+        case LOG_TRACE: return "TRACE: ";
+        case LOG_DEBUG: return "DEBUG: ";
+        case LOG_INFO: return "INFO: ";
+        case LOG_WARNING: return "WARNING: ";
+        case LOG_ERROR: return "ERROR: ";
+        case LOG_FATAL: return "FATAL: ";
+        default: return "";
+    }
+}
+
+// Stores what the format will need, without formatting anything
+static void CaptureRecord(LogRecord *record, int level, const char *format, va_list args)
+{
+    int formatLength = (int)strlen(format);
+    if (formatLength > ASYNC_LOG_TEXT_BYTES - 1) formatLength = ASYNC_LOG_TEXT_BYTES - 1;
+
+    memcpy(record->text, format, formatLength);
+    record->text[formatLength] = '\0';
+    record->level = (uint8_t)level;
+    record->argCount = 0;
+
+    int used = formatLength + 1;
+
+    for (const char *c = format; *c != '\0'; c++)
+    {
+        if (*c != '%') continue;
+
+        int length = SpecLength(c);
+        char conversion = c[length - 1];
+        if (conversion == '%')
+        {
+            c += length - 1;
+            continue;
+        }
+
+        // Width or precision from the arguments
+        for (int k = 1; k < length - 1; k++)
+        {
+            if ((c[k] == '*') && (record->argCount < ASYNC_LOG_MAX_ARGS)) record->args[record->argCount++].i = va_arg(args, int);
+            else if (c[k] == '*') (void)va_arg(args, int);
+        }
+
+        // Length modifier
+        int longs = 0, shorts = 0;
+        bool sizeType = false, longDouble = false;
+        for (int k = 1; k < length - 1; k++)
+        {
+            if (c[k] == 'l') longs++;
+            else if (c[k] == 'h') shorts++;
+            else if ((c[k] == 'z') || (c[k] == 'j') || (c[k] == 't')) sizeType = true;
+            else if ((c[k] == 'L') || (c[k] == 'q')) longDouble = true;
+        }
+
+        LogArg arg = { .u = 0 };
+
+        if (strchr("di", conversion) != NULL)
+        {
+            if (longs >= 2) arg.i = va_arg(args, long long);
+            else if (longs == 1) arg.i = va_arg(args, long);
+            else if (sizeType) arg.i = (long long)va_arg(args, ptrdiff_t);
+            else arg.i = va_arg(args, int);
+
+            if (shorts == 1) arg.i = (short)arg.i;
+            else if (shorts >= 2) arg.i = (signed char)arg.i;
+        }
+        else if (strchr("uoxXc", conversion) != NULL)
+        {
+            if (longs >= 2) arg.u = va_arg(args, unsigned long long);
+            else if (longs == 1) arg.u = va_arg(args, unsigned long);
+            else if (sizeType) arg.u = (unsigned long long)va_arg(args, size_t);
+            else arg.u = va_arg(args, unsigned int);
+
+            if (shorts == 1) arg.u = (unsigned short)arg.u;
+            else if ((shorts >= 2) || (conversion == 'c')) arg.u = (unsigned char)arg.u;
+        }
+        else if (strchr("fFeEgGaA", conversion) != NULL) arg.d = longDouble ? (double)va_arg(args, long double) : va_arg(args, double);
+        else if (conversion == 's')
+        {
+            const char *text = va_arg(args, const char *);
+            if (text == NULL) text = "(null)";
+
+            int space = ASYNC_LOG_TEXT_BYTES - used - 1;
+            int size = (int)strnlen(text, (space > 0) ? space : 0);
+
+            arg.offset = (unsigned int)used;
+            if (space >= 0)
+            {
+                memcpy(record->text + used, text, size);
+                record->text[used + size] = '\0';
+                used += size + 1;
+            }
+            else arg.offset = (unsigned int)formatLength;      // Out of room: empty string
+        }
+        else if (conversion == 'p') arg.p = va_arg(args, void *);
+        else if (conversion == 'n') (void)va_arg(args, void *);
+        else
+        {
+            c += length - 1;
+            continue;
+        }
+
+        if (record->argCount < ASYNC_LOG_MAX_ARGS) record->args[record->argCount++] = arg;
+        c += length - 1;
+    }
+
+    record->textLength = (uint16_t)used;
+}
+
+// printf work on the writer thread, one conversion at a time from the stored arguments
+static int FormatRecord(const LogRecord *record, char *out, int size)
+{
+    const char *format = record->text;
+    int written = snprintf(out, size, "%s", LevelPrefix(record->level));
+    int argIndex = 0;
+
+    for (const char *c = format; (*c != '\0') && (written < size - 1); c++)
+    {
+        if (*c != '%')
+        {
+            out[written++] = *c;
+            continue;
+        }
+
+        int length = SpecLength(c);
+        char conversion = c[length - 1];
+        char spec[48];
+        int specLength = 0;
+
+        if (conversion == '%')
+        {
+            out[written++] = '%';
+            c += length - 1;
+            continue;
+        }
+
+        // Rebuild the spec: stars replaced by their values, length modifiers by the stored width
+        spec[specLength++] = '%';
+        for (int k = 1; (k < length - 1) && (specLength < 32); k++)
+        {
+            if (c[k] == '*') specLength += snprintf(spec + specLength, sizeof(spec) - specLength, "%lld",
+                                                    (argIndex < record->argCount) ? record->args[argIndex++].i : 0);
+            else if (strchr("hlLqjzt", c[k]) == NULL) spec[specLength++] = c[k];
+        }
+
+        bool integer = (strchr("diuoxX", conversion) != NULL);
+        if (integer)
+        {
+            spec[specLength++] = 'l';
+            spec[specLength++] = 'l';
+        }
+        spec[specLength++] = conversion;
+        spec[specLength] = '\0';
+
+        LogArg arg = (argIndex < record->argCount) ? record->args[argIndex++] : (LogArg){ .u = 0 };
+        int room = size - written;
+
+        if (strchr("di", conversion) != NULL) written += snprintf(out + written, room, spec, arg.i);
+        else if (integer) written += snprintf(out + written, room, spec, arg.u);
+        else if (conversion == 'c') written += snprintf(out + written, room, spec, (int)arg.u);
+        else if (strchr("fFeEgGaA", conversion) != NULL) written += snprintf(out + written, room, spec, arg.d);
+        else if (conversion == 's') written += snprintf(out + written, room, spec, record->text + arg.offset);
+        else if (conversion == 'p') written += snprintf(out + written, room, spec, arg.p);
+
+        if (written > size - 1) written = size - 1;
+        c += length - 1;
+    }
+
+    out[written++] = '\n';
+    return written;
+}
+
+static bool TakeRecord(LogRecord **record)
+{
+    LogRecord *slot = &ring[ringHead & ringMask];
+    uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+    if (sequence != ringHead + 1) return false;
+
+    *record = slot;
+    return true;
+}
+
+static void ReleaseRecord(LogRecord *record)
+{
+    __atomic_store_n(&record->sequence, ringHead + ringMask + 1, __ATOMIC_RELEASE);
+    ringHead++;
+}
+
+// Everything published so far, returns whether anything was written
+static bool DrainRing(void)
+{
+    char line[ASYNC_LOG_RECORD_BYTES*2];
+    LogRecord *record;
+    bool any = false;
+
+    while (TakeRecord(&record))
+    {
+        int length = FormatRecord(record, line, sizeof(line) - 1);
+        ReleaseRecord(record);
+
+        fwrite(line, 1, length, stdout);
+        any = true;
+    }
+
+    uint64_t dropped = __atomic_load_n(&droppedRecords, __ATOMIC_RELAXED);
+    if (dropped != reportedDrops)
+    {
+        fprintf(stdout, "WARNING: LOG: %llu messages dropped, log ring full\n", (unsigned long long)(dropped - reportedDrops));
+        reportedDrops = dropped;
+        any = true;
+    }
+
+    if (any) fflush(stdout);
+    return any;
+}
+
+static void *WriterThread(void *arg)
+{
+    (void)arg;
+    struct timespec poll = { 0, ASYNC_LOG_POLL_MS*1000000L };
+
+    while (__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE))
+    {
+        if (!DrainRing()) nanosleep(&poll, NULL);
+    }
+
+    DrainRing();
+    return NULL;
+}
+
+// Writer drains everything queued before it stops
+static void StopWriter(void)
+{
+    __atomic_store_n(&writerRunning, false, __ATOMIC_RELEASE);
+    pthread_join(writerThread, NULL);
+}
+
+static void AsyncTraceLog(int level, const char *text, va_list args)
+{
+    // raylib does not exit after a fatal message once a callback is installed: out with
+    // everything queued, then it directly, and exit as raylib would
+    if (level == LOG_FATAL)
+    {
+        SetTraceLogCallback(NULL);
+        if (__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) StopWriter();
+
+        fputs(LevelPrefix(level), stdout);
+        vfprintf(stdout, text, args);
+        fputc('\n', stdout);
+        fflush(stdout);
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t position = __atomic_load_n(&ringTail, __ATOMIC_RELAXED);
+    LogRecord *slot;
+
+    for (;;)
+    {
+        slot = &ring[position & ringMask];
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+        if (sequence == position)
+        {
+            if (__atomic_compare_exchange_n(&ringTail, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        }
+        else if (sequence < position)
+        {
+            // Full: the writer has not freed this slot yet
+            __atomic_fetch_add(&droppedRecords, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        else position = __atomic_load_n(&ringTail, __ATOMIC_RELAXED);
+    }
+
+    CaptureRecord(slot, level, text, args);
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool InitAsyncLog(int records)
+{
+#if defined(ASYNC_LOG_SUPPORTED)
+    if (writerRunning || (records < 2) || ((records & (records - 1)) != 0)) return false;
+
+    ring = (LogRecord *)malloc((size_t)records*sizeof(LogRecord));
+    if (ring == NULL) return false;
+
+    // Touched now: no page faults on the logging threads later
+    memset(ring, 0, (size_t)records*sizeof(LogRecord));
+    for (int i = 0; i < records; i++) ring[i].sequence = (uint64_t)i;
+
+    ringMask = (uint64_t)records - 1;
+    ringTail = ringHead = 0;
+    droppedRecords = reportedDrops = 0;
+
+    writerRunning = true;
+    if (pthread_create(&writerThread, NULL, WriterThread, NULL) != 0)
+    {
+        writerRunning = false;
+        free(ring);
+        ring = NULL;
+        return false;
+    }
+
+    SetTraceLogCallback(AsyncTraceLog);
+    return true;
+#else
+    (void)records;
+    return false;
+#endif
+}
+
+void CloseAsyncLog(void)
+{
+#if defined(ASYNC_LOG_SUPPORTED)
+    if (!writerRunning) return;
+
+    SetTraceLogCallback(NULL);
+    StopWriter();
+
+    free(ring);
+    ring = NULL;
+#endif
+}
+
+uint64_t GetAsyncLogDropped(void)
+{
+#if defined(ASYNC_LOG_SUPPORTED)
+    return __atomic_load_n(&droppedRecords, __ATOMIC_RELAXED);
+#else
+    return 0;
+#endif
+}
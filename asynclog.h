@@ -0,0 +1,36 @@
+/*******************************************************************************************
+*
+*   C-volley - asynchronous logging
+*
+*   raylib's TraceLog() writes to stdout on the calling thread, a slow terminal or journald
+*   then stalls the frame. With the asynchronous log installed (SetTraceLogCallback) a call
+*   only copies its format string and raw arguments (%s strings inline) into a fixed-size
+*   binary record of a bounded lock-free ring; a writer thread does the printf work and the
+*   write. Any thread may log (audio, mixer, renderer workers). When the ring is full the
+*   record is dropped and counted, the writer reports drops in the output, nothing blocks.
+*
+*   LOG_FATAL is written synchronously after draining the ring, then the callback exits the
+*   process itself: raylib's TraceLog() returns right after an installed callback.
+*   Output is raylib's own format ("INFO: ...") on stdout.
+*
+*   POSIX threads only; InitAsyncLog() returns false elsewhere and logging stays synchronous.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef ASYNCLOG_H
+#define ASYNCLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ASYNC_LOG_DEFAULT_RECORDS 1024  // 512 KB of 512 byte records
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool InitAsyncLog(int records);         // Power of two, installs the TraceLog callback and starts the writer
+void CloseAsyncLog(void);               // Writes what is queued, stops the writer, back to synchronous output
+uint64_t GetAsyncLogDropped(void);      // Records lost to a full ring so far
+
+#endif // ASYNCLOG_H
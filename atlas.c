@@ -0,0 +1,464 @@
+/*******************************************************************************************
+*
+*   C-volley - texture atlas and batched 2D primitives
+*
+*   Atlas layout (512x128, point filtered, 2px gutters between cells):
+*     [0,0]     default font glyphs (128x128, copied from raylib's default font texture)
+*     [130,2]   4x4 white block, shapes sample its center texel
+*     [130,10]  particle sprite
+*     [140,2]   ball sprite (downscaled once at load)
+*     [216,2]   blob/disc sprite
+*
+*   Every primitive below is emitted as RL_QUADS bound to the atlas texture (triangles are
+*   sent as quads with a repeated vertex), vertex order follows raylib's own shape functions.
+*   With AtlasSetSoftTarget(true) the same calls are recorded into the software rasterizer
+*   instead, sampling a CPU copy of the atlas pixels.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "atlas.h"
+#include "renderstats.h"
+#include "rlgl.h"
+#include "softrender.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define ATLAS_WIDTH 512
+#define ATLAS_HEIGHT 128
+
+#define ATLAS_WHITE_X 130
+#define ATLAS_WHITE_Y 2
+#define ATLAS_PARTICLE_X 130
+#define ATLAS_PARTICLE_Y 10
+#define ATLAS_PARTICLE_SIZE 8
+#define ATLAS_BALL_X 140
+#define ATLAS_BALL_Y 2
+#define ATLAS_BALL_MAX_SIZE 72
+#define ATLAS_DISC_X 216
+#define ATLAS_DISC_Y 2
+#define ATLAS_DISC_SIZE 100
+
+#define ATLAS_CIRCLE_SEGMENTS 36
+
+//----------------------------------------------------------------------------------
+// Module state
+//----------------------------------------------------------------------------------
+static Texture2D atlasTexture = { 0 };
+static Rectangle spriteRecs[ATLAS_SPRITE_COUNT] = { 0 };
+static bool spriteLoaded[ATLAS_SPRITE_COUNT] = { 0 };
+
+static Font atlasFont = { 0 };      // Default font metrics, recs remapped into the atlas
+static bool atlasFontLoaded = false;
+
+static float whiteU = 0.0f;         // Texel center of the white block
+static float whiteV = 0.0f;
+
+static Color *atlasPixels = NULL;   // CPU copy for the software rasterizer
+static SoftTexture atlasSoftTexture = { 0 };
+static bool softTarget = false;
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+
+// Copy an RGBA image into atlas pixels without blending
+static void BlitImage(Color *pixels, Image image, int posX, int posY)
+{
+    Color *src = LoadImageColors(image);
+
+    for (int y = 0; y < image.height; y++)
+    {
+        memcpy(&pixels[(posY + y)*ATLAS_WIDTH + posX], &src[y*image.width], image.width*sizeof(Color));
+    }
+
+    UnloadImageColors(src);
+}
+
+// Anti-aliased white disc, alpha falloff over 'softness' pixels at the rim
+static void GenDisc(Color *pixels, int posX, int posY, int size, float softness)
+{
+    float radius = size/2.0f;
+
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            float dx = x + 0.5f - radius;
+            float dy = y + 0.5f - radius;
+            float coverage = (radius - sqrtf(dx*dx + dy*dy))/softness;
+            if (coverage < 0.0f) coverage = 0.0f;
+            if (coverage > 1.0f) coverage = 1.0f;
+
+            pixels[(posY + y)*ATLAS_WIDTH + posX + x] = (Color){ 255, 255, 255, (unsigned char)(coverage*255.0f) };
+        }
+    }
+}
+
+static inline void AtlasBegin(int vertexCount)
+{
+    bool flushed = rlCheckRenderBatchLimit(vertexCount);
+    RENDER_STATS_PRIMITIVE(atlasTexture.id, vertexCount, flushed);
+
+    rlSetTexture(atlasTexture.id);
+    rlBegin(RL_QUADS);
+}
+
+static inline void AtlasEnd(void)
+{
+    rlEnd();
+    rlSetTexture(0);
+}
+
+static inline void AtlasVertex(float x, float y, float u, float v, Color color)
+{
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlTexCoord2f(u, v);
+    rlVertex2f(x, y);
+}
+
+//----------------------------------------------------------------------------------
+// Module functions definition
+//----------------------------------------------------------------------------------
+
+// Build the atlas: font glyphs, white texel, generated sprites and the ball image
+bool LoadAtlas(const char *ballFileName, int ballSize)
+{
+    Image atlasImage = GenImageColor(ATLAS_WIDTH, ATLAS_HEIGHT, BLANK);
+    Color *pixels = (Color *)atlasImage.data;
+
+    // Default font glyphs
+    Font font = GetFontDefault();
+    if ((font.texture.id > 0) && (font.texture.width <= ATLAS_WHITE_X - 2) && (font.texture.height <= ATLAS_HEIGHT))
+    {
+        Image fontImage = LoadImageFromTexture(font.texture);
+        BlitImage(pixels, fontImage, 0, 0);
+        UnloadImage(fontImage);
+
+        atlasFont = font;
+        atlasFont.recs = (Rectangle *)malloc(font.glyphCount*sizeof(Rectangle));
+        memcpy(atlasFont.recs, font.recs, font.glyphCount*sizeof(Rectangle));
+        atlasFontLoaded = true;
+    }
+    else TraceLog(LOG_WARNING, "ATLAS: Default font does not fit, text falls back to DrawText()");
+
+    // White block for untextured shapes
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 4; x++) pixels[(ATLAS_WHITE_Y + y)*ATLAS_WIDTH + ATLAS_WHITE_X + x] = WHITE;
+    }
+    whiteU = (ATLAS_WHITE_X + 1.5f)/ATLAS_WIDTH;
+    whiteV = (ATLAS_WHITE_Y + 1.5f)/ATLAS_HEIGHT;
+
+    // Generated sprites
+    GenDisc(pixels, ATLAS_PARTICLE_X, ATLAS_PARTICLE_Y, ATLAS_PARTICLE_SIZE, 2.0f);
+    spriteRecs[ATLAS_SPRITE_PARTICLE] = (Rectangle){ ATLAS_PARTICLE_X, ATLAS_PARTICLE_Y, ATLAS_PARTICLE_SIZE, ATLAS_PARTICLE_SIZE };
+    spriteLoaded[ATLAS_SPRITE_PARTICLE] = true;
+
+    GenDisc(pixels, ATLAS_DISC_X, ATLAS_DISC_Y, ATLAS_DISC_SIZE, 1.0f);
+    spriteRecs[ATLAS_SPRITE_BLOB] = (Rectangle){ ATLAS_DISC_X, ATLAS_DISC_Y, ATLAS_DISC_SIZE, ATLAS_DISC_SIZE };
+    spriteLoaded[ATLAS_SPRITE_BLOB] = true;
+
+    // Ball image, downscaled once to its on-screen size
+    if (ballSize > ATLAS_BALL_MAX_SIZE) ballSize = ATLAS_BALL_MAX_SIZE;
+
+    Image ballImage = LoadImage(ballFileName);
+    if (ballImage.data != NULL)
+    {
+        ImageFormat(&ballImage, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        ImageResize(&ballImage, ballSize, ballSize);
+        BlitImage(pixels, ballImage, ATLAS_BALL_X, ATLAS_BALL_Y);
+        UnloadImage(ballImage);
+
+        spriteRecs[ATLAS_SPRITE_BALL] = (Rectangle){ ATLAS_BALL_X, ATLAS_BALL_Y, (float)ballSize, (float)ballSize };
+        spriteLoaded[ATLAS_SPRITE_BALL] = true;
+    }
+
+    atlasTexture = LoadTextureFromImage(atlasImage);
+
+    atlasPixels = (Color *)malloc(ATLAS_WIDTH*ATLAS_HEIGHT*sizeof(Color));
+    if (atlasPixels != NULL) memcpy(atlasPixels, pixels, ATLAS_WIDTH*ATLAS_HEIGHT*sizeof(Color));
+    atlasSoftTexture = (SoftTexture){ atlasPixels, ATLAS_WIDTH, ATLAS_HEIGHT };
+
+    UnloadImage(atlasImage);
+
+    if (atlasTexture.id == 0)
+    {
+        UnloadAtlas();
+        return false;
+    }
+
+    // Let any raylib shape function that still gets called hit the same texture
+    SetShapesTexture(atlasTexture, (Rectangle){ ATLAS_WHITE_X + 1, ATLAS_WHITE_Y + 1, 1, 1 });
+
+    if (atlasFontLoaded) atlasFont.texture = atlasTexture;
+
+    return true;
+}
+
+void UnloadAtlas(void)
+{
+    if (atlasFontLoaded) free(atlasFont.recs);
+    atlasFontLoaded = false;
+
+    if (atlasTexture.id > 0)
+    {
+        SetShapesTexture((Texture2D){ 0 }, (Rectangle){ 0 });
+        UnloadTexture(atlasTexture);
+    }
+    atlasTexture = (Texture2D){ 0 };
+
+    free(atlasPixels);
+    atlasPixels = NULL;
+    atlasSoftTexture = (SoftTexture){ 0 };
+
+    memset(spriteLoaded, 0, sizeof(spriteLoaded));
+}
+
+// Record into the software rasterizer instead of rlgl, caller owns SoftBeginFrame()/SoftEndFrame()
+void AtlasSetSoftTarget(bool enabled)
+{
+    softTarget = enabled && IsSoftRendererReady();
+}
+
+bool AtlasHasSprite(AtlasSprite sprite)
+{
+    return (atlasTexture.id > 0) && spriteLoaded[sprite];
+}
+
+// Same math as DrawTexturePro(), source taken from the sprite cell
+void AtlasDrawSprite(AtlasSprite sprite, Rectangle dest, Vector2 origin, float rotation, Color tint)
+{
+    Rectangle src = spriteRecs[sprite];
+    float u0 = src.x/ATLAS_WIDTH;
+    float v0 = src.y/ATLAS_HEIGHT;
+    float u1 = (src.x + src.width)/ATLAS_WIDTH;
+    float v1 = (src.y + src.height)/ATLAS_HEIGHT;
+
+    Vector2 topLeft, topRight, bottomLeft, bottomRight;
+
+    if (rotation == 0.0f)
+    {
+        float x = dest.x - origin.x;
+        float y = dest.y - origin.y;
+        topLeft = (Vector2){ x, y };
+        topRight = (Vector2){ x + dest.width, y };
+        bottomLeft = (Vector2){ x, y + dest.height };
+        bottomRight = (Vector2){ x + dest.width, y + dest.height };
+    }
+    else
+    {
+        float sinRotation = sinf(rotation*DEG2RAD);
+        float cosRotation = cosf(rotation*DEG2RAD);
+        float dx = -origin.x;
+        float dy = -origin.y;
+
+        topLeft.x = dest.x + dx*cosRotation - dy*sinRotation;
+        topLeft.y = dest.y + dx*sinRotation + dy*cosRotation;
+        topRight.x = dest.x + (dx + dest.width)*cosRotation - dy*sinRotation;
+        topRight.y = dest.y + (dx + dest.width)*sinRotation + dy*cosRotation;
+        bottomLeft.x = dest.x + dx*cosRotation - (dy + dest.height)*sinRotation;
+        bottomLeft.y = dest.y + dx*sinRotation + (dy + dest.height)*cosRotation;
+        bottomRight.x = dest.x + (dx + dest.width)*cosRotation - (dy + dest.height)*sinRotation;
+        bottomRight.y = dest.y + (dx + dest.width)*sinRotation + (dy + dest.height)*cosRotation;
+    }
+
+    if (softTarget)
+    {
+        SoftDrawQuad(&atlasSoftTexture, topLeft, bottomLeft, topRight, src, tint);
+        return;
+    }
+
+    AtlasBegin(4);
+        AtlasVertex(topLeft.x, topLeft.y, u0, v0, tint);
+        AtlasVertex(bottomLeft.x, bottomLeft.y, u0, v1, tint);
+        AtlasVertex(bottomRight.x, bottomRight.y, u1, v1, tint);
+        AtlasVertex(topRight.x, topRight.y, u1, v0, tint);
+    AtlasEnd();
+}
+
+void AtlasDrawRectangle(float x, float y, float width, float height, Color color)
+{
+    AtlasDrawRectangleGradientH(x, y, width, height, color, color);
+}
+
+void AtlasDrawRectangleGradientH(float x, float y, float width, float height, Color left, Color right)
+{
+    if (softTarget)
+    {
+        SoftDrawRectangleGradientH(x, y, width, height, left, right);
+        return;
+    }
+
+    AtlasBegin(4);
+        AtlasVertex(x, y, whiteU, whiteV, left);
+        AtlasVertex(x, y + height, whiteU, whiteV, left);
+        AtlasVertex(x + width, y + height, whiteU, whiteV, right);
+        AtlasVertex(x + width, y, whiteU, whiteV, right);
+    AtlasEnd();
+}
+
+void AtlasDrawLine(Vector2 start, Vector2 end, float thick, Color color)
+{
+    float dx = end.x - start.x;
+    float dy = end.y - start.y;
+    float length = sqrtf(dx*dx + dy*dy);
+    if (length <= 0.0f) return;
+
+    // Half-thickness normal
+    float nx = -dy/length*thick*0.5f;
+    float ny = dx/length*thick*0.5f;
+
+    if (softTarget)
+    {
+        SoftDrawQuad(NULL, (Vector2){ start.x - nx, start.y - ny }, (Vector2){ start.x + nx, start.y + ny },
+                     (Vector2){ end.x - nx, end.y - ny }, (Rectangle){ 0 }, color);
+        return;
+    }
+
+    AtlasBegin(4);
+        AtlasVertex(start.x - nx, start.y - ny, whiteU, whiteV, color);
+        AtlasVertex(start.x + nx, start.y + ny, whiteU, whiteV, color);
+        AtlasVertex(end.x + nx, end.y + ny, whiteU, whiteV, color);
+        AtlasVertex(end.x - nx, end.y - ny, whiteU, whiteV, color);
+    AtlasEnd();
+}
+
+void AtlasDrawCircle(Vector2 center, float radius, Color color)
+{
+    AtlasDrawEllipse(center, radius, radius, color);
+}
+
+// Disc sprite stretched over the ellipse bounds
+void AtlasDrawEllipse(Vector2 center, float radiusH, float radiusV, Color color)
+{
+    if (softTarget)
+    {
+        SoftDrawEllipse(center, radiusH, radiusV, color);
+        return;
+    }
+
+    Rectangle dest = { center.x - radiusH, center.y - radiusV, radiusH*2.0f, radiusV*2.0f };
+    AtlasDrawSprite(ATLAS_SPRITE_BLOB, dest, (Vector2){ 0, 0 }, 0.0f, color);
+}
+
+void AtlasDrawCircleGradient(Vector2 center, float radius, Color inner, Color outer)
+{
+    if (softTarget)
+    {
+        SoftDrawCircleGradient(center, radius, inner, outer);
+        return;
+    }
+
+    const float step = 360.0f/ATLAS_CIRCLE_SEGMENTS;
+
+    AtlasBegin(4*ATLAS_CIRCLE_SEGMENTS);
+    for (int i = 0; i < ATLAS_CIRCLE_SEGMENTS; i++)
+    {
+        float angle = i*step*DEG2RAD;
+        float nextAngle = (i + 1)*step*DEG2RAD;
+
+        AtlasVertex(center.x, center.y, whiteU, whiteV, inner);
+        AtlasVertex(center.x + cosf(nextAngle)*radius, center.y + sinf(nextAngle)*radius, whiteU, whiteV, outer);
+        AtlasVertex(center.x + cosf(angle)*radius, center.y + sinf(angle)*radius, whiteU, whiteV, outer);
+        AtlasVertex(center.x + cosf(angle)*radius, center.y + sinf(angle)*radius, whiteU, whiteV, outer);
+    }
+    AtlasEnd();
+}
+
+// One pixel wide ring, replaces DrawCircleLines() which would switch to RL_LINES
+void AtlasDrawCircleLines(Vector2 center, float radius, Color color)
+{
+    const float step = 360.0f/ATLAS_CIRCLE_SEGMENTS;
+    float innerRadius = radius - 0.5f;
+    float outerRadius = radius + 0.5f;
+
+    if (softTarget)
+    {
+        SoftDrawRing(center, innerRadius, outerRadius, color);
+        return;
+    }
+
+    AtlasBegin(4*ATLAS_CIRCLE_SEGMENTS);
+    for (int i = 0; i < ATLAS_CIRCLE_SEGMENTS; i++)
+    {
+        float cosA = cosf(i*step*DEG2RAD);
+        float sinA = sinf(i*step*DEG2RAD);
+        float cosB = cosf((i + 1)*step*DEG2RAD);
+        float sinB = sinf((i + 1)*step*DEG2RAD);
+
+        AtlasVertex(center.x + cosA*outerRadius, center.y + sinA*outerRadius, whiteU, whiteV, color);
+        AtlasVertex(center.x + cosA*innerRadius, center.y + sinA*innerRadius, whiteU, whiteV, color);
+        AtlasVertex(center.x + cosB*innerRadius, center.y + sinB*innerRadius, whiteU, whiteV, color);
+        AtlasVertex(center.x + cosB*outerRadius, center.y + sinB*outerRadius, whiteU, whiteV, color);
+    }
+    AtlasEnd();
+}
+
+// Equivalent of DrawText(): default font, spacing = fontSize/10, glyphs from the atlas
+void AtlasDrawText(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    if (!atlasFontLoaded)
+    {
+        if (softTarget) return;     // No CPU copy of the font without the atlas
+
+        RENDER_STATS_PRIMITIVE(GetFontDefault().texture.id, 4*(int)strlen(text), false);
+        DrawText(text, posX, posY, fontSize, color);
+        return;
+    }
+
+    const int defaultFontSize = 10;
+    if (fontSize < defaultFontSize) fontSize = defaultFontSize;
+
+    float scale = (float)fontSize/atlasFont.baseSize;
+    float spacing = (float)(fontSize/defaultFontSize);
+    float padding = (float)atlasFont.glyphPadding;
+    float offsetX = 0.0f;
+
+    while (*text != '\0')
+    {
+        int codepointSize = 0;
+        int codepoint = GetCodepointNext(text, &codepointSize);
+        int index = GetGlyphIndex(atlasFont, codepoint);
+        text += codepointSize;
+
+        Rectangle rec = atlasFont.recs[index];
+        GlyphInfo glyph = atlasFont.glyphs[index];
+
+        if ((codepoint != ' ') && (codepoint != '\t'))
+        {
+            float x = posX + offsetX + (glyph.offsetX - padding)*scale;
+            float y = posY + (glyph.offsetY - padding)*scale;
+            float w = (rec.width + 2.0f*padding)*scale;
+            float h = (rec.height + 2.0f*padding)*scale;
+
+            float u0 = (rec.x - padding)/ATLAS_WIDTH;
+            float v0 = (rec.y - padding)/ATLAS_HEIGHT;
+            float u1 = (rec.x + rec.width + padding)/ATLAS_WIDTH;
+            float v1 = (rec.y + rec.height + padding)/ATLAS_HEIGHT;
+
+            if (softTarget)
+            {
+                Rectangle texels = { rec.x - padding, rec.y - padding, rec.width + 2.0f*padding, rec.height + 2.0f*padding };
+                SoftDrawQuad(&atlasSoftTexture, (Vector2){ x, y }, (Vector2){ x, y + h }, (Vector2){ x + w, y }, texels, color);
+            }
+            else
+            {
+                AtlasBegin(4);
+                    AtlasVertex(x, y, u0, v0, color);
+                    AtlasVertex(x, y + h, u0, v1, color);
+                    AtlasVertex(x + w, y + h, u1, v1, color);
+                    AtlasVertex(x + w, y, u1, v0, color);
+                AtlasEnd();
+            }
+        }
+
+        if (glyph.advanceX == 0) offsetX += rec.width*scale + spacing;
+        else offsetX += glyph.advanceX*scale + spacing;
+    }
+}
@@ -0,0 +1,40 @@
+/*******************************************************************************************
+*
+*   C-volley - texture atlas and batched 2D primitives
+*
+*   All gameplay/menu drawing goes through this module. Ball, font glyphs, particle sprite,
+*   blob sprite and a white texel for untextured shapes live in a single texture and every
+*   primitive is emitted as RL_QUADS, so rlgl never has to switch texture or draw mode and
+*   a whole frame (excluding the background image) ends up in one draw call.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "raylib.h"
+
+typedef enum AtlasSprite {
+    ATLAS_SPRITE_BALL = 0,
+    ATLAS_SPRITE_BLOB,          // White anti-aliased disc, also used for plain circles/ellipses
+    ATLAS_SPRITE_PARTICLE,      // Small soft white dot
+    ATLAS_SPRITE_COUNT
+} AtlasSprite;
+
+bool LoadAtlas(const char *ballFileName, int ballSize);   // Requires window (reads back default font texture)
+void UnloadAtlas(void);
+bool AtlasHasSprite(AtlasSprite sprite);
+void AtlasSetSoftTarget(bool enabled);                      // Route everything below to softrender.h
+
+void AtlasDrawSprite(AtlasSprite sprite, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void AtlasDrawRectangle(float x, float y, float width, float height, Color color);
+void AtlasDrawRectangleGradientH(float x, float y, float width, float height, Color left, Color right);
+void AtlasDrawLine(Vector2 start, Vector2 end, float thick, Color color);
+void AtlasDrawCircle(Vector2 center, float radius, Color color);
+void AtlasDrawCircleGradient(Vector2 center, float radius, Color inner, Color outer);
+void AtlasDrawCircleLines(Vector2 center, float radius, Color color);
+void AtlasDrawEllipse(Vector2 center, float radiusH, float radiusV, Color color);
+void AtlasDrawText(const char *text, int posX, int posY, int fontSize, Color color);
+
+#endif // ATLAS_H
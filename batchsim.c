@@ -0,0 +1,679 @@
+/*******************************************************************************************
+*
+*   C-volley - NUMA aware batch self-play runner (Linux)
+*
+*   Usage:
+*     batchsim [matches] [--threads N] [--lanes N] [--pages small|thp|huge] [--no-pin] [--scale]
+*              [--ai] [--agent PLUGIN] [--agent-left PLUGIN] [--agent-right PLUGIN]
+*              [--idle-serve] [--skip-dead-time]
+*
+*   Plays whole matches headless between two scripted players (SimScriptAction()), or the
+*   built-in AI on both sides with --ai, as many at once per worker as there are lanes,
+*   stepping every lane one tick per sweep.
+*
+*   --agent loads an agent plug-in (agent.h) for both sides, --agent-left/--agent-right for
+*   one. Each worker creates its own agent and, per sweep, collects the observations of all
+*   lanes that need a decision and makes one decideBatch() call per side; the time spent in
+*   those calls is reported per decision. A side-canonical agent (AGENT_FLAG_CANONICAL) given
+*   with --agent plays both sides from one handle and one call per sweep, both sides' lanes
+*   in the same batch.
+*
+*   Headless matches have no visual delay to fill: players send nothing while the score delay
+*   runs, and with --idle-serve also from the serve until the ball is first touched or lands.
+*   --skip-dead-time jumps over those frames with SimSkipDeadTime() instead of stepping them,
+*   the results (and checksum) stay the same. Steps count simulated frames either way.
+*
+*   Workers are spread over NUMA nodes round-robin and pinned to one CPU each. A worker
+*   allocates its own lane and result arrays after pinning: the mapping is bound to the
+*   worker's node (mbind) and first touched by the worker, and backed by transparent huge
+*   pages (default) or explicit hugetlbfs pages, falling back to small pages when none are
+*   available. Afterwards every page of the arrays is looked up (move_pages) and the share
+*   living on another node is reported as the remote ratio, together with steps/second per
+*   node. --scale repeats the run from 1 worker up to one per CPU.
+*
+*   Match m always uses the same seeds, the checksum over all results is the same for any
+*   thread count, lane count or page mode.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include "selfplay.h"
+#include "agentplugin.h"
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_NODES 64
+#define MAX_NODE_ID (4*MAX_NODES)       // Node ids in sysfs can have gaps, the mbind() mask covers them all
+#define MAX_WORKERS 1024
+#define HUGE_PAGE_SIZE (2*1024*1024)
+#define DEFAULT_LANES 4096
+#define PAGE_QUERY_BATCH 1024
+
+typedef enum { PAGES_SMALL = 0, PAGES_TRANSPARENT, PAGES_EXPLICIT } PageMode;
+
+static const char *pageModeNames[] = { "small", "thp", "huge" };
+
+typedef struct Node {
+    int id;
+    int cpus[MAX_WORKERS];
+    int cpuCount;
+} Node;
+
+typedef struct Worker {
+    pthread_t thread;
+    int cpu;                    // -1 when not pinned
+    int node;                   // Index into nodes[]
+    int firstMatch;
+    int matchCount;
+
+    // Arena: lanes followed by results, owned by the worker thread
+    void *arena;
+    size_t arenaSize;
+    PageMode pages;             // What the arena actually got
+    size_t hugeBytes;
+
+    uint64_t steps;
+    uint64_t skipped;           // Frames advanced by SimSkipDeadTime()
+    uint64_t decisions;         // Agent plug-in decisions and time spent in them
+    double decisionSeconds;
+    double seconds;
+    long pageCount;
+    long remotePages;
+} Worker;
+
+typedef struct Config {
+    int matches;
+    int threads;
+    int lanes;
+    PageMode pages;
+    bool pin;
+    SelfPlayConfig play;
+} Config;
+
+static Node nodes[MAX_NODES] = { 0 };
+static int nodeCount = 0;
+static int cpuCount = 0;
+
+static Config config = { 0 };
+static AgentPlugin plugins[2] = { 0 };
+static bool sharedAgent = false;            // One canonical agent handle and batch for both sides
+static Worker workers[MAX_WORKERS] = { 0 };
+static pthread_barrier_t startBarrier;
+
+//----------------------------------------------------------------------------------
+// Topology
+//----------------------------------------------------------------------------------
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec*1e-9;
+}
+
+// Parses a sysfs cpulist ("0-7,16-23") into the CPUs this process may run on
+static void ParseCpuList(const char *list, const cpu_set_t *allowed, Node *node)
+{
+    const char *p = list;
+
+    while (*p)
+    {
+        char *end = NULL;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+
+        long last = first;
+        if (*end == '-') last = strtol(end + 1, &end, 10);
+
+        for (long cpu = first; (cpu <= last) && (node->cpuCount < MAX_WORKERS); cpu++)
+        {
+            if (CPU_ISSET((int)cpu, allowed)) node->cpus[node->cpuCount++] = (int)cpu;
+        }
+
+        p = (*end == ',') ? end + 1 : end;
+        if (*p == '\n') break;
+    }
+}
+
+static void DiscoverTopology(void)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    for (int id = 0; (id < MAX_NODE_ID) && (nodeCount < MAX_NODES); id++)
+    {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+
+        FILE *file = fopen(path, "r");
+        if (file == NULL) continue;
+
+        char list[4096] = { 0 };
+        if (fgets(list, sizeof(list), file) != NULL)
+        {
+            Node *node = &nodes[nodeCount];
+            node->id = id;
+            node->cpuCount = 0;
+            ParseCpuList(list, &allowed, node);
+            if (node->cpuCount > 0) nodeCount++;     // Memory-only nodes and CPUs outside our mask
+        }
+        fclose(file);
+    }
+
+    // No NUMA in sysfs (or kernel without it): a single node with every allowed CPU
+    if (nodeCount == 0)
+    {
+        nodes[0].id = 0;
+        for (int cpu = 0; (cpu < CPU_SETSIZE) && (nodes[0].cpuCount < MAX_WORKERS); cpu++)
+        {
+            if (CPU_ISSET(cpu, &allowed)) nodes[0].cpus[nodes[0].cpuCount++] = cpu;
+        }
+        nodeCount = 1;
+    }
+
+    cpuCount = 0;
+    for (int i = 0; i < nodeCount; i++) cpuCount += nodes[i].cpuCount;
+}
+
+// Worker i goes to node i%nodeCount (skipping full nodes), so every socket gets its share
+// of memory bandwidth at any thread count
+static void PlaceWorkers(int count)
+{
+    int used[MAX_NODES] = { 0 };
+    int node = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!config.pin)
+        {
+            workers[i].cpu = -1;
+            workers[i].node = 0;
+            continue;
+        }
+
+        while (used[node] >= nodes[node].cpuCount) node = (node + 1)%nodeCount;
+
+        workers[i].node = node;
+        workers[i].cpu = nodes[node].cpus[used[node]++];
+        node = (node + 1)%nodeCount;
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Node local memory
+//----------------------------------------------------------------------------------
+static size_t RoundUp(size_t size, size_t alignment)
+{
+    return (size + alignment - 1)/alignment*alignment;
+}
+
+// Bytes of the range backed by transparent huge pages, from /proc/self/smaps
+static size_t TransparentHugeBytes(const void *address, size_t size)
+{
+    FILE *file = fopen("/proc/self/smaps", "r");
+    if (file == NULL) return 0;
+
+    uintptr_t begin = (uintptr_t)address;
+    uintptr_t end = begin + size;
+    bool inside = false;
+    size_t total = 0;
+    char line[512];
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        unsigned long start = 0, stop = 0;
+        if (sscanf(line, "%lx-%lx ", &start, &stop) == 2) inside = (start < end) && (stop > begin);
+        else if (inside)
+        {
+            unsigned long kb = 0;
+            if (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1) total += kb*1024;
+        }
+    }
+
+    fclose(file);
+    return total;
+}
+
+// Maps 'size' bytes for the calling (already pinned) thread, bound to 'node' when NUMA is
+// present, and touches every page so it is faulted in here and now
+static void *AllocateLocal(size_t size, int node, PageMode mode, PageMode *got, size_t *mappedSize)
+{
+    void *memory = MAP_FAILED;
+    size = RoundUp(size, HUGE_PAGE_SIZE);
+
+    if (mode == PAGES_EXPLICIT)
+    {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) *got = PAGES_EXPLICIT;
+        else mode = PAGES_TRANSPARENT;      // No hugetlbfs pages reserved (vm.nr_hugepages)
+    }
+
+    if (memory == MAP_FAILED)
+    {
+        // Over-allocate to cut out a 2 MB aligned range, THP only maps aligned 2 MB extents
+        size_t padded = size + HUGE_PAGE_SIZE;
+        uint8_t *raw = (uint8_t *)mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) return NULL;
+
+        uint8_t *aligned = (uint8_t *)RoundUp((size_t)raw, HUGE_PAGE_SIZE);
+        if (aligned > raw) munmap(raw, aligned - raw);
+        if (aligned + size < raw + padded) munmap(aligned + size, (raw + padded) - (aligned + size));
+
+        memory = aligned;
+        *got = PAGES_SMALL;
+        if ((mode == PAGES_TRANSPARENT) && (madvise(memory, size, MADV_HUGEPAGE) == 0)) *got = PAGES_TRANSPARENT;
+    }
+
+    if ((nodeCount > 1) && (node >= 0))
+    {
+        unsigned long mask[MAX_NODE_ID/(8*sizeof(unsigned long))] = { 0 };
+        int id = nodes[node].id;
+        mask[id/(8*sizeof(unsigned long))] |= 1ul << (id%(8*sizeof(unsigned long)));
+
+        // Without a binding, first touch below still places pages on this node unless it is full
+        syscall(SYS_mbind, memory, size, MPOL_BIND, mask, (unsigned long)MAX_NODE_ID + 1, 0);
+    }
+
+    memset(memory, 0, size);
+
+    *mappedSize = size;
+    return memory;
+}
+
+// Counts the pages of the range that live on another node than 'nodeId'
+static void CountRemotePages(const void *address, size_t size, int nodeId, long *pageCount, long *remotePages)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    long count = (long)(size/pageSize);
+    void *pages[PAGE_QUERY_BATCH];
+    int status[PAGE_QUERY_BATCH];
+
+    *pageCount = 0;
+    *remotePages = 0;
+
+    for (long first = 0; first < count; first += PAGE_QUERY_BATCH)
+    {
+        long batch = ((count - first) < PAGE_QUERY_BATCH) ? (count - first) : PAGE_QUERY_BATCH;
+        for (long i = 0; i < batch; i++) pages[i] = (uint8_t *)address + (first + i)*pageSize;
+
+        // No target nodes: only reports where each page is
+        if (syscall(SYS_move_pages, 0, (unsigned long)batch, pages, NULL, status, 0) != 0) return;
+
+        for (long i = 0; i < batch; i++)
+        {
+            if (status[i] < 0) continue;        // Not present
+            (*pageCount)++;
+            if (status[i] != nodeId) (*remotePages)++;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Matches
+//----------------------------------------------------------------------------------
+
+// Batch buffers of one worker's agents, room for both sides of every lane
+typedef struct WorkerAgents {
+    void *agent[2];
+    AgentObs *obs;
+    AgentAction *actions;
+    int *lanes;
+} WorkerAgents;
+
+static bool CreateAgents(WorkerAgents *agents, int laneCount)
+{
+    memset(agents, 0, sizeof(WorkerAgents));
+
+    for (int side = 0; side < 2; side++)
+    {
+        if ((config.play.agents[side] != AGENT_PLUGIN) || (sharedAgent && (side == 1))) continue;
+
+        agents->agent[side] = plugins[side].api->create(laneCount, config.play.seed);
+        if (agents->agent[side] == NULL) return false;
+    }
+
+    agents->obs = (AgentObs *)malloc(2*laneCount*sizeof(AgentObs));
+    agents->actions = (AgentAction *)malloc(2*laneCount*sizeof(AgentAction));
+    agents->lanes = (int *)malloc(2*laneCount*sizeof(int));
+
+    return (agents->obs != NULL) && (agents->actions != NULL) && (agents->lanes != NULL);
+}
+
+static void DestroyAgents(WorkerAgents *agents)
+{
+    for (int side = 0; side < 2; side++)
+    {
+        if (agents->agent[side] != NULL) plugins[side].api->destroy(agents->agent[side]);
+    }
+
+    free(agents->obs);
+    free(agents->actions);
+    free(agents->lanes);
+}
+
+// One decideBatch() call per plug-in side (per shared agent) for all lanes acting on their next step
+static void DecideAgents(Worker *worker, WorkerAgents *agents, SelfPlayLane *lanes, int count)
+{
+    for (int side = 0; side < 2; side++)
+    {
+        if (agents->agent[side] == NULL) continue;
+
+        int lastSide = sharedAgent ? 1 : side;
+        int n = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (!SelfPlayNeedsDecision(&lanes[i], &config.play)) continue;
+
+            for (int s = side; s <= lastSide; s++)
+            {
+                AgentObserve(&lanes[i].sim, s, (uint32_t)lanes[i].match, &agents->obs[n]);
+                agents->lanes[n++] = i;
+            }
+        }
+        if (n == 0) continue;
+
+        double start = NowSeconds();
+        AgentDecide(&plugins[side], agents->agent[side], agents->obs, agents->actions, n);
+        worker->decisionSeconds += NowSeconds() - start;
+        worker->decisions += n;
+
+        // The observation keeps the real side, also after canonicalization
+        for (int k = 0; k < n; k++) lanes[agents->lanes[k]].decided[agents->obs[k].side] = agents->actions[k] & (ACTION_LEFT | ACTION_RIGHT | ACTION_JUMP);
+    }
+}
+
+static void *WorkerThread(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+
+    if (worker->cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(worker->cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    int laneCount = (worker->matchCount < config.lanes) ? worker->matchCount : config.lanes;
+    size_t laneBytes = RoundUp((size_t)laneCount*sizeof(SelfPlayLane), 64);
+    size_t size = laneBytes + (size_t)worker->matchCount*sizeof(MatchResult);
+
+    worker->arena = AllocateLocal(size, (worker->cpu >= 0) ? worker->node : -1, config.pages, &worker->pages, &worker->arenaSize);
+    if (worker->arena == NULL)
+    {
+        fprintf(stderr, "batchsim: could not allocate %zu bytes\n", size);
+        exit(1);
+    }
+
+    SelfPlayLane *lanes = (SelfPlayLane *)worker->arena;
+    MatchResult *results = (MatchResult *)((uint8_t *)worker->arena + laneBytes);
+
+    int nextMatch = 0;
+    for (int i = 0; i < laneCount; i++) SelfPlayStart(&lanes[i], &config.play, worker->firstMatch + nextMatch++);
+
+    WorkerAgents agents;
+    bool useAgents = (config.play.agents[0] == AGENT_PLUGIN) || (config.play.agents[1] == AGENT_PLUGIN);
+    if (useAgents && !CreateAgents(&agents, laneCount))
+    {
+        fprintf(stderr, "batchsim: could not create agents\n");
+        exit(1);
+    }
+    worker->decisions = 0;
+    worker->decisionSeconds = 0;
+
+    pthread_barrier_wait(&startBarrier);
+    double start = NowSeconds();
+
+    uint64_t steps = 0;
+    uint64_t skipped = 0;
+    int active = laneCount;
+
+    while (active > 0)
+    {
+        if (useAgents) DecideAgents(worker, &agents, lanes, active);
+
+        // A lane moved down by the compaction below carries its decision along
+        for (int i = 0; i < active; i++)
+        {
+            SelfPlayLane *lane = &lanes[i];
+            steps += SelfPlayStep(lane, &config.play, &skipped);
+
+            if (!SelfPlayDone(lane)) continue;
+
+            results[lane->match - worker->firstMatch] = SelfPlayResult(lane);
+
+            if (nextMatch < worker->matchCount) SelfPlayStart(lane, &config.play, worker->firstMatch + nextMatch++);
+            else
+            {
+                // Keep running lanes contiguous, the moved lane is stepped next
+                *lane = lanes[--active];
+                i--;
+            }
+        }
+    }
+
+    worker->seconds = NowSeconds() - start;
+    worker->steps = steps;
+    if (useAgents) DestroyAgents(&agents);
+    worker->skipped = skipped;
+    worker->hugeBytes = (worker->pages == PAGES_EXPLICIT) ? worker->arenaSize : TransparentHugeBytes(worker->arena, worker->arenaSize);
+
+    CountRemotePages(worker->arena, worker->arenaSize, (worker->cpu >= 0) ? nodes[worker->node].id : -1,
+                     &worker->pageCount, &worker->remotePages);
+
+    return NULL;
+}
+
+// Order independent, so equal for every split of the matches over workers
+static uint64_t ResultChecksum(const Worker *worker)
+{
+    int laneCount = (worker->matchCount < config.lanes) ? worker->matchCount : config.lanes;
+    const MatchResult *results = (const MatchResult *)((const uint8_t *)worker->arena + RoundUp((size_t)laneCount*sizeof(SelfPlayLane), 64));
+    uint64_t sum = 0;
+
+    for (int i = 0; i < worker->matchCount; i++) sum += SelfPlayResultHash(worker->firstMatch + i, results[i]);
+
+    return sum;
+}
+
+// Runs all matches on 'count' workers, returns total steps/second
+static double RunBatch(int count, bool report)
+{
+    PlaceWorkers(count);
+
+    int perWorker = config.matches/count;
+    int extra = config.matches%count;
+    int first = 0;
+
+    pthread_barrier_init(&startBarrier, NULL, (unsigned int)count);
+
+    for (int i = 0; i < count; i++)
+    {
+        Worker *worker = &workers[i];
+        worker->firstMatch = first;
+        worker->matchCount = perWorker + ((i < extra) ? 1 : 0);
+        first += worker->matchCount;
+
+        pthread_create(&worker->thread, NULL, WorkerThread, worker);
+    }
+
+    uint64_t totalSteps = 0;
+    uint64_t totalSkipped = 0;
+    uint64_t totalDecisions = 0;
+    double decisionSeconds = 0;
+    uint64_t checksum = 0;
+    double wall = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        totalSteps += workers[i].steps;
+        totalSkipped += workers[i].skipped;
+        totalDecisions += workers[i].decisions;
+        decisionSeconds += workers[i].decisionSeconds;
+        checksum += ResultChecksum(&workers[i]);
+        if (workers[i].seconds > wall) wall = workers[i].seconds;
+    }
+
+    pthread_barrier_destroy(&startBarrier);
+
+    double stepsPerSecond = (wall > 0) ? totalSteps/wall : 0;
+
+    if (report)
+    {
+        for (int n = 0; n < (config.pin ? nodeCount : 1); n++)
+        {
+            int nodeWorkers = 0;
+            uint64_t steps = 0;
+            double rate = 0;
+            long pages = 0, remote = 0;
+            size_t mapped = 0, huge = 0;
+
+            for (int i = 0; i < count; i++)
+            {
+                if (workers[i].node != n) continue;
+
+                nodeWorkers++;
+                steps += workers[i].steps;
+                if (workers[i].seconds > 0) rate += workers[i].steps/workers[i].seconds;
+                pages += workers[i].pageCount;
+                remote += workers[i].remotePages;
+                mapped += workers[i].arenaSize;
+                huge += workers[i].hugeBytes;
+            }
+
+            if (nodeWorkers == 0) continue;
+
+            if (config.pin) printf("node %d: %d workers", nodes[n].id, nodeWorkers);
+            else printf("unpinned: %d workers", nodeWorkers);
+
+            printf(", %.2f M steps/s (%.2f M per worker), %.1f MB arrays, %.0f%% huge pages",
+                   rate/1e6, rate/1e6/nodeWorkers, mapped/1048576.0, (mapped > 0) ? 100.0*huge/mapped : 0.0);
+
+            if (!config.pin) printf("\n");
+            else if (pages > 0) printf(", remote %.2f%% (%ld of %ld pages)\n", 100.0*remote/pages, remote, pages);
+            else printf(", remote n/a (move_pages unavailable)\n");
+        }
+
+        printf("total: %d matches, %llu steps in %.3f s, %.2f M steps/s, checksum %016llx\n", config.matches,
+               (unsigned long long)totalSteps, wall, stepsPerSecond/1e6, (unsigned long long)checksum);
+        if (config.play.skipDeadTime) printf("dead time skipped: %.1f%% of steps\n", 100.0*totalSkipped/totalSteps);
+        if (totalDecisions > 0)
+        {
+            printf("agent decisions: %llu, %.1f ns each (%.1f%% of worker time)\n", (unsigned long long)totalDecisions,
+                   decisionSeconds*1e9/totalDecisions, 100.0*decisionSeconds/(wall*count));
+        }
+        printf("BENCH batchsim.steps_per_s %.0f higher\n", stepsPerSecond);      // For benchgate
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        munmap(workers[i].arena, workers[i].arenaSize);
+        workers[i].arena = NULL;
+    }
+
+    return stepsPerSecond;
+}
+
+int main(int argc, char *argv[])
+{
+    bool scale = false;
+    const char *agentPaths[2] = { NULL, NULL };
+
+    config.matches = 2000;
+    config.threads = 0;
+    config.lanes = DEFAULT_LANES;
+    config.pages = PAGES_TRANSPARENT;
+    config.pin = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) config.threads = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--lanes") == 0) && (i + 1 < argc)) config.lanes = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--pages") == 0) && (i + 1 < argc))
+        {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "small") == 0) config.pages = PAGES_SMALL;
+            else if (strcmp(mode, "thp") == 0) config.pages = PAGES_TRANSPARENT;
+            else if (strcmp(mode, "huge") == 0) config.pages = PAGES_EXPLICIT;
+            else config.matches = -1;
+        }
+        else if (strcmp(argv[i], "--no-pin") == 0) config.pin = false;
+        else if (strcmp(argv[i], "--scale") == 0) scale = true;
+        else if (strcmp(argv[i], "--ai") == 0) config.play.agents[0] = config.play.agents[1] = AGENT_AI;
+        else if ((strcmp(argv[i], "--agent") == 0) && (i + 1 < argc)) agentPaths[0] = agentPaths[1] = argv[++i];
+        else if ((strcmp(argv[i], "--agent-left") == 0) && (i + 1 < argc)) agentPaths[0] = argv[++i];
+        else if ((strcmp(argv[i], "--agent-right") == 0) && (i + 1 < argc)) agentPaths[1] = argv[++i];
+        else if (strcmp(argv[i], "--idle-serve") == 0) config.play.idleServe = true;
+        else if (strcmp(argv[i], "--skip-dead-time") == 0) config.play.skipDeadTime = true;
+        else if (argv[i][0] != '-') config.matches = atoi(argv[i]);
+        else config.matches = -1;
+    }
+
+    if ((config.matches <= 0) || (config.lanes <= 0))
+    {
+        fprintf(stderr, "usage: %s [matches] [--threads N] [--lanes N] [--pages small|thp|huge] [--no-pin] [--scale]\n"
+                        "       [--ai] [--agent PLUGIN] [--agent-left PLUGIN] [--agent-right PLUGIN] [--idle-serve] [--skip-dead-time]\n", argv[0]);
+        return 1;
+    }
+
+    for (int side = 0; side < 2; side++)
+    {
+        if (agentPaths[side] == NULL) continue;
+        if (!AgentPluginLoad(&plugins[side], agentPaths[side])) return 1;
+        config.play.agents[side] = AGENT_PLUGIN;
+    }
+    sharedAgent = (agentPaths[0] != NULL) && (agentPaths[0] == agentPaths[1]) && ((plugins[0].api->flags & AGENT_FLAG_CANONICAL) != 0);
+
+    DiscoverTopology();
+
+    int maxThreads = config.pin ? cpuCount : MAX_WORKERS;
+    if ((config.threads <= 0) || (config.threads > maxThreads)) config.threads = config.pin ? cpuCount : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (config.threads > config.matches) config.threads = config.matches;
+
+    const char *agentNames[2];
+    for (int side = 0; side < 2; side++)
+    {
+        if (config.play.agents[side] == AGENT_AI) agentNames[side] = "AI";
+        else if (config.play.agents[side] == AGENT_PLUGIN) agentNames[side] = plugins[side].api->name;
+        else agentNames[side] = "scripted";
+    }
+
+    printf("%d NUMA node(s), %d CPUs, %d matches (%s vs %s%s), %d lanes/worker, %s pages, %s\n", nodeCount, cpuCount,
+           config.matches, agentNames[0], agentNames[1], sharedAgent ? ", shared" : "", config.lanes,
+           pageModeNames[config.pages], config.pin ? "pinned" : "unpinned");
+
+    if (!scale)
+    {
+        RunBatch(config.threads, true);
+        return 0;
+    }
+
+    printf("workers  M steps/s  speedup  efficiency\n");
+
+    double single = 0;
+    for (int count = 1; ; count = (count*2 < config.threads) ? count*2 : config.threads)
+    {
+        double rate = RunBatch(count, false);
+        if (count == 1) single = rate;
+
+        printf("%7d  %9.2f  %7.2f  %9.0f%%\n", count, rate/1e6, rate/single, 100.0*rate/single/count);
+
+        if (count == config.threads) break;
+    }
+
+    RunBatch(config.threads, true);
+
+    return 0;
+}
@@ -0,0 +1,521 @@
+/*******************************************************************************************
+*
+*   C-volley - benchmark history and regression gate (POSIX)
+*
+*   Usage:
+*     benchgate record [--trials N] [--history FILE] -- COMMAND [ARGS...]
+*     benchgate compare BASE [HEAD] [--history FILE] [--threshold PCT] [--alpha P]
+*     benchgate check BASE [--trials N] [--history FILE] [--threshold PCT] [--alpha P] -- COMMAND [ARGS...]
+*     benchgate machine
+*
+*   Benchmarks print one line per result, "BENCH name value lower|higher" (which direction is
+*   better). record runs COMMAND --trials times and appends every result to the history file
+*   (bench-history.txt), keyed by the current commit (git, "-dirty" with uncommitted changes)
+*   and a fingerprint of the machine (CPU model, CPU count, kernel), so runs on different
+*   machines are never compared.
+*
+*   compare takes all samples of BASE and HEAD (commits, resolved with git, HEAD defaults to
+*   the current one) on this machine and, per benchmark, runs a one-sided Mann-Whitney U test
+*   (normal approximation with tie correction) for "HEAD is worse". The size of the change is
+*   the Hodges-Lehmann shift (median of all pairwise differences) relative to the BASE median.
+*   A benchmark regresses when it is worse by more than --threshold percent (3) with
+*   p < --alpha (0.01); compare then exits with status 1. check is record followed by compare.
+*
+*   Single runs vary by several percent, ten or more trials per side are needed to see 3%.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_HISTORY "bench-history.txt"
+#define DEFAULT_TRIALS 10
+#define DEFAULT_THRESHOLD 3.0           // Percent
+#define DEFAULT_ALPHA 0.01
+#define MIN_SAMPLES 3                   // Per side, fewer and a benchmark is reported but not judged
+
+#define KEY_LENGTH 64
+#define NAME_LENGTH 96
+
+typedef struct Sample {
+    char commit[KEY_LENGTH];
+    char machine[KEY_LENGTH];
+    char name[NAME_LENGTH];
+    bool higherIsBetter;
+    double value;
+} Sample;
+
+typedef struct RankedValue {
+    double value;
+    int group;                          // 0 base, 1 head
+} RankedValue;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static const char *historyFile = DEFAULT_HISTORY;
+static int trials = DEFAULT_TRIALS;
+static double threshold = DEFAULT_THRESHOLD;
+static double alpha = DEFAULT_ALPHA;
+
+static Sample *samples = NULL;
+static int sampleCount = 0;
+static int sampleCapacity = 0;
+
+//----------------------------------------------------------------------------------
+// Keys: commit and machine
+//----------------------------------------------------------------------------------
+
+// First line of a shell command's output, false if it failed or printed nothing
+static bool CommandLine(const char *command, char *line, int size)
+{
+    FILE *pipe = popen(command, "r");
+    if (pipe == NULL) return false;
+
+    bool read = (fgets(line, size, pipe) != NULL);
+    int status = pclose(pipe);
+    if (!read || (status != 0)) return false;
+
+    line[strcspn(line, "\r\n")] = '\0';
+    return (line[0] != '\0');
+}
+
+// Commit key of a git revision, the argument itself if git does not know it
+static void ResolveCommit(const char *revision, char *key)
+{
+    char command[256];
+    snprintf(command, sizeof(command), "git rev-parse --short=12 --verify --quiet '%s^{commit}' 2>/dev/null", revision);
+
+    if (!CommandLine(command, key, KEY_LENGTH)) snprintf(key, KEY_LENGTH, "%s", revision);
+}
+
+static void CurrentCommit(char *key)
+{
+    char status[8];
+
+    if (!CommandLine("git rev-parse --short=12 HEAD 2>/dev/null", key, KEY_LENGTH)) snprintf(key, KEY_LENGTH, "unknown");
+    else if (CommandLine("git status --porcelain --untracked-files=no 2>/dev/null", status, sizeof(status)))
+    {
+        strncat(key, "-dirty", KEY_LENGTH - strlen(key) - 1);
+    }
+}
+
+static void MachineDescription(char *description, int size)
+{
+    char model[256] = "unknown cpu";
+
+    FILE *file = fopen("/proc/cpuinfo", "r");
+    if (file != NULL)
+    {
+        char line[512];
+        while (fgets(line, sizeof(line), file) != NULL)
+        {
+            char *colon = strchr(line, ':');
+            if ((colon == NULL) || (strncmp(line, "model name", 10) != 0)) continue;
+
+            snprintf(model, sizeof(model), "%s", colon + 2);
+            model[strcspn(model, "\r\n")] = '\0';
+            break;
+        }
+        fclose(file);
+    }
+
+    struct utsname system;
+    if (uname(&system) != 0) memset(&system, 0, sizeof(system));
+
+    snprintf(description, size, "%s | %ld cpus | %s %s %s", model, sysconf(_SC_NPROCESSORS_ONLN),
+             system.sysname, system.release, system.machine);
+}
+
+// FNV-1a of the description, short enough to read in the history file
+static void MachineFingerprint(char *key)
+{
+    char description[512];
+    MachineDescription(description, sizeof(description));
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char *c = description; *c; c++) hash = (hash ^ (uint8_t)*c)*0x100000001b3ull;
+
+    snprintf(key, KEY_LENGTH, "%016llx", (unsigned long long)hash);
+}
+
+//----------------------------------------------------------------------------------
+// History file: one sample per line, "commit machine name lower|higher value time"
+//----------------------------------------------------------------------------------
+static void AddSample(const Sample *sample)
+{
+    if (sampleCount == sampleCapacity)
+    {
+        sampleCapacity = (sampleCapacity > 0) ? sampleCapacity*2 : 256;
+        samples = (Sample *)realloc(samples, sampleCapacity*sizeof(Sample));
+        if (samples == NULL)
+        {
+            fprintf(stderr, "benchgate: out of memory\n");
+            exit(2);
+        }
+    }
+
+    samples[sampleCount++] = *sample;
+}
+
+static void LoadHistory(void)
+{
+    FILE *file = fopen(historyFile, "r");
+    if (file == NULL) return;
+
+    char line[512];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] == '#') continue;
+
+        Sample sample = { 0 };
+        char direction[16];
+        if (sscanf(line, "%63s %63s %95s %15s %lf", sample.commit, sample.machine, sample.name, direction, &sample.value) != 5) continue;
+
+        sample.higherIsBetter = (strcmp(direction, "higher") == 0);
+        AddSample(&sample);
+    }
+
+    fclose(file);
+}
+
+// Runs the benchmark once, appends its BENCH lines, returns how many there were (-1 on failure)
+static int RunTrial(char *command[], const char *commit, const char *machine, FILE *history)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+
+    pid_t child = fork();
+    if (child < 0) return -1;
+
+    if (child == 0)
+    {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execvp(command[0], command);
+        fprintf(stderr, "benchgate: could not run %s\n", command[0]);
+        _exit(127);
+    }
+
+    close(fds[1]);
+    FILE *output = fdopen(fds[0], "r");
+
+    int results = 0;
+    char line[512];
+    while ((output != NULL) && (fgets(line, sizeof(line), output) != NULL))
+    {
+        char name[NAME_LENGTH], direction[16];
+        double value = 0;
+
+        if (strncmp(line, "BENCH ", 6) != 0) continue;
+        if ((sscanf(line + 6, "%95s %lf %15s", name, &value, direction) != 3) ||
+            ((strcmp(direction, "lower") != 0) && (strcmp(direction, "higher") != 0)))
+        {
+            fprintf(stderr, "benchgate: ignoring malformed line: %s", line);
+            continue;
+        }
+
+        fprintf(history, "%s %s %s %s %.9g %ld\n", commit, machine, name, direction, value, (long)time(NULL));
+        results++;
+    }
+
+    if (output != NULL) fclose(output);
+    else close(fds[0]);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) return -1;
+
+    return results;
+}
+
+static int Record(char *command[])
+{
+    char commit[KEY_LENGTH], machine[KEY_LENGTH];
+    CurrentCommit(commit);
+    MachineFingerprint(machine);
+
+    FILE *history = fopen(historyFile, "a");
+    if (history == NULL)
+    {
+        fprintf(stderr, "benchgate: could not open %s\n", historyFile);
+        return 2;
+    }
+
+    printf("recording %d trials of %s for %s on %s\n", trials, command[0], commit, machine);
+
+    for (int i = 0; i < trials; i++)
+    {
+        int results = RunTrial(command, commit, machine, history);
+        fflush(history);
+
+        if (results < 0)
+        {
+            fprintf(stderr, "benchgate: trial %d failed\n", i + 1);
+            fclose(history);
+            return 2;
+        }
+        if (results == 0)
+        {
+            fprintf(stderr, "benchgate: %s printed no BENCH lines\n", command[0]);
+            fclose(history);
+            return 2;
+        }
+
+        printf("  trial %d/%d: %d results\n", i + 1, trials, results);
+    }
+
+    fclose(history);
+    return 0;
+}
+
+//----------------------------------------------------------------------------------
+// Statistics
+//----------------------------------------------------------------------------------
+static int CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static int CompareRanked(const void *a, const void *b)
+{
+    return CompareDoubles(&((const RankedValue *)a)->value, &((const RankedValue *)b)->value);
+}
+
+static double Median(double *values, int count)
+{
+    qsort(values, count, sizeof(double), CompareDoubles);
+    return (count%2 == 1) ? values[count/2] : 0.5*(values[count/2 - 1] + values[count/2]);
+}
+
+// One-sided p-value for "head values tend to be larger than base values"
+static double MannWhitneyP(const double *base, int baseCount, const double *head, int headCount)
+{
+    int n = baseCount + headCount;
+    RankedValue *all = (RankedValue *)malloc(n*sizeof(RankedValue));
+    if (all == NULL) return 1.0;
+
+    for (int i = 0; i < baseCount; i++) all[i] = (RankedValue){ base[i], 0 };
+    for (int i = 0; i < headCount; i++) all[baseCount + i] = (RankedValue){ head[i], 1 };
+    qsort(all, n, sizeof(RankedValue), CompareRanked);
+
+    // Ties share the average of their ranks
+    double headRanks = 0, ties = 0;
+    for (int i = 0; i < n; )
+    {
+        int j = i;
+        while ((j + 1 < n) && (all[j + 1].value == all[i].value)) j++;
+
+        double rank = 0.5*(i + j) + 1.0;
+        for (int k = i; k <= j; k++) if (all[k].group == 1) headRanks += rank;
+
+        double t = j - i + 1;
+        ties += t*t*t - t;
+        i = j + 1;
+    }
+    free(all);
+
+    double u = headRanks - headCount*(headCount + 1)/2.0;
+    double mean = baseCount*headCount/2.0;
+    double variance = baseCount*headCount/12.0*((n + 1) - ties/((double)n*(n - 1)));
+    if (variance <= 0) return 1.0;
+
+    double z = (u - mean - 0.5)/sqrt(variance);        // Continuity correction
+    return 0.5*erfc(z/sqrt(2.0));
+}
+
+// Median of all pairwise differences head - base
+static double HodgesLehmannShift(const double *base, int baseCount, const double *head, int headCount)
+{
+    double *differences = (double *)malloc((size_t)baseCount*headCount*sizeof(double));
+    if (differences == NULL) return 0;
+
+    for (int i = 0; i < headCount; i++)
+    {
+        for (int j = 0; j < baseCount; j++) differences[i*baseCount + j] = head[i] - base[j];
+    }
+
+    double shift = Median(differences, baseCount*headCount);
+    free(differences);
+
+    return shift;
+}
+
+//----------------------------------------------------------------------------------
+// Compare
+//----------------------------------------------------------------------------------
+
+// Values of one benchmark for a commit on a machine, as "larger is worse"
+static int CollectValues(const char *commit, const char *machine, const char *name, double *values, double *raw)
+{
+    int count = 0;
+
+    for (int i = 0; i < sampleCount; i++)
+    {
+        const Sample *sample = &samples[i];
+        if ((strcmp(sample->commit, commit) != 0) || (strcmp(sample->machine, machine) != 0) || (strcmp(sample->name, name) != 0)) continue;
+
+        raw[count] = sample->value;
+        values[count] = sample->higherIsBetter ? -sample->value : sample->value;
+        count++;
+    }
+
+    return count;
+}
+
+static int Compare(const char *baseRevision, const char *headRevision)
+{
+    char base[KEY_LENGTH], head[KEY_LENGTH], machine[KEY_LENGTH];
+    ResolveCommit(baseRevision, base);
+    if (headRevision != NULL) ResolveCommit(headRevision, head);
+    else CurrentCommit(head);
+    MachineFingerprint(machine);
+
+    sampleCount = 0;
+    LoadHistory();
+
+    double *baseValues = (double *)malloc((sampleCount + 1)*sizeof(double));
+    double *headValues = (double *)malloc((sampleCount + 1)*sizeof(double));
+    double *baseRaw = (double *)malloc((sampleCount + 1)*sizeof(double));
+    double *headRaw = (double *)malloc((sampleCount + 1)*sizeof(double));
+    if ((baseValues == NULL) || (headValues == NULL) || (baseRaw == NULL) || (headRaw == NULL))
+    {
+        fprintf(stderr, "benchgate: out of memory\n");
+        return 2;
+    }
+
+    printf("%s -> %s on %s, threshold %.1f%%, alpha %.3g\n", base, head, machine, threshold, alpha);
+    printf("%-40s %6s %12s %12s %8s %9s  %s\n", "benchmark", "n", "base", "head", "change", "p", "verdict");
+
+    int compared = 0, regressions = 0;
+
+    for (int i = 0; i < sampleCount; i++)
+    {
+        const Sample *sample = &samples[i];
+        if ((strcmp(sample->commit, head) != 0) || (strcmp(sample->machine, machine) != 0)) continue;
+
+        // First sample of each benchmark only
+        bool seen = false;
+        for (int j = 0; (j < i) && !seen; j++)
+        {
+            seen = (strcmp(samples[j].commit, head) == 0) && (strcmp(samples[j].machine, machine) == 0) && (strcmp(samples[j].name, sample->name) == 0);
+        }
+        if (seen) continue;
+
+        int headCount = CollectValues(head, machine, sample->name, headValues, headRaw);
+        int baseCount = CollectValues(base, machine, sample->name, baseValues, baseRaw);
+        if (baseCount == 0) continue;
+
+        double baseMedian = Median(baseRaw, baseCount);
+        double headMedian = Median(headRaw, headCount);
+
+        char counts[32];
+        snprintf(counts, sizeof(counts), "%d/%d", baseCount, headCount);
+
+        if ((baseCount < MIN_SAMPLES) || (headCount < MIN_SAMPLES))
+        {
+            printf("%-40s %6s %12.6g %12.6g %8s %9s  too few samples\n", sample->name, counts, baseMedian, headMedian, "", "");
+            continue;
+        }
+
+        double p = MannWhitneyP(baseValues, baseCount, headValues, headCount);
+        double worse = (baseMedian != 0) ? 100.0*HodgesLehmannShift(baseValues, baseCount, headValues, headCount)/fabs(baseMedian) : 0;
+        bool regressed = (worse > threshold) && (p < alpha);
+
+        const char *verdict = "ok";
+        if (regressed) verdict = "REGRESSION";
+        else if (worse > threshold) verdict = "slower, not significant";
+        else if (worse < -threshold) verdict = "faster";
+
+        // Change is shown as the value moves, sign of "worse" depends on the direction
+        printf("%-40s %6s %12.6g %12.6g %+7.2f%% %9.2g  %s\n", sample->name, counts, baseMedian, headMedian,
+               sample->higherIsBetter ? -worse : worse, p, verdict);
+
+        compared++;
+        if (regressed) regressions++;
+    }
+
+    free(baseValues);
+    free(headValues);
+    free(baseRaw);
+    free(headRaw);
+
+    if (compared == 0)
+    {
+        fprintf(stderr, "benchgate: no benchmark has samples for both %s and %s on this machine\n", base, head);
+        return 2;
+    }
+
+    printf("%d benchmarks, %d regressions\n", compared, regressions);
+    return (regressions > 0) ? 1 : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Program main entry point
+//----------------------------------------------------------------------------------
+static int Usage(const char *program)
+{
+    fprintf(stderr, "usage: %s record [--trials N] [--history FILE] -- COMMAND [ARGS...]\n"
+                    "       %s compare BASE [HEAD] [--history FILE] [--threshold PCT] [--alpha P]\n"
+                    "       %s check BASE [--trials N] [--history FILE] [--threshold PCT] [--alpha P] -- COMMAND [ARGS...]\n"
+                    "       %s machine\n", program, program, program, program);
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) return Usage(argv[0]);
+
+    const char *mode = argv[1];
+    const char *revisions[2] = { NULL, NULL };
+    int revisionCount = 0;
+    char **command = NULL;
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--") == 0)
+        {
+            if (i + 1 < argc) command = &argv[i + 1];
+            break;
+        }
+        else if ((strcmp(argv[i], "--trials") == 0) && (i + 1 < argc)) trials = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--history") == 0) && (i + 1 < argc)) historyFile = argv[++i];
+        else if ((strcmp(argv[i], "--threshold") == 0) && (i + 1 < argc)) threshold = atof(argv[++i]);
+        else if ((strcmp(argv[i], "--alpha") == 0) && (i + 1 < argc)) alpha = atof(argv[++i]);
+        else if ((argv[i][0] != '-') && (revisionCount < 2)) revisions[revisionCount++] = argv[i];
+        else return Usage(argv[0]);
+    }
+
+    if (trials <= 0) return Usage(argv[0]);
+
+    if (strcmp(mode, "machine") == 0)
+    {
+        char description[512], key[KEY_LENGTH];
+        MachineDescription(description, sizeof(description));
+        MachineFingerprint(key);
+        printf("%s  %s\n", key, description);
+        return 0;
+    }
+    else if ((strcmp(mode, "record") == 0) && (command != NULL)) return Record(command);
+    else if ((strcmp(mode, "compare") == 0) && (revisionCount >= 1)) return Compare(revisions[0], revisions[1]);
+    else if ((strcmp(mode, "check") == 0) && (revisionCount == 1) && (command != NULL))
+    {
+        int result = Record(command);
+        return (result != 0) ? result : Compare(revisions[0], NULL);
+    }
+
+    return Usage(argv[0]);
+}
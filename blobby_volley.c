@@ -15,7 +15,28 @@
 ********************************************************************************************/
 
 #include "raylib.h"
+#include "atlas.h"
+#include "renderstats.h"
+#include "botlink.h"
+#include "agentplugin.h"
+#include "agentworker.h"
+#include "sfxmixer.h"
+#include "softrender.h"
+#include "sim.h"
+#include "replay.h"
+#include "replaystream.h"
+#include "dataset.h"
+#include "cabinet.h"
+#include "shadercache.h"
+#include "asynclog.h"
+#include "framelimiter.h"
+#include "fileio.h"
+#include "bloom.h"
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -28,40 +49,17 @@
 #define APP_NAME "C-Volley"
 #define COPYRIGHT "C-Volley v1.0, dmth (c) 2025"
 
-#define SCREEN_WIDTH 1024
-#define SCREEN_HEIGHT 768
-
-// Physics constants
-#define PLAYER_GRAVITY 0.8f
-#define BALL_GRAVITY 0.4f
-#define BALL_AIR_RESISTANCE 0.99f  // Horizontal velocity damping per frame
-#define BALL_BOUNCE_DAMPING 1.0f   // Energy loss on wall/ceiling bounce
-#define GROUND_LEVEL (SCREEN_HEIGHT - 50)
-#define PLAYER_RADIUS 50.0f
-#define BALL_RADIUS 35.0f
-
-// Movement constants
-#define PLAYER_MOVE_SPEED 4.0f
-#define PLAYER_JUMP_FORCE -12.0f
-#define PLAYER_MAX_VELOCITY_Y 15.0f
-#define BALL_INITIAL_SPEED_X 4.0f
-#define BALL_INITIAL_SPEED_Y -6.0f
-#define BALL_MAX_SPEED 15.0f
-
-// Court layout
-#define NET_X (SCREEN_WIDTH / 2)
-#define NET_HEIGHT 140.0f
-#define NET_WIDTH 10.0f
-
-// Game rules
-#define WIN_SCORE 10
+// Court, physics, rules and AI constants live in sim.h
+
 #define TRAIL_LENGTH 3
 
-// AI constants
-#define AI_REACTION_DISTANCE 150.0f
-#define AI_JUMP_THRESHOLD 60.0f
-#define AI_POSITION_TOLERANCE 20.0f
-#define AI_JUMP_COOLDOWN 30
+// Bots
+#define BOT_DEFAULT_TIMEOUT_US 2000
+
+// Low latency sound effects (see sfxmixer.h)
+#define SFX_DEFAULT_BUFFER_FRAMES 512
+#define CALIBRATION_INTERVAL 30     // Frames between flashes
+#define CALIBRATION_FLASHES 12
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
@@ -70,9 +68,18 @@ typedef enum GameState {
     MENU = 0,
     PLAYING,
     GAMEOVER,
-    CREDITS
+    CREDITS,
+    REPLAY
 } GameState;
 
+// Per-state callbacks, enter/exit run once per transition, update/draw every frame
+typedef struct GameStateHandlers {
+    void (*enter)(void);
+    void (*exit)(void);
+    void (*update)(void);
+    void (*draw)(void);
+} GameStateHandlers;
+
 typedef enum GameMode {
     SINGLE_PLAYER = 0,
     TWO_PLAYER
@@ -120,10 +127,14 @@ static const int screenWidth = SCREEN_WIDTH;
 static const int screenHeight = SCREEN_HEIGHT;
 
 static GameState gameState = MENU;
+static GameState nextGameState = MENU;      // Requested during update, switched after it
 static GameMode gameMode = SINGLE_PLAYER;
 static bool pause = false;
 static int framesCounter = 0;
 
+// Match simulation, player1/player2/ball below mirror it for drawing
+static SimState sim = { 0 };
+
 static Player player1 = { 0 };
 static Player player2 = { 0 };
 static Ball ball = { 0 };
@@ -131,16 +142,6 @@ static Ball ball = { 0 };
 // Particle system
 static Particle particles[MAX_PARTICLES] = { 0 };
 
-// AI state
-static int aiJumpCooldown = 0;
-
-// Serving state
-static PlayerSide servingSide = LEFT;
-
-// Score delay (2 seconds at 60fps = 120 frames)
-static int scoreDelayTimer = 0;
-#define SCORE_DELAY_FRAMES 120
-
 // Menu selection
 static int menuSelection = 0;
 
@@ -149,9 +150,7 @@ static float creditsScroll = 0;
 
 // Exit flag
 static bool shouldExitGame = false;
-
-// Match timer (in frames, 60fps)
-static int matchTimer = 0;
+static bool atlasLoaded = false;       // Every gameplay/menu draw samples the atlas, no game without it
 
 // Audio (commented - structure ready for future sound files)
 static Sound fxJump;
@@ -159,13 +158,83 @@ static Sound fxBallBounce;
 static Sound fxScore;
 static Sound fxGameOver;
 
+// Same effects on the low latency mixer, -1 when it is not running
+static int sfxBallBounce = -1;
+static int sfxScore = -1;
+static int sfxGameOver = -1;
+static int sfxBufferFrames = 0;             // 0 keeps raylib audio for effects
+static const char *sfxDevice = "default";
+
+// Audio/visual offset calibration
+static bool audioCalibration = false;
+static const char *calibrationDevice = NULL;
+static int calibrationFrame = 0;
+static SfxCalibrationResult calibrationResult = { 0 };
+
 // Music
 static Music menuMusic;
 static Music creditsMusic;
-
-// Textures
+static Music *activeMusic = NULL;           // Stream of the current state, the only one updated
+
+// External bots driving a side over shared memory (see botlink.h)
+static BotLink botLinks[2] = { 0 };
+static bool botEnabled[2] = { false, false };
+static unsigned char botActions[2] = { 0 };
+static int botTimeoutUs = BOT_DEFAULT_TIMEOUT_US;
+
+// Agent plug-ins
+static const char *agentPaths[2] = { NULL, NULL };
+static AgentPlugin agentPlugins[2] = { 0 };
+static void *agents[2] = { NULL, NULL };
+static bool agentWorker = true;             // Decide on a worker thread one tick behind (--agent-inline), see agentworker.h
+static unsigned char agentActions[2] = { 0 };
+
+// Textures (everything except the background lives in the atlas, see atlas.c)
 static Texture2D backgroundTexture;
-static Texture2D ballTexture;
+
+// CPU rendering (--software): frames are rasterized by softrender.c and uploaded as a texture
+static bool softRendering = false;
+static int softThreads = 0;                 // 0: one per core
+static Texture2D softFrameTexture = { 0 };
+static Image backgroundImage = { 0 };
+static SoftTexture backgroundSoftTexture = { 0 };
+
+// Match recording (--record-replays, --record-dataset), see replay.h and dataset.h
+static const char *replayDirectory = NULL;
+static const char *datasetDirectory = NULL;
+static Replay replay = { 0 };
+static DatasetWriter dataset = { 0 };
+static bool recordingMatch = false;
+static int recordedMatches = 0;
+static long recordingSession = 0;           // Start time, keeps file names of different runs apart
+
+// Replay viewer (--replay FILE, ?replay=URL on the web), played while it streams in, see replaystream.h
+static const char *replayLocation = NULL;
+static ReplayStream replayStream = { 0 };
+static int replayTick = 0;                  // Action pairs applied to sim
+static bool replayStarted = false;          // Header in, sim holds the replay
+static int replayDesyncs = 0;               // Keyframes this build did not reach on its own
+
+// Cabinet mode (dedicated machines)
+static bool cabinetMode = false;
+static int cabinetCpu = -1;                 // -1: first isolated CPU, else the last one
+static const char *jitterFile = NULL;
+
+// Shader program binaries (--shader-cache, --no-shader-cache), see shadercache.h
+static const char *shaderCacheDirectory = NULL;     // NULL: $XDG_CACHE_HOME/c-volley/shaders
+static bool shaderCacheEnabled = true;
+
+// Glow around the ball and particles (--bloom TIER), see bloom.h
+static int bloomTier = BLOOM_AUTO;
+
+// TraceLog() output from a writer thread (--sync-log to write on the calling thread), see asynclog.h
+static bool asyncLog = true;
+
+// Replay and dataset files written by an I/O thread (--sync-io to write them here), see fileio.h
+static bool fileIo = true;
+
+// Frame pacing: sleep and spin to each deadline (--raylib-frame-wait for SetTargetFPS()), see framelimiter.h
+static bool frameLimiter = true;
 
 //------------------------------------------------------------------------------------
 // Module Functions Declaration (local)
@@ -175,11 +244,44 @@ static void UpdateGame(void);
 static void DrawGame(void);
 static void UnloadGame(void);
 static void UpdateDrawFrame(void);
+static void ParseCommandLine(int argc, char *argv[]);
+static void UpdateDrawCalibration(void);
+static void PresentSoftFrame(void);
+static void DrawGlowSources(void);
+
+// Game states
+static void EnterGameState(GameState state);
+static void ChangeGameState(GameState state);
+static void EnterMenu(void);
+static void ExitMenu(void);
+static void UpdateMenu(void);
+static void EnterPlaying(void);
+static void ExitPlaying(void);
+static void UpdatePlaying(void);
+static void DrawPlaying(void);
+static void EnterGameOver(void);
+static void ExitGameOver(void);
+static void UpdateGameOver(void);
+static void DrawGameOver(void);
+static void EnterCredits(void);
+static void ExitCredits(void);
+static void UpdateCredits(void);
+static void EnterReplay(void);
+static void ExitReplay(void);
+static void UpdateReplay(void);
+static void DrawReplay(void);
 
 // Helper functions
-static void ResetBall(void);
-static void UpdatePlayerControls(void);
-static void UpdateAI(void);
+static void SyncFromSim(void);
+static unsigned char GetKeyboardAction(int leftKey, int rightKey, int jumpKey);
+static unsigned char GetAgentAction(int side);
+static void GetPlayerActions(unsigned char actions[2]);
+static void UpdateBots(void);
+static void BeginMatchRecording(void);
+static void EndMatchRecording(void);
+static bool SaveShardAsync(const char *fileName, uint8_t *shard, int size);
+static void PlayGameSound(Sound sound, int sfx);
+static void PlaySimEvents(unsigned int events);
 static void UpdateBallTrail(void);
 static void DrawBallTrail(void);
 static void DrawSpinningBall(void);
@@ -195,72 +297,154 @@ static void SpawnGroundParticles(Vector2 position, int count);
 static void UpdateParticles(void);
 static void DrawParticles(void);
 
+//------------------------------------------------------------------------------------
+// Game state table
+//------------------------------------------------------------------------------------
+static const GameStateHandlers stateHandlers[] = {
+    [MENU] = { EnterMenu, ExitMenu, UpdateMenu, DrawMenu },
+    [PLAYING] = { EnterPlaying, ExitPlaying, UpdatePlaying, DrawPlaying },
+    [GAMEOVER] = { EnterGameOver, ExitGameOver, UpdateGameOver, DrawGameOver },
+    [CREDITS] = { EnterCredits, ExitCredits, UpdateCredits, DrawCredits },
+    [REPLAY] = { EnterReplay, ExitReplay, UpdateReplay, DrawReplay },
+};
+
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char *argv[])
 {
+    ParseCommandLine(argc, argv);
+
+#if defined(PLATFORM_WEB)
+    // The page passes a replay to show as ?replay=URL
+    static char replayUrl[512] = { 0 };
+    snprintf(replayUrl, sizeof(replayUrl), "%s", emscripten_run_script_string("new URLSearchParams(location.search).get('replay') || ''"));
+    if (replayUrl[0] != '\0') replayLocation = replayUrl;
+#endif
+
+    // Before any thread is started, they all inherit the non-game cores
+    if (cabinetMode) cabinetMode = InitCabinetMode(cabinetCpu);
+    if (asyncLog) InitAsyncLog(ASYNC_LOG_DEFAULT_RECORDS);
+    if (fileIo) fileIo = InitFileIo();
+
     InitWindow(screenWidth, screenHeight, APP_NAME);
     SetExitKey(KEY_NULL);  // Disable default Escape key to close window
 
     InitGame();
 
+    if (cabinetMode) EnterCabinetGameThread();
+
 #if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
+    if (!shouldExitGame) emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
 #else
-    SetTargetFPS(60);
+    if (frameLimiter) frameLimiter = InitFrameLimiter(60);
+    if (!frameLimiter) SetTargetFPS(60);
 
     while (!WindowShouldClose() && !shouldExitGame)
     {
         UpdateDrawFrame();
+        if (frameLimiter) WaitFrameLimiter();
+        if (cabinetMode || (jitterFile != NULL)) RecordFrameJitter(60);
     }
 #endif
 
+    CloseFrameLimiter();
+    CloseCabinetMode();
+    if (cabinetMode || (jitterFile != NULL)) CloseFrameJitter(jitterFile);
+
     UnloadGame();
+    CloseFileIo();
     CloseWindow();
+    CloseAsyncLog();
 
-    return 0;
+    return atlasLoaded ? 0 : 1;
 }
 
 //------------------------------------------------------------------------------------
 // Module Functions Definitions (local)
 //------------------------------------------------------------------------------------
 
+// Parse command line options
+void ParseCommandLine(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bot-left") == 0) botEnabled[LEFT] = true;
+        else if (strcmp(argv[i], "--bot-right") == 0) botEnabled[RIGHT] = true;
+        else if ((strcmp(argv[i], "--bot-timeout-us") == 0) && (i + 1 < argc)) botTimeoutUs = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--agent-left") == 0) && (i + 1 < argc)) agentPaths[LEFT] = argv[++i];
+        else if ((strcmp(argv[i], "--agent-right") == 0) && (i + 1 < argc)) agentPaths[RIGHT] = argv[++i];
+        else if (strcmp(argv[i], "--agent-inline") == 0) agentWorker = false;
+        else if ((strcmp(argv[i], "--audio-buffer") == 0) && (i + 1 < argc)) sfxBufferFrames = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--audio-device") == 0) && (i + 1 < argc)) sfxDevice = argv[++i];
+        else if ((strcmp(argv[i], "--audio-calibrate") == 0) && (i + 1 < argc)) calibrationDevice = argv[++i];
+        else if (strcmp(argv[i], "--software") == 0) softRendering = true;
+        else if ((strcmp(argv[i], "--software-threads") == 0) && (i + 1 < argc)) softThreads = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--record-replays") == 0) && (i + 1 < argc)) replayDirectory = argv[++i];
+        else if ((strcmp(argv[i], "--record-dataset") == 0) && (i + 1 < argc)) datasetDirectory = argv[++i];
+        else if ((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc)) replayLocation = argv[++i];
+        else if (strcmp(argv[i], "--cabinet") == 0) cabinetMode = true;
+        else if ((strcmp(argv[i], "--cabinet-cpu") == 0) && (i + 1 < argc)) { cabinetMode = true; cabinetCpu = atoi(argv[++i]); }
+        else if ((strcmp(argv[i], "--jitter-histogram") == 0) && (i + 1 < argc)) jitterFile = argv[++i];
+        else if ((strcmp(argv[i], "--shader-cache") == 0) && (i + 1 < argc)) shaderCacheDirectory = argv[++i];
+        else if (strcmp(argv[i], "--no-shader-cache") == 0) shaderCacheEnabled = false;
+        else if ((strcmp(argv[i], "--bloom") == 0) && (i + 1 < argc))
+        {
+            const char *tier = argv[++i];
+            bloomTier = BLOOM_AUTO;
+            for (int t = BLOOM_OFF; t <= BLOOM_HIGH; t++)
+            {
+                if (strcmp(tier, GetBloomTierName(t)) == 0) bloomTier = t;
+            }
+            if ((bloomTier == BLOOM_AUTO) && (strcmp(tier, "auto") != 0)) TraceLog(LOG_WARNING, "Unknown bloom tier: %s", tier);
+        }
+        else if (strcmp(argv[i], "--sync-log") == 0) asyncLog = false;
+        else if (strcmp(argv[i], "--sync-io") == 0) fileIo = false;
+        else if (strcmp(argv[i], "--raylib-frame-wait") == 0) frameLimiter = false;
+        else TraceLog(LOG_WARNING, "Unknown option: %s", argv[i]);
+    }
+}
+
 // Initialize game variables
 void InitGame(void)
 {
-    // Set initial game state
+    // The menu is entered once loading is done (or calibration is over)
     gameState = MENU;
-    menuSelection = 0;
+    nextGameState = MENU;
     pause = false;
     framesCounter = 0;
-    aiJumpCooldown = 0;
-    servingSide = LEFT;
-    scoreDelayTimer = 0;
-    matchTimer = 0;
+
+    // Blobs at their spots, ball above the left side
+    SimInit(&sim, (uint32_t)time(NULL));
+
+    recordingSession = (long)time(NULL);
+    if (datasetDirectory != NULL)
+    {
+        char prefix[64];
+        snprintf(prefix, sizeof(prefix), "live-%ld", recordingSession);
+
+        if (!DatasetWriterOpen(&dataset, datasetDirectory, prefix))
+        {
+            TraceLog(LOG_WARNING, "DATASET: Could not allocate shard buffer, recording disabled");
+            datasetDirectory = NULL;
+        }
+        else if (fileIo) dataset.saveShard = SaveShardAsync;
+    }
 
     // Initialize Player 1 (left side - blue)
-    player1.position = (Vector2){ SCREEN_WIDTH / 4, GROUND_LEVEL - PLAYER_RADIUS };
-    player1.velocity = (Vector2){ 0, 0 };
     player1.radius = PLAYER_RADIUS;
     player1.side = LEFT;
     player1.color = BLUE;
-    player1.score = 0;
-    player1.onGround = true;
 
     // Initialize Player 2 (right side - red)
-    player2.position = (Vector2){ SCREEN_WIDTH * 3 / 4, GROUND_LEVEL - PLAYER_RADIUS };
-    player2.velocity = (Vector2){ 0, 0 };
     player2.radius = PLAYER_RADIUS;
     player2.side = RIGHT;
     player2.color = RED;
-    player2.score = 0;
-    player2.onGround = true;
 
     // Initialize Ball
     ball.radius = BALL_RADIUS;
     ball.trailCount = 0;
-    ResetBall();
+    SyncFromSim();
 
     // SFX initialization 
     InitAudioDevice();
@@ -269,184 +453,255 @@ void InitGame(void)
     fxScore = LoadSound("resources/score.wav");
     fxGameOver = LoadSound("resources/gameover.wav");
 
+    if ((calibrationDevice != NULL) && (sfxBufferFrames == 0)) sfxBufferFrames = SFX_DEFAULT_BUFFER_FRAMES;
+
+    if ((sfxBufferFrames > 0) && InitSfxMixer(sfxDevice, sfxBufferFrames))
+    {
+        sfxBallBounce = LoadSfx("resources/bounce.wav");
+        sfxScore = LoadSfx("resources/score.wav");
+        sfxGameOver = LoadSfx("resources/gameover.wav");
+
+        if (calibrationDevice != NULL)
+        {
+            audioCalibration = BeginSfxCalibration(calibrationDevice);
+            if (!audioCalibration) TraceLog(LOG_WARNING, "SFX: Could not open capture device %s", calibrationDevice);
+        }
+    }
+
     menuMusic = LoadMusicStream("resources/hymn_to_aurora.mod");
     SetMusicVolume(menuMusic, 0.5f);
 
     creditsMusic = LoadMusicStream("resources/space_debris.mod");
     SetMusicVolume(creditsMusic, 0.5f);
 
-    // Load textures
-    backgroundTexture = LoadTexture("resources/background.png");
-    ballTexture = LoadTexture("resources/ball.png");
-}
-
-// Reset ball on serving player's side
-void ResetBall(void)
-{
-    if (servingSide == LEFT)
+    // Bot links, a side whose link fails falls back to keyboard/AI
+    for (int side = LEFT; side <= RIGHT; side++)
     {
-        ball.position = (Vector2){ SCREEN_WIDTH / 4, 100 };
+        if (!botEnabled[side]) continue;
+
+        botEnabled[side] = BotLinkCreate(&botLinks[side], side);
+        if (botEnabled[side]) TraceLog(LOG_INFO, "BOT: Waiting for %s side bot", (side == LEFT) ? "left" : "right");
+        else TraceLog(LOG_WARNING, "BOT: Could not create shared memory for %s side", (side == LEFT) ? "left" : "right");
     }
-    else
+
+    // Agent plug-ins, a side whose plug-in does not load falls back to keyboard/AI
+    for (int side = LEFT; side <= RIGHT; side++)
     {
-        ball.position = (Vector2){ SCREEN_WIDTH * 3 / 4, 100 };
-    }
+        if (agentPaths[side] == NULL) continue;
 
-    ball.velocity.x = 0;
-    ball.velocity.y = 0;
-    ball.trailCount = 0;
-    ball.rotation = 0;
-}
+        if (AgentPluginLoad(&agentPlugins[side], agentPaths[side]))
+        {
+            agents[side] = agentPlugins[side].api->create(1, (uint64_t)time(NULL));
+            if (agents[side] == NULL) AgentPluginUnload(&agentPlugins[side]);
+        }
 
-// Update player controls
-void UpdatePlayerControls(void)
-{
-    // Player 1 (Left side) - W/A/D controls
-    if (IsKeyDown(KEY_A))
-    {
-        player1.position.x -= PLAYER_MOVE_SPEED;
-        player1.velocity.x = -PLAYER_MOVE_SPEED;
+        if (agents[side] != NULL) TraceLog(LOG_INFO, "AGENT: %s side played by %s", (side == LEFT) ? "left" : "right", agentPlugins[side].api->name);
+        else TraceLog(LOG_WARNING, "AGENT: Could not load %s", agentPaths[side]);
     }
-    else if (IsKeyDown(KEY_D))
+
+    // Bots take precedence over agents on a side, the worker only decides for the rest
+    if (agentWorker)
     {
-        player1.position.x += PLAYER_MOVE_SPEED;
-        player1.velocity.x = PLAYER_MOVE_SPEED;
+        void *workerAgents[2] = { botEnabled[LEFT] ? NULL : agents[LEFT], botEnabled[RIGHT] ? NULL : agents[RIGHT] };
+        agentWorker = InitAgentWorker(agentPlugins, workerAgents);
     }
-    else
+
+    // Shader binary cache, before anything loads a shader
+    static char shaderCachePath[512] = { 0 };
+    if (shaderCacheEnabled && (shaderCacheDirectory == NULL))
     {
-        player1.velocity.x = 0;
+        const char *cacheHome = getenv("XDG_CACHE_HOME");
+        const char *home = getenv("HOME");
+
+        if ((cacheHome != NULL) && (cacheHome[0] != '\0')) snprintf(shaderCachePath, sizeof(shaderCachePath), "%s/c-volley/shaders", cacheHome);
+        else if (home != NULL) snprintf(shaderCachePath, sizeof(shaderCachePath), "%s/.cache/c-volley/shaders", home);
+
+        if (shaderCachePath[0] != '\0') shaderCacheDirectory = shaderCachePath;
     }
+    InitShaderCache(shaderCacheEnabled ? shaderCacheDirectory : NULL);
 
-    // Jump
-    if (IsKeyPressed(KEY_W) && player1.onGround)
+    // Load textures
+    backgroundTexture = LoadTexture("resources/background.png");
+    atlasLoaded = LoadAtlas("resources/ball.png", (int)(BALL_RADIUS * 2));
+    if (!atlasLoaded)
     {
-        player1.velocity.y = PLAYER_JUMP_FORCE;
-        player1.onGround = false;
-        /* NOTE: Need better jump sound 
-           PlaySound(fxJump); */
+        TraceLog(LOG_ERROR, "ATLAS: Could not create the atlas texture, exiting");
+        shouldExitGame = true;
+        return;
     }
 
-    // Keep player on their side (left of net)
-    if (player1.position.x - player1.radius < 0)
+    if (softRendering)
     {
-        player1.position.x = player1.radius;
+        Image frameImage = GenImageColor(screenWidth, screenHeight, BLANK);
+        softFrameTexture = LoadTextureFromImage(frameImage);
+        UnloadImage(frameImage);
+
+        backgroundImage = LoadImage("resources/background.png");
+        if (backgroundImage.data != NULL) ImageFormat(&backgroundImage, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        backgroundSoftTexture = (SoftTexture){ (Color *)backgroundImage.data, backgroundImage.width, backgroundImage.height };
+
+        softRendering = (softFrameTexture.id > 0) && InitSoftRenderer(screenWidth, screenHeight, softThreads);
+        if (!softRendering) TraceLog(LOG_WARNING, "SOFTRENDER: Falling back to GPU rendering");
     }
-    if (player1.position.x + player1.radius > NET_X - NET_WIDTH / 2)
+
+    // Render targets and blur programs, warmed up while the menu shows
+    if (!softRendering) InitBloom(screenWidth, screenHeight, bloomTier);
+
+    if (!audioCalibration) EnterGameState((replayLocation != NULL) ? REPLAY : MENU);
+}
+
+// Copy simulation state into the structs the Draw* functions use
+void SyncFromSim(void)
+{
+    Player *players[2] = { &player1, &player2 };
+
+    for (int side = LEFT; side <= RIGHT; side++)
     {
-        player1.position.x = NET_X - NET_WIDTH / 2 - player1.radius;
+        players[side]->position = sim.blobs[side].position;
+        players[side]->velocity = sim.blobs[side].velocity;
+        players[side]->score = sim.blobs[side].score;
+        players[side]->onGround = sim.blobs[side].onGround;
     }
 
-    // Player 2 (Right side) - Only if TWO_PLAYER mode
-    if (gameMode == TWO_PLAYER)
-    {
-        if (IsKeyDown(KEY_LEFT))
-        {
-            player2.position.x -= PLAYER_MOVE_SPEED;
-            player2.velocity.x = -PLAYER_MOVE_SPEED;
-        }
-        else if (IsKeyDown(KEY_RIGHT))
-        {
-            player2.position.x += PLAYER_MOVE_SPEED;
-            player2.velocity.x = PLAYER_MOVE_SPEED;
-        }
-        else
-        {
-            player2.velocity.x = 0;
-        }
+    ball.position = sim.ball.position;
+    ball.velocity = sim.ball.velocity;
+    ball.rotation = sim.ball.rotation;
+}
 
-        if (IsKeyPressed(KEY_UP) && player2.onGround)
-        {
-            player2.velocity.y = PLAYER_JUMP_FORCE;
-            player2.onGround = false;
-            /* NOTE: Need better jump sound PlaySound(fxJump); */
-        }
+// Read keyboard state into an action bitfield
+unsigned char GetKeyboardAction(int leftKey, int rightKey, int jumpKey)
+{
+    unsigned char action = 0;
 
-        // Keep player on their side (right of net)
-        if (player2.position.x - player2.radius < NET_X + NET_WIDTH / 2)
-        {
-            player2.position.x = NET_X + NET_WIDTH / 2 + player2.radius;
-        }
-        if (player2.position.x + player2.radius > SCREEN_WIDTH)
-        {
-            player2.position.x = SCREEN_WIDTH - player2.radius;
-        }
-    }
+    if (IsKeyDown(leftKey)) action |= ACTION_LEFT;
+    else if (IsKeyDown(rightKey)) action |= ACTION_RIGHT;
+
+    if (IsKeyPressed(jumpKey)) action |= ACTION_JUMP;
+
+    return action;
+}
+
+// Action of an agent plug-in side, a batch of one, or what the worker decided last tick
+unsigned char GetAgentAction(int side)
+{
+    if (agentWorker) return agentActions[side] & (ACTION_LEFT | ACTION_RIGHT | ACTION_JUMP);
+
+    AgentObs obs;
+    AgentAction action = 0;
+
+    AgentObserve(&sim, side, (uint32_t)recordedMatches, &obs);
+    AgentDecide(&agentPlugins[side], agents[side], &obs, &action, 1);
+
+    return action & (ACTION_LEFT | ACTION_RIGHT | ACTION_JUMP);
+}
+
+// Actions of both sides for this tick: bot, agent, keyboard, or the built-in AI on the right in single player
+void GetPlayerActions(unsigned char actions[2])
+{
+    // Player 1 (Left side) - W/A/D controls, bot or agent
+    if (botEnabled[LEFT]) actions[LEFT] = botActions[LEFT] & (ACTION_LEFT | ACTION_RIGHT | ACTION_JUMP);
+    else if (agents[LEFT] != NULL) actions[LEFT] = GetAgentAction(LEFT);
+    else actions[LEFT] = GetKeyboardAction(KEY_A, KEY_D, KEY_W);
+
+    // Player 2 (Right side) - bot, agent, arrow keys in TWO_PLAYER mode, AI otherwise
+    if (botEnabled[RIGHT]) actions[RIGHT] = botActions[RIGHT] & (ACTION_LEFT | ACTION_RIGHT | ACTION_JUMP);
+    else if (agents[RIGHT] != NULL) actions[RIGHT] = GetAgentAction(RIGHT);
+    else if (gameMode == TWO_PLAYER) actions[RIGHT] = GetKeyboardAction(KEY_LEFT, KEY_RIGHT, KEY_UP);
+    else actions[RIGHT] = ACTION_AI;
+}
+
+// Start recording the match that was just reset, if replays or dataset are enabled
+void BeginMatchRecording(void)
+{
+    if ((replayDirectory == NULL) && (datasetDirectory == NULL)) return;
+
+    unsigned char source[2];
+    if (botEnabled[LEFT]) source[LEFT] = REPLAY_SOURCE_BOT;
+    else source[LEFT] = (agents[LEFT] != NULL) ? REPLAY_SOURCE_AGENT : REPLAY_SOURCE_KEYBOARD;
+    if (botEnabled[RIGHT]) source[RIGHT] = REPLAY_SOURCE_BOT;
+    else if (agents[RIGHT] != NULL) source[RIGHT] = REPLAY_SOURCE_AGENT;
+    else source[RIGHT] = (gameMode == TWO_PLAYER) ? REPLAY_SOURCE_KEYBOARD : REPLAY_SOURCE_AI;
+
+    if (replayDirectory != NULL) ReplayBegin(&replay, &sim, source);
+    if (datasetDirectory != NULL) DatasetBeginMatch(&dataset, (uint32_t)recordedMatches, source);
+
+    recordingMatch = true;
 }
 
-// Update AI (controls player2 in single-player mode)
-void UpdateAI(void)
+// Finished or abandoned match: save the replay, close its dataset records
+void EndMatchRecording(void)
 {
-    // Cooldown management
-    if (aiJumpCooldown > 0) aiJumpCooldown--;
+    if (!recordingMatch) return;
 
-    // Only react if ball is on AI's side or coming toward it
-    bool ballComingToward = (ball.velocity.x > 0 && ball.position.x < NET_X) ||
-                            (ball.position.x >= NET_X);
+    recordingMatch = false;
 
-    if (!ballComingToward)
+    if (datasetDirectory != NULL) DatasetEndMatch(&dataset, &sim);
+
+    if ((replayDirectory != NULL) && (replay.tickCount > 0))
     {
-        // Return to center of side
-        float targetX = NET_X + (SCREEN_WIDTH - NET_X) / 2;
-        if (player2.position.x < targetX - AI_POSITION_TOLERANCE)
-        {
-            player2.position.x += PLAYER_MOVE_SPEED * 0.6f;
-        }
-        else if (player2.position.x > targetX + AI_POSITION_TOLERANCE)
+        char fileName[512];
+        snprintf(fileName, sizeof(fileName), "%s/match-%ld-%03d%s", replayDirectory, recordingSession, recordedMatches, REPLAY_FILE_EXTENSION);
+
+        // The I/O thread writes it when it runs, failures are logged there
+        int size = 0;
+        uint8_t *data = fileIo ? ReplayEncode(&replay, &size) : NULL;
+
+        if ((data != NULL) && FileWriteAsync(fileName, data, size)) TraceLog(LOG_INFO, "REPLAY: Saving %d ticks to %s", replay.tickCount, fileName);
+        else
         {
-            player2.position.x -= PLAYER_MOVE_SPEED * 0.6f;
+            free(data);
+            if (ReplaySave(&replay, fileName)) TraceLog(LOG_INFO, "REPLAY: Saved %d ticks to %s", replay.tickCount, fileName);
+            else TraceLog(LOG_WARNING, "REPLAY: Could not write %s", fileName);
         }
-        player2.velocity.x = 0;
-        return;
     }
 
-    // Calculate horizontal distance to ball
-    float distanceX = ball.position.x - player2.position.x;
+    recordedMatches++;
+}
 
-    // Move toward ball's X position
-    if (distanceX < -AI_POSITION_TOLERANCE)
-    {
-        player2.position.x -= PLAYER_MOVE_SPEED * 0.8f;
-        player2.velocity.x = -PLAYER_MOVE_SPEED * 0.8f;
-    }
-    else if (distanceX > AI_POSITION_TOLERANCE)
-    {
-        player2.position.x += PLAYER_MOVE_SPEED * 0.8f;
-        player2.velocity.x = PLAYER_MOVE_SPEED * 0.8f;
-    }
-    else
+// Full dataset shards go to the I/O thread, the writer goes on in a new buffer
+bool SaveShardAsync(const char *fileName, uint8_t *shard, int size)
+{
+    return FileWriteAsync(fileName, shard, size);
+}
+
+// Publish this tick to connected bots and collect their actions for the same tick
+void UpdateBots(void)
+{
+    BotState state = { 0 };
+    state.tick = (uint32_t)(sim.tick + 1);     // Tick the actions will be applied on
+    state.scoreDelay = (uint32_t)sim.scoreDelay;
+    state.ballX = sim.ball.position.x;
+    state.ballY = sim.ball.position.y;
+    state.ballVX = sim.ball.velocity.x;
+    state.ballVY = sim.ball.velocity.y;
+
+    for (int side = LEFT; side <= RIGHT; side++)
     {
-        player2.velocity.x = 0;
+        state.blobX[side] = sim.blobs[side].position.x;
+        state.blobY[side] = sim.blobs[side].position.y;
+        state.blobVX[side] = sim.blobs[side].velocity.x;
+        state.blobVY[side] = sim.blobs[side].velocity.y;
+        state.onGround[side] = sim.blobs[side].onGround;
+        state.score[side] = (uint8_t)sim.blobs[side].score;
     }
+    state.servingSide = (uint8_t)sim.servingSide;
 
-    // Keep AI on their side
-    if (player2.position.x - player2.radius < NET_X + NET_WIDTH / 2)
+    // Publish to both first so two bots think in parallel
+    for (int side = LEFT; side <= RIGHT; side++)
     {
-        player2.position.x = NET_X + NET_WIDTH / 2 + player2.radius;
+        if (botEnabled[side]) BotLinkPublish(&botLinks[side], &state);
     }
-    if (player2.position.x + player2.radius > SCREEN_WIDTH)
+    for (int side = LEFT; side <= RIGHT; side++)
     {
-        player2.position.x = SCREEN_WIDTH - player2.radius;
+        if (botEnabled[side]) botActions[side] = BotLinkWaitAction(&botLinks[side], state.tick, botTimeoutUs);
     }
+}
 
-    // Jump decision logic
-    float distanceY = player2.position.y - ball.position.y;
-    float horizontalDist = fabsf(distanceX);
-
-    // Jump conditions
-    bool shouldJump = (horizontalDist < AI_REACTION_DISTANCE) &&
-                      (distanceY > -AI_JUMP_THRESHOLD) &&
-                      (distanceY < 100.0f) &&
-                      (aiJumpCooldown == 0) &&
-                      (player2.onGround);
-
-    // Add randomness to make AI beatable (20% chance to miss)
-    if (shouldJump && GetRandomValue(0, 100) > 20)
-    {
-        player2.velocity.y = PLAYER_JUMP_FORCE * 0.9f;
-        player2.onGround = false;
-        aiJumpCooldown = AI_JUMP_COOLDOWN;
-        /* NOTE: Need better jump sound,  PlaySound(fxJump); */
-    }
+// Play an effect on the low latency mixer when it runs, through raylib otherwise
+void PlayGameSound(Sound sound, int sfx)
+{
+    if (sfx >= 0) PlaySfx(sfx);
+    else PlaySound(sound);
 }
 
 // Update ball trail effect
@@ -470,573 +725,521 @@ void UpdateGame(void)
 {
     framesCounter++;
 
-    // Update music streams
-    UpdateMusicStream(menuMusic);
-    UpdateMusicStream(creditsMusic);
+    RENDER_STATS_UPDATE();
+
+    if (activeMusic != NULL) UpdateMusicStream(*activeMusic);
+
+    stateHandlers[gameState].update();
+
+    // Transitions requested by the update run here, so a frame never draws a half entered state
+    if (nextGameState != gameState) ChangeGameState(nextGameState);
+}
+
+// First state after loading, nothing to exit
+void EnterGameState(GameState state)
+{
+    gameState = state;
+    nextGameState = state;
+    stateHandlers[state].enter();
+}
+
+void ChangeGameState(GameState state)
+{
+    stateHandlers[gameState].exit();
+    EnterGameState(state);
+}
+
+void EnterMenu(void)
+{
+    menuSelection = 0;
+
+    activeMusic = &menuMusic;
+    PlayMusicStream(menuMusic);
+}
 
-    // Control music based on game state
-    if (gameState == MENU)
+void ExitMenu(void)
+{
+    StopMusicStream(menuMusic);
+    activeMusic = NULL;
+}
+
+void UpdateMenu(void)
+{
+    // Menu navigation
+    if (IsKeyPressed(KEY_UP))
     {
-        if (!IsMusicStreamPlaying(menuMusic))
-        {
-            PlayMusicStream(menuMusic);
-        }
-        if (IsMusicStreamPlaying(creditsMusic))
-        {
-            StopMusicStream(creditsMusic);
-        }
+        menuSelection--;
+        if (menuSelection < 0) menuSelection = 3;
     }
-    else if (gameState == CREDITS)
+    if (IsKeyPressed(KEY_DOWN))
     {
-        if (!IsMusicStreamPlaying(creditsMusic))
-        {
-            PlayMusicStream(creditsMusic);
-        }
-        if (IsMusicStreamPlaying(menuMusic))
-        {
-            StopMusicStream(menuMusic);
-        }
+        menuSelection++;
+        if (menuSelection > 3) menuSelection = 0;
     }
-    else
+
+    // Start game, show credits, or exit
+    if (IsKeyPressed(KEY_ENTER))
     {
-        if (IsMusicStreamPlaying(menuMusic))
+        if (menuSelection == 0 || menuSelection == 1)
         {
-            StopMusicStream(menuMusic);
+            gameMode = (menuSelection == 0) ? SINGLE_PLAYER : TWO_PLAYER;
+            nextGameState = PLAYING;
         }
-        if (IsMusicStreamPlaying(creditsMusic))
+        else if (menuSelection == 2) nextGameState = CREDITS;
+        else if (menuSelection == 3)
         {
-            StopMusicStream(creditsMusic);
+            // Exit game
+            shouldExitGame = true;
         }
     }
+}
+
+void EnterPlaying(void)
+{
+    pause = false;
+
+    // Reset scores
+    SimResetMatch(&sim);
+    ball.trailCount = 0;
+    SyncFromSim();
+    if (agentWorker) AgentWorkerReset();
+    BeginMatchRecording();
+}
 
-    switch (gameState)
+// Saves the match whether it was finished or abandoned
+void ExitPlaying(void)
+{
+    EndMatchRecording();
+}
+
+void UpdatePlaying(void)
+{
+    if (IsKeyPressed(KEY_P))
     {
-        case MENU:
-        {
-            // Menu navigation
-            if (IsKeyPressed(KEY_UP))
-            {
-                menuSelection--;
-                if (menuSelection < 0) menuSelection = 3;
-            }
-            if (IsKeyPressed(KEY_DOWN))
-            {
-                menuSelection++;
-                if (menuSelection > 3) menuSelection = 0;
-            }
+        pause = !pause;
+    }
 
-            // Start game, show credits, or exit
-            if (IsKeyPressed(KEY_ENTER))
-            {
-                if (menuSelection == 0 || menuSelection == 1)
-                {
-                    gameMode = (menuSelection == 0) ? SINGLE_PLAYER : TWO_PLAYER;
-                    gameState = PLAYING;
-
-                    // Reset scores
-                    player1.score = 0;
-                    player2.score = 0;
-                    matchTimer = 0;
-                    ResetBall();
-                }
-                else if (menuSelection == 2)
-                {
-                    // Show credits
-                    gameState = CREDITS;
-                    creditsScroll = SCREEN_HEIGHT;
-                }
-                else if (menuSelection == 3)
-                {
-                    // Exit game
-                    shouldExitGame = true;
-                }
-            }
-        } break;
+    // Return to menu on Escape
+    if (IsKeyPressed(KEY_ESCAPE))
+    {
+        nextGameState = MENU;
+        return;
+    }
 
-        case PLAYING:
-        {
-            if (IsKeyPressed(KEY_P))
-            {
-                pause = !pause;
-            }
+    if (pause) return;
 
-            // Return to menu on Escape
-            if (IsKeyPressed(KEY_ESCAPE))
-            {
-                gameState = MENU;
-                menuSelection = 0;
-                break;
-            }
+    // Update particles
+    UpdateParticles();
 
-            if (!pause)
-            {
-                // Increment match timer
-                matchTimer++;
+    // Update bots, then collect both sides' actions
+    if (botEnabled[LEFT] || botEnabled[RIGHT]) UpdateBots();
 
-                // Update particles
-                UpdateParticles();
+    if (agentWorker) AgentWorkerExchange(&sim, (uint32_t)recordedMatches, agentActions);
 
-                // Update controls
-                UpdatePlayerControls();
+    unsigned char actions[2];
+    GetPlayerActions(actions);
 
-                // Update AI if single player
-                if (gameMode == SINGLE_PLAYER)
-                {
-                    UpdateAI();
-                }
+    if (recordingMatch && (datasetDirectory != NULL)) DatasetRecord(&dataset, &sim, actions);
 
-                // Apply physics to players
-                player1.position.x += player1.velocity.x;
-                player1.position.y += player1.velocity.y;
-                player2.position.x += player2.velocity.x;
-                player2.position.y += player2.velocity.y;
+    unsigned int events = SimStep(&sim, actions);
+    if (recordingMatch && (replayDirectory != NULL)) ReplayRecord(&replay, actions, &sim);
+    SyncFromSim();
+    PlaySimEvents(events);
 
-                player1.velocity.y += PLAYER_GRAVITY;
-                player2.velocity.y += PLAYER_GRAVITY;
+    if (events & SIM_EVENT_GAMEOVER) nextGameState = GAMEOVER;
+}
 
-                // Clamp max velocity
-                if (player1.velocity.y > PLAYER_MAX_VELOCITY_Y)
-                    player1.velocity.y = PLAYER_MAX_VELOCITY_Y;
-                if (player2.velocity.y > PLAYER_MAX_VELOCITY_Y)
-                    player2.velocity.y = PLAYER_MAX_VELOCITY_Y;
+// Trail, sounds and particles of a simulation step, in play and in replays
+void PlaySimEvents(unsigned int events)
+{
+    // Update trail every 2nd frame, restarted when the ball is put back for a serve
+    if (events & SIM_EVENT_RESET) ball.trailCount = 0;
+    if (framesCounter % 2 == 0) UpdateBallTrail();
 
-                // Player ground collision
-                if (player1.position.y + player1.radius >= GROUND_LEVEL)
-                {
-                    player1.position.y = GROUND_LEVEL - player1.radius;
-                    player1.velocity.y = 0;
-                    player1.onGround = true;
-                }
-                else
-                {
-                    player1.onGround = false;
-                }
+    if (events & (SIM_EVENT_NET | SIM_EVENT_BLOB_LEFT | SIM_EVENT_BLOB_RIGHT)) PlayGameSound(fxBallBounce, sfxBallBounce);
 
-                if (player2.position.y + player2.radius >= GROUND_LEVEL)
-                {
-                    player2.position.y = GROUND_LEVEL - player2.radius;
-                    player2.velocity.y = 0;
-                    player2.onGround = true;
-                }
-                else
-                {
-                    player2.onGround = false;
-                }
+    // Spawn ground particles on impact
+    if (events & SIM_EVENT_GROUND) SpawnGroundParticles((Vector2){ ball.position.x, GROUND_LEVEL }, 15);
 
-                // Handle score delay timer
-                if (scoreDelayTimer > 0)
-                {
-                    scoreDelayTimer--;
-                    if (scoreDelayTimer == 0)
-                    {
-                        ResetBall();
-                    }
-                }
+    if (events & SIM_EVENT_SCORE) PlayGameSound(fxScore, sfxScore);
+}
 
-                // Update ball physics 
-                ball.position.x += ball.velocity.x;
-                ball.position.y += ball.velocity.y;
-                ball.velocity.y += BALL_GRAVITY;
+void EnterGameOver(void)
+{
+    PlayGameSound(fxGameOver, sfxGameOver);
+}
 
-                // NOTE: Air resistance, turns out not very useful now
-                //ball.velocity.x *= BALL_AIR_RESISTANCE;
+// Court back to the start positions behind the menu
+void ExitGameOver(void)
+{
+    SimResetMatch(&sim);
+    SyncFromSim();
+}
 
-                // NOTE: ball rotation based on speed
-                float speed = sqrtf(ball.velocity.x * ball.velocity.x); // + ball.velocity.y * ball.velocity.y);
-                ball.rotation += (speed / ball.radius) * 35.0f;
+void UpdateGameOver(void)
+{
+    // Return to menu
+    if (IsKeyPressed(KEY_ENTER)) nextGameState = MENU;
+}
 
-                // Update trail every 2nd frame
-                if (framesCounter % 2 == 0)
-                {
-                    UpdateBallTrail();
-                }
+void EnterCredits(void)
+{
+    creditsScroll = SCREEN_HEIGHT;
 
-                // Ball wall collision (left and right)
-                if (ball.position.x - ball.radius <= 0)
-                {
-                    ball.position.x = ball.radius;
-                    ball.velocity.x *= -BALL_BOUNCE_DAMPING;
-                }
-                if (ball.position.x + ball.radius >= SCREEN_WIDTH)
-                {
-                    ball.position.x = SCREEN_WIDTH - ball.radius;
-                    ball.velocity.x *= -BALL_BOUNCE_DAMPING;
-                }
+    activeMusic = &creditsMusic;
+    PlayMusicStream(creditsMusic);
+}
 
-                // Ball ceiling collision
-                if (ball.position.y - ball.radius <= 0)
-                {
-                    ball.position.y = ball.radius;
-                    ball.velocity.y *= -BALL_BOUNCE_DAMPING;
-                }
+void ExitCredits(void)
+{
+    StopMusicStream(creditsMusic);
+    activeMusic = NULL;
+}
 
-                // Ball-net collision
-                Rectangle netRect = {
-                    NET_X - NET_WIDTH / 2,
-                    GROUND_LEVEL - NET_HEIGHT,
-                    NET_WIDTH,
-                    NET_HEIGHT
-                };
+void UpdateCredits(void)
+{
+    // Scroll credits up
+    creditsScroll -= 2.0f;
 
-                if (CheckCollisionCircleRec(ball.position, ball.radius, netRect))
-                {
-                    // Realistic net collision with energy loss
-                    ball.velocity.x *= -BALL_BOUNCE_DAMPING;
-                    ball.velocity.y *= 0.9f;  // Slight vertical damping on net hit
-
-                    // Push ball out of net
-                    if (ball.position.x < NET_X)
-                    {
-                        ball.position.x = netRect.x - ball.radius;
-                    }
-                    else
-                    {
-                        ball.position.x = netRect.x + netRect.width + ball.radius;
-                    }
-                    PlaySound(fxBallBounce);
-                }
+    if (creditsScroll <= -800) {
+        creditsScroll = -800;
+    }
 
-                // Ball-Player collision with velocity transfer (skip during score delay)
-                if (scoreDelayTimer == 0 && CheckCollisionCircles(ball.position, ball.radius,
-                                         player1.position, player1.radius))
-                {
-                    // Calculate collision normal
-                    Vector2 normal = {
-                        ball.position.x - player1.position.x,
-                        ball.position.y - player1.position.y
-                    };
-
-                    // Normalize
-                    float length = sqrtf(normal.x * normal.x + normal.y * normal.y);
-                    if (length > 0)
-                    {
-                        normal.x /= length;
-                        normal.y /= length;
-                    }
-
-                    // Reflect ball velocity with realistic energy retention
-                    float dotProduct = ball.velocity.x * normal.x + ball.velocity.y * normal.y;
-                    ball.velocity.x = ball.velocity.x - 2 * dotProduct * normal.x;
-                    ball.velocity.y = ball.velocity.y - 2 * dotProduct * normal.y;
-
-                    // Apply slight energy loss on collision
-                    ball.velocity.x *= 0.95f;
-                    ball.velocity.y *= 0.95f;
-
-                    // Add player's velocity influence
-                    ball.velocity.x += player1.velocity.x * 0.7f;
-                    ball.velocity.y += player1.velocity.y * 0.5f;
-
-                    // Special case: if blob is jumping, add upward boost
-                    if (player1.velocity.y < -5.0f)
-                    {
-                        ball.velocity.y -= 3.0f;
-                    }
-
-                    // Clamp ball speed
-                    float speed = sqrtf(ball.velocity.x * ball.velocity.x +
-                                       ball.velocity.y * ball.velocity.y);
-                    if (speed > BALL_MAX_SPEED)
-                    {
-                        ball.velocity.x = (ball.velocity.x / speed) * BALL_MAX_SPEED;
-                        ball.velocity.y = (ball.velocity.y / speed) * BALL_MAX_SPEED;
-                    }
-
-                    // Push ball out of blob
-                    ball.position.x = player1.position.x + normal.x * (player1.radius + ball.radius);
-                    ball.position.y = player1.position.y + normal.y * (player1.radius + ball.radius);
-
-                    PlaySound(fxBallBounce);
-                }
+    // Return to menu on ESC or ENTER, or when credits finish
+    if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_ESCAPE)) // || creditsScroll < -800)
+    {
+        nextGameState = MENU;
+    }
+}
 
-                // Ball-Player2 collision (skip during score delay)
-                if (scoreDelayTimer == 0 && CheckCollisionCircles(ball.position, ball.radius,
-                                         player2.position, player2.radius))
-                {
-                    // Calculate collision normal
-                    Vector2 normal = {
-                        ball.position.x - player2.position.x,
-                        ball.position.y - player2.position.y
-                    };
-
-                    // Normalize
-                    float length = sqrtf(normal.x * normal.x + normal.y * normal.y);
-                    if (length > 0)
-                    {
-                        normal.x /= length;
-                        normal.y /= length;
-                    }
-
-                    // Reflect ball velocity with realistic energy retention
-                    float dotProduct = ball.velocity.x * normal.x + ball.velocity.y * normal.y;
-                    ball.velocity.x = ball.velocity.x - 2 * dotProduct * normal.x;
-                    ball.velocity.y = ball.velocity.y - 2 * dotProduct * normal.y;
-
-                    // Apply slight energy loss on collision
-                    ball.velocity.x *= 0.95f;
-                    ball.velocity.y *= 0.95f;
-
-                    // Add player's velocity influence
-                    ball.velocity.x += player2.velocity.x * 0.7f;
-                    ball.velocity.y += player2.velocity.y * 0.5f;
-
-                    // Special case: if blob is jumping, add upward boost
-                    if (player2.velocity.y < -5.0f)
-                    {
-                        ball.velocity.y -= 3.0f;
-                    }
-
-                    // Clamp ball speed
-                    float speed = sqrtf(ball.velocity.x * ball.velocity.x +
-                                       ball.velocity.y * ball.velocity.y);
-                    if (speed > BALL_MAX_SPEED)
-                    {
-                        ball.velocity.x = (ball.velocity.x / speed) * BALL_MAX_SPEED;
-                        ball.velocity.y = (ball.velocity.y / speed) * BALL_MAX_SPEED;
-                    }
-
-                    // Push ball out of blob
-                    ball.position.x = player2.position.x + normal.x * (player2.radius + ball.radius);
-                    ball.position.y = player2.position.y + normal.y * (player2.radius + ball.radius);
-
-                    PlaySound(fxBallBounce);
-                }
+void EnterReplay(void)
+{
+    pause = false;
+    replayTick = 0;
+    replayStarted = false;
+    replayDesyncs = 0;
 
-                // Ball ground collision
-                if (ball.position.y + ball.radius >= GROUND_LEVEL)
-                {
-                    // Bounce ball off ground
-                    ball.position.y = GROUND_LEVEL - ball.radius;
-                    ball.velocity.y *= -BALL_BOUNCE_DAMPING;
-
-                    // Spawn ground particles on impact
-                    Vector2 impactPos = { ball.position.x, GROUND_LEVEL };
-                    SpawnGroundParticles(impactPos, 15);
-
-                    // Only process scoring if not in delay 
-                    if (scoreDelayTimer == 0)
-                    {
-                        // Determine which side scored
-                        if (ball.position.x < NET_X)
-                        {
-                            // Ball landed on left side, right player scores
-                            player2.score++;
-                            servingSide = RIGHT;  // Winner gets the serve
-                        }
-                        else
-                        {
-                            // Ball landed on right side, left player scores
-                            player1.score++;
-                            servingSide = LEFT;  // Winner gets the serve
-                        }
-                        PlaySound(fxScore);
-
-                        // Check win condition
-                        if (player1.score >= WIN_SCORE || player2.score >= WIN_SCORE)
-                        {
-                            gameState = GAMEOVER;
-                            PlaySound(fxGameOver);
-                        }
-                        else
-                        {
-                            // Start score delay timer instead of immediately resetting
-                            scoreDelayTimer = SCORE_DELAY_FRAMES;
-                        }
-                    }
-                }
-            }
-        } break;
+    SimResetMatch(&sim);
+    ball.trailCount = 0;
+    SyncFromSim();
 
-        case GAMEOVER:
-        {
-            // Return to menu
-            if (IsKeyPressed(KEY_ENTER))
-            {
-                gameState = MENU;
-                menuSelection = 0;
-                player1.score = 0;
-                player2.score = 0;
-                matchTimer = 0;
-            }
-        } break;
+    if (!ReplayStreamOpen(&replayStream, replayLocation)) nextGameState = MENU;
+}
 
-        case CREDITS:
-        {
-            // Scroll credits up
-            creditsScroll -= 2.0f;
+void ExitReplay(void)
+{
+    if (replayDesyncs > 0) TraceLog(LOG_WARNING, "REPLAY: %d keyframe(s) not reached by this build, corrected", replayDesyncs);
 
-            if (creditsScroll <= -800) {
-                creditsScroll = -800;
-            }
+    ReplayStreamClose(&replayStream);
+    replayLocation = NULL;
 
-            // Return to menu on ESC or ENTER, or when credits finish
-            if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_ESCAPE)) // || creditsScroll < -800)
-            {
-                gameState = MENU;
-                menuSelection = 0;
-            }
-        } break;
+    SimResetMatch(&sim);
+    SyncFromSim();
+}
+
+// One tick per frame as far as the replay has arrived; arrows seek 5 s, clicks on the bar anywhere in it
+void UpdateReplay(void)
+{
+    ReplayStreamUpdate(&replayStream);
+    const ReplayDecoder *decoder = &replayStream.decoder;
+
+    if (IsKeyPressed(KEY_ESCAPE) || (IsKeyPressed(KEY_ENTER) && replayStream.finished))
+    {
+        nextGameState = MENU;
+        return;
+    }
+
+    if (!replayStarted)
+    {
+        if (decoder->totalTicks < 0) return;
+
+        sim = decoder->replay.start;
+        SyncFromSim();
+        replayStarted = true;
+    }
+
+    if (IsKeyPressed(KEY_P) || IsKeyPressed(KEY_SPACE)) pause = !pause;
+
+    int seekTo = -1;
+    if (IsKeyPressed(KEY_RIGHT)) seekTo = replayTick + 5*60;
+    if (IsKeyPressed(KEY_LEFT)) seekTo = (replayTick > 5*60) ? replayTick - 5*60 : 0;
+    if (IsKeyPressed(KEY_HOME)) seekTo = 0;
+
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && (mouse.y >= SCREEN_HEIGHT - 40) && (decoder->totalTicks > 0))
+    {
+        seekTo = (int)((mouse.x - 20)/(SCREEN_WIDTH - 40)*decoder->totalTicks);
+    }
+
+    // From the nearest keyframe, at most a keyframe interval of steps
+    if (seekTo >= 0)
+    {
+        replayTick = ReplayDecoderSeek(decoder, seekTo, &sim);
+        ball.trailCount = 0;
+        SyncFromSim();
+    }
+
+    if (pause) return;
+
+    UpdateParticles();
+
+    // Waits at the end of what has arrived
+    if (replayTick >= decoder->replay.tickCount) return;
+
+    unsigned int events = SimStep(&sim, &decoder->replay.actions[replayTick*2]);
+    replayTick++;
+    if (!ReplayDecoderSync(decoder, replayTick, &sim)) replayDesyncs++;
+
+    SyncFromSim();
+    PlaySimEvents(events);
+}
+
+// The court as in play, with the download and the playhead along the bottom
+void DrawReplay(void)
+{
+    DrawPlaying();
+
+    const ReplayDecoder *decoder = &replayStream.decoder;
+    float width = SCREEN_WIDTH - 40;
+    float arrived = (decoder->totalTicks > 0) ? (float)decoder->replay.tickCount/decoder->totalTicks : 0.0f;
+    float played = (decoder->totalTicks > 0) ? (float)replayTick/decoder->totalTicks : 0.0f;
+
+    AtlasDrawRectangle(20, SCREEN_HEIGHT - 24, width, 8, Fade(BLACK, 0.4f));
+    AtlasDrawRectangle(20, SCREEN_HEIGHT - 24, width*arrived, 8, Fade(LIGHTGRAY, 0.6f));
+    AtlasDrawRectangle(20, SCREEN_HEIGHT - 24, width*played, 8, GOLD);
+
+    const char *status = NULL;
+    if (replayStream.failed) status = "REPLAY NOT AVAILABLE - ESC for the menu";
+    else if (!replayStarted || (!pause && (replayTick >= decoder->replay.tickCount) && !replayStream.finished)) status = "BUFFERING...";
+    else if (replayStream.finished && (replayTick >= decoder->totalTicks)) status = "END OF REPLAY - ENTER for the menu";
+
+    if (status != NULL)
+    {
+        int statusWidth = MeasureText(status, 20);
+        AtlasDrawText(status, SCREEN_WIDTH / 2 - statusWidth / 2, SCREEN_HEIGHT - 56, 20, LIGHTGRAY);
     }
 }
 
 // Draw game (one frame)
 void DrawGame(void)
 {
-    BeginDrawing();
-    ClearBackground(RAYWHITE);
+    RENDER_STATS_FRAME_BEGIN();
+
+    if (softRendering)
+    {
+        SoftBeginFrame(RAYWHITE);
+        AtlasSetSoftTarget(true);
+    }
+    else
+    {
+        DrawGlowSources();
+        BeginDrawing();
+        ClearBackground(RAYWHITE);
+    }
 
     // Draw background image
-    if (backgroundTexture.id > 0)
+    if (softRendering) SoftDrawTexture(&backgroundSoftTexture, 0, 0, GRAY);
+    else if (backgroundTexture.id > 0)
     {
+        RENDER_STATS_PRIMITIVE(backgroundTexture.id, 4, false);
         DrawTexture(backgroundTexture, 0, 0, GRAY);
     }
 
-    switch (gameState)
+    stateHandlers[gameState].draw();
+
+    // Glow grows with the ball speed, smashes light up the court
+    if (!softRendering)
     {
-        case MENU:
-        {
-            DrawMenu();
-        } break;
+        float speed = sqrtf(ball.velocity.x*ball.velocity.x + ball.velocity.y*ball.velocity.y)/BALL_MAX_SPEED;
+        DrawBloom(0.45f + 0.55f*speed*speed);
+    }
 
-        case PLAYING:
-        {
-            // Draw ground
-            DrawGround();
-
-            // Draw net
-            DrawNet();
-
-            // Draw player shadows
-            DrawPlayerShadow(player1);
-            DrawPlayerShadow(player2);
-
-            // Draw players with borders and highlights
-            // Subtle pulsing effect
-            float pulse = 0.4f + sinf(framesCounter * 0.05f) * 0.1f;
-
-            // Player 1
-            DrawCircleV(player1.position, player1.radius, player1.color);
-            DrawCircleLines((int)player1.position.x, (int)player1.position.y, player1.radius, BLACK);
-            DrawCircleLines((int)player1.position.x, (int)player1.position.y, player1.radius - 2, Fade(WHITE, 0.3f));
-            // Natural highlight with movement
-            float offset1X = -player1.radius * 0.35f + player1.velocity.x * 0.5f;
-            float offset1Y = -player1.radius * 0.35f - fabsf(player1.velocity.y) * 0.3f;
-            Vector2 highlight1 = { player1.position.x + offset1X, player1.position.y + offset1Y };
-            DrawCircleGradient((int)highlight1.x, (int)highlight1.y, player1.radius * 0.25f,
-                             Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
-
-            // Player 2
-            DrawCircleV(player2.position, player2.radius, player2.color);
-            DrawCircleLines((int)player2.position.x, (int)player2.position.y, player2.radius, BLACK);
-            DrawCircleLines((int)player2.position.x, (int)player2.position.y, player2.radius - 2, Fade(WHITE, 0.3f));
-            // Natural highlight with movement
-            float offset2X = -player2.radius * 0.35f + player2.velocity.x * 0.5f;
-            float offset2Y = -player2.radius * 0.35f - fabsf(player2.velocity.y) * 0.3f;
-            Vector2 highlight2 = { player2.position.x + offset2X, player2.position.y + offset2Y };
-            DrawCircleGradient((int)highlight2.x, (int)highlight2.y, player2.radius * 0.25f,
-                             Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
-
-            // Draw particles
-            DrawParticles();
-
-            // Draw ball with trail and spinning animation
-            DrawBallTrail();
-            DrawSpinningBall();
-
-            // Draw score
-            DrawScore();
-
-            // Draw pause indicator
-            if (pause)
-            {
-                DrawText("PAUSED", SCREEN_WIDTH / 2 - 60, SCREEN_HEIGHT / 2, 40, GRAY);
-                DrawText("Press P to continue",
-                        SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 + 50, 20, LIGHTGRAY);
-            }
-        } break;
+    RENDER_STATS_DRAW();
 
-        case GAMEOVER:
-        {
-            // Draw final state
-            DrawGround();
-            DrawNet();
-
-            // Draw players with borders and highlights
-            // Subtle pulsing effect
-            float pulse = 0.4f + sinf(framesCounter * 0.05f) * 0.1f;
-
-            // Player 1
-            DrawCircleV(player1.position, player1.radius, player1.color);
-            DrawCircleLines((int)player1.position.x, (int)player1.position.y, player1.radius, BLACK);
-            DrawCircleLines((int)player1.position.x, (int)player1.position.y, player1.radius - 2, Fade(WHITE, 0.3f));
-            // Natural highlight
-            Vector2 highlight1 = { player1.position.x - player1.radius * 0.35f, player1.position.y - player1.radius * 0.35f };
-            DrawCircleGradient((int)highlight1.x, (int)highlight1.y, player1.radius * 0.25f,
-                             Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
-
-            // Player 2
-            DrawCircleV(player2.position, player2.radius, player2.color);
-            DrawCircleLines((int)player2.position.x, (int)player2.position.y, player2.radius, BLACK);
-            DrawCircleLines((int)player2.position.x, (int)player2.position.y, player2.radius - 2, Fade(WHITE, 0.3f));
-            // Natural highlight
-            Vector2 highlight2 = { player2.position.x - player2.radius * 0.35f, player2.position.y - player2.radius * 0.35f };
-            DrawCircleGradient((int)highlight2.x, (int)highlight2.y, player2.radius * 0.25f,
-                             Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
-
-            DrawSpinningBall();
-            DrawScore();
-
-            // Winner announcement
-            const char *winner = (player1.score >= WIN_SCORE) ?
-                                "PLAYER 1 WINS!" : "PLAYER 2 WINS!";
-            int winnerWidth = MeasureText(winner, 60);
-            DrawText(winner, SCREEN_WIDTH / 2 - winnerWidth / 2,
-                    SCREEN_HEIGHT / 2 - 80, 60, GOLD);
-
-            DrawText("Press ENTER to return to menu",
-                    SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 20, 20, LIGHTGRAY);
-        } break;
-
-        case CREDITS:
-        {
-            DrawCredits();
-        } break;
+    if (softRendering) PresentSoftFrame();
+    else EndDrawing();
+
+    RENDER_STATS_FRAME_END();
+}
+
+// Court, players and ball in play
+void DrawPlaying(void)
+{
+    // Draw ground
+    DrawGround();
+
+    // Draw net
+    DrawNet();
+
+    // Draw player shadows
+    DrawPlayerShadow(player1);
+    DrawPlayerShadow(player2);
+
+    // Draw players with borders and highlights
+    // Subtle pulsing effect
+    float pulse = 0.4f + sinf(framesCounter * 0.05f) * 0.1f;
+
+    RENDER_STATS_BEGIN("DrawPlayers");
+
+    // Player 1
+    AtlasDrawCircle(player1.position, player1.radius, player1.color);
+    AtlasDrawCircleLines(player1.position, player1.radius, BLACK);
+    AtlasDrawCircleLines(player1.position, player1.radius - 2, Fade(WHITE, 0.3f));
+    // Natural highlight with movement
+    float offset1X = -player1.radius * 0.35f + player1.velocity.x * 0.5f;
+    float offset1Y = -player1.radius * 0.35f - fabsf(player1.velocity.y) * 0.3f;
+    Vector2 highlight1 = { player1.position.x + offset1X, player1.position.y + offset1Y };
+    AtlasDrawCircleGradient(highlight1, player1.radius * 0.25f,
+                            Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
+
+    // Player 2
+    AtlasDrawCircle(player2.position, player2.radius, player2.color);
+    AtlasDrawCircleLines(player2.position, player2.radius, BLACK);
+    AtlasDrawCircleLines(player2.position, player2.radius - 2, Fade(WHITE, 0.3f));
+    // Natural highlight with movement
+    float offset2X = -player2.radius * 0.35f + player2.velocity.x * 0.5f;
+    float offset2Y = -player2.radius * 0.35f - fabsf(player2.velocity.y) * 0.3f;
+    Vector2 highlight2 = { player2.position.x + offset2X, player2.position.y + offset2Y };
+    AtlasDrawCircleGradient(highlight2, player2.radius * 0.25f,
+                            Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
+
+    RENDER_STATS_END();
+
+    // Draw particles
+    DrawParticles();
+
+    // Draw ball with trail and spinning animation
+    DrawBallTrail();
+    DrawSpinningBall();
+
+    // Draw score
+    DrawScore();
+
+    // Draw pause indicator
+    if (pause)
+    {
+        AtlasDrawText("PAUSED", SCREEN_WIDTH / 2 - 60, SCREEN_HEIGHT / 2, 40, GRAY);
+        AtlasDrawText("Press P to continue",
+                      SCREEN_WIDTH / 2 - 100, SCREEN_HEIGHT / 2 + 50, 20, LIGHTGRAY);
     }
+}
+
+// Final state of the court and the winner
+void DrawGameOver(void)
+{
+    // Draw final state
+    DrawGround();
+    DrawNet();
+
+    // Draw players with borders and highlights
+    // Subtle pulsing effect
+    float pulse = 0.4f + sinf(framesCounter * 0.05f) * 0.1f;
+
+    RENDER_STATS_BEGIN("DrawPlayers");
+
+    // Player 1
+    AtlasDrawCircle(player1.position, player1.radius, player1.color);
+    AtlasDrawCircleLines(player1.position, player1.radius, BLACK);
+    AtlasDrawCircleLines(player1.position, player1.radius - 2, Fade(WHITE, 0.3f));
+    // Natural highlight
+    Vector2 highlight1 = { player1.position.x - player1.radius * 0.35f, player1.position.y - player1.radius * 0.35f };
+    AtlasDrawCircleGradient(highlight1, player1.radius * 0.25f,
+                            Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
+
+    // Player 2
+    AtlasDrawCircle(player2.position, player2.radius, player2.color);
+    AtlasDrawCircleLines(player2.position, player2.radius, BLACK);
+    AtlasDrawCircleLines(player2.position, player2.radius - 2, Fade(WHITE, 0.3f));
+    // Natural highlight
+    Vector2 highlight2 = { player2.position.x - player2.radius * 0.35f, player2.position.y - player2.radius * 0.35f };
+    AtlasDrawCircleGradient(highlight2, player2.radius * 0.25f,
+                            Fade(WHITE, pulse * 0.8f), Fade(WHITE, 0.0f));
+
+    RENDER_STATS_END();
+
+    DrawSpinningBall();
+    DrawScore();
+
+    // Winner announcement
+    const char *winner = (player1.score >= WIN_SCORE) ?
+                        "PLAYER 1 WINS!" : "PLAYER 2 WINS!";
+    int winnerWidth = MeasureText(winner, 60);
+    AtlasDrawText(winner, SCREEN_WIDTH / 2 - winnerWidth / 2,
+                  SCREEN_HEIGHT / 2 - 80, 60, GOLD);
+
+    AtlasDrawText("Press ENTER to return to menu",
+                  SCREEN_WIDTH / 2 - 150, SCREEN_HEIGHT / 2 + 20, 20, LIGHTGRAY);
+}
+
+// Rasterize the recorded frame on the CPU and show it as a single textured quad
+void PresentSoftFrame(void)
+{
+    AtlasSetSoftTarget(false);
+    SoftEndFrame();
+    UpdateTexture(softFrameTexture, SoftGetPixels());
 
+    BeginDrawing();
+    DrawTexture(softFrameTexture, 0, 0, WHITE);
     EndDrawing();
 }
 
+// Ball and particles once more, into the bloom target; dust is drawn light so it catches the glow
+void DrawGlowSources(void)
+{
+    if ((gameState != PLAYING) && (gameState != GAMEOVER) && (gameState != REPLAY)) return;
+    if (!BeginBloomSources()) return;
+
+    for (int i = 0; i < MAX_PARTICLES; i++)
+    {
+        if (!particles[i].active) continue;
+
+        float size = 3.0f * particles[i].life;
+        Rectangle dest = { particles[i].position.x, particles[i].position.y, size * 2.0f, size * 2.0f };
+        AtlasDrawSprite(ATLAS_SPRITE_PARTICLE, dest, (Vector2){ size, size }, 0.0f,
+                        Fade((Color){ 255, 220, 170, 255 }, particles[i].alpha));
+    }
+
+    DrawSpinningBall();
+
+    EndBloomSources();
+}
+
 // Draw ball trail effect
 void DrawBallTrail(void)
 {
+    RENDER_STATS_BEGIN("DrawBallTrail");
+
     for (int i = 0; i < ball.trailCount; i++)
     {
         float alpha = 1.0f - ((float)i / TRAIL_LENGTH);
         float radius = ball.radius * (1.0f - ((float)i / TRAIL_LENGTH) * 0.5f);
-        DrawCircleV(ball.trail[i], radius, Fade(LIGHTGRAY, alpha * 0.6f));
+        AtlasDrawCircle(ball.trail[i], radius, Fade(LIGHTGRAY, alpha * 0.6f));
     }
+
+    RENDER_STATS_END();
 }
 
 // Draw ball with spinning animation (volleyball pattern)
 void DrawSpinningBall(void)
 {
+    RENDER_STATS_BEGIN("DrawSpinningBall");
+
     // Draw shadow for depth (bottom-right)
     Vector2 shadowPos = {
         ball.position.x + ball.radius * 0.15f,
         ball.position.y + ball.radius * 0.15f
     };
-    DrawCircleV(shadowPos, ball.radius, Fade(BLACK, 0.15f));
+    AtlasDrawCircle(shadowPos, ball.radius, Fade(BLACK, 0.15f));
 
-    // If ball texture is loaded, use it; otherwise fall back to procedural drawing
-    if (ballTexture.id > 0)
+    // If ball sprite is loaded, use it; otherwise fall back to procedural drawing
+    if (AtlasHasSprite(ATLAS_SPRITE_BALL))
     {
-        // Draw rotating ball texture
+        // Draw rotating ball sprite
         float diameter = ball.radius * 2.0f;
-        Rectangle source = { 0, 0, (float)ballTexture.width, (float)ballTexture.height };
         Rectangle dest = { ball.position.x, ball.position.y, diameter, diameter };
         Vector2 origin = { ball.radius, ball.radius };
 
-        DrawTexturePro(ballTexture, source, dest, origin, ball.rotation, WHITE);
+        AtlasDrawSprite(ATLAS_SPRITE_BALL, dest, origin, ball.rotation, WHITE);
     }
     else
     {
@@ -1045,7 +1248,7 @@ void DrawSpinningBall(void)
         Color edgeColor = (Color){ 255, 140, 60, 255 };     // Orange edge
 
         // Main ball with gradient
-        DrawCircleGradient((int)ball.position.x, (int)ball.position.y, ball.radius, centerColor, edgeColor);
+        AtlasDrawCircleGradient(ball.position, ball.radius, centerColor, edgeColor);
 
         // Draw rotating stripes to show ball spin
         Color stripeColor = (Color){ 220, 100, 40, 200 };
@@ -1079,7 +1282,7 @@ void DrawSpinningBall(void)
                 float alpha = 1.0f - fabsf(t1 - 0.5f) * 1.2f;
                 if (alpha > 0)
                 {
-                    DrawLineEx(p1, p2, 2.5f, Fade(stripeColor, alpha));
+                    AtlasDrawLine(p1, p2, 2.5f, Fade(stripeColor, alpha));
                 }
             }
         }
@@ -1089,104 +1292,116 @@ void DrawSpinningBall(void)
             ball.position.x + ball.radius * 0.4f,
             ball.position.y + ball.radius * 0.4f
         };
-        DrawCircleGradient((int)shadePos.x, (int)shadePos.y, ball.radius * 0.6f,
-                           Fade(BLANK, 0.0f), Fade(ORANGE, 0.3f));
+        AtlasDrawCircleGradient(shadePos, ball.radius * 0.6f,
+                                Fade(BLANK, 0.0f), Fade(ORANGE, 0.3f));
 
         // Add bright highlight for spherical 3D effect (top-left)
         Vector2 highlightPos = {
             ball.position.x - ball.radius * 0.35f,
             ball.position.y - ball.radius * 0.35f
         };
-        DrawCircleV(highlightPos, ball.radius * 0.3f, Fade(WHITE, 0.5f));
-        DrawCircleV(highlightPos, ball.radius * 0.18f, Fade(WHITE, 0.7f));
-        DrawCircleV(highlightPos, ball.radius * 0.08f, Fade(WHITE, 0.9f));
+        AtlasDrawCircle(highlightPos, ball.radius * 0.3f, Fade(WHITE, 0.5f));
+        AtlasDrawCircle(highlightPos, ball.radius * 0.18f, Fade(WHITE, 0.7f));
+        AtlasDrawCircle(highlightPos, ball.radius * 0.08f, Fade(WHITE, 0.9f));
 
         // Outer rim for definition
-        DrawCircleLines((int)ball.position.x, (int)ball.position.y, ball.radius, Fade(ORANGE, 0.3f));
+        AtlasDrawCircleLines(ball.position, ball.radius, Fade(ORANGE, 0.3f));
     }
+
+    RENDER_STATS_END();
 }
 
 // Draw net
 void DrawNet(void)
 {
+    RENDER_STATS_BEGIN("DrawNet");
+
     // Draw shadow cast on the ground from the pole
     Vector2 shadowStart = { NET_X + NET_WIDTH / 2, GROUND_LEVEL };
     Vector2 shadowEnd = { NET_X + NET_WIDTH / 2 + 15, GROUND_LEVEL };
-    DrawLineEx(shadowStart, shadowEnd, 8.0f, Fade(BLACK, 0.3f));
+    AtlasDrawLine(shadowStart, shadowEnd, 8.0f, Fade(BLACK, 0.3f));
 
     // Draw pole shadow on left side for 3D depth
-    DrawRectangle(NET_X - NET_WIDTH / 2 - 2,
-                 GROUND_LEVEL - NET_HEIGHT,
-                 2,
-                 NET_HEIGHT,
-                 Fade(BLACK, 0.4f));
+    AtlasDrawRectangle(NET_X - NET_WIDTH / 2 - 2,
+                       GROUND_LEVEL - NET_HEIGHT,
+                       2,
+                       NET_HEIGHT,
+                       Fade(BLACK, 0.4f));
 
     // Main net post with gradient for roundness
-    DrawRectangleGradientH(NET_X - NET_WIDTH / 2,
-                          GROUND_LEVEL - NET_HEIGHT,
-                          NET_WIDTH,
-                          NET_HEIGHT,
-                          GRAY,
-                          WHITE);
+    AtlasDrawRectangleGradientH(NET_X - NET_WIDTH / 2,
+                                GROUND_LEVEL - NET_HEIGHT,
+                                NET_WIDTH,
+                                NET_HEIGHT,
+                                GRAY,
+                                WHITE);
 
     // Right edge shadow for cylinder effect
-    DrawRectangle(NET_X + NET_WIDTH / 2 - 1,
-                 GROUND_LEVEL - NET_HEIGHT,
-                 1,
-                 NET_HEIGHT,
-                 Fade(DARKGRAY, 0.5f));
+    AtlasDrawRectangle(NET_X + NET_WIDTH / 2 - 1,
+                       GROUND_LEVEL - NET_HEIGHT,
+                       1,
+                       NET_HEIGHT,
+                       Fade(DARKGRAY, 0.5f));
 
     // Top cap for the pole
-    DrawRectangle(NET_X - NET_WIDTH / 2 - 2,
-                 GROUND_LEVEL - NET_HEIGHT - 5,
-                 NET_WIDTH + 4,
-                 5,
-                 ORANGE);
+    AtlasDrawRectangle(NET_X - NET_WIDTH / 2 - 2,
+                       GROUND_LEVEL - NET_HEIGHT - 5,
+                       NET_WIDTH + 4,
+                       5,
+                       ORANGE);
 
     // Top cap highlight
-    DrawRectangle(NET_X - NET_WIDTH / 2 - 2,
-                 GROUND_LEVEL - NET_HEIGHT - 5,
-                 NET_WIDTH + 4,
-                 2,
-                 LIGHTGRAY);
+    AtlasDrawRectangle(NET_X - NET_WIDTH / 2 - 2,
+                       GROUND_LEVEL - NET_HEIGHT - 5,
+                       NET_WIDTH + 4,
+                       2,
+                       LIGHTGRAY);
+
+    RENDER_STATS_END();
 }
 
 // Draw score
 void DrawScore(void)
 {
+    RENDER_STATS_BEGIN("DrawScore");
+
     // Player 1 score (left side)
-    DrawText(TextFormat("%d", player1.score),
-             SCREEN_WIDTH / 4 - 20,
-             30,
-             60,
-             BLUE);
+    AtlasDrawText(TextFormat("%d", player1.score),
+                  SCREEN_WIDTH / 4 - 20,
+                  30,
+                  60,
+                  BLUE);
 
     // Player 2 score (right side)
-    DrawText(TextFormat("%d", player2.score),
-             SCREEN_WIDTH * 3 / 4 - 20,
-             30,
-             60,
-             RED);
+    AtlasDrawText(TextFormat("%d", player2.score),
+                  SCREEN_WIDTH * 3 / 4 - 20,
+                  30,
+                  60,
+                  RED);
 
     // Separator
-    DrawText("-", SCREEN_WIDTH / 2 - 10, 30, 60, LIGHTGRAY);
+    AtlasDrawText("-", SCREEN_WIDTH / 2 - 10, 30, 60, LIGHTGRAY);
 
     // Match timer (convert frames to minutes:seconds)
-    int totalSeconds = matchTimer / 60;
+    int totalSeconds = sim.tick / 60;
     int minutes = totalSeconds / 60;
     int seconds = totalSeconds % 60;
     const char *timerText = TextFormat("%02d:%02d", minutes, seconds);
     int timerWidth = MeasureText(timerText, 30);
-    DrawText(timerText, SCREEN_WIDTH / 2 - timerWidth / 2, 100, 30, WHITE);
+    AtlasDrawText(timerText, SCREEN_WIDTH / 2 - timerWidth / 2, 100, 30, WHITE);
+
+    RENDER_STATS_END();
 }
 
 // Draw menu
 void DrawMenu(void)
 {
+    RENDER_STATS_BEGIN("DrawMenu");
+
     // Title
     const char *title = APP_NAME;
     int titleWidth = MeasureText(title, 60);
-    DrawText(title, SCREEN_WIDTH / 2 - titleWidth / 2, 80, 60, WHITE);
+    AtlasDrawText(title, SCREEN_WIDTH / 2 - titleWidth / 2, 80, 60, WHITE);
 
     // Menu options
     const char *option1 = "Single Player (vs Computer)";
@@ -1205,26 +1420,30 @@ void DrawMenu(void)
     Color color3 = (menuSelection == 2) ? RED : GRAY;
     Color color4 = (menuSelection == 3) ? RED : GRAY;
 
-    DrawText(option1, SCREEN_WIDTH / 2 - opt1Width / 2, 200, 30, color1);
-    DrawText(option2, SCREEN_WIDTH / 2 - opt2Width / 2, 250, 30, color2);
-    DrawText(option3, SCREEN_WIDTH / 2 - opt3Width / 2, 300, 30, color3);
-    DrawText(option4, SCREEN_WIDTH / 2 - opt4Width / 2, 350, 30, color4);
+    AtlasDrawText(option1, SCREEN_WIDTH / 2 - opt1Width / 2, 200, 30, color1);
+    AtlasDrawText(option2, SCREEN_WIDTH / 2 - opt2Width / 2, 250, 30, color2);
+    AtlasDrawText(option3, SCREEN_WIDTH / 2 - opt3Width / 2, 300, 30, color3);
+    AtlasDrawText(option4, SCREEN_WIDTH / 2 - opt4Width / 2, 350, 30, color4);
 
     // Instructions
-    DrawText("Use UP/DOWN to select, ENTER to start",
-             SCREEN_WIDTH / 2 - MeasureText("Use UP/DOWN to select, ENTER to start", 20) / 2,
-             450, 20, LIGHTGRAY);
+    AtlasDrawText("Use UP/DOWN to select, ENTER to start",
+                  SCREEN_WIDTH / 2 - MeasureText("Use UP/DOWN to select, ENTER to start", 20) / 2,
+                  450, 20, LIGHTGRAY);
 
     // Controls info
-    DrawText("P1: W (jump), A/D (move)", 50, SCREEN_HEIGHT - 60, 16, LIGHTGRAY);
-    DrawText("P2: UP (jump), LEFT/RIGHT (move)", 50, SCREEN_HEIGHT - 35, 16, LIGHTGRAY);
+    AtlasDrawText("P1: W (jump), A/D (move)", 50, SCREEN_HEIGHT - 60, 16, LIGHTGRAY);
+    AtlasDrawText("P2: UP (jump), LEFT/RIGHT (move)", 50, SCREEN_HEIGHT - 35, 16, LIGHTGRAY);
+
+    AtlasDrawText(COPYRIGHT, SCREEN_WIDTH - MeasureText(COPYRIGHT, 16) - 25, SCREEN_HEIGHT-35, 16, BLACK);
 
-    DrawText(COPYRIGHT, SCREEN_WIDTH - MeasureText(COPYRIGHT, 16) - 25, SCREEN_HEIGHT-35, 16, BLACK);
+    RENDER_STATS_END();
 }
 
 // Draw player shadow cast on ground
 void DrawPlayerShadow(Player player)
 {
+    RENDER_STATS_BEGIN("DrawPlayerShadow");
+
     // Shadow position is on the ground, horizontally aligned with player
     Vector2 shadowPos = {
         player.position.x,
@@ -1238,35 +1457,43 @@ void DrawPlayerShadow(Player player)
     if (shadowScale > 1.0f) shadowScale = 1.0f;
     float shadowAlpha = 0.3f * shadowScale;
 
-    DrawEllipse((int)shadowPos.x, (int)shadowPos.y,
-               player.radius * shadowScale * 1.2f,
-               player.radius * shadowScale * 0.5f,
-               Fade(BLACK, shadowAlpha));
+    AtlasDrawEllipse(shadowPos,
+                     player.radius * shadowScale * 1.2f,
+                     player.radius * shadowScale * 0.5f,
+                     Fade(BLACK, shadowAlpha));
+
+    RENDER_STATS_END();
 }
 
 // Draw ground
 void DrawGround(void)
 {
+    RENDER_STATS_BEGIN("DrawGround");
+
     // Draw ground
-    DrawRectangle(0, GROUND_LEVEL, SCREEN_WIDTH,
-                 SCREEN_HEIGHT - GROUND_LEVEL, DARKBROWN);
+    AtlasDrawRectangle(0, GROUND_LEVEL, SCREEN_WIDTH,
+                       SCREEN_HEIGHT - GROUND_LEVEL, DARKBROWN);
 
     // Draw court line
-    DrawLineEx((Vector2){ 0, GROUND_LEVEL },
-              (Vector2){ SCREEN_WIDTH, GROUND_LEVEL },
-              3.0f, GREEN);
+    AtlasDrawLine((Vector2){ 0, GROUND_LEVEL },
+                  (Vector2){ SCREEN_WIDTH, GROUND_LEVEL },
+                  3.0f, GREEN);
 
-    DrawText(COPYRIGHT, SCREEN_WIDTH - MeasureText(COPYRIGHT, 16) - 25, SCREEN_HEIGHT-35, 16, GRAY);
+    AtlasDrawText(COPYRIGHT, SCREEN_WIDTH - MeasureText(COPYRIGHT, 16) - 25, SCREEN_HEIGHT-35, 16, GRAY);
+
+    RENDER_STATS_END();
 }
 
 void text_center(const char *text, int y, int fontSize, Color color) {
     int centerX = SCREEN_WIDTH / 2;
-    DrawText(text, centerX - MeasureText(text, fontSize) / 2, y, fontSize, color);
+    AtlasDrawText(text, centerX - MeasureText(text, fontSize) / 2, y, fontSize, color);
 }
 
 // Draw scrolling credits
 void DrawCredits(void)
 {
+    RENDER_STATS_BEGIN("DrawCredits");
+
     int y = (int)creditsScroll;
 
     // Title
@@ -1314,6 +1541,8 @@ void DrawCredits(void)
     
     y += 100;
     text_center("Press ENTER or ESC to return", y, 20, LIGHTGRAY);
+
+    RENDER_STATS_END();
 }
 
 // Spawn ground particles on impact
@@ -1374,25 +1603,39 @@ void UpdateParticles(void)
 // Draw all active particles
 void DrawParticles(void)
 {
+    RENDER_STATS_BEGIN("DrawParticles");
+
     for (int i = 0; i < MAX_PARTICLES; i++)
     {
         if (particles[i].active)
         {
-            // Draw particle as a small circle
-            float size = 3.0f * particles[i].life;  
-            DrawCircleV(particles[i].position, size,
-                       Fade(particles[i].color, particles[i].alpha));
+            // Draw particle as a small sprite
+            float size = 3.0f * particles[i].life;
+            Rectangle dest = { particles[i].position.x, particles[i].position.y, size * 2.0f, size * 2.0f };
+            AtlasDrawSprite(ATLAS_SPRITE_PARTICLE, dest, (Vector2){ size, size }, 0.0f,
+                            Fade(particles[i].color, particles[i].alpha));
         }
     }
+
+    RENDER_STATS_END();
 }
 
 void UnloadGame(void)
 {
+    EndMatchRecording();
+    if ((datasetDirectory != NULL) && !DatasetWriterClose(&dataset))
+    {
+        TraceLog(LOG_WARNING, "DATASET: Could not write all shards to %s", datasetDirectory);
+    }
+    ReplayFree(&replay);
+
     UnloadSound(fxJump);
     UnloadSound(fxBallBounce);
     UnloadSound(fxScore);
     UnloadSound(fxGameOver);
 
+    CloseSfxMixer();
+
     UnloadMusicStream(menuMusic);
     UnloadMusicStream(creditsMusic);
 
@@ -1402,14 +1645,114 @@ void UnloadGame(void)
     {
         UnloadTexture(backgroundTexture);
     }
-    if (ballTexture.id > 0)
+    UnloadAtlas();
+    CloseBloom();
+    CloseShaderCache();
+
+    if (softFrameTexture.id > 0) UnloadTexture(softFrameTexture);
+    if (backgroundImage.data != NULL) UnloadImage(backgroundImage);
+    CloseSoftRenderer();
+
+    for (int side = LEFT; side <= RIGHT; side++)
     {
-        UnloadTexture(ballTexture);
+        if (!botEnabled[side]) continue;
+
+        BotLinkStats *stats = &botLinks[side].stats;
+        if (stats->rounds > 0)
+        {
+            TraceLog(LOG_INFO, "BOT: %s side: %llu ticks, %llu timeouts, rtt avg %.2f us, p99 < %.2f us, max %.2f us",
+                     (side == LEFT) ? "left" : "right", (unsigned long long)stats->rounds,
+                     (unsigned long long)stats->timeouts, (double)stats->rttSumNs/stats->rounds/1000.0,
+                     BotLinkRttPercentileNs(stats, 0.99)/1000.0, stats->rttMaxNs/1000.0);
+        }
+        BotLinkDestroy(&botLinks[side]);
     }
+
+    CloseAgentWorker();
+
+    for (int side = LEFT; side <= RIGHT; side++)
+    {
+        if (agents[side] != NULL) agentPlugins[side].api->destroy(agents[side]);
+        AgentPluginUnload(&agentPlugins[side]);
+    }
+
+    RENDER_STATS_CLOSE();
+}
+
+// Audio calibration: white flash and click on the same tick, offset reported at the end
+void UpdateDrawCalibration(void)
+{
+    const int totalFrames = CALIBRATION_INTERVAL * (CALIBRATION_FLASHES + 1);
+
+    // Pace frames ourselves so the flash timestamp is taken right after the buffer swap
+    if (calibrationFrame == 0) SetTargetFPS(0);
+    double frameStart = GetTime();
+
+    calibrationFrame++;
+    bool flash = (calibrationFrame < totalFrames) && (calibrationFrame % CALIBRATION_INTERVAL == 0);
+    if (flash) PlaySfxCalibrationClick();
+
+    if (calibrationFrame == totalFrames)
+    {
+        calibrationResult = GetSfxCalibrationResult();
+        EndSfxCalibration();
+
+        TraceLog(LOG_INFO, "SFX: Calibration %d/%d clicks, audio after frame: mean %.2f ms, min %.2f ms, max %.2f ms",
+                 calibrationResult.samples, CALIBRATION_FLASHES, calibrationResult.meanOffsetMs,
+                 calibrationResult.minOffsetMs, calibrationResult.maxOffsetMs);
+    }
+
+    BeginDrawing();
+    ClearBackground(flash ? WHITE : BLACK);
+
+    if (calibrationFrame < totalFrames)
+    {
+        text_center("AUDIO CALIBRATION", 300, 40, GRAY);
+        text_center(TextFormat("click %d of %d", calibrationFrame / CALIBRATION_INTERVAL + 1, CALIBRATION_FLASHES), 360, 20, GRAY);
+    }
+    else
+    {
+        text_center("AUDIO CALIBRATION", 250, 40, WHITE);
+        if (calibrationResult.samples > 0)
+        {
+            text_center(TextFormat("audio arrives %.1f ms after the frame (%.2f frames)",
+                                   calibrationResult.meanOffsetMs, calibrationResult.meanOffsetMs * 60.0 / 1000.0), 320, 20, LIGHTGRAY);
+            text_center(TextFormat("min %.1f ms, max %.1f ms over %d clicks",
+                                   calibrationResult.minOffsetMs, calibrationResult.maxOffsetMs, calibrationResult.samples), 350, 20, LIGHTGRAY);
+        }
+        else text_center("no click detected on the capture device", 320, 20, RED);
+
+        text_center("Press ENTER to continue", 420, 20, GRAY);
+    }
+
+    EndDrawing();
+
+    if (flash) MarkSfxCalibrationFlash();
+
+    if ((calibrationFrame >= totalFrames) && IsKeyPressed(KEY_ENTER))
+    {
+        audioCalibration = false;
+        if (!frameLimiter) SetTargetFPS(60);
+        EnterGameState(MENU);
+        return;
+    }
+
+    // The frame limiter waits right after this returns
+    double remaining = 1.0 / 60.0 - (GetTime() - frameStart);
+    if (!frameLimiter && (remaining > 0)) WaitTime(remaining);
 }
 
 void UpdateDrawFrame(void)
 {
+    if (audioCalibration)
+    {
+        UpdateDrawCalibration();
+        return;
+    }
+
     UpdateGame();
     DrawGame();
+
+    // Shaders not needed for the first frames load between frames
+    UpdateShaderWarmup(SHADER_WARMUP_BUDGET);
 }
@@ -0,0 +1,465 @@
+/*******************************************************************************************
+*
+*   C-volley - bloom and glow post-processing
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "bloom.h"
+#include "renderstats.h"
+#include "shadercache.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__) && !defined(PLATFORM_WEB)
+    #define BLOOM_TIMER_QUERIES
+#endif
+
+#define BLOOM_TIERS 4
+#define BLOOM_QUERY_FRAMES 4            // Frames a timer result may lag behind before one is skipped
+#define BLOOM_SAMPLE_FRAMES 120         // Measured frames per tier decision
+#define BLOOM_SETTLE_FRAMES 30          // Not measured after a tier change
+
+// GL enums and entry points, raylib does not export its loader
+#define GL_TIME_ELAPSED 0x88BF
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+
+typedef void (*GenQueriesFunc)(int n, unsigned int *ids);
+typedef void (*DeleteQueriesFunc)(int n, const unsigned int *ids);
+typedef void (*BeginQueryFunc)(unsigned int target, unsigned int id);
+typedef void (*EndQueryFunc)(unsigned int target);
+typedef void (*GetQueryObjectuivFunc)(unsigned int id, unsigned int name, unsigned int *params);
+typedef void (*GetQueryObjectui64vFunc)(unsigned int id, unsigned int name, uint64_t *params);
+
+typedef void *(*GetProcAddressFunc)(const char *name);
+
+#if defined(BLOOM_TIMER_QUERIES)
+// Weak: each resolves only if the raylib platform linked that library in (static or shared)
+extern void *glfwGetProcAddress(const char *name) __attribute__((weak));
+extern void *eglGetProcAddress(const char *name) __attribute__((weak));
+extern void *SDL_GL_GetProcAddress(const char *name) __attribute__((weak));
+#endif
+
+// Blur fragment shaders: raylib's default vertex shader, GLSL 330 on desktop, 100 on GLES 2
+#if defined(PLATFORM_WEB) || defined(PLATFORM_ANDROID)
+    #define GLSL_HEADER "#version 100\nprecision mediump float;\n" \
+                        "#define TEXTURE texture2D\n#define VARYING varying\n#define FRAG_COLOR gl_FragColor\n"
+#else
+    #define GLSL_HEADER "#version 330\nout vec4 finalColor;\n" \
+                        "#define TEXTURE texture\n#define VARYING in\n#define FRAG_COLOR finalColor\n"
+#endif
+
+// Every fetch goes through the bright pass (threshold 0 in the second pass keeps it all);
+// alpha 1 so alpha blending writes the sum as it is
+#define BLUR_BEGIN(centerWeight) GLSL_HEADER \
+    "VARYING vec2 fragTexCoord;\n" \
+    "uniform sampler2D texture0;\n" \
+    "uniform vec2 direction;\n" \
+    "uniform float threshold;\n" \
+    "vec3 Tap(vec2 uv)\n" \
+    "{\n" \
+    "    vec3 color = TEXTURE(texture0, uv).rgb;\n" \
+    "    float luma = dot(color, vec3(0.2126, 0.7152, 0.0722));\n" \
+    "    return color*max(luma - threshold, 0.0)/max(luma*(1.0 - threshold), 0.0001);\n" \
+    "}\n" \
+    "void main()\n" \
+    "{\n" \
+    "    vec3 sum = Tap(fragTexCoord)*" centerWeight ";\n"
+
+// Two neighbouring taps in one bilinear fetch on each side: offset and weight of the pair
+#define BLUR_PAIR(offset, weight) \
+    "    sum += (Tap(fragTexCoord + direction*" offset ") + Tap(fragTexCoord - direction*" offset "))*" weight ";\n"
+
+#define BLUR_END \
+    "    FRAG_COLOR = vec4(sum, 1.0);\n" \
+    "}\n"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct BloomTier {
+    const char *name;
+    int divisor;                // Target resolution, screen/divisor
+    int taps;
+} BloomTier;
+
+// Timer queries of one frame: sources and blur, composite
+typedef struct BloomQueries {
+    unsigned int ids[2];
+    bool issued;                // Both ended, results pending
+} BloomQueries;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+
+// Gaussian of sigma 8 screen pixels in every tier (4, 2 and 1 texels), cut at two sigma
+static const BloomTier tiers[BLOOM_TIERS] = {
+    [BLOOM_OFF] = { "off", 1, 0 },
+    [BLOOM_LOW] = { "low", 8, 5 },
+    [BLOOM_MEDIUM] = { "medium", 4, 9 },
+    [BLOOM_HIGH] = { "high", 2, 17 },
+};
+
+static CachedShader blurShaders[BLOOM_TIERS] = {
+    [BLOOM_LOW] = { .name = "bloom-blur5", .fsCode =
+        BLUR_BEGIN("0.402620")
+        BLUR_PAIR("1.182426", "0.298690")
+        BLUR_END },
+    [BLOOM_MEDIUM] = { .name = "bloom-blur9", .fsCode =
+        BLUR_BEGIN("0.204164")
+        BLUR_PAIR("1.407333", "0.304005")
+        BLUR_PAIR("3.294215", "0.093913")
+        BLUR_END },
+    [BLOOM_HIGH] = { .name = "bloom-blur17", .fsCode =
+        BLUR_BEGIN("0.103153")
+        BLUR_PAIR("1.476580", "0.191011")
+        BLUR_PAIR("3.445530", "0.140429")
+        BLUR_PAIR("5.414899", "0.080715")
+        BLUR_PAIR("7.384912", "0.036269")
+        BLUR_END },
+};
+static int directionLocs[BLOOM_TIERS] = { 0 };
+static int thresholdLocs[BLOOM_TIERS] = { 0 };
+static bool locsFound[BLOOM_TIERS] = { 0 };
+
+static int screenWidth = 0;
+static int screenHeight = 0;
+static int tier = BLOOM_OFF;
+static bool autoTier = false;
+static RenderTexture2D targets[2] = { 0 };      // Sources and vertical pass, horizontal pass
+static bool sourcesDrawn = false;               // This frame, DrawBloom() has something to add
+
+static struct {
+    GenQueriesFunc GenQueries;
+    DeleteQueriesFunc DeleteQueries;
+    BeginQueryFunc BeginQuery;
+    EndQueryFunc EndQuery;
+    GetQueryObjectuivFunc GetQueryObjectuiv;
+    GetQueryObjectui64vFunc GetQueryObjectui64v;
+} gl = { 0 };
+
+static bool timerQueries = false;
+static BloomQueries queries[BLOOM_QUERY_FRAMES] = { 0 };
+static int queryFrame = 0;
+static bool measuring = false;                  // This frame's queries are running
+static int settleFrames = 0;
+static int sampleFrames = 0;
+static uint64_t sampleNs = 0;
+static uint64_t totalNs = 0;                    // Current tier, for the log at close
+static int totalFrames = 0;
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(BLOOM_TIMER_QUERIES)
+// Whichever loader the raylib platform linked in, core name or the GLES extension's
+static void *GetGlProc(const char *name, const char *extName)
+{
+    GetProcAddressFunc getProc = NULL;
+    if (glfwGetProcAddress != NULL) getProc = glfwGetProcAddress;
+    else if (eglGetProcAddress != NULL) getProc = eglGetProcAddress;
+    else if (SDL_GL_GetProcAddress != NULL) getProc = SDL_GL_GetProcAddress;
+
+    if (getProc == NULL) return NULL;
+
+    void *proc = getProc(name);
+    return (proc != NULL) ? proc : getProc(extName);
+}
+#endif
+
+static void InitTimerQueries(void)
+{
+    timerQueries = false;
+
+#if defined(BLOOM_TIMER_QUERIES)
+    *(void **)&gl.GenQueries = GetGlProc("glGenQueries", "glGenQueriesEXT");
+    *(void **)&gl.DeleteQueries = GetGlProc("glDeleteQueries", "glDeleteQueriesEXT");
+    *(void **)&gl.BeginQuery = GetGlProc("glBeginQuery", "glBeginQueryEXT");
+    *(void **)&gl.EndQuery = GetGlProc("glEndQuery", "glEndQueryEXT");
+    *(void **)&gl.GetQueryObjectuiv = GetGlProc("glGetQueryObjectuiv", "glGetQueryObjectuivEXT");
+    *(void **)&gl.GetQueryObjectui64v = GetGlProc("glGetQueryObjectui64v", "glGetQueryObjectui64vEXT");
+
+    if ((gl.GenQueries == NULL) || (gl.DeleteQueries == NULL) || (gl.BeginQuery == NULL) || (gl.EndQuery == NULL) ||
+        (gl.GetQueryObjectuiv == NULL) || (gl.GetQueryObjectui64v == NULL)) return;
+
+    for (int i = 0; i < BLOOM_QUERY_FRAMES; i++)
+    {
+        gl.GenQueries(2, queries[i].ids);
+        queries[i].issued = false;
+    }
+
+    timerQueries = true;
+#endif
+}
+
+static void LoadTargets(void)
+{
+    int width = GetRenderWidth()/tiers[tier].divisor;
+    int height = GetRenderHeight()/tiers[tier].divisor;
+
+    for (int i = 0; i < 2; i++)
+    {
+        targets[i] = LoadRenderTexture((width > 0) ? width : 1, (height > 0) ? height : 1);
+
+        // Bilinear for the paired taps and the upscale, clamped so glow does not wrap around
+        SetTextureFilter(targets[i].texture, TEXTURE_FILTER_BILINEAR);
+        SetTextureWrap(targets[i].texture, TEXTURE_WRAP_CLAMP);
+    }
+}
+
+static void UnloadTargets(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (targets[i].id > 0) UnloadRenderTexture(targets[i]);
+        targets[i] = (RenderTexture2D){ 0 };
+    }
+}
+
+static void SetTier(int next)
+{
+    UnloadTargets();
+    tier = next;
+    if (tier != BLOOM_OFF) LoadTargets();
+
+    for (int i = 0; i < BLOOM_QUERY_FRAMES; i++) queries[i].issued = false;
+    measuring = false;
+    settleFrames = BLOOM_SETTLE_FRAMES;
+    sampleFrames = 0;
+    sampleNs = totalNs = 0;
+    totalFrames = 0;
+}
+
+// The tier's program, loaded now unless warmup got to it; off when it does not compile
+static bool UseTierShader(void)
+{
+    CachedShader *shader = &blurShaders[tier];
+
+    if (!LoadCachedShader(shader))
+    {
+        TraceLog(LOG_WARNING, "BLOOM: Blur shader does not compile, bloom off");
+        SetTier(BLOOM_OFF);
+        return false;
+    }
+
+    if (!locsFound[tier])
+    {
+        directionLocs[tier] = GetShaderLocation(shader->shader, "direction");
+        thresholdLocs[tier] = GetShaderLocation(shader->shader, "threshold");
+        locsFound[tier] = true;
+    }
+
+    return true;
+}
+
+static void BlurPass(RenderTexture2D from, RenderTexture2D to, Vector2 direction, float threshold)
+{
+    Shader shader = blurShaders[tier].shader;
+
+    // No clear: the quad covers the target and writes alpha 1. Switching targets flushed the batch
+    RENDER_STATS_PRIMITIVE(from.texture.id, 4, true);
+    BeginTextureMode(to);
+    BeginShaderMode(shader);
+    SetShaderValue(shader, directionLocs[tier], &direction, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, thresholdLocs[tier], &threshold, SHADER_UNIFORM_FLOAT);
+    DrawTextureRec(from.texture, (Rectangle){ 0, 0, (float)from.texture.width, (float)-from.texture.height }, (Vector2){ 0, 0 }, WHITE);
+    EndShaderMode();
+    EndTextureMode();
+}
+
+// Adds up the frame that used this slot BLOOM_QUERY_FRAMES ago; false while its results are
+// not in yet, then this frame goes unmeasured rather than waiting on the GPU
+static bool CollectQueries(BloomQueries *slot)
+{
+    if (!slot->issued) return true;
+
+    unsigned int available = 0;
+    gl.GetQueryObjectuiv(slot->ids[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    uint64_t passNs = 0, compositeNs = 0;
+    gl.GetQueryObjectui64v(slot->ids[0], GL_QUERY_RESULT, &passNs);
+    gl.GetQueryObjectui64v(slot->ids[1], GL_QUERY_RESULT, &compositeNs);
+    slot->issued = false;
+
+    totalNs += passNs + compositeNs;
+    totalFrames++;
+    sampleNs += passNs + compositeNs;
+    sampleFrames++;
+
+    if (!autoTier || (sampleFrames < BLOOM_SAMPLE_FRAMES)) return true;
+
+    double averageMs = (double)sampleNs/sampleFrames/1000000.0;
+    sampleFrames = 0;
+    sampleNs = 0;
+
+    if (averageMs > BLOOM_GPU_BUDGET_MS)
+    {
+        TraceLog(LOG_INFO, "BLOOM: %.2f ms GPU at %s, over the %.2f ms budget, switching to %s", averageMs,
+                 tiers[tier].name, BLOOM_GPU_BUDGET_MS, tiers[tier - 1].name);
+        SetTier(tier - 1);
+        return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool InitBloom(int width, int height, int requestedTier)
+{
+    screenWidth = width;
+    screenHeight = height;
+    autoTier = (requestedTier == BLOOM_AUTO);
+
+    InitTimerQueries();
+
+    int start = requestedTier;
+    if (autoTier) start = timerQueries ? BLOOM_HIGH : BLOOM_MEDIUM;
+    if ((start < BLOOM_OFF) || (start > BLOOM_HIGH)) start = BLOOM_MEDIUM;
+
+    SetTier(start);
+    if (tier == BLOOM_OFF) return false;
+
+    // Glow is not needed on the menu, programs for the tiers BLOOM_AUTO may step down to as well
+    for (int i = tier; i > BLOOM_OFF; i--)
+    {
+        QueueShaderWarmup(&blurShaders[i]);
+        if (!autoTier) break;
+    }
+
+    TraceLog(LOG_INFO, "BLOOM: %s%s, %dx%d glow, %d-tap blur%s", tiers[tier].name, autoTier ? " (auto)" : "",
+             targets[0].texture.width, targets[0].texture.height, tiers[tier].taps,
+             timerQueries ? "" : ", no GPU timer queries");
+
+    return true;
+}
+
+void CloseBloom(void)
+{
+    if (totalFrames > 0)
+    {
+        TraceLog(LOG_INFO, "BLOOM: %s, GPU %.3f ms avg over %d frames", tiers[tier].name,
+                 (double)totalNs/totalFrames/1000000.0, totalFrames);
+    }
+
+    UnloadTargets();
+    tier = BLOOM_OFF;
+
+    for (int i = BLOOM_LOW; i < BLOOM_TIERS; i++)
+    {
+        UnloadCachedShader(&blurShaders[i]);
+        locsFound[i] = false;
+    }
+
+    if (timerQueries)
+    {
+        for (int i = 0; i < BLOOM_QUERY_FRAMES; i++) gl.DeleteQueries(2, queries[i].ids);
+        timerQueries = false;
+    }
+}
+
+bool BeginBloomSources(void)
+{
+    // A frame whose bloom was not drawn is not measured, its first query is simply reused
+    sourcesDrawn = false;
+    measuring = false;
+    if (tier == BLOOM_OFF) return false;
+
+    BloomQueries *slot = &queries[queryFrame];
+    if (timerQueries && (settleFrames == 0)) measuring = CollectQueries(slot);     // May step down
+    else if (settleFrames > 0) settleFrames--;
+
+    if ((tier == BLOOM_OFF) || !UseTierShader())
+    {
+        measuring = false;
+        return false;
+    }
+
+    // Timed from here: whatever is still batched belongs to the frame before
+    if (measuring)
+    {
+        rlDrawRenderBatchActive();
+        gl.BeginQuery(GL_TIME_ELAPSED, slot->ids[0]);
+    }
+
+    // Sources count under "Bloom" unless drawn in a section of their own
+    RENDER_STATS_BEGIN("Bloom");
+    RENDER_STATS_PRIMITIVE(0, 0, true);         // Flush only, for the target switch
+    BeginTextureMode(targets[0]);
+    ClearBackground(BLANK);
+
+    Camera2D camera = { 0 };
+    camera.zoom = (float)targets[0].texture.width/screenWidth;
+    BeginMode2D(camera);
+
+    sourcesDrawn = true;
+    return true;
+}
+
+void EndBloomSources(void)
+{
+    if (!sourcesDrawn) return;
+
+    EndMode2D();
+    EndTextureMode();
+
+    float width = (float)targets[0].texture.width;
+    float height = (float)targets[0].texture.height;
+    BlurPass(targets[0], targets[1], (Vector2){ 1.0f/width, 0.0f }, BLOOM_THRESHOLD);
+    BlurPass(targets[1], targets[0], (Vector2){ 0.0f, 1.0f/height }, 0.0f);
+    RENDER_STATS_PRIMITIVE(0, 0, true);         // Back to the screen
+    RENDER_STATS_END();
+
+    if (measuring) gl.EndQuery(GL_TIME_ELAPSED);
+}
+
+void DrawBloom(float intensity)
+{
+    if (!sourcesDrawn) return;
+    sourcesDrawn = false;
+
+    BloomQueries *slot = &queries[queryFrame];
+    if (measuring)
+    {
+        rlDrawRenderBatchActive();
+        gl.BeginQuery(GL_TIME_ELAPSED, slot->ids[1]);
+    }
+
+    float width = (float)targets[0].texture.width;
+    float height = (float)targets[0].texture.height;
+
+    RENDER_STATS_BEGIN("Bloom");
+    RENDER_STATS_PRIMITIVE(targets[0].texture.id, 4, true);     // The blend mode change flushes
+    BeginBlendMode(BLEND_ADDITIVE);
+    DrawTexturePro(targets[0].texture, (Rectangle){ 0, 0, width, -height },
+                   (Rectangle){ 0, 0, (float)screenWidth, (float)screenHeight }, (Vector2){ 0, 0 }, 0.0f,
+                   Fade(WHITE, (intensity < 0.0f) ? 0.0f : (intensity > 1.0f) ? 1.0f : intensity));
+    EndBlendMode();
+    RENDER_STATS_PRIMITIVE(0, 0, true);
+    RENDER_STATS_END();
+
+    if (measuring)
+    {
+        gl.EndQuery(GL_TIME_ELAPSED);
+        slot->issued = true;
+        measuring = false;
+    }
+    queryFrame = (queryFrame + 1) % BLOOM_QUERY_FRAMES;
+}
+
+int GetBloomTier(void)
+{
+    return tier;
+}
+
+const char *GetBloomTierName(int index)
+{
+    return ((index >= BLOOM_OFF) && (index < BLOOM_TIERS)) ? tiers[index].name : "auto";
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************************
+*
+*   C-volley - bloom and glow post-processing
+*
+*   Only what should glow (ball, its highlights, particles) is drawn a second time, into a
+*   render target at a fraction of the screen resolution, so the blur touches a quarter of
+*   the pixels or fewer instead of the whole frame. A separable Gaussian blur then runs in two
+*   passes (horizontal, vertical) between two such targets, the first one keeping only what
+*   is brighter than BLOOM_THRESHOLD, and the result is added over the frame in one quad.
+*
+*   The blur samples between texels so that bilinear filtering weights each pair of taps in
+*   one fetch: a 17-tap kernel costs 9 fetches, a 9-tap one 5. Each quality tier pairs a
+*   target resolution with the kernel that keeps the glow the same size on screen:
+*     - high:    1/2 resolution, 17 taps
+*     - medium:  1/4 resolution, 9 taps
+*     - low:     1/8 resolution, 5 taps
+*   BLOOM_AUTO starts high and steps down while GPU timer queries (GL 3.3 or
+*   EXT_disjoint_timer_query) measure the whole chain above BLOOM_GPU_BUDGET_MS, down to off;
+*   without timer queries it stays at medium.
+*
+*   Blur programs go through the shader cache (shadercache.h) and are warmed up between frames.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define BLOOM_AUTO -1
+#define BLOOM_OFF 0
+#define BLOOM_LOW 1
+#define BLOOM_MEDIUM 2
+#define BLOOM_HIGH 3
+
+#define BLOOM_GPU_BUDGET_MS 1.0         // Sources, blur and composite together, BLOOM_AUTO only
+#define BLOOM_THRESHOLD 0.55f           // Luminance a source needs to glow
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool InitBloom(int width, int height, int tier);    // After InitShaderCache(), screen size in draw coordinates
+void CloseBloom(void);                              // Before CloseShaderCache(), logs the tier and GPU time
+
+bool BeginBloomSources(void);           // Before BeginDrawing(), false: bloom is off, draw nothing
+void EndBloomSources(void);             // Blurs what was drawn since BeginBloomSources()
+void DrawBloom(float intensity);        // Inside BeginDrawing() over the frame, intensity 0..1
+
+int GetBloomTier(void);
+const char *GetBloomTierName(int tier);
+
+#endif // BLOOM_H
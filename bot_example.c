@@ -0,0 +1,139 @@
+/*******************************************************************************************
+*
+*   C-volley - example external bot
+*
+*   Usage:
+*     bot_example left|right [--spin]    play the given side of a game started with --bot-<side>
+*     bot_example --bench [ticks]        measure protocol round trip without the game
+*
+*   The bot itself is trivial: walk under the ball and jump when it is close. It is meant as
+*   a reference for bots written in other languages, see botlink.h for the memory layout.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "botlink.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static uint8_t ChaseBall(const BotState *state)
+{
+    int side = state->controlledSide;
+    float dx = state->ballX - state->blobX[side];
+    float dy = state->blobY[side] - state->ballY;
+    uint8_t action = 0;
+
+    if (dx < -15.0f) action |= BOTLINK_ACTION_LEFT;
+    else if (dx > 15.0f) action |= BOTLINK_ACTION_RIGHT;
+
+    if ((fabsf(dx) < 60.0f) && (dy > 0.0f) && (dy < 160.0f) && state->onGround[side]) action |= BOTLINK_ACTION_JUMP;
+
+    return action;
+}
+
+static int RunBot(int side, bool spin)
+{
+    BotLink link;
+
+    if (!BotLinkConnect(&link, side))
+    {
+        fprintf(stderr, "bot: no game is waiting for a %s bot (start it with --bot-%s)\n",
+                side ? "right" : "left", side ? "right" : "left");
+        return 1;
+    }
+
+    if (spin) link.spinNs = 1000000000ull;
+
+    printf("bot: playing %s side\n", side ? "right" : "left");
+
+    BotState state;
+    for (;;)
+    {
+        if (BotLinkWaitState(&link, &state, 1000000)) BotLinkSendAction(&link, &state, ChaseBall(&state));
+    }
+
+    BotLinkDisconnect(&link);
+    return 0;
+}
+
+// Game and bot in two processes, one tick after the other as fast as possible
+static int RunBench(int ticks)
+{
+    BotLink game;
+    if (!BotLinkCreate(&game, 1))
+    {
+        fprintf(stderr, "bench: could not create shared memory segment\n");
+        return 1;
+    }
+
+    pid_t child = fork();
+    if (child == 0)
+    {
+        BotLink bot;
+        if (!BotLinkConnect(&bot, 1)) _exit(1);
+
+        // Only the latest state is seen, a tick the game gave up on is skipped: done at the last
+        // tick, or once no state comes for a second
+        BotState state;
+        while (BotLinkWaitState(&bot, &state, 1000000))
+        {
+            BotLinkSendAction(&bot, &state, ChaseBall(&state));
+            if (state.tick == (uint32_t)(ticks - 1)) break;
+        }
+
+        BotLinkDisconnect(&bot);
+        _exit(0);
+    }
+
+    while (!__atomic_load_n(&game.shared->botAttached, __ATOMIC_ACQUIRE)) usleep(1000);
+
+    BotState state = { 0 };
+    state.blobX[1] = 768.0f;
+    state.blobY[1] = 668.0f;
+    state.onGround[1] = 1;
+
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        state.tick = (uint32_t)tick;
+        state.ballX = 512.0f + (tick%200);
+        state.ballY = 100.0f + (tick%300);
+
+        BotLinkPublish(&game, &state);
+        BotLinkWaitAction(&game, state.tick, 100000);
+    }
+
+    waitpid(child, NULL, 0);
+
+    BotLinkStats *stats = &game.stats;
+    printf("ticks %d  answered %llu  timeouts %llu\n", ticks,
+           (unsigned long long)stats->rounds, (unsigned long long)stats->timeouts);
+    if (stats->rounds > 0)
+    {
+        printf("rtt min %.2f us  avg %.2f us  p50 <%.2f us  p99 <%.2f us  max %.2f us\n",
+               stats->rttMinNs/1000.0, (double)stats->rttSumNs/stats->rounds/1000.0,
+               BotLinkRttPercentileNs(stats, 0.50)/1000.0, BotLinkRttPercentileNs(stats, 0.99)/1000.0,
+               stats->rttMaxNs/1000.0);
+    }
+
+    BotLinkDestroy(&game);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if ((argc >= 2) && (strcmp(argv[1], "--bench") == 0)) return RunBench((argc >= 3) ? atoi(argv[2]) : 100000);
+
+    if ((argc >= 2) && ((strcmp(argv[1], "left") == 0) || (strcmp(argv[1], "right") == 0)))
+    {
+        bool spin = (argc >= 3) && (strcmp(argv[2], "--spin") == 0);
+        return RunBot((strcmp(argv[1], "right") == 0) ? 1 : 0, spin);
+    }
+
+    fprintf(stderr, "usage: %s left|right [--spin]\n       %s --bench [ticks]\n", argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,336 @@
+/*******************************************************************************************
+*
+*   C-volley - local bot protocol over shared memory
+*
+*   Rings are SPSC with free-running indices: the producer owns head, the consumer owns
+*   tail. A consumer that runs out of spin budget raises consumerWaiting and sleeps on
+*   head with FUTEX_WAIT (shared, the mapping lives in two processes); the producer only
+*   issues FUTEX_WAKE when that flag is set, so the fast path is syscall free.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "botlink.h"
+
+#include <string.h>
+#include <time.h>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+static const char *SegmentName(int side)
+{
+    return (side == 0) ? "/cvolley-bot-left" : "/cvolley-bot-right";
+}
+
+static inline uint32_t LoadAcquire(const uint32_t *value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static inline void StoreRelease(uint32_t *value, uint32_t newValue)
+{
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+}
+
+static inline void CpuRelax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Producer side: make slot [head] visible and wake a sleeping consumer
+static void RingCommit(BotRingIndex *index)
+{
+    __atomic_store_n(&index->head, index->head + 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&index->consumerWaiting, __ATOMIC_SEQ_CST))
+    {
+        syscall(SYS_futex, &index->head, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+// Consumer side: wait until head moves past tail, spin first then sleep
+static bool RingWait(BotRingIndex *index, uint32_t tail, uint64_t spinNs, uint64_t deadlineNs)
+{
+    uint64_t now = BotLinkNowNs();
+    uint64_t spinUntil = now + spinNs;
+    if (spinUntil > deadlineNs) spinUntil = deadlineNs;
+
+    while (now < spinUntil)
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            if (LoadAcquire(&index->head) != tail) return true;
+            CpuRelax();
+        }
+        now = BotLinkNowNs();
+    }
+
+    while (now < deadlineNs)
+    {
+        __atomic_store_n(&index->consumerWaiting, 1, __ATOMIC_SEQ_CST);
+
+        uint32_t head = __atomic_load_n(&index->head, __ATOMIC_SEQ_CST);
+        if (head == tail)
+        {
+            uint64_t remaining = deadlineNs - now;
+            struct timespec timeout = { (time_t)(remaining/1000000000ull), (long)(remaining%1000000000ull) };
+            syscall(SYS_futex, &index->head, FUTEX_WAIT, head, &timeout, NULL, 0);
+        }
+
+        __atomic_store_n(&index->consumerWaiting, 0, __ATOMIC_RELAXED);
+
+        if (LoadAcquire(&index->head) != tail) return true;
+        now = BotLinkNowNs();
+    }
+
+    return false;
+}
+
+// Spinning only pays off when game and bot can run at the same time
+static uint64_t DefaultSpinNs(void)
+{
+    return (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? BOTLINK_DEFAULT_SPIN_NS : 0;
+}
+
+static BotLinkShared *MapSegment(int side, bool create)
+{
+    const char *name = SegmentName(side);
+
+    if (create) shm_unlink(name);   // Stale segment from a crashed run
+
+    int fd = shm_open(name, create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) return NULL;
+
+    if (create && (ftruncate(fd, sizeof(BotLinkShared)) != 0))
+    {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    void *memory = mmap(NULL, sizeof(BotLinkShared), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    return (memory == MAP_FAILED) ? NULL : (BotLinkShared *)memory;
+}
+
+static void RecordRoundTrip(BotLinkStats *stats, uint64_t rttNs)
+{
+    if ((stats->rounds == 0) || (rttNs < stats->rttMinNs)) stats->rttMinNs = rttNs;
+    if (rttNs > stats->rttMaxNs) stats->rttMaxNs = rttNs;
+
+    uint64_t bucket = rttNs/250;
+    if (bucket > 63) bucket = 63;
+    stats->rttHistogram[bucket]++;
+
+    stats->rttSumNs += rttNs;
+    stats->rounds++;
+}
+
+//----------------------------------------------------------------------------------
+// Module functions definition
+//----------------------------------------------------------------------------------
+uint64_t BotLinkNowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec*1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+bool BotLinkCreate(BotLink *link, int side)
+{
+    memset(link, 0, sizeof(BotLink));
+
+    BotLinkShared *shared = MapSegment(side, true);
+    if (shared == NULL) return false;
+
+    memset(shared, 0, sizeof(BotLinkShared));
+    shared->version = BOTLINK_VERSION;
+    shared->side = (uint32_t)side;
+    shared->slots = BOTLINK_RING_SLOTS;
+    StoreRelease(&shared->magic, BOTLINK_MAGIC);
+
+    link->shared = shared;
+    link->owner = true;
+    link->side = side;
+    link->spinNs = DefaultSpinNs();
+
+    return true;
+}
+
+void BotLinkDestroy(BotLink *link)
+{
+    if (link->shared == NULL) return;
+
+    munmap(link->shared, sizeof(BotLinkShared));
+    if (link->owner) shm_unlink(SegmentName(link->side));
+
+    link->shared = NULL;
+}
+
+void BotLinkPublish(BotLink *link, BotState *state)
+{
+    BotRingIndex *index = &link->shared->stateIndex;
+    uint32_t head = index->head;
+
+    if (head - LoadAcquire(&index->tail) >= BOTLINK_RING_SLOTS)
+    {
+        link->stats.dropped++;
+        return;
+    }
+
+    state->controlledSide = (uint8_t)link->side;
+    state->publishNs = BotLinkNowNs();
+    link->shared->states[head%BOTLINK_RING_SLOTS] = *state;
+
+    RingCommit(index);
+}
+
+uint8_t BotLinkWaitAction(BotLink *link, uint32_t tick, int timeoutUs)
+{
+    BotLinkShared *shared = link->shared;
+    BotRingIndex *index = &shared->actionIndex;
+
+    if (!LoadAcquire(&shared->botAttached)) return link->lastAction;
+
+    uint64_t deadline = BotLinkNowNs() + (uint64_t)timeoutUs*1000;
+
+    for (;;)
+    {
+        uint32_t tail = index->tail;
+
+        while (tail != LoadAcquire(&index->head))
+        {
+            BotAction action = shared->actions[tail%BOTLINK_RING_SLOTS];
+            StoreRelease(&index->tail, ++tail);
+
+            // Late answers for older ticks still carry the bot's latest intent
+            link->lastAction = action.action;
+
+            if (action.tick == tick)
+            {
+                RecordRoundTrip(&link->stats, BotLinkNowNs() - action.echoNs);
+                return link->lastAction;
+            }
+        }
+
+        if (!RingWait(index, tail, link->spinNs, deadline))
+        {
+            link->stats.timeouts++;
+            return link->lastAction;
+        }
+    }
+}
+
+uint64_t BotLinkRttPercentileNs(const BotLinkStats *stats, double percentile)
+{
+    uint64_t target = (uint64_t)(stats->rounds*percentile);
+    uint64_t seen = 0;
+
+    for (int i = 0; i < 64; i++)
+    {
+        seen += stats->rttHistogram[i];
+        if ((seen > target) && (i < 63)) return (uint64_t)(i + 1)*250;
+    }
+
+    return stats->rttMaxNs;
+}
+
+bool BotLinkConnect(BotLink *link, int side)
+{
+    memset(link, 0, sizeof(BotLink));
+
+    BotLinkShared *shared = MapSegment(side, false);
+    if (shared == NULL) return false;
+
+    if ((LoadAcquire(&shared->magic) != BOTLINK_MAGIC) || (shared->version != BOTLINK_VERSION))
+    {
+        munmap(shared, sizeof(BotLinkShared));
+        return false;
+    }
+
+    // Skip states published before we attached
+    StoreRelease(&shared->stateIndex.tail, LoadAcquire(&shared->stateIndex.head));
+    StoreRelease(&shared->botAttached, 1);
+
+    link->shared = shared;
+    link->side = side;
+    link->spinNs = DefaultSpinNs();
+
+    return true;
+}
+
+void BotLinkDisconnect(BotLink *link)
+{
+    if (link->shared == NULL) return;
+
+    StoreRelease(&link->shared->botAttached, 0);
+    BotLinkDestroy(link);
+}
+
+bool BotLinkWaitState(BotLink *link, BotState *state, int timeoutUs)
+{
+    BotRingIndex *index = &link->shared->stateIndex;
+    uint32_t tail = index->tail;
+
+    if ((LoadAcquire(&index->head) == tail) &&
+        !RingWait(index, tail, link->spinNs, BotLinkNowNs() + (uint64_t)timeoutUs*1000)) return false;
+
+    // Only the newest state matters, stale ticks are skipped
+    uint32_t head = LoadAcquire(&index->head);
+    *state = link->shared->states[(head - 1)%BOTLINK_RING_SLOTS];
+    StoreRelease(&index->tail, head);
+
+    return true;
+}
+
+void BotLinkSendAction(BotLink *link, const BotState *state, uint8_t action)
+{
+    BotRingIndex *index = &link->shared->actionIndex;
+    uint32_t head = index->head;
+
+    // Game is not consuming (menu, pause), nothing to answer
+    if (head - LoadAcquire(&index->tail) >= BOTLINK_RING_SLOTS) return;
+
+    BotAction *slot = &link->shared->actions[head%BOTLINK_RING_SLOTS];
+    slot->tick = state->tick;
+    slot->action = action;
+    slot->echoNs = state->publishNs;
+
+    RingCommit(index);
+}
+
+#else
+
+uint64_t BotLinkNowNs(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (uint64_t)now.tv_sec*1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+bool BotLinkCreate(BotLink *link, int side) { memset(link, 0, sizeof(BotLink)); link->side = side; return false; }
+void BotLinkDestroy(BotLink *link) { link->shared = NULL; }
+void BotLinkPublish(BotLink *link, BotState *state) { (void)link; (void)state; }
+uint8_t BotLinkWaitAction(BotLink *link, uint32_t tick, int timeoutUs) { (void)tick; (void)timeoutUs; return link->lastAction; }
+uint64_t BotLinkRttPercentileNs(const BotLinkStats *stats, double percentile) { (void)percentile; return stats->rttMaxNs; }
+bool BotLinkConnect(BotLink *link, int side) { memset(link, 0, sizeof(BotLink)); link->side = side; return false; }
+void BotLinkDisconnect(BotLink *link) { link->shared = NULL; }
+bool BotLinkWaitState(BotLink *link, BotState *state, int timeoutUs) { (void)link; (void)state; (void)timeoutUs; return false; }
+void BotLinkSendAction(BotLink *link, const BotState *state, uint8_t action) { (void)link; (void)state; (void)action; }
+
+#endif
@@ -0,0 +1,128 @@
+/*******************************************************************************************
+*
+*   C-volley - local bot protocol over shared memory
+*
+*   Each bot-driven side gets a POSIX shared memory segment (/cvolley-bot-left or
+*   /cvolley-bot-right) holding two single-producer/single-consumer rings:
+*     - state ring:  game -> bot, one BotState per simulated tick
+*     - action ring: bot -> game, one BotAction per tick (action bitfield)
+*
+*   The game publishes the tick state, then waits for the action of that same tick: it spins
+*   briefly and then sleeps on a futex on the action ring head, falling back to the previous
+*   action on timeout. Bots do the same on the state ring head.
+*
+*   The layout is plain C with fixed-size fields so bots in other languages can map it
+*   directly (Python ctypes/struct, Rust #[repr(C)]). All ring indices are free-running
+*   uint32 counters, slot = index % BOTLINK_RING_SLOTS.
+*
+*   Linux only (futex), BotLinkCreate()/BotLinkConnect() fail gracefully elsewhere.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef BOTLINK_H
+#define BOTLINK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define BOTLINK_MAGIC 0x4C544F42u       // "BOTL"
+#define BOTLINK_VERSION 1
+#define BOTLINK_RING_SLOTS 16           // Power of two
+#define BOTLINK_DEFAULT_SPIN_NS 20000   // Busy-wait this long before sleeping on the futex (multicore only)
+
+// Action bitfield, same values as the game's ACTION_* flags
+#define BOTLINK_ACTION_LEFT  0x01
+#define BOTLINK_ACTION_RIGHT 0x02
+#define BOTLINK_ACTION_JUMP  0x04
+
+//----------------------------------------------------------------------------------
+// Shared memory layout
+//----------------------------------------------------------------------------------
+
+// Per tick world state, side 0 is left, side 1 is right
+typedef struct BotState {
+    uint32_t tick;
+    uint32_t scoreDelay;        // Frames left before the next serve, 0 while the rally is live
+    uint64_t publishNs;         // Game clock (CLOCK_MONOTONIC), echoed back in BotAction
+    float ballX, ballY;
+    float ballVX, ballVY;
+    float blobX[2], blobY[2];
+    float blobVX[2], blobVY[2];
+    uint8_t onGround[2];
+    uint8_t score[2];
+    uint8_t servingSide;
+    uint8_t controlledSide;     // Side this link drives
+    uint8_t reserved[2];
+} BotState;
+
+typedef struct BotAction {
+    uint32_t tick;              // Tick of the BotState this action answers
+    uint8_t action;             // BOTLINK_ACTION_* bits
+    uint8_t reserved[3];
+    uint64_t echoNs;            // BotState.publishNs, used for round-trip measurement
+} BotAction;
+
+// Ring indices, producer and consumer on separate cache lines
+typedef struct BotRingIndex {
+    uint32_t head;              // Written by producer only, also the futex word
+    uint32_t consumerWaiting;   // Set by a consumer about to sleep on head
+    uint8_t pad0[56];
+    uint32_t tail;              // Written by consumer only
+    uint8_t pad1[60];
+} BotRingIndex;
+
+typedef struct BotLinkShared {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t side;
+    uint32_t slots;
+    uint32_t botAttached;       // Set by the bot while connected, game does not wait otherwise
+    uint8_t pad[44];
+    BotRingIndex stateIndex;
+    BotState states[BOTLINK_RING_SLOTS];
+    BotRingIndex actionIndex;
+    BotAction actions[BOTLINK_RING_SLOTS];
+} BotLinkShared;
+
+//----------------------------------------------------------------------------------
+// Process local handle
+//----------------------------------------------------------------------------------
+typedef struct BotLinkStats {
+    uint64_t rounds;            // Ticks answered in time
+    uint64_t timeouts;          // Ticks that fell back to the previous action
+    uint64_t dropped;           // States not published because the ring was full
+    uint64_t rttSumNs;
+    uint64_t rttMinNs;
+    uint64_t rttMaxNs;
+    uint32_t rttHistogram[64];  // 250ns buckets, last bucket collects the tail
+} BotLinkStats;
+
+typedef struct BotLink {
+    BotLinkShared *shared;
+    bool owner;                 // Game side, unlinks the segment on destroy
+    int side;
+    uint64_t spinNs;            // Busy-wait budget per wait, raise it on dedicated cores
+    uint8_t lastAction;
+    BotLinkStats stats;
+} BotLink;
+
+// Game side
+bool BotLinkCreate(BotLink *link, int side);
+void BotLinkDestroy(BotLink *link);
+void BotLinkPublish(BotLink *link, BotState *state);                    // Stamps publishNs
+uint8_t BotLinkWaitAction(BotLink *link, uint32_t tick, int timeoutUs);  // Falls back to lastAction
+uint64_t BotLinkRttPercentileNs(const BotLinkStats *stats, double percentile);
+
+// Bot side
+bool BotLinkConnect(BotLink *link, int side);
+void BotLinkDisconnect(BotLink *link);
+bool BotLinkWaitState(BotLink *link, BotState *state, int timeoutUs);   // Latest state, skips stale ones
+void BotLinkSendAction(BotLink *link, const BotState *state, uint8_t action);
+
+uint64_t BotLinkNowNs(void);
+
+#endif // BOTLINK_H
@@ -0,0 +1,300 @@
+/*******************************************************************************************
+*
+*   C-volley - cabinet mode: real-time scheduling and jitter isolation
+*
+*   Affinity is inherited by new threads, so InitCabinetMode() first narrows the main thread
+*   to the "other" cores and everything raylib and the game start from there on lands on
+*   them; only afterwards EnterCabinetGameThread() moves the main thread alone onto the game
+*   core. Minor and major page faults of the game thread are counted from that point on and
+*   reported at exit next to the jitter histogram.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include "cabinet.h"
+#include "raylib.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Frame jitter histogram
+//----------------------------------------------------------------------------------
+#define JITTER_WARMUP_FRAMES 60         // Startup frames (shader compiles, first uploads) are not counted
+#define JITTER_LATE_MS 2.0              // Frames this much past the target period count as hitches
+
+static unsigned int jitterBins[JITTER_BINS] = { 0 };
+static unsigned long long jitterFrames = 0;
+static double jitterSum = 0, jitterSumSq = 0, jitterMax = 0;
+static double jitterTarget = 0;
+static unsigned long long jitterLate = 0;
+static double lastFrameTime = 0;
+static int warmupFrames = 0;
+
+void RecordFrameJitter(double targetFps)
+{
+    double now = GetTime();
+    double previous = lastFrameTime;
+    lastFrameTime = now;
+
+    if (warmupFrames < JITTER_WARMUP_FRAMES)
+    {
+        warmupFrames++;
+        return;
+    }
+
+    double ms = (now - previous)*1000.0;
+    int bin = (int)(ms/JITTER_BIN_MS);
+    if (bin >= JITTER_BINS) bin = JITTER_BINS - 1;
+
+    jitterTarget = 1000.0/targetFps;
+    jitterBins[bin]++;
+    jitterFrames++;
+    jitterSum += ms;
+    jitterSumSq += ms*ms;
+    if (ms > jitterMax) jitterMax = ms;
+    if (ms > jitterTarget + JITTER_LATE_MS) jitterLate++;
+}
+
+static double JitterPercentile(double fraction)
+{
+    unsigned long long target = (unsigned long long)ceil(fraction*jitterFrames);
+    unsigned long long seen = 0;
+
+    for (int i = 0; i < JITTER_BINS; i++)
+    {
+        seen += jitterBins[i];
+        if (seen >= target) return (i + 1)*JITTER_BIN_MS;        // Upper bin edge
+    }
+
+    return JITTER_BINS*JITTER_BIN_MS;
+}
+
+void CloseFrameJitter(const char *fileName)
+{
+    if (jitterFrames == 0) return;
+
+    double mean = jitterSum/jitterFrames;
+    double variance = jitterSumSq/jitterFrames - mean*mean;
+
+    TraceLog(LOG_INFO, "JITTER: %llu frames, interval mean %.3f ms, stddev %.3f ms, p50 < %.1f ms, p99 < %.1f ms, p99.9 < %.1f ms, max %.2f ms",
+             jitterFrames, mean, (variance > 0) ? sqrt(variance) : 0.0, JitterPercentile(0.5), JitterPercentile(0.99),
+             JitterPercentile(0.999), jitterMax);
+    TraceLog(LOG_INFO, "JITTER: %llu frames (%.3f%%) more than %.0f ms over the %.2f ms period",
+             jitterLate, 100.0*jitterLate/jitterFrames, JITTER_LATE_MS, jitterTarget);
+
+    if (fileName == NULL) return;
+
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "JITTER: Could not write %s", fileName);
+        return;
+    }
+
+    fprintf(file, "interval_ms,frames\n");
+    for (int i = 0; i < JITTER_BINS; i++)
+    {
+        if (jitterBins[i] > 0) fprintf(file, "%.1f,%u\n", i*JITTER_BIN_MS, jitterBins[i]);
+    }
+    fclose(file);
+}
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define CABINET_STACK_PREFAULT (512*1024)
+#define CABINET_HEAP_RESERVE (16*1024*1024)     // Touched once and kept by the allocator
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static bool cabinetActive = false;
+static int gameCpu = -1;
+static cpu_set_t otherCpus;
+static struct rusage faultsAtEntry;
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+
+// First CPU of the kernel's isolated list (isolcpus=) we are allowed on, -1 if none
+static int FirstIsolatedCpu(const cpu_set_t *allowed)
+{
+    FILE *file = fopen("/sys/devices/system/cpu/isolated", "r");
+    if (file == NULL) return -1;
+
+    char list[1024] = { 0 };
+    bool read = (fgets(list, sizeof(list), file) != NULL);
+    fclose(file);
+    if (!read) return -1;
+
+    for (const char *p = list; *p && (*p != '\n'); )
+    {
+        char *end = NULL;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+
+        long last = first;
+        if (*end == '-') last = strtol(end + 1, &end, 10);
+
+        for (long cpu = first; cpu <= last; cpu++)
+        {
+            if ((cpu < CPU_SETSIZE) && CPU_ISSET((int)cpu, allowed)) return (int)cpu;
+        }
+
+        p = (*end == ',') ? end + 1 : end;
+    }
+
+    return -1;
+}
+
+// Never gets inlined, so the array really is below the caller's frame
+static __attribute__((noinline)) void PrefaultStack(void)
+{
+    unsigned char stack[CABINET_STACK_PREFAULT];
+    memset(stack, 0, sizeof(stack));
+    __asm__ __volatile__("" : : "r"(stack) : "memory");      // Keep the stores
+}
+
+// Malloc keeps freed memory instead of trimming or unmapping it, so after one big touched
+// block every later allocation comes from resident pages
+static void PrefaultHeap(void)
+{
+#if defined(__GLIBC__)
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+#endif
+
+    unsigned char *reserve = (unsigned char *)malloc(CABINET_HEAP_RESERVE);
+    if (reserve == NULL) return;
+
+    for (int i = 0; i < CABINET_HEAP_RESERVE; i += 4096) reserve[i] = 0;
+    free(reserve);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool InitCabinetMode(int requestedCpu)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+
+    cabinetActive = true;
+    gameCpu = -1;
+
+    // Memory locking still helps, but real-time priority on the only core would starve audio
+    if (CPU_COUNT(&allowed) < 2)
+    {
+        TraceLog(LOG_WARNING, "CABINET: Only one CPU available, running without a dedicated game core");
+        return true;
+    }
+
+    if ((requestedCpu >= 0) && (requestedCpu < CPU_SETSIZE) && CPU_ISSET(requestedCpu, &allowed)) gameCpu = requestedCpu;
+    else if (requestedCpu >= 0) TraceLog(LOG_WARNING, "CABINET: CPU %d not available, picking one", requestedCpu);
+
+    if (gameCpu < 0) gameCpu = FirstIsolatedCpu(&allowed);
+    if (gameCpu < 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &allowed)) gameCpu = cpu;
+        }
+    }
+
+    otherCpus = allowed;
+    CPU_CLR(gameCpu, &otherCpus);
+
+    if (sched_setaffinity(0, sizeof(otherCpus), &otherCpus) != 0)
+    {
+        TraceLog(LOG_WARNING, "CABINET: Could not set CPU affinity, running without a dedicated game core");
+        gameCpu = -1;
+        return true;
+    }
+
+    TraceLog(LOG_INFO, "CABINET: CPU %d reserved for the game thread, %d CPUs for everything else", gameCpu, CPU_COUNT(&otherCpus));
+
+    return true;
+}
+
+void EnterCabinetGameThread(void)
+{
+    if (!cabinetActive) return;
+
+    // Lock everything mapped now and later; try the hard limit if the soft one is too small
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        struct rlimit limit;
+        if ((getrlimit(RLIMIT_MEMLOCK, &limit) == 0) && (limit.rlim_cur < limit.rlim_max))
+        {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_MEMLOCK, &limit);
+        }
+
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) TraceLog(LOG_INFO, "CABINET: Memory locked");
+        else TraceLog(LOG_WARNING, "CABINET: Could not lock memory (RLIMIT_MEMLOCK or CAP_IPC_LOCK), pages may still be evicted");
+    }
+    else TraceLog(LOG_INFO, "CABINET: Memory locked");
+
+    PrefaultStack();
+    PrefaultHeap();
+
+    if (gameCpu < 0)
+    {
+        getrusage(RUSAGE_THREAD, &faultsAtEntry);
+        return;
+    }
+
+    cpu_set_t game;
+    CPU_ZERO(&game);
+    CPU_SET(gameCpu, &game);
+    if (sched_setaffinity(0, sizeof(game), &game) != 0) TraceLog(LOG_WARNING, "CABINET: Could not pin the game thread to CPU %d", gameCpu);
+
+    struct sched_param param = { .sched_priority = CABINET_GAME_PRIORITY };
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0)
+    {
+        TraceLog(LOG_INFO, "CABINET: Game thread on CPU %d, SCHED_FIFO priority %d", gameCpu, CABINET_GAME_PRIORITY);
+    }
+    else TraceLog(LOG_WARNING, "CABINET: Game thread on CPU %d at normal priority (no real-time permission)", gameCpu);
+
+    getrusage(RUSAGE_THREAD, &faultsAtEntry);
+}
+
+void CloseCabinetMode(void)
+{
+    if (!cabinetActive) return;
+
+    struct rusage now;
+    getrusage(RUSAGE_THREAD, &now);
+    TraceLog(LOG_INFO, "CABINET: Game thread page faults since start: %ld minor, %ld major",
+             now.ru_minflt - faultsAtEntry.ru_minflt, now.ru_majflt - faultsAtEntry.ru_majflt);
+
+    // Back to normal scheduling for the teardown
+    struct sched_param param = { .sched_priority = 0 };
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    munlockall();
+
+    cabinetActive = false;
+}
+
+#else
+
+bool InitCabinetMode(int gameCpu) { (void)gameCpu; TraceLog(LOG_WARNING, "CABINET: Not supported on this platform"); return false; }
+void EnterCabinetGameThread(void) { }
+void CloseCabinetMode(void) { }
+
+#endif
@@ -0,0 +1,45 @@
+/*******************************************************************************************
+*
+*   C-volley - cabinet mode: real-time scheduling and jitter isolation
+*
+*   Dedicated machines should never drop a frame to the scheduler or a page fault. Cabinet
+*   mode splits the CPUs in two: the game thread gets one core to itself (the first of the
+*   kernel's isolated CPUs, isolcpus=, or else the last CPU we may run on) at SCHED_FIFO
+*   priority, everything else - raylib's audio thread, the effects mixer, software renderer
+*   workers, GPU driver threads - stays on the remaining cores. All memory is locked
+*   (mlockall), so assets and arenas loaded at start are resident, and the stack and heap
+*   are prefaulted with the allocator told never to hand memory back.
+*
+*   Every step is optional: without CAP_SYS_NICE / CAP_IPC_LOCK (or a large enough
+*   RLIMIT_MEMLOCK) it logs what it could not do and the game runs as before.
+*
+*   The frame jitter histogram (frame to frame intervals) works anywhere, with or without
+*   cabinet mode, so both can be compared.
+*
+*   Linux only for the scheduling part; InitCabinetMode() returns false elsewhere.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef CABINET_H
+#define CABINET_H
+
+#include <stdbool.h>
+
+#define CABINET_GAME_PRIORITY 60        // SCHED_FIFO, below the effects mixer thread (70)
+#define JITTER_BIN_MS 0.1
+#define JITTER_BINS 500                 // Intervals up to 50 ms, longer ones go to the last bin
+
+// Before InitWindow(): moves the calling thread, and so every thread it starts, off the game
+// core. gameCpu < 0 picks one. With a single CPU only the memory part is done later
+bool InitCabinetMode(int gameCpu);
+
+// After the assets are loaded: locks and prefaults memory, pins the calling (game) thread
+// to its core at real-time priority
+void EnterCabinetGameThread(void);
+void CloseCabinetMode(void);
+
+void RecordFrameJitter(double targetFps);                   // Once per frame, after EndDrawing()
+void CloseFrameJitter(const char *fileName);                // Logs a summary, writes the histogram (CSV) if fileName is set
+
+#endif // CABINET_H
@@ -0,0 +1,247 @@
+/*******************************************************************************************
+*
+*   C-volley - imitation learning dataset shards
+*
+*   A shard is assembled in memory and written in one go when it is full (or on close), so
+*   live recording costs a few stores per frame and one ~5 MB write every 18 minutes of play.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "dataset.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGN_UP(x) (((x) + DATASET_ALIGNMENT - 1)/DATASET_ALIGNMENT*DATASET_ALIGNMENT)
+
+#define FEATURES_OFFSET ALIGN_UP(sizeof(DatasetShardHeader))
+#define ACTIONS_OFFSET (FEATURES_OFFSET + ALIGN_UP((size_t)DATASET_SHARD_RECORDS*DATASET_FEATURES*sizeof(float)))
+#define INDEX_OFFSET (ACTIONS_OFFSET + ALIGN_UP((size_t)DATASET_SHARD_RECORDS*2))
+#define SHARD_SIZE (INDEX_OFFSET + ALIGN_UP((size_t)DATASET_SHARD_MATCHES*sizeof(DatasetMatch)))
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+// Takes a zeroed shard image
+static void AttachShard(DatasetWriter *writer, uint8_t *shard)
+{
+    writer->shard = shard;
+    writer->header = (DatasetShardHeader *)shard;
+    writer->features = (float *)(shard + FEATURES_OFFSET);
+    writer->actions = shard + ACTIONS_OFFSET;
+    writer->index = (DatasetMatch *)(shard + INDEX_OFFSET);
+
+    DatasetShardHeader *header = writer->header;
+    memcpy(header->magic, "CVDS", 4);
+    header->version = DATASET_VERSION;
+    header->featureCount = DATASET_FEATURES;
+    header->recordCapacity = DATASET_SHARD_RECORDS;
+    header->matchCapacity = DATASET_SHARD_MATCHES;
+    header->featuresOffset = FEATURES_OFFSET;
+    header->actionsOffset = ACTIONS_OFFSET;
+    header->indexOffset = INDEX_OFFSET;
+    header->fileSize = SHARD_SIZE;
+    strncpy(header->featureNames, DATASET_FEATURE_NAMES, sizeof(header->featureNames) - 1);
+}
+
+static void ResetShard(DatasetWriter *writer)
+{
+    memset(writer->shard, 0, SHARD_SIZE);
+    AttachShard(writer, writer->shard);
+}
+
+static void FlushShard(DatasetWriter *writer)
+{
+    // Nothing to write, but an index full of empty match parts still has to make room
+    if (writer->header->recordCount == 0)
+    {
+        if (writer->header->matchCount > 0) ResetShard(writer);
+        return;
+    }
+
+    char fileName[600];
+    snprintf(fileName, sizeof(fileName), "%s-%05d%s", writer->path, writer->shardIndex, DATASET_FILE_EXTENSION);
+
+    // Handed over whole, recording goes on in a fresh image: calloc() pages are zero already
+    // and only touched as records come in
+    if (writer->saveShard != NULL)
+    {
+        uint8_t *next = (uint8_t *)calloc(1, SHARD_SIZE);
+
+        if ((next != NULL) && writer->saveShard(fileName, writer->shard, (int)SHARD_SIZE))
+        {
+            AttachShard(writer, next);
+            writer->shardIndex++;
+            writer->shards++;
+            return;
+        }
+
+        free(next);
+    }
+
+    FILE *file = fopen(fileName, "wb");
+    bool written = (file != NULL) && (fwrite(writer->shard, SHARD_SIZE, 1, file) == 1);
+    if (file != NULL) written = (fclose(file) == 0) && written;
+
+    if (!written) writer->failed = true;
+
+    writer->shardIndex++;
+    writer->shards++;
+    ResetShard(writer);
+}
+
+// Index entry for the records that follow, the first part of a match or its continuation
+static void OpenMatchPart(DatasetWriter *writer, uint32_t firstTick)
+{
+    if (writer->header->matchCount >= DATASET_SHARD_MATCHES) FlushShard(writer);
+
+    DatasetShardHeader *header = writer->header;        // A new image after a flush
+    DatasetMatch *part = &writer->index[header->matchCount++];
+    part->matchId = writer->matchId;
+    part->firstRecord = header->recordCount;
+    part->firstTick = firstTick;
+    part->source[0] = writer->source[0];
+    part->source[1] = writer->source[1];
+    part->flags = writer->flags;
+
+    writer->current = part;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+bool DatasetWriterOpen(DatasetWriter *writer, const char *directory, const char *prefix)
+{
+    memset(writer, 0, sizeof(DatasetWriter));
+
+    writer->shard = (uint8_t *)malloc(SHARD_SIZE);
+    if (writer->shard == NULL) return false;
+
+    snprintf(writer->path, sizeof(writer->path), "%s/%s", directory, prefix);
+    ResetShard(writer);
+
+    return true;
+}
+
+bool DatasetWriterClose(DatasetWriter *writer)
+{
+    if (writer->shard == NULL) return false;
+
+    FlushShard(writer);
+    free(writer->shard);
+    writer->shard = NULL;
+
+    return !writer->failed;
+}
+
+static void BeginMatch(DatasetWriter *writer, uint32_t matchId, const unsigned char source[2], uint32_t flags)
+{
+    writer->matchId = matchId;
+    writer->source[0] = source[0];
+    writer->source[1] = source[1];
+    writer->flags = flags;
+    writer->matches++;
+
+    OpenMatchPart(writer, 0);
+}
+
+void DatasetBeginMatch(DatasetWriter *writer, uint32_t matchId, const unsigned char source[2])
+{
+    BeginMatch(writer, matchId, source, 0);
+}
+
+void DatasetRecord(DatasetWriter *writer, const SimState *state, const unsigned char actions[2])
+{
+    if (writer->current == NULL) return;
+
+    // Shard full: close this part of the match, it continues in the next shard
+    if (writer->header->recordCount >= DATASET_SHARD_RECORDS)
+    {
+        writer->current->score[0] = (uint8_t)state->blobs[0].score;
+        writer->current->score[1] = (uint8_t)state->blobs[1].score;
+        FlushShard(writer);
+        OpenMatchPart(writer, (uint32_t)state->tick);
+    }
+
+    uint32_t record = writer->header->recordCount++;
+    float *out = &writer->features[(size_t)record*DATASET_FEATURES];
+    const SimBall *ball = &state->ball;
+
+    out[0] = ball->position.x;
+    out[1] = ball->position.y;
+    out[2] = ball->velocity.x;
+    out[3] = ball->velocity.y;
+
+    for (int side = 0; side < 2; side++)
+    {
+        const SimBlob *blob = &state->blobs[side];
+        float *blobOut = &out[4 + side*5];
+
+        blobOut[0] = blob->position.x;
+        blobOut[1] = blob->position.y;
+        blobOut[2] = blob->velocity.x;
+        blobOut[3] = blob->velocity.y;
+        blobOut[4] = blob->onGround ? 1.0f : 0.0f;
+    }
+
+    out[14] = (float)state->blobs[0].score;
+    out[15] = (float)state->blobs[1].score;
+    out[16] = (float)state->servingSide;
+    out[17] = (float)state->scoreDelay;
+
+    writer->actions[record*2] = actions[0];
+    writer->actions[record*2 + 1] = actions[1];
+
+    writer->current->recordCount++;
+    writer->records++;
+}
+
+void DatasetEndMatch(DatasetWriter *writer, const SimState *final)
+{
+    if (writer->current == NULL) return;
+
+    writer->current->score[0] = (uint8_t)final->blobs[0].score;
+    writer->current->score[1] = (uint8_t)final->blobs[1].score;
+    writer->current = NULL;
+}
+
+int DatasetExportReplay(DatasetWriter *writer, const Replay *replay, uint32_t matchId, bool mirrored)
+{
+    SimState state = replay->start;
+    SimState view;
+
+    if (!mirrored) DatasetBeginMatch(writer, matchId, replay->source);
+    else
+    {
+        unsigned char source[2] = { replay->source[1], replay->source[0] };
+        BeginMatch(writer, matchId, source, DATASET_MATCH_MIRRORED);
+    }
+
+    for (int tick = 0; tick < replay->tickCount; tick++)
+    {
+        const unsigned char *actions = &replay->actions[tick*2];
+
+        // The replay is always simulated as played, only what is recorded is mirrored
+        if (!mirrored) DatasetRecord(writer, &state, actions);
+        else
+        {
+            unsigned char viewActions[2] = { SimMirrorAction(actions[1]), SimMirrorAction(actions[0]) };
+            SimMirror(&state, &view);
+            DatasetRecord(writer, &view, viewActions);
+        }
+
+        SimStep(&state, actions);
+    }
+
+    if (mirrored)
+    {
+        SimMirror(&state, &view);
+        state = view;
+    }
+    DatasetEndMatch(writer, &state);
+
+    return replay->tickCount;
+}
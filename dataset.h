@@ -0,0 +1,118 @@
+/*******************************************************************************************
+*
+*   C-volley - imitation learning dataset shards
+*
+*   Aligned (state, action) records: the state a tick starts from and the two action bytes
+*   SimStep() was given for it. Records are written live from the game or by re-simulating
+*   replays, into fixed-size shard files that training code can memory-map as flat tensors:
+*
+*     offset 0               DatasetShardHeader (fixed-size fields, padded to 4 KB)
+*     featuresOffset         float32 features[recordCapacity][DATASET_FEATURES]
+*     actionsOffset          uint8   actions[recordCapacity][2]       left, right (ACTION_*)
+*     indexOffset            DatasetMatch index[matchCapacity]
+*
+*   Every shard has the same size and offsets (aligned to 4 KB), only recordCount/matchCount
+*   say how much is filled. The index lists the records of each match in the shard; a match
+*   that does not fit continues in the next shard with firstTick > 0. Sides played by the
+*   built-in AI have ACTION_AI as action, use DatasetMatch.source to pick the human ones.
+*   Mirrored matches (DATASET_MATCH_MIRRORED) are a replay seen from the other side of the net
+*   (SimMirror()): sides, sources, scores and actions swapped, same match id.
+*
+*   Host byte order (all supported targets are little-endian).
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "replay.h"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define DATASET_VERSION 1
+#define DATASET_FEATURES 18
+#define DATASET_SHARD_RECORDS 65536         // 18 minutes of play
+#define DATASET_SHARD_MATCHES 1024
+#define DATASET_ALIGNMENT 4096
+#define DATASET_FILE_EXTENSION ".cvds"
+
+// DatasetMatch.flags
+#define DATASET_MATCH_MIRRORED 0x01
+
+// Column order of features[][], also stored in the header
+#define DATASET_FEATURE_NAMES "ball_x,ball_y,ball_vx,ball_vy," \
+    "left_x,left_y,left_vx,left_vy,left_on_ground,right_x,right_y,right_vx,right_vy,right_on_ground," \
+    "left_score,right_score,serving_side,score_delay"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct DatasetShardHeader {
+    char magic[4];              // "CVDS"
+    uint32_t version;
+    uint32_t featureCount;
+    uint32_t recordCapacity;
+    uint32_t recordCount;
+    uint32_t matchCapacity;
+    uint32_t matchCount;
+    uint32_t reserved;
+    uint64_t featuresOffset;
+    uint64_t actionsOffset;
+    uint64_t indexOffset;
+    uint64_t fileSize;
+    char featureNames[448];     // DATASET_FEATURE_NAMES, zero terminated
+} DatasetShardHeader;
+
+typedef struct DatasetMatch {
+    uint32_t matchId;
+    uint32_t firstRecord;       // Into this shard's features/actions
+    uint32_t recordCount;
+    uint32_t firstTick;         // Tick the first record starts from, > 0 for a continued match
+    uint8_t source[2];          // REPLAY_SOURCE_* per side
+    uint8_t score[2];           // After the last record of this part
+    uint32_t flags;             // DATASET_MATCH_*, 0 in version 1 shards written before it existed
+} DatasetMatch;
+
+// Takes a full shard image (malloc) and writes it later, false: the writer writes it itself
+typedef bool (*DatasetSaveShardFunc)(const char *fileName, uint8_t *shard, int size);
+
+typedef struct DatasetWriter {
+    char path[512];             // Directory and file name prefix
+    int shardIndex;
+    uint8_t *shard;             // Image of the shard being filled
+    DatasetShardHeader *header;
+    float *features;
+    uint8_t *actions;
+    DatasetMatch *index;
+    DatasetMatch *current;      // Part of the running match in this shard, NULL between matches
+    uint32_t matchId;
+    unsigned char source[2];
+    uint32_t flags;             // DATASET_MATCH_* of the running match
+    uint64_t records;           // Totals over all shards
+    uint64_t matches;
+    int shards;
+    bool failed;                // A shard could not be written
+    DatasetSaveShardFunc saveShard;     // NULL: written with stdio by the recording thread
+} DatasetWriter;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+
+// Shards go to <directory>/<prefix>-00000.cvds, -00001.cvds, ...
+bool DatasetWriterOpen(DatasetWriter *writer, const char *directory, const char *prefix);
+bool DatasetWriterClose(DatasetWriter *writer);            // Writes the last, partly filled shard
+
+void DatasetBeginMatch(DatasetWriter *writer, uint32_t matchId, const unsigned char source[2]);
+void DatasetRecord(DatasetWriter *writer, const SimState *state, const unsigned char actions[2]);   // Before SimStep()
+void DatasetEndMatch(DatasetWriter *writer, const SimState *final);
+
+// Re-simulates a replay into records, returns how many. Mirrored records it as seen from the
+// other side (DATASET_MATCH_MIRRORED), doubling the data for side-symmetric training
+int DatasetExportReplay(DatasetWriter *writer, const Replay *replay, uint32_t matchId, bool mirrored);
+
+#endif // DATASET_H
@@ -0,0 +1,146 @@
+/*******************************************************************************************
+*
+*   C-volley - convert replay archives into imitation learning dataset shards
+*
+*   Usage:
+*     dataset_export OUTDIR [--threads N] [--prefix NAME] [--mirror] REPLAY...
+*
+*   Each worker thread takes the next replay from the list, re-simulates it and appends its
+*   records to its own shard sequence (OUTDIR/NAME-tNN-00000.cvds, ...), so workers never
+*   share a shard and need no locking. The match id of a replay is its position in the list.
+*   See dataset.h for the shard layout.
+*
+*   --mirror also writes every replay seen from the other side of the net, right after it
+*   and under the same match id (DATASET_MATCH_MIRRORED): twice the records for policies that
+*   play in a side-canonical frame, at the cost of a second re-simulation.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "dataset.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS 256
+
+typedef struct Worker {
+    pthread_t thread;
+    int index;
+    DatasetWriter writer;
+    int failedReplays;
+    bool openFailed;
+} Worker;
+
+static const char *outputDirectory = NULL;
+static const char *prefix = "replays";
+static char **replayFiles = NULL;
+static int replayCount = 0;
+static int nextReplay = 0;      // Shared work counter
+static bool mirror = false;
+
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec*1e-9;
+}
+
+static void *WorkerThread(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+
+    char shardPrefix[256];
+    snprintf(shardPrefix, sizeof(shardPrefix), "%s-t%02d", prefix, worker->index);
+    if (!DatasetWriterOpen(&worker->writer, outputDirectory, shardPrefix))
+    {
+        fprintf(stderr, "dataset_export: worker %d could not allocate a shard\n", worker->index);
+        worker->openFailed = true;
+        return NULL;
+    }
+
+    for (;;)
+    {
+        int i = __atomic_fetch_add(&nextReplay, 1, __ATOMIC_RELAXED);
+        if (i >= replayCount) break;
+
+        Replay replay;
+        if (!ReplayLoad(&replay, replayFiles[i]))
+        {
+            fprintf(stderr, "dataset_export: could not read replay %s\n", replayFiles[i]);
+            worker->failedReplays++;
+            continue;
+        }
+
+        DatasetExportReplay(&worker->writer, &replay, (uint32_t)i, false);
+        if (mirror) DatasetExportReplay(&worker->writer, &replay, (uint32_t)i, true);
+        ReplayFree(&replay);
+    }
+
+    if (!DatasetWriterClose(&worker->writer)) fprintf(stderr, "dataset_export: could not write all shards of worker %d\n", worker->index);
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    static Worker workers[MAX_THREADS];
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    replayFiles = (char **)malloc(sizeof(char *)*argc);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) threads = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--prefix") == 0) && (i + 1 < argc)) prefix = argv[++i];
+        else if (strcmp(argv[i], "--mirror") == 0) mirror = true;
+        else if (outputDirectory == NULL) outputDirectory = argv[i];
+        else replayFiles[replayCount++] = argv[i];
+    }
+
+    if ((outputDirectory == NULL) || (replayCount == 0))
+    {
+        fprintf(stderr, "usage: %s OUTDIR [--threads N] [--prefix NAME] [--mirror] REPLAY...\n", argv[0]);
+        return 1;
+    }
+
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    if (threads > replayCount) threads = replayCount;
+
+    double start = NowSeconds();
+
+    for (int i = 0; i < threads; i++)
+    {
+        workers[i].index = i;
+        pthread_create(&workers[i].thread, NULL, WorkerThread, &workers[i]);
+    }
+
+    uint64_t records = 0;
+    uint64_t matches = 0;
+    int shards = 0;
+    int failed = 0;
+
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        records += workers[i].writer.records;
+        matches += workers[i].writer.matches;
+        shards += workers[i].writer.shards;
+        failed += workers[i].failedReplays + (workers[i].writer.failed ? 1 : 0) + (workers[i].openFailed ? 1 : 0);
+    }
+
+    double seconds = NowSeconds() - start;
+
+    printf("%llu matches, %llu records into %d shards in %.3f s with %d threads: %.0f matches/s, %.2f M records/s\n",
+           (unsigned long long)matches, (unsigned long long)records, shards, seconds, threads,
+           matches/seconds, records/seconds/1e6);
+
+    free(replayFiles);
+
+    return (failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,940 @@
+/*******************************************************************************************
+*
+*   C-volley - distributed self-play coordinator and workers (POSIX)
+*
+*   Usage:
+*     distsim coordinator ADDRESS [matches] [--unit N] [--pairings LIST] [--seed N]
+*                                 [--timeout S] [--idle-serve] [--skip-dead-time]
+*     distsim worker ADDRESS [--procs N] [--lanes N]
+*     distsim local WORKERS [matches] [--kill N] [--scale] [coordinator options]
+*
+*   ADDRESS is unix:PATH or tcp:HOST:PORT, the coordinator listens there and workers connect.
+*
+*   The coordinator cuts the matches into work units of --unit consecutive matches, each
+*   with the seed and an agent pairing (--pairings ss,sa,as,aa: scripted or AI per side,
+*   cycled over the units), and hands them out on demand. Every worker keeps WORK_PREFETCH
+*   units queued so it never waits for the next one. Workers are single threaded processes
+*   playing a unit on their lanes (selfplay.h) and sending back one record per match, so a
+*   node runs one worker per core (--procs) and adding workers adds matches/second.
+*
+*   Fault tolerance: a worker that disconnects, breaks the protocol or holds a unit longer
+*   than --timeout seconds without reporting is dropped and its units go back to the queue.
+*   Once the queue is empty, idle workers also get a second copy of a unit still in flight,
+*   so one slow worker does not hold up the end of the run. Results are deterministic, the
+*   first copy of a unit to come back counts and later ones are ignored. The checksum is the
+*   one batchsim prints for the same matches.
+*
+*   local listens on a Unix socket and forks WORKERS worker processes on this machine,
+*   --kill N SIGKILLs N of them once a quarter of the units is done, --scale repeats the
+*   run with 1, 2, 4 ... workers and prints the speedup.
+*
+*   Messages are a uint32 type and uint32 payload size followed by the payload, host byte
+*   order (all supported targets are little-endian), see the Wire* structures.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include "selfplay.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WIRE_VERSION 1
+#define WORK_PREFETCH 2                 // Units queued per worker
+#define MAX_CONNECTIONS 1024
+#define MAX_PROCS 1024
+#define MAX_UNIT_MATCHES 65536
+#define CONNECT_RETRY_SECONDS 10.0
+#define DEFAULT_UNIT_MATCHES 50
+#define DEFAULT_TIMEOUT_SECONDS 60.0
+
+typedef enum { MSG_HELLO = 1, MSG_UNIT, MSG_RESULTS, MSG_DONE } MessageType;
+
+// Called by the coordinator whenever a unit completes (local runs)
+typedef void (*ProgressCallback)(void);
+
+//----------------------------------------------------------------------------------
+// Wire format
+//----------------------------------------------------------------------------------
+typedef struct WireHeader {
+    uint32_t type;
+    uint32_t size;              // Payload bytes after the header
+} WireHeader;
+
+// Worker -> coordinator, once after connecting
+typedef struct WireHello {
+    uint32_t version;
+    uint32_t pid;
+    char host[64];
+} WireHello;
+
+// Coordinator -> worker
+typedef struct WireUnit {
+    uint32_t unit;
+    uint32_t firstMatch;
+    uint32_t matchCount;
+    uint32_t seed;
+    uint8_t agents[2];          // AGENT_* per side
+    uint8_t idleServe;
+    uint8_t skipDeadTime;
+} WireUnit;
+
+// Worker -> coordinator, followed by matchCount WireMatch records
+typedef struct WireResults {
+    uint32_t unit;
+    uint32_t matchCount;
+    uint64_t steps;
+} WireResults;
+
+typedef struct WireMatch {
+    uint32_t match;
+    MatchResult result;
+} WireMatch;
+
+//----------------------------------------------------------------------------------
+// Coordinator state
+//----------------------------------------------------------------------------------
+typedef struct Unit {
+    WireUnit wire;
+    bool done;
+    int copies;                 // Workers currently holding it
+} Unit;
+
+typedef struct Connection {
+    int fd;
+    bool hello;
+    char host[64];
+    uint32_t pid;
+    int inFlight[WORK_PREFETCH];
+    int inFlightCount;
+    double lastProgress;        // Unit handed out or results received
+    uint8_t *buffer;            // Partly received message
+    size_t used, capacity;
+} Connection;
+
+typedef struct CoordinatorConfig {
+    int matches;
+    int unitMatches;
+    char pairings[16][2];       // Cycled over the units
+    int pairingCount;
+    uint32_t seed;
+    double timeout;
+    bool idleServe;
+    bool skipDeadTime;
+} CoordinatorConfig;
+
+typedef struct RunStats {
+    int workersSeen;
+    int workersLost;
+    int requeued;               // Units handed out again after a worker was lost
+    int duplicates;             // Results of units that were already done
+    uint64_t steps;
+    uint64_t checksum;
+    double seconds;
+} RunStats;
+
+static CoordinatorConfig config = { 0 };
+static Unit *units = NULL;
+static int unitCount = 0;
+static int unitsDone = 0;
+static int *pending = NULL;     // Stack of units to hand out, requeued ones on top
+static int pendingCount = 0;
+static Connection connections[MAX_CONNECTIONS];
+static int connectionCount = 0;
+static RunStats stats = { 0 };
+
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec*1e-9;
+}
+
+//----------------------------------------------------------------------------------
+// Sockets
+//----------------------------------------------------------------------------------
+
+// unix:PATH or tcp:HOST:PORT into a socket address, returns the address length or 0
+static socklen_t ParseAddress(const char *address, struct sockaddr_storage *storage, int *family)
+{
+    memset(storage, 0, sizeof(*storage));
+
+    if (strncmp(address, "unix:", 5) == 0)
+    {
+        struct sockaddr_un *local = (struct sockaddr_un *)storage;
+        if (strlen(address + 5) >= sizeof(local->sun_path)) return 0;
+
+        local->sun_family = AF_UNIX;
+        strcpy(local->sun_path, address + 5);
+        *family = AF_UNIX;
+        return sizeof(struct sockaddr_un);
+    }
+
+    if (strncmp(address, "tcp:", 4) != 0) return 0;
+
+    char host[256];
+    snprintf(host, sizeof(host), "%s", address + 4);
+    char *port = strrchr(host, ':');
+    if (port == NULL) return 0;
+    *port++ = '\0';
+
+    struct addrinfo hints = { 0 }, *info = NULL;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    if (getaddrinfo((host[0] != '\0') ? host : NULL, port, &hints, &info) != 0) return 0;
+
+    socklen_t length = info->ai_addrlen;
+    memcpy(storage, info->ai_addr, length);
+    *family = info->ai_family;
+    freeaddrinfo(info);
+
+    return length;
+}
+
+static int Listen(const char *address)
+{
+    struct sockaddr_storage storage;
+    int family = 0;
+    socklen_t length = ParseAddress(address, &storage, &family);
+    if (length == 0) return -1;
+
+    int fd = socket(family, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    if (family == AF_UNIX) unlink(((struct sockaddr_un *)&storage)->sun_path);
+    else setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &(int){ 1 }, sizeof(int));
+
+    if ((bind(fd, (struct sockaddr *)&storage, length) != 0) || (listen(fd, 128) != 0))
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// Retries for a while so workers can be started before the coordinator
+static int Connect(const char *address)
+{
+    struct sockaddr_storage storage;
+    int family = 0;
+    socklen_t length = ParseAddress(address, &storage, &family);
+    if (length == 0) return -1;
+
+    double giveUp = NowSeconds() + CONNECT_RETRY_SECONDS;
+
+    for (;;)
+    {
+        int fd = socket(family, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+
+        if (connect(fd, (struct sockaddr *)&storage, length) == 0)
+        {
+            if (family != AF_UNIX) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &(int){ 1 }, sizeof(int));
+            return fd;
+        }
+
+        close(fd);
+        if (NowSeconds() > giveUp) return -1;
+        usleep(50000);
+    }
+}
+
+static bool WriteAll(int fd, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    while (size > 0)
+    {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        bytes += written;
+        size -= (size_t)written;
+    }
+
+    return true;
+}
+
+static bool ReadAll(int fd, void *data, size_t size)
+{
+    uint8_t *bytes = (uint8_t *)data;
+
+    while (size > 0)
+    {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (got == 0) return false;
+
+        bytes += got;
+        size -= (size_t)got;
+    }
+
+    return true;
+}
+
+// Header and payload in one write, so small messages go out as one segment
+static bool SendMessage(int fd, MessageType type, const void *payload, uint32_t size, const void *extra, uint32_t extraSize)
+{
+    uint8_t stack[256];
+    size_t total = sizeof(WireHeader) + size + extraSize;
+    uint8_t *message = (total <= sizeof(stack)) ? stack : (uint8_t *)malloc(total);
+    if (message == NULL) return false;
+
+    WireHeader header = { (uint32_t)type, size + extraSize };
+    memcpy(message, &header, sizeof(header));
+    if (size > 0) memcpy(message + sizeof(header), payload, size);
+    if (extraSize > 0) memcpy(message + sizeof(header) + size, extra, extraSize);
+
+    bool sent = WriteAll(fd, message, total);
+    if (message != stack) free(message);
+
+    return sent;
+}
+
+//----------------------------------------------------------------------------------
+// Worker
+//----------------------------------------------------------------------------------
+static WireMatch *PlayUnit(const WireUnit *unit, int maxLanes, uint64_t *steps)
+{
+    SelfPlayConfig play = { 0 };
+    play.seed = unit->seed;
+    // Workers load no plug-ins, only scripted players and the built-in AI travel over the wire
+    play.agents[0] = (unit->agents[0] == AGENT_AI) ? AGENT_AI : AGENT_SCRIPTED;
+    play.agents[1] = (unit->agents[1] == AGENT_AI) ? AGENT_AI : AGENT_SCRIPTED;
+    play.idleServe = unit->idleServe;
+    play.skipDeadTime = unit->skipDeadTime;
+
+    int matchCount = (int)unit->matchCount;
+    int laneCount = ((maxLanes > 0) && (maxLanes < matchCount)) ? maxLanes : matchCount;
+    SelfPlayLane *lanes = (SelfPlayLane *)malloc(sizeof(SelfPlayLane)*laneCount);
+    WireMatch *records = (WireMatch *)malloc(sizeof(WireMatch)*matchCount);
+    if ((lanes == NULL) || (records == NULL))
+    {
+        free(lanes);
+        free(records);
+        return NULL;
+    }
+
+    int nextMatch = 0;
+    for (int i = 0; i < laneCount; i++) SelfPlayStart(&lanes[i], &play, (int)unit->firstMatch + nextMatch++);
+
+    uint64_t skipped = 0;
+    int active = laneCount;
+    *steps = 0;
+
+    while (active > 0)
+    {
+        for (int i = 0; i < active; i++)
+        {
+            SelfPlayLane *lane = &lanes[i];
+            *steps += SelfPlayStep(lane, &play, &skipped);
+
+            if (!SelfPlayDone(lane)) continue;
+
+            WireMatch *record = &records[lane->match - (int)unit->firstMatch];
+            record->match = (uint32_t)lane->match;
+            record->result = SelfPlayResult(lane);
+
+            if (nextMatch < matchCount) SelfPlayStart(lane, &play, (int)unit->firstMatch + nextMatch++);
+            else
+            {
+                *lane = lanes[--active];
+                i--;
+            }
+        }
+    }
+
+    free(lanes);
+
+    return records;
+}
+
+// Plays units until the coordinator says done, returns the process exit code
+static int RunWorker(const char *address, int maxLanes)
+{
+    int fd = Connect(address);
+    if (fd < 0)
+    {
+        fprintf(stderr, "distsim: worker %d could not connect to %s\n", (int)getpid(), address);
+        return 1;
+    }
+
+    WireHello hello = { 0 };
+    hello.version = WIRE_VERSION;
+    hello.pid = (uint32_t)getpid();
+    gethostname(hello.host, sizeof(hello.host) - 1);
+
+    if (!SendMessage(fd, MSG_HELLO, &hello, sizeof(hello), NULL, 0))
+    {
+        close(fd);
+        return 1;
+    }
+
+    int units = 0;
+
+    for (;;)
+    {
+        WireHeader header;
+        WireUnit unit;
+
+        if (!ReadAll(fd, &header, sizeof(header))) break;       // Coordinator gone
+        if (header.type == MSG_DONE)
+        {
+            close(fd);
+            return 0;
+        }
+
+        if ((header.type != MSG_UNIT) || (header.size != sizeof(unit)) || !ReadAll(fd, &unit, sizeof(unit)) ||
+            (unit.matchCount == 0) || (unit.matchCount > MAX_UNIT_MATCHES)) break;
+
+        uint64_t steps = 0;
+        WireMatch *records = PlayUnit(&unit, maxLanes, &steps);
+        if (records == NULL) break;
+
+        WireResults results = { unit.unit, unit.matchCount, steps };
+        bool sent = SendMessage(fd, MSG_RESULTS, &results, sizeof(results), records, (uint32_t)(sizeof(WireMatch)*unit.matchCount));
+        free(records);
+
+        // The coordinator may already be done with a second copy of this unit, its stop
+        // message is still there to read
+        if (sent) units++;
+    }
+
+    fprintf(stderr, "distsim: worker %d lost the coordinator after %d units\n", (int)getpid(), units);
+    close(fd);
+
+    return 1;
+}
+
+//----------------------------------------------------------------------------------
+// Coordinator
+//----------------------------------------------------------------------------------
+static void CreateUnits(void)
+{
+    unitCount = (config.matches + config.unitMatches - 1)/config.unitMatches;
+    units = (Unit *)calloc(unitCount, sizeof(Unit));
+    pending = (int *)malloc(sizeof(int)*unitCount);
+
+    for (int i = 0; i < unitCount; i++)
+    {
+        WireUnit *wire = &units[i].wire;
+        const char *pairing = config.pairings[i%config.pairingCount];
+
+        wire->unit = (uint32_t)i;
+        wire->firstMatch = (uint32_t)(i*config.unitMatches);
+        wire->matchCount = (uint32_t)(((i + 1)*config.unitMatches <= config.matches) ? config.unitMatches : config.matches - i*config.unitMatches);
+        wire->seed = config.seed;
+        wire->agents[0] = (pairing[0] == 'a') ? AGENT_AI : AGENT_SCRIPTED;
+        wire->agents[1] = (pairing[1] == 'a') ? AGENT_AI : AGENT_SCRIPTED;
+        wire->idleServe = config.idleServe;
+        wire->skipDeadTime = config.skipDeadTime;
+
+        pending[i] = unitCount - 1 - i;     // Unit 0 on top of the stack
+    }
+
+    unitsDone = 0;
+    pendingCount = unitCount;
+}
+
+static void FreeUnits(void)
+{
+    free(units);
+    free(pending);
+    units = NULL;
+    pending = NULL;
+}
+
+static void DropConnection(int index, const char *reason)
+{
+    Connection *connection = &connections[index];
+
+    if (connection->hello) fprintf(stderr, "distsim: lost worker %s/%u (%s), requeueing %d units\n",
+                                   connection->host, connection->pid, reason, connection->inFlightCount);
+
+    for (int i = 0; i < connection->inFlightCount; i++)
+    {
+        Unit *unit = &units[connection->inFlight[i]];
+        unit->copies--;
+
+        // Still held by another worker (second copy): no need to queue it again
+        if (!unit->done && (unit->copies == 0))
+        {
+            pending[pendingCount++] = connection->inFlight[i];
+            stats.requeued++;
+        }
+    }
+
+    if (connection->hello) stats.workersLost++;
+
+    close(connection->fd);
+    free(connection->buffer);
+    connections[index] = connections[--connectionCount];
+}
+
+// A unit nobody else holds from the queue, or once it is empty a second copy of one in flight
+static int NextUnit(const Connection *connection)
+{
+    while (pendingCount > 0)
+    {
+        int unit = pending[--pendingCount];
+        if (!units[unit].done) return unit;
+    }
+
+    if (connection->inFlightCount > 0) return -1;
+
+    for (int i = 0; i < unitCount; i++)
+    {
+        if (!units[i].done && (units[i].copies == 1)) return i;
+    }
+
+    return -1;
+}
+
+static bool FillConnection(Connection *connection)
+{
+    while (connection->inFlightCount < WORK_PREFETCH)
+    {
+        int unit = NextUnit(connection);
+        if (unit < 0) break;
+
+        if (!SendMessage(connection->fd, MSG_UNIT, &units[unit].wire, sizeof(WireUnit), NULL, 0))
+        {
+            if (units[unit].copies == 0) pending[pendingCount++] = unit;
+            return false;
+        }
+
+        units[unit].copies++;
+        connection->inFlight[connection->inFlightCount++] = unit;
+        connection->lastProgress = NowSeconds();
+    }
+
+    return true;
+}
+
+static bool HandleResults(Connection *connection, const uint8_t *payload, uint32_t size)
+{
+    WireResults results;
+    if (size < sizeof(results)) return false;
+    memcpy(&results, payload, sizeof(results));
+
+    int slot = -1;
+    for (int i = 0; i < connection->inFlightCount; i++)
+    {
+        if (connection->inFlight[i] == (int)results.unit) slot = i;
+    }
+
+    if (slot < 0) return false;     // Never handed to this worker
+
+    Unit *unit = &units[results.unit];
+    if ((results.matchCount != unit->wire.matchCount) || (size != sizeof(results) + sizeof(WireMatch)*results.matchCount)) return false;
+
+    connection->inFlight[slot] = connection->inFlight[--connection->inFlightCount];
+    connection->lastProgress = NowSeconds();
+    unit->copies--;
+
+    if (unit->done)
+    {
+        stats.duplicates++;
+        return true;
+    }
+
+    const uint8_t *records = payload + sizeof(results);
+    uint64_t checksum = 0;
+
+    for (uint32_t i = 0; i < results.matchCount; i++)
+    {
+        WireMatch record;
+        memcpy(&record, records + i*sizeof(WireMatch), sizeof(record));
+        if (record.match != unit->wire.firstMatch + i) return false;
+
+        checksum += SelfPlayResultHash((int)record.match, record.result);
+    }
+
+    stats.checksum += checksum;
+
+    unit->done = true;
+    unitsDone++;
+    stats.steps += results.steps;
+
+    return true;
+}
+
+// Handles every complete message in the buffer, false on a protocol error
+static bool HandleMessages(Connection *connection)
+{
+    size_t offset = 0;
+
+    while (connection->used - offset >= sizeof(WireHeader))
+    {
+        WireHeader header;
+        memcpy(&header, connection->buffer + offset, sizeof(header));
+        if (header.size > sizeof(WireResults) + sizeof(WireMatch)*MAX_UNIT_MATCHES) return false;
+        if (connection->used - offset < sizeof(header) + header.size) break;
+
+        const uint8_t *payload = connection->buffer + offset + sizeof(header);
+        offset += sizeof(header) + header.size;
+
+        if ((header.type == MSG_HELLO) && !connection->hello && (header.size == sizeof(WireHello)))
+        {
+            WireHello hello;
+            memcpy(&hello, payload, sizeof(hello));
+            if (hello.version != WIRE_VERSION) return false;
+
+            connection->hello = true;
+            connection->pid = hello.pid;
+            memcpy(connection->host, hello.host, sizeof(connection->host));
+            connection->host[sizeof(connection->host) - 1] = '\0';
+            stats.workersSeen++;
+        }
+        else if ((header.type == MSG_RESULTS) && connection->hello)
+        {
+            if (!HandleResults(connection, payload, header.size)) return false;
+        }
+        else return false;
+    }
+
+    memmove(connection->buffer, connection->buffer + offset, connection->used - offset);
+    connection->used -= offset;
+
+    return true;
+}
+
+static bool ReceiveFrom(Connection *connection)
+{
+    if (connection->capacity - connection->used < 65536)
+    {
+        size_t capacity = (connection->capacity > 0) ? connection->capacity*2 : 131072;
+        uint8_t *grown = (uint8_t *)realloc(connection->buffer, capacity);
+        if (grown == NULL) return false;
+
+        connection->buffer = grown;
+        connection->capacity = capacity;
+    }
+
+    ssize_t got = read(connection->fd, connection->buffer + connection->used, connection->capacity - connection->used);
+    if (got <= 0) return (got < 0) && (errno == EINTR);
+
+    connection->used += (size_t)got;
+
+    return HandleMessages(connection);
+}
+
+static void AcceptWorker(int listener)
+{
+    int fd = accept(listener, NULL, NULL);
+    if (fd < 0) return;
+
+    if (connectionCount >= MAX_CONNECTIONS)
+    {
+        close(fd);
+        return;
+    }
+
+    // A worker that stops reading must not block the coordinator
+    struct timeval sendTimeout = { 2, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &(int){ 1 }, sizeof(int));      // Fails harmlessly on Unix sockets
+
+    Connection *connection = &connections[connectionCount++];
+    memset(connection, 0, sizeof(Connection));
+    connection->fd = fd;
+    connection->lastProgress = NowSeconds();
+}
+
+// Hands out all units over the listening socket, returns false if interrupted
+static bool RunCoordinator(int listener, ProgressCallback onProgress)
+{
+    struct pollfd fds[MAX_CONNECTIONS + 1];
+
+    memset(&stats, 0, sizeof(stats));
+    CreateUnits();
+    double start = NowSeconds();
+
+    while (unitsDone < unitCount)
+    {
+        fds[0].fd = listener;
+        fds[0].events = POLLIN;
+        for (int i = 0; i < connectionCount; i++)
+        {
+            fds[i + 1].fd = connections[i].fd;
+            fds[i + 1].events = POLLIN;
+        }
+
+        int polled = connectionCount;
+        if ((poll(fds, polled + 1, 100) < 0) && (errno != EINTR)) return false;
+
+        // Backwards, dropping moves the last connection into the freed slot
+        for (int i = polled - 1; i >= 0; i--)
+        {
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            int done = unitsDone;
+            if (!ReceiveFrom(&connections[i])) DropConnection(i, "disconnected or bad message");
+            else if ((unitsDone > done) && (onProgress != NULL)) onProgress();
+        }
+
+        if (fds[0].revents & POLLIN) AcceptWorker(listener);
+
+        double now = NowSeconds();
+        for (int i = connectionCount - 1; i >= 0; i--)
+        {
+            Connection *connection = &connections[i];
+
+            if ((connection->inFlightCount > 0) && (now - connection->lastProgress > config.timeout)) DropConnection(i, "timed out");
+            else if (connection->hello && !FillConnection(connection)) DropConnection(i, "send failed");
+        }
+    }
+
+    stats.seconds = NowSeconds() - start;
+
+    // Workers still holding a copy of a finished unit just get told to stop
+    for (int i = 0; i < connectionCount; i++)
+    {
+        SendMessage(connections[i].fd, MSG_DONE, NULL, 0, NULL, 0);
+        close(connections[i].fd);
+        free(connections[i].buffer);
+    }
+    connectionCount = 0;
+
+    FreeUnits();
+
+    return true;
+}
+
+static void PrintStats(void)
+{
+    printf("%d matches in %.3f s with %d workers: %.0f matches/s, %.2f M steps/s, checksum %016llx\n", config.matches,
+           stats.seconds, stats.workersSeen, config.matches/stats.seconds, stats.steps/stats.seconds/1e6,
+           (unsigned long long)stats.checksum);
+
+    if ((stats.workersLost > 0) || (stats.requeued > 0) || (stats.duplicates > 0))
+    {
+        printf("lost %d workers, requeued %d units, %d duplicate results ignored\n", stats.workersLost, stats.requeued, stats.duplicates);
+    }
+}
+
+//----------------------------------------------------------------------------------
+// Local runs
+//----------------------------------------------------------------------------------
+static pid_t localWorkers[MAX_PROCS];
+static int localWorkerCount = 0;
+static int localListener = -1;
+static int killCount = 0;
+static int unitsBeforeKill = 0;
+
+static void KillSomeWorkers(void)
+{
+    if ((killCount <= 0) || (unitsDone < unitsBeforeKill)) return;
+
+    for (int i = 0; (i < killCount) && (i < localWorkerCount); i++)
+    {
+        kill(localWorkers[i], SIGKILL);
+        printf("killed worker %d\n", (int)localWorkers[i]);
+    }
+
+    killCount = 0;
+}
+
+static pid_t SpawnWorker(const char *address, int maxLanes)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        if (localListener >= 0) close(localListener);
+        _exit(RunWorker(address, maxLanes));
+    }
+
+    return pid;
+}
+
+static void ReapWorkers(void)
+{
+    for (int i = 0; i < localWorkerCount; i++) waitpid(localWorkers[i], NULL, 0);
+    localWorkerCount = 0;
+}
+
+// One run with 'count' local worker processes, returns matches/second
+static double RunLocal(const char *address, int listener, int count, int kills)
+{
+    fflush(stdout);
+
+    for (int i = 0; i < count; i++) localWorkers[localWorkerCount++] = SpawnWorker(address, 0);
+
+    killCount = (kills < count) ? kills : count - 1;
+    unitsBeforeKill = ((config.matches + config.unitMatches - 1)/config.unitMatches)/4;
+
+    bool finished = RunCoordinator(listener, KillSomeWorkers);
+    ReapWorkers();
+
+    return finished ? config.matches/stats.seconds : 0;
+}
+
+//----------------------------------------------------------------------------------
+// Main
+//----------------------------------------------------------------------------------
+
+// "ss,sa,aa" into config.pairings
+static bool ParsePairings(const char *list)
+{
+    config.pairingCount = 0;
+
+    for (const char *p = list; *p; )
+    {
+        if ((config.pairingCount >= 16) || !((p[0] == 's') || (p[0] == 'a')) || !((p[1] == 's') || (p[1] == 'a'))) return false;
+
+        config.pairings[config.pairingCount][0] = p[0];
+        config.pairings[config.pairingCount][1] = p[1];
+        config.pairingCount++;
+
+        p += 2;
+        if (*p == ',') p++;
+        else if (*p != '\0') return false;
+    }
+
+    return (config.pairingCount > 0);
+}
+
+static int Usage(const char *program)
+{
+    fprintf(stderr, "usage: %s coordinator ADDRESS [matches] [--unit N] [--pairings ss,sa,as,aa] [--seed N]\n"
+                    "                          [--timeout S] [--idle-serve] [--skip-dead-time]\n"
+                    "       %s worker ADDRESS [--procs N] [--lanes N]\n"
+                    "       %s local WORKERS [matches] [--kill N] [--scale] [coordinator options]\n"
+                    "ADDRESS: unix:PATH or tcp:HOST:PORT\n", program, program, program);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) return Usage(argv[0]);
+
+    const char *mode = argv[1];
+    const char *target = argv[2];
+    int procs = 1;
+    int lanes = 0;
+    int kills = 0;
+    bool scale = false;
+    bool valid = true;
+
+    config.matches = 2000;
+    config.unitMatches = DEFAULT_UNIT_MATCHES;
+    config.timeout = DEFAULT_TIMEOUT_SECONDS;
+    ParsePairings("ss");
+
+    for (int i = 3; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--unit") == 0) && (i + 1 < argc)) config.unitMatches = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--pairings") == 0) && (i + 1 < argc)) valid = ParsePairings(argv[++i]) && valid;
+        else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) config.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if ((strcmp(argv[i], "--timeout") == 0) && (i + 1 < argc)) config.timeout = atof(argv[++i]);
+        else if ((strcmp(argv[i], "--procs") == 0) && (i + 1 < argc)) procs = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--lanes") == 0) && (i + 1 < argc)) lanes = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--kill") == 0) && (i + 1 < argc)) kills = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scale") == 0) scale = true;
+        else if (strcmp(argv[i], "--idle-serve") == 0) config.idleServe = true;
+        else if (strcmp(argv[i], "--skip-dead-time") == 0) config.skipDeadTime = true;
+        else if (argv[i][0] != '-') config.matches = atoi(argv[i]);
+        else valid = false;
+    }
+
+    if (!valid || (config.matches <= 0) || (config.unitMatches <= 0) || (config.unitMatches > MAX_UNIT_MATCHES) ||
+        (config.timeout <= 0) || (procs < 1) || (procs > MAX_PROCS)) return Usage(argv[0]);
+
+    // Writes to a dead peer fail with EPIPE instead of killing the process
+    signal(SIGPIPE, SIG_IGN);
+
+    if (strcmp(mode, "worker") == 0)
+    {
+        for (int i = 1; i < procs; i++) localWorkers[localWorkerCount++] = SpawnWorker(target, lanes);
+
+        int status = RunWorker(target, lanes);
+        ReapWorkers();
+        return status;
+    }
+
+    if (strcmp(mode, "coordinator") == 0)
+    {
+        int listener = Listen(target);
+        if (listener < 0)
+        {
+            fprintf(stderr, "distsim: could not listen on %s\n", target);
+            return 1;
+        }
+
+        printf("coordinator on %s: %d matches in units of %d\n", target, config.matches, config.unitMatches);
+        bool finished = RunCoordinator(listener, NULL);
+        close(listener);
+        if (strncmp(target, "unix:", 5) == 0) unlink(target + 5);
+        if (!finished) return 1;
+
+        PrintStats();
+        return 0;
+    }
+
+    if (strcmp(mode, "local") != 0) return Usage(argv[0]);
+
+    int workerCount = atoi(target);
+    if ((workerCount < 1) || (workerCount > MAX_PROCS)) return Usage(argv[0]);
+
+    char address[108];
+    snprintf(address, sizeof(address), "unix:/tmp/distsim-%d.sock", (int)getpid());
+
+    int listener = Listen(address);
+    if (listener < 0)
+    {
+        fprintf(stderr, "distsim: could not listen on %s\n", address);
+        return 1;
+    }
+
+    localListener = listener;
+    int status = 0;
+
+    if (scale)
+    {
+        printf("workers  matches/s  speedup  efficiency\n");
+
+        double single = 0;
+        for (int count = 1; ; count = (count*2 < workerCount) ? count*2 : workerCount)
+        {
+            double rate = RunLocal(address, listener, count, 0);
+            if (count == 1) single = rate;
+
+            printf("%7d  %9.0f  %7.2f  %9.0f%%\n", count, rate, rate/single, 100.0*rate/single/count);
+
+            if (count == workerCount) break;
+        }
+    }
+
+    if (RunLocal(address, listener, workerCount, kills) > 0) PrintStats();
+    else status = 1;
+
+    close(listener);
+    unlink(address + 5);
+
+    return status;
+}
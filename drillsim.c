@@ -0,0 +1,428 @@
+/*******************************************************************************************
+*
+*   C-volley - scenario drills: short episodes from sampled start states
+*
+*   Usage:
+*     drillsim [drills] [--threads N] [--lanes N] [--seed N] [--scenario NAME]
+*              [--side left|right|both] [--scripted] [--agent PLUGIN]
+*
+*   Whole matches spend most frames on ordinary serves. A drill instead starts from a state
+*   drawn from one scenario's ranges (ball position and velocity, the drilled blob's spot) and
+*   runs only until the drilled side returns the ball over the net or wins the point after
+*   touching it (returned), the ball lands on its side (missed), the drilled side wins the
+*   point without a touch (untouched: net cord, a lob landing short on the other side), or
+*   DRILL_MAX_TICKS pass (timeout). The
+*   drilled side is the built-in AI, a scripted player with --scripted or an agent plug-in
+*   (agent.h) with --agent, decided in one batch per sweep like batchsim; the other blob
+*   stands still, a drill ends before it would matter. Success rates per scenario show where
+*   a player is weak.
+*
+*   Scenarios are written for the left side and mirrored with SimMirror() for right side
+*   drills, --side both (default) alternates. Drill d is scenario d % count and gets the same
+*   start state and script for any thread or lane count, the checksum over all outcomes stays
+*   the same. New scenarios get a row in the table below.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "agentplugin.h"
+#include "selfplay.h"          // AGENT_* player kinds
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS 256
+#define DRILL_MAX_TICKS 600             // 10 seconds
+
+#define BLOB_MIN_X PLAYER_RADIUS
+#define BLOB_MAX_X (NET_X - NET_WIDTH/2 - PLAYER_RADIUS)
+
+#define SIDE_BOTH -1
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Range {
+    float min, max;
+} Range;
+
+// Start state ranges for the left side, drawn uniformly
+typedef struct Scenario {
+    const char *name;
+    Range ballX, ballY;
+    Range ballVX, ballVY;
+    Range blobX;                        // Drilled blob, on the ground
+} Scenario;
+
+static const Scenario scenarios[] = {
+    // Plain serve over a moved blob, the baseline
+    { "serve",        { 256, 256 }, { 100, 100 }, { 0, 0 },     { 0, 0 },   { 106, 406 } },
+    // Ball dropping just in front of the net
+    { "net-drop",     { 400, 470 }, { 380, 520 }, { -2, 0.5f }, { -1, 2 },  { BLOB_MIN_X, BLOB_MAX_X } },
+    // Ball coming low over the net tape
+    { "net-cord",     { 550, 600 }, { 300, 360 }, { -4, -2 },   { -4, -2 }, { BLOB_MIN_X, BLOB_MAX_X } },
+    // Fast, steep ball aimed deep
+    { "deep-smash",   { 550, 710 }, { 120, 300 }, { -13, -9 },  { 3, 7 },   { 150, BLOB_MAX_X } },
+    // High, slow ball from the far side
+    { "lob",          { 570, 710 }, { 60, 140 },  { -6, -3 },   { -4, -1 }, { BLOB_MIN_X, BLOB_MAX_X } },
+    // Ball about to bounce off the back wall
+    { "wall-rebound", { 60, 180 },  { 300, 520 }, { -9, -5 },   { -3, 2 },  { 200, BLOB_MAX_X } },
+    // Blob at the net, ball falling deep behind it
+    { "wrong-foot",   { 100, 220 }, { 150, 300 }, { -3, -1 },   { 0, 3 },   { 380, BLOB_MAX_X } },
+};
+
+#define SCENARIO_COUNT ((int)(sizeof(scenarios)/sizeof(scenarios[0])))
+
+typedef enum {
+    OUTCOME_RUNNING = 0,
+    OUTCOME_RETURNED,
+    OUTCOME_MISSED,
+    OUTCOME_UNTOUCHED,                  // Point won, but not by playing the ball
+    OUTCOME_TIMEOUT,
+} DrillOutcome;
+
+typedef struct DrillLane {
+    SimState sim;
+    SimScript script;
+    int drill;                          // -1 when the lane is idle
+    int scenario;
+    int side;
+    bool touched;                       // Drilled blob touched the ball
+    unsigned char decided;              // Plug-in action for the next step
+} DrillLane;
+
+typedef struct ScenarioStats {
+    long long drills;
+    long long returned;
+    long long missed;
+    long long untouched;
+    long long timeouts;
+    long long ticks;                    // Over all drills
+} ScenarioStats;
+
+typedef struct Worker {
+    pthread_t thread;
+    ScenarioStats stats[SCENARIO_COUNT];
+    uint64_t checksum;
+    long long steps;
+    bool failed;
+} Worker;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static int drillCount = 100000;
+static int laneCount = 1024;
+static uint32_t seed = 0;
+static int drilledSide = SIDE_BOTH;
+static int player = AGENT_AI;
+static int scenarioFilter = -1;         // Only this scenario, -1 for all
+static AgentPlugin plugin = { 0 };
+static int nextDrill = 0;               // Shared work counter
+
+//----------------------------------------------------------------------------------
+// Drills
+//----------------------------------------------------------------------------------
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec/1e9;
+}
+
+static uint64_t Mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+
+    return x;
+}
+
+// Uniform in the range, from a splitmix sequence
+static float Sample(uint64_t *state, Range range)
+{
+    *state += 0x9e3779b97f4a7c15ull;
+    float unit = (float)(Mix(*state) >> 40)/(float)(1 << 24);
+
+    return range.min + (range.max - range.min)*unit;
+}
+
+static bool NextDrill(int *drill)
+{
+    *drill = __atomic_fetch_add(&nextDrill, 1, __ATOMIC_RELAXED);
+
+    return *drill < drillCount;
+}
+
+static void StartDrill(DrillLane *lane, int drill)
+{
+    int scenario = (scenarioFilter >= 0) ? scenarioFilter : drill%SCENARIO_COUNT;
+    const Scenario *s = &scenarios[scenario];
+    uint64_t state = Mix(((uint64_t)seed << 32) ^ (uint64_t)drill);
+
+    SimState left;
+    SimInit(&left, 1000u + (uint32_t)drill);
+    left.ball.position = (Vector2){ Sample(&state, s->ballX), Sample(&state, s->ballY) };
+    left.ball.velocity = (Vector2){ Sample(&state, s->ballVX), Sample(&state, s->ballVY) };
+    left.blobs[0].position.x = Sample(&state, s->blobX);
+
+    lane->side = (drilledSide != SIDE_BOTH) ? drilledSide : (drill/SCENARIO_COUNT)%2;
+    if (lane->side == 0) lane->sim = left;
+    else SimMirror(&left, &lane->sim);
+
+    SimScriptInit(&lane->script, (uint32_t)drill*2654435761u + 1);
+    lane->drill = drill;
+    lane->scenario = scenario;
+    lane->touched = false;
+    lane->decided = 0;
+}
+
+static DrillOutcome StepDrill(DrillLane *lane)
+{
+    SimState *sim = &lane->sim;
+    int side = lane->side;
+
+    unsigned char actions[2] = { 0, 0 };
+    if (player == AGENT_AI) actions[side] = ACTION_AI;
+    else if (player == AGENT_PLUGIN) actions[side] = lane->decided;
+    else actions[side] = SimScriptAction(&lane->script, sim, side);
+
+    int score = sim->blobs[side].score;
+    unsigned int events = SimStep(sim, actions);
+
+    if (events & ((side == 0) ? SIM_EVENT_BLOB_LEFT : SIM_EVENT_BLOB_RIGHT)) lane->touched = true;
+
+    if (events & SIM_EVENT_SCORE)
+    {
+        if (sim->blobs[side].score == score) return OUTCOME_MISSED;
+        return lane->touched ? OUTCOME_RETURNED : OUTCOME_UNTOUCHED;
+    }
+
+    bool overNet = (side == 0) ? (sim->ball.position.x > NET_X) : (sim->ball.position.x < NET_X);
+    if (lane->touched && overNet) return OUTCOME_RETURNED;
+
+    return (sim->tick >= DRILL_MAX_TICKS) ? OUTCOME_TIMEOUT : OUTCOME_RUNNING;
+}
+
+static void DecideDrills(void *agent, DrillLane *lanes, AgentObs *obs, AgentAction *actions, int *index)
+{
+    int n = 0;
+    for (int i = 0; i < laneCount; i++)
+    {
+        if (lanes[i].drill < 0) continue;
+
+        AgentObserve(&lanes[i].sim, lanes[i].side, (uint32_t)lanes[i].drill, &obs[n]);
+        index[n++] = i;
+    }
+    if (n == 0) return;
+
+    AgentDecide(&plugin, agent, obs, actions, n);
+    for (int k = 0; k < n; k++) lanes[index[k]].decided = actions[k] & (ACTION_LEFT | ACTION_RIGHT | ACTION_JUMP);
+}
+
+static void *WorkerThread(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+
+    DrillLane *lanes = (DrillLane *)malloc(laneCount*sizeof(DrillLane));
+    AgentObs *obs = (AgentObs *)malloc(laneCount*sizeof(AgentObs));
+    AgentAction *actions = (AgentAction *)malloc(laneCount*sizeof(AgentAction));
+    int *index = (int *)malloc(laneCount*sizeof(int));
+    void *agent = (player == AGENT_PLUGIN) ? plugin.api->create(laneCount, seed) : NULL;
+
+    if ((lanes == NULL) || (obs == NULL) || (actions == NULL) || (index == NULL) || ((player == AGENT_PLUGIN) && (agent == NULL)))
+    {
+        worker->failed = true;
+        free(lanes);
+        free(obs);
+        free(actions);
+        free(index);
+        return NULL;
+    }
+
+    int active = 0;
+    for (int i = 0; i < laneCount; i++)
+    {
+        int drill;
+        lanes[i].drill = -1;
+        if (NextDrill(&drill))
+        {
+            StartDrill(&lanes[i], drill);
+            active++;
+        }
+    }
+
+    while (active > 0)
+    {
+        if (agent != NULL) DecideDrills(agent, lanes, obs, actions, index);
+
+        for (int i = 0; i < laneCount; i++)
+        {
+            DrillLane *lane = &lanes[i];
+            if (lane->drill < 0) continue;
+
+            DrillOutcome outcome = StepDrill(lane);
+            worker->steps++;
+            if (outcome == OUTCOME_RUNNING) continue;
+
+            ScenarioStats *stats = &worker->stats[lane->scenario];
+            stats->drills++;
+            stats->returned += (outcome == OUTCOME_RETURNED);
+            stats->missed += (outcome == OUTCOME_MISSED);
+            stats->untouched += (outcome == OUTCOME_UNTOUCHED);
+            stats->timeouts += (outcome == OUTCOME_TIMEOUT);
+            stats->ticks += lane->sim.tick;
+            worker->checksum += Mix(((uint64_t)lane->drill << 32) ^ ((uint64_t)outcome << 16) ^ (uint64_t)lane->sim.tick);
+
+            int drill;
+            if (NextDrill(&drill)) StartDrill(lane, drill);
+            else
+            {
+                lane->drill = -1;
+                active--;
+            }
+        }
+    }
+
+    if (agent != NULL) plugin.api->destroy(agent);
+    free(lanes);
+    free(obs);
+    free(actions);
+    free(index);
+
+    return NULL;
+}
+
+static void PrintStats(const char *name, const ScenarioStats *stats)
+{
+    double drills = (stats->drills > 0) ? (double)stats->drills : 1.0;
+
+    printf("%-14s %9lld  %7.1f%%  %6.1f%%  %8.1f%%  %6.1f%%  %10.1f\n", name, stats->drills, 100.0*stats->returned/drills,
+           100.0*stats->missed/drills, 100.0*stats->untouched/drills, 100.0*stats->timeouts/drills, stats->ticks/drills);
+}
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    static Worker workers[MAX_THREADS];
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *agentPath = NULL;
+    bool usage = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) threads = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--lanes") == 0) && (i + 1 < argc)) laneCount = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if ((strcmp(argv[i], "--scenario") == 0) && (i + 1 < argc))
+        {
+            const char *name = argv[++i];
+            for (int s = 0; s < SCENARIO_COUNT; s++) if (strcmp(scenarios[s].name, name) == 0) scenarioFilter = s;
+            if (scenarioFilter < 0) usage = true;
+        }
+        else if ((strcmp(argv[i], "--side") == 0) && (i + 1 < argc))
+        {
+            const char *side = argv[++i];
+            if (strcmp(side, "left") == 0) drilledSide = 0;
+            else if (strcmp(side, "right") == 0) drilledSide = 1;
+            else if (strcmp(side, "both") == 0) drilledSide = SIDE_BOTH;
+            else usage = true;
+        }
+        else if (strcmp(argv[i], "--scripted") == 0) player = AGENT_SCRIPTED;
+        else if ((strcmp(argv[i], "--agent") == 0) && (i + 1 < argc))
+        {
+            agentPath = argv[++i];
+            player = AGENT_PLUGIN;
+        }
+        else if (argv[i][0] != '-') drillCount = atoi(argv[i]);
+        else usage = true;
+    }
+
+    if (usage || (drillCount <= 0) || (laneCount <= 0))
+    {
+        fprintf(stderr, "usage: %s [drills] [--threads N] [--lanes N] [--seed N] [--scenario NAME]\n"
+                        "       [--side left|right|both] [--scripted] [--agent PLUGIN]\nscenarios:", argv[0]);
+        for (int s = 0; s < SCENARIO_COUNT; s++) fprintf(stderr, " %s", scenarios[s].name);
+        fprintf(stderr, "\n");
+        return 1;
+    }
+
+    if ((agentPath != NULL) && !AgentPluginLoad(&plugin, agentPath)) return 1;
+
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    const char *playerName = (player == AGENT_AI) ? "built-in AI" : (player == AGENT_PLUGIN) ? plugin.api->name : "scripted";
+    const char *sideName = (drilledSide == 0) ? "left" : (drilledSide == 1) ? "right" : "both sides";
+    printf("%d drills of %s on %s, %d threads x %d lanes, seed %u\n", drillCount, playerName, sideName, threads, laneCount, seed);
+
+    double start = NowSeconds();
+
+    for (int i = 0; i < threads; i++) pthread_create(&workers[i].thread, NULL, WorkerThread, &workers[i]);
+
+    ScenarioStats stats[SCENARIO_COUNT] = { 0 };
+    ScenarioStats total = { 0 };
+    uint64_t checksum = 0;
+    long long steps = 0;
+    bool failed = false;
+
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        failed |= workers[i].failed;
+        checksum += workers[i].checksum;
+        steps += workers[i].steps;
+
+        for (int s = 0; s < SCENARIO_COUNT; s++)
+        {
+            const ScenarioStats *w = &workers[i].stats[s];
+            stats[s].drills += w->drills;
+            stats[s].returned += w->returned;
+            stats[s].missed += w->missed;
+            stats[s].untouched += w->untouched;
+            stats[s].timeouts += w->timeouts;
+            stats[s].ticks += w->ticks;
+        }
+    }
+
+    double seconds = NowSeconds() - start;
+
+    if (failed)
+    {
+        fprintf(stderr, "drillsim: a worker could not allocate its lanes or agent\n");
+        return 1;
+    }
+
+    printf("scenario          drills  returned   missed  untouched  timeout  mean ticks\n");
+    for (int s = 0; s < SCENARIO_COUNT; s++)
+    {
+        if (stats[s].drills == 0) continue;
+
+        PrintStats(scenarios[s].name, &stats[s]);
+        total.drills += stats[s].drills;
+        total.returned += stats[s].returned;
+        total.missed += stats[s].missed;
+        total.untouched += stats[s].untouched;
+        total.timeouts += stats[s].timeouts;
+        total.ticks += stats[s].ticks;
+    }
+    PrintStats("total", &total);
+
+    printf("%.3f s: %.0f drills/s (%.2f M/min), %.2f M steps/s, checksum %016llx\n", seconds, total.drills/seconds,
+           total.drills/seconds*60/1e6, steps/seconds/1e6, (unsigned long long)checksum);
+    printf("BENCH drills.per_second %.0f higher\n", total.drills/seconds);     // For benchgate
+
+    if (agentPath != NULL) AgentPluginUnload(&plugin);
+
+    return 0;
+}
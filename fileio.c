@@ -0,0 +1,647 @@
+/*******************************************************************************************
+*
+*   C-volley - asynchronous file I/O service
+*
+*   Jobs go through a bounded multi-producer ring with a sequence number per slot (like the
+*   log ring in asynclog.c); the I/O thread copies a job out and frees its slot before doing
+*   any I/O, and sleeps on a futex when the ring is empty.
+*
+*   On io_uring every step is a submission: OPENAT, then the data in batches of FILEIO_BUFFERS
+*   chunks (WRITE_FIXED/READ_FIXED on the registered buffers, one io_uring_enter() per batch),
+*   then CLOSE. The ring is set up without liburing, the few structures involved come from
+*   <linux/io_uring.h>. Buffers that cannot be registered (RLIMIT_MEMLOCK on older kernels)
+*   are used with plain WRITE/READ; a kernel without the opcodes gets blocking calls.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include "fileio.h"
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define JOB_WRITE 0
+#define JOB_READ 1
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct FileJob {
+    uint64_t sequence;          // Ring slot state
+    int type;                   // JOB_WRITE, JOB_READ
+    int size;
+    void *data;                 // JOB_WRITE, freed once written
+    FileRead *read;             // JOB_READ
+    char path[FILEIO_PATH_MAX];
+} FileJob;
+
+typedef struct Uring {
+    int fd;
+    uint32_t generation;        // Of the last batch, upper half of user_data
+    unsigned *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sqRing, *cqRing;
+    size_t sqRingSize, cqRingSize, sqesSize;
+    bool fixedBuffers;          // Buffers registered, WRITE_FIXED/READ_FIXED
+} Uring;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static FileJob jobs[FILEIO_QUEUE_SLOTS];
+static uint64_t jobTail = 0;            // Next slot to claim, producers
+static uint64_t jobHead = 0;            // Next slot to run, I/O thread only
+static uint32_t jobSignal = 0;          // Bumped after every published job, futex word
+static uint32_t ioWaiting = 0;
+
+static bool ioRunning = false;
+static pthread_t ioThread;
+
+static Uring ring = { .fd = -1 };
+static bool uringActive = false;
+static unsigned char *buffers = NULL;   // FILEIO_BUFFERS*FILEIO_BUFFER_SIZE, page aligned
+static FileIoStats stats = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module internal functions: io_uring
+//----------------------------------------------------------------------------------
+static bool OpcodesSupported(int fd)
+{
+    size_t size = sizeof(struct io_uring_probe) + 256*sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = (struct io_uring_probe *)calloc(1, size);
+    if (probe == NULL) return false;
+
+    static const int needed[] = { IORING_OP_OPENAT, IORING_OP_CLOSE, IORING_OP_READ, IORING_OP_WRITE,
+                                  IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED };
+    bool supported = (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) == 0);
+
+    for (int i = 0; supported && (i < (int)(sizeof(needed)/sizeof(needed[0]))); i++)
+    {
+        supported = (needed[i] < probe->ops_len) && (probe->ops[needed[i]].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    free(probe);
+    return supported;
+}
+
+static void CloseUring(void)
+{
+    if (ring.sqes != NULL) munmap(ring.sqes, ring.sqesSize);
+    if ((ring.cqRing != NULL) && (ring.cqRing != ring.sqRing)) munmap(ring.cqRing, ring.cqRingSize);
+    if (ring.sqRing != NULL) munmap(ring.sqRing, ring.sqRingSize);
+    if (ring.fd >= 0) close(ring.fd);
+
+    memset(&ring, 0, sizeof(ring));
+    ring.fd = -1;
+}
+
+static bool SetupUring(void)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    ring.fd = (int)syscall(__NR_io_uring_setup, FILEIO_BUFFERS*2, &params);
+    if (ring.fd < 0) return false;
+
+    if (!OpcodesSupported(ring.fd))
+    {
+        CloseUring();
+        return false;
+    }
+
+    ring.sqRingSize = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    ring.cqRingSize = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) && (ring.cqRingSize > ring.sqRingSize)) ring.sqRingSize = ring.cqRingSize;
+
+    ring.sqRing = mmap(NULL, ring.sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+    if (ring.sqRing == MAP_FAILED) ring.sqRing = NULL;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) ring.cqRing = ring.sqRing;
+    else
+    {
+        ring.cqRing = mmap(NULL, ring.cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+        if (ring.cqRing == MAP_FAILED) ring.cqRing = NULL;
+    }
+
+    ring.sqesSize = params.sq_entries*sizeof(struct io_uring_sqe);
+    ring.sqes = (struct io_uring_sqe *)mmap(NULL, ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if (ring.sqes == MAP_FAILED) ring.sqes = NULL;
+
+    if ((ring.sqRing == NULL) || (ring.cqRing == NULL) || (ring.sqes == NULL))
+    {
+        CloseUring();
+        return false;
+    }
+
+    unsigned char *sq = (unsigned char *)ring.sqRing;
+    unsigned char *cq = (unsigned char *)ring.cqRing;
+    ring.sqTail = (unsigned *)(sq + params.sq_off.tail);
+    ring.sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring.sqArray = (unsigned *)(sq + params.sq_off.array);
+    ring.cqHead = (unsigned *)(cq + params.cq_off.head);
+    ring.cqTail = (unsigned *)(cq + params.cq_off.tail);
+    ring.cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    // Pinned once here instead of on every transfer
+    struct iovec iov[FILEIO_BUFFERS];
+    for (int i = 0; i < FILEIO_BUFFERS; i++)
+    {
+        iov[i].iov_base = buffers + (size_t)i*FILEIO_BUFFER_SIZE;
+        iov[i].iov_len = FILEIO_BUFFER_SIZE;
+    }
+    ring.fixedBuffers = (syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, iov, FILEIO_BUFFERS) == 0);
+
+    return true;
+}
+
+// Submits count prepared entries in one call and waits for all of them, results by index.
+// Whatever happens, nothing of the batch is left in the ring when it returns: a failed
+// io_uring_enter() takes back the entries the kernel has not seen (the next call would submit
+// them) and still waits for those it has, their buffers and paths are about to be reused.
+// user_data carries the batch generation, completions of another batch are dropped.
+static void SubmitAndWait(const struct io_uring_sqe *batch, int count, int results[])
+{
+    unsigned tail = *ring.sqTail;
+    uint64_t generation = (uint64_t)(++ring.generation) << 32;
+
+    for (int i = 0; i < count; i++)
+    {
+        unsigned index = (tail + i) & *ring.sqMask;
+        ring.sqes[index] = batch[i];
+        ring.sqes[index].user_data = generation | (uint64_t)i;
+        ring.sqArray[index] = index;
+        results[i] = -EIO;
+    }
+    __atomic_store_n(ring.sqTail, tail + count, __ATOMIC_RELEASE);
+
+    int unsubmitted = count;        // In the submission queue, not consumed by the kernel yet
+    int inFlight = 0;
+
+    while ((unsubmitted > 0) || (inFlight > 0))
+    {
+        int entered = (int)syscall(__NR_io_uring_enter, ring.fd, unsubmitted, unsubmitted + inFlight, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (entered > 0)
+        {
+            if (entered > unsubmitted) entered = unsubmitted;
+            unsubmitted -= entered;
+            inFlight += entered;
+        }
+        else if ((entered < 0) && (errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY))
+        {
+            int error = errno;
+
+            if (unsubmitted > 0)
+            {
+                for (int i = count - unsubmitted; i < count; i++) results[i] = -error;
+                __atomic_store_n(ring.sqTail, tail + (unsigned)(count - unsubmitted), __ATOMIC_RELEASE);
+                unsubmitted = 0;
+            }
+            else
+            {
+                // Cannot even wait: the ring is no use any more, blocking calls from here on
+                TraceLog(LOG_WARNING, "FILEIO: io_uring failed (error %d), switching to blocking calls", error);
+                CloseUring();
+                uringActive = false;
+                stats.uring = false;
+                return;
+            }
+        }
+
+        unsigned head = *ring.cqHead;
+        unsigned available = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+
+        for (; head != available; head++)
+        {
+            const struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cqMask];
+            uint64_t index = cqe->user_data & 0xFFFFFFFFu;
+
+            if (((cqe->user_data & ~(uint64_t)0xFFFFFFFFu) == generation) && (index < (uint64_t)count))
+            {
+                results[index] = cqe->res;
+                inFlight--;
+            }
+        }
+        __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    stats.submissions++;
+}
+
+//----------------------------------------------------------------------------------
+// Module internal functions: operations, io_uring or blocking
+//----------------------------------------------------------------------------------
+static int IoOpen(const char *path, int flags)
+{
+    if (!uringActive) return open(path, flags, 0644);
+
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_OPENAT;
+    sqe.fd = AT_FDCWD;
+    sqe.addr = (uint64_t)(uintptr_t)path;
+    sqe.len = 0644;
+    sqe.open_flags = (uint32_t)flags;
+
+    int result = -1;
+    SubmitAndWait(&sqe, 1, &result);
+    return result;
+}
+
+static bool IoClose(int fd)
+{
+    if (!uringActive) return (close(fd) == 0);
+
+    struct io_uring_sqe sqe;
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_CLOSE;
+    sqe.fd = fd;
+
+    int result = -1;
+    SubmitAndWait(&sqe, 1, &result);
+    return (result == 0);
+}
+
+// Chunk i in buffer i at offset + i*FILEIO_BUFFER_SIZE, bytes done or -errno per chunk
+static void IoTransfer(bool write, int fd, int count, const int lengths[], int64_t offset, int results[])
+{
+    if (!uringActive)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            unsigned char *buffer = buffers + (size_t)i*FILEIO_BUFFER_SIZE;
+            off_t at = (off_t)(offset + (int64_t)i*FILEIO_BUFFER_SIZE);
+            ssize_t done = write ? pwrite(fd, buffer, lengths[i], at) : pread(fd, buffer, lengths[i], at);
+            results[i] = (done >= 0) ? (int)done : -errno;
+        }
+        return;
+    }
+
+    struct io_uring_sqe batch[FILEIO_BUFFERS];
+    memset(batch, 0, sizeof(batch));
+
+    for (int i = 0; i < count; i++)
+    {
+        if (ring.fixedBuffers) batch[i].opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        else batch[i].opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+        batch[i].fd = fd;
+        batch[i].addr = (uint64_t)(uintptr_t)(buffers + (size_t)i*FILEIO_BUFFER_SIZE);
+        batch[i].len = (uint32_t)lengths[i];
+        batch[i].off = (uint64_t)(offset + (int64_t)i*FILEIO_BUFFER_SIZE);
+        batch[i].buf_index = (uint16_t)i;
+    }
+
+    SubmitAndWait(batch, count, results);
+}
+
+//----------------------------------------------------------------------------------
+// Module internal functions: jobs
+//----------------------------------------------------------------------------------
+static bool RunWrite(const FileJob *job)
+{
+    int fd = IoOpen(job->path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    const unsigned char *data = (const unsigned char *)job->data;
+    int64_t offset = 0;
+    bool written = true;
+
+    while (written && (offset < job->size))
+    {
+        int lengths[FILEIO_BUFFERS], results[FILEIO_BUFFERS];
+        int count = 0;
+
+        for (int64_t at = offset; (count < FILEIO_BUFFERS) && (at < job->size); at += FILEIO_BUFFER_SIZE)
+        {
+            lengths[count] = (job->size - at < FILEIO_BUFFER_SIZE) ? (int)(job->size - at) : FILEIO_BUFFER_SIZE;
+            memcpy(buffers + (size_t)count*FILEIO_BUFFER_SIZE, data + at, lengths[count]);
+            count++;
+        }
+
+        IoTransfer(true, fd, count, lengths, offset, results);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (results[i] != lengths[i]) written = false;
+            offset += lengths[i];
+        }
+    }
+
+    if (!IoClose(fd)) written = false;
+    if (written) stats.bytes += (unsigned long long)job->size;
+
+    return written;
+}
+
+static bool RunRead(const FileJob *job)
+{
+    FileRead *read = job->read;
+    int fd = IoOpen(job->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    unsigned char *data = NULL;
+    int64_t size = 0;
+    bool done = false, failed = false;
+
+    while (!done && !failed)
+    {
+        int lengths[FILEIO_BUFFERS], results[FILEIO_BUFFERS];
+        for (int i = 0; i < FILEIO_BUFFERS; i++) lengths[i] = FILEIO_BUFFER_SIZE;
+
+        IoTransfer(false, fd, FILEIO_BUFFERS, lengths, size, results);
+
+        // Short chunk: end of file
+        for (int i = 0; (i < FILEIO_BUFFERS) && !done && !failed; i++)
+        {
+            if ((results[i] < 0) || (size + results[i] > 0x7fffffff))
+            {
+                failed = true;
+                break;
+            }
+
+            unsigned char *grown = (unsigned char *)realloc(data, (size_t)(size + results[i] + 1));
+            if (grown == NULL)
+            {
+                failed = true;
+                break;
+            }
+
+            data = grown;
+            memcpy(data + size, buffers + (size_t)i*FILEIO_BUFFER_SIZE, results[i]);
+            size += results[i];
+            done = (results[i] < FILEIO_BUFFER_SIZE);
+        }
+    }
+
+    if (!IoClose(fd)) failed = true;
+
+    if (failed)
+    {
+        free(data);
+        return false;
+    }
+
+    read->data = data;
+    read->size = (int)size;
+    stats.bytes += (unsigned long long)size;
+
+    return true;
+}
+
+// Copies the next job out and frees its slot, so producers never wait for the I/O
+static bool TakeJob(FileJob *job)
+{
+    FileJob *slot = &jobs[jobHead & (FILEIO_QUEUE_SLOTS - 1)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != jobHead + 1) return false;
+
+    *job = *slot;
+    __atomic_store_n(&slot->sequence, jobHead + FILEIO_QUEUE_SLOTS, __ATOMIC_RELEASE);
+    jobHead++;
+
+    return true;
+}
+
+static void *IoThread(void *arg)
+{
+    (void)arg;
+    FileJob job;
+
+    // Runs when the game thread sleeps, a wakeup never preempts a frame on a shared core
+    struct sched_param param = { 0 };
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+    for (;;)
+    {
+        if (TakeJob(&job))
+        {
+            bool ok = (job.type == JOB_WRITE) ? RunWrite(&job) : RunRead(&job);
+
+            if (job.type == JOB_WRITE)
+            {
+                free(job.data);
+                stats.writes++;
+            }
+            else
+            {
+                __atomic_store_n(&job.read->state, ok ? FILE_READ_DONE : FILE_READ_FAILED, __ATOMIC_RELEASE);
+                stats.reads++;
+            }
+
+            // A failed read is the caller's to report, often just a file that is not there yet
+            if (!ok)
+            {
+                stats.failed++;
+                TraceLog((job.type == JOB_WRITE) ? LOG_WARNING : LOG_DEBUG, "FILEIO: [%s] Could not %s file", job.path,
+                         (job.type == JOB_WRITE) ? "write" : "read");
+            }
+            continue;
+        }
+
+        // Empty: everything queued before a close is done by now
+        if (!__atomic_load_n(&ioRunning, __ATOMIC_ACQUIRE)) break;
+
+        uint32_t signal = __atomic_load_n(&jobSignal, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&ioWaiting, 1, __ATOMIC_SEQ_CST);
+
+        FileJob *next = &jobs[jobHead & (FILEIO_QUEUE_SLOTS - 1)];
+        if ((__atomic_load_n(&next->sequence, __ATOMIC_SEQ_CST) != jobHead + 1) && __atomic_load_n(&ioRunning, __ATOMIC_SEQ_CST))
+        {
+            syscall(SYS_futex, &jobSignal, FUTEX_WAIT_PRIVATE, signal, NULL, NULL, 0);
+        }
+
+        __atomic_store_n(&ioWaiting, 0, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+static void WakeIoThread(void)
+{
+    __atomic_fetch_add(&jobSignal, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&ioWaiting, __ATOMIC_SEQ_CST))
+    {
+        syscall(SYS_futex, &jobSignal, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
+
+// Claims a slot and fills it, false when the ring is full
+static bool PostJob(int type, const char *path, void *data, int size, FileRead *read)
+{
+    if (!__atomic_load_n(&ioRunning, __ATOMIC_ACQUIRE) || (strlen(path) >= FILEIO_PATH_MAX)) return false;
+
+    uint64_t position = __atomic_load_n(&jobTail, __ATOMIC_RELAXED);
+    FileJob *slot;
+
+    for (;;)
+    {
+        slot = &jobs[position & (FILEIO_QUEUE_SLOTS - 1)];
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+        if (sequence == position)
+        {
+            if (__atomic_compare_exchange_n(&jobTail, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        }
+        else if (sequence < position)
+        {
+            __atomic_fetch_add(&stats.queueFull, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        else position = __atomic_load_n(&jobTail, __ATOMIC_RELAXED);
+    }
+
+    slot->type = type;
+    slot->size = size;
+    slot->data = data;
+    slot->read = read;
+    strcpy(slot->path, path);
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+
+    WakeIoThread();
+    return true;
+}
+
+// raylib's SaveFileData() while the service runs: a copy is queued, the caller keeps its data
+static bool SaveFileDataAsync(const char *fileName, void *data, int dataSize)
+{
+    void *copy = malloc((dataSize > 0) ? (size_t)dataSize : 1);
+
+    if (copy != NULL)
+    {
+        memcpy(copy, data, (dataSize > 0) ? (size_t)dataSize : 0);
+        if (FileWriteAsync(fileName, copy, dataSize)) return true;
+        free(copy);
+    }
+
+    // Ring full: what raylib would have done
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    bool written = (dataSize <= 0) || (fwrite(data, (size_t)dataSize, 1, file) == 1);
+    return (fclose(file) == 0) && written;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool InitFileIo(void)
+{
+    if (ioRunning) return false;
+
+    buffers = (unsigned char *)mmap(NULL, (size_t)FILEIO_BUFFERS*FILEIO_BUFFER_SIZE, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (buffers == MAP_FAILED)
+    {
+        buffers = NULL;
+        return false;
+    }
+
+    for (int i = 0; i < FILEIO_QUEUE_SLOTS; i++) jobs[i].sequence = (uint64_t)i;
+    jobTail = jobHead = 0;
+    memset(&stats, 0, sizeof(stats));
+
+    uringActive = SetupUring();
+    stats.uring = uringActive;
+
+    ioRunning = true;
+    if (pthread_create(&ioThread, NULL, IoThread, NULL) != 0)
+    {
+        ioRunning = false;
+        CloseUring();
+        munmap(buffers, (size_t)FILEIO_BUFFERS*FILEIO_BUFFER_SIZE);
+        buffers = NULL;
+        return false;
+    }
+
+    SetSaveFileDataCallback(SaveFileDataAsync);
+
+    if (uringActive) TraceLog(LOG_INFO, "FILEIO: io_uring, %d x %d KB %s buffers", FILEIO_BUFFERS, FILEIO_BUFFER_SIZE/1024,
+                              ring.fixedBuffers ? "registered" : "plain");
+    else TraceLog(LOG_INFO, "FILEIO: io_uring not available, blocking calls on the I/O thread");
+
+    return true;
+}
+
+void CloseFileIo(void)
+{
+    if (!ioRunning) return;
+
+    SetSaveFileDataCallback(NULL);
+
+    __atomic_store_n(&ioRunning, false, __ATOMIC_RELEASE);
+    WakeIoThread();
+    pthread_join(ioThread, NULL);
+
+    CloseUring();
+    munmap(buffers, (size_t)FILEIO_BUFFERS*FILEIO_BUFFER_SIZE);
+    buffers = NULL;
+
+    if ((stats.writes + stats.reads) > 0)
+    {
+        TraceLog(LOG_INFO, "FILEIO: %llu writes, %llu reads, %.1f MB, %llu failed, %llu done by the caller (queue full), %llu submissions",
+                 stats.writes, stats.reads, stats.bytes/(1024.0*1024.0), stats.failed, stats.queueFull, stats.submissions);
+    }
+}
+
+bool FileWriteAsync(const char *path, void *data, int size)
+{
+    return PostJob(JOB_WRITE, path, data, size, NULL);
+}
+
+bool FileReadAsync(const char *path, FileRead *read)
+{
+    read->data = NULL;
+    read->size = 0;
+    read->state = FILE_READ_PENDING;
+
+    if (PostJob(JOB_READ, path, NULL, 0, read)) return true;
+
+    read->state = FILE_READ_IDLE;
+    return false;
+}
+
+#else
+
+bool InitFileIo(void) { return false; }
+void CloseFileIo(void) { }
+bool FileWriteAsync(const char *path, void *data, int size) { (void)path; (void)data; (void)size; return false; }
+bool FileReadAsync(const char *path, FileRead *read) { (void)path; read->state = FILE_READ_IDLE; return false; }
+
+#endif
+
+int GetFileReadState(const FileRead *read)
+{
+    return __atomic_load_n(&read->state, __ATOMIC_ACQUIRE);
+}
+
+FileIoStats GetFileIoStats(void)
+{
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+    return stats;
+#else
+    FileIoStats none = { 0 };
+    return none;
+#endif
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************************
+*
+*   C-volley - asynchronous file I/O service
+*
+*   Saving a replay or a 5 MB dataset shard from the game thread costs milliseconds of
+*   open/write/close, more when the disk is busy. Reads and writes are handed to an I/O
+*   thread instead: the calling thread only fills a slot of a lock-free job queue. The I/O
+*   thread runs them on io_uring (Linux 5.6) in chunks through a set of registered buffers,
+*   a batch of chunks per submission, or with plain blocking calls where io_uring is not
+*   available (older kernels, seccomp in containers).
+*
+*   raylib's SaveFileData() goes through the service too once it runs (its callback copies
+*   the data and queues it), so modules saving through raylib need no change.
+*
+*   While it runs, the game thread makes no file calls during play: replays, dataset shards,
+*   shader cache files, the replay viewer's file and the render stats CSV all go through it.
+*   What still blocks, outside of play:
+*     - resources loaded at startup (textures, sounds, music, the atlas ball image)
+*     - the shader cache directory check and creation in InitShaderCache()
+*     - the frame jitter histogram written at exit (--jitter-histogram)
+*     - log output with --sync-log
+*
+*   Linux only; InitFileIo() returns false elsewhere, and without the service (or with
+*   --sync-io) callers do their own blocking I/O.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define FILEIO_QUEUE_SLOTS 64           // Jobs waiting for the I/O thread, power of two
+#define FILEIO_BUFFERS 8                // Registered buffers, also the chunks in flight per submission
+#define FILEIO_BUFFER_SIZE (256*1024)
+#define FILEIO_PATH_MAX 512
+
+// FileRead.state
+#define FILE_READ_IDLE 0
+#define FILE_READ_PENDING 1
+#define FILE_READ_DONE 2
+#define FILE_READ_FAILED 3
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct FileRead {
+    int state;                  // FILE_READ_*, poll with GetFileReadState()
+    unsigned char *data;        // Once done, owned by the caller (free() or UnloadFileData())
+    int size;
+} FileRead;
+
+typedef struct FileIoStats {
+    unsigned long long writes;
+    unsigned long long reads;
+    unsigned long long failed;
+    unsigned long long queueFull;       // Jobs refused, the caller did them itself
+    unsigned long long bytes;
+    unsigned long long submissions;     // io_uring_enter() calls with chunks
+    bool uring;                         // false: blocking calls on the I/O thread
+} FileIoStats;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool InitFileIo(void);                                      // Starts the I/O thread, installs the SaveFileData() callback
+void CloseFileIo(void);                                     // Finishes every queued job first, logs the stats
+
+bool FileWriteAsync(const char *path, void *data, int size);    // Takes data (malloc) on success, false: caller keeps it
+bool FileReadAsync(const char *path, FileRead *read);           // read must stay valid until no longer pending
+int GetFileReadState(const FileRead *read);
+
+FileIoStats GetFileIoStats(void);
+
+#endif // FILEIO_H
@@ -0,0 +1,208 @@
+/*******************************************************************************************
+*
+*   C-volley - frame time under heavy recording, blocking writes against the I/O service
+*
+*   Usage:
+*     fileio_bench [frames] [--dir DIR] [--work-ms MS]
+*
+*   Runs a 60 Hz frame loop (MS of busy work per frame, 2 by default, then a sleep to the next
+*   frame) that records like the game with replays and dataset on, only much more often: a
+*   replay of a five minute match every 20 frames and a full dataset shard (5 MB) every 150.
+*   Once with the writes done in the loop, as before, once handed to the I/O service
+*   (fileio.h), and reports frame times (work and file calls, not the sleep) and how long
+*   the loop spent in file calls. Files go to DIR (current directory by default) and are
+*   removed afterwards.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "fileio.h"
+#include "replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPLAY_EVERY 20
+#define SHARD_EVERY 150
+#define FRAME_MS (1000.0/60.0)
+#define SHARD_BYTES (5*1024*1024)
+#define MATCH_TICKS (5*60*60)
+
+typedef struct FrameTimes {
+    double *frameMs;
+    double ioMs;                // Spent in file calls on the frame loop
+    double maxIoMs;
+    int files;
+} FrameTimes;
+
+static double NowMs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+static int CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static bool WriteBlocking(const char *path, const void *data, int size)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    bool written = (fwrite(data, (size_t)size, 1, file) == 1);
+    return (fclose(file) == 0) && written;
+}
+
+static void RunFrames(int frames, double workMs, bool async, const char *directory, const Replay *replay, FrameTimes *times)
+{
+    memset(times->frameMs, 0, (size_t)frames*sizeof(double));
+    times->ioMs = times->maxIoMs = 0;
+    times->files = 0;
+
+    for (int frame = 0; frame < frames; frame++)
+    {
+        double start = NowMs();
+        while (NowMs() - start < workMs) { }
+
+        char path[600];
+        double ioStart = NowMs();
+
+        if ((frame % REPLAY_EVERY) == REPLAY_EVERY - 1)
+        {
+            snprintf(path, sizeof(path), "%s/fileio-bench-%d%s", directory, times->files % 8, REPLAY_FILE_EXTENSION);
+
+            if (async)
+            {
+                int size = 0;
+                uint8_t *data = ReplayEncode(replay, &size);
+                if ((data != NULL) && !FileWriteAsync(path, data, size)) { WriteBlocking(path, data, size); free(data); }
+            }
+            else ReplaySave(replay, path);
+
+            times->files++;
+        }
+
+        if ((frame % SHARD_EVERY) == SHARD_EVERY - 1)
+        {
+            snprintf(path, sizeof(path), "%s/fileio-bench-shard-%d.cvds", directory, times->files % 2);
+
+            // Filled over the last frames in the game, a fresh image here
+            uint8_t *shard = (uint8_t *)malloc(SHARD_BYTES);
+            if (shard != NULL)
+            {
+                memset(shard, frame & 0xff, SHARD_BYTES);
+                ioStart = NowMs();
+
+                if (!async || !FileWriteAsync(path, shard, SHARD_BYTES))
+                {
+                    WriteBlocking(path, shard, SHARD_BYTES);
+                    free(shard);
+                }
+            }
+
+            times->files++;
+        }
+
+        double ioMs = NowMs() - ioStart;
+        times->ioMs += ioMs;
+        if (ioMs > times->maxIoMs) times->maxIoMs = ioMs;
+
+        times->frameMs[frame] = NowMs() - start;
+
+        double remaining = FRAME_MS - times->frameMs[frame];
+        if (remaining > 0)
+        {
+            struct timespec wait = { 0, (long)(remaining*1000000.0) };
+            nanosleep(&wait, NULL);
+        }
+    }
+}
+
+static void Report(const char *name, FrameTimes *times, int frames)
+{
+    qsort(times->frameMs, frames, sizeof(double), CompareDoubles);
+
+    printf("%-6s frame p50 %.3f ms, p99 %.3f ms, max %.3f ms | file calls on the frame: %.3f ms total, %.3f ms max (%d files)\n",
+           name, times->frameMs[frames/2], times->frameMs[(int)(frames*0.99)], times->frameMs[frames - 1],
+           times->ioMs, times->maxIoMs, times->files);
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 600;
+    double workMs = 2.0;
+    const char *directory = ".";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--dir") == 0) && (i + 1 < argc)) directory = argv[++i];
+        else if ((strcmp(argv[i], "--work-ms") == 0) && (i + 1 < argc)) workMs = atof(argv[++i]);
+        else if (atoi(argv[i]) > 0) frames = atoi(argv[i]);
+        else
+        {
+            fprintf(stderr, "Usage: %s [frames] [--dir DIR] [--work-ms MS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // One recorded match, built-in AI on both sides
+    SimState sim;
+    SimInit(&sim, 1);
+    Replay replay = { 0 };
+    unsigned char source[2] = { REPLAY_SOURCE_AI, REPLAY_SOURCE_AI };
+    unsigned char actions[2] = { ACTION_AI, ACTION_AI };
+    ReplayBegin(&replay, &sim, source);
+    for (int tick = 0; tick < MATCH_TICKS; tick++)
+    {
+        SimStep(&sim, actions);
+        ReplayRecord(&replay, actions, &sim);
+    }
+
+    FrameTimes blocking = { .frameMs = (double *)malloc((size_t)frames*sizeof(double)) };
+    FrameTimes service = { .frameMs = (double *)malloc((size_t)frames*sizeof(double)) };
+    if ((blocking.frameMs == NULL) || (service.frameMs == NULL)) return 1;
+
+    RunFrames(frames, workMs, false, directory, &replay, &blocking);
+
+    if (!InitFileIo())
+    {
+        fprintf(stderr, "I/O service not available on this platform\n");
+        return 1;
+    }
+
+    RunFrames(frames, workMs, true, directory, &replay, &service);
+    FileIoStats stats = GetFileIoStats();
+    CloseFileIo();
+
+    printf("%d frames of %.1f ms work, a replay every %d frames, a 5 MB shard every %d\n", frames, workMs, REPLAY_EVERY, SHARD_EVERY);
+    Report("before", &blocking, frames);
+    Report("after", &service, frames);
+    printf("I/O service: %s, %llu writes, %llu submissions, %llu done in the loop (queue full)\n",
+           stats.uring ? "io_uring" : "blocking calls", stats.writes, stats.submissions, stats.queueFull);
+
+    printf("BENCH fileio.frame_io_max_ms %.4f lower\n", service.maxIoMs);      // For benchgate
+
+    char path[600];
+    for (int i = 0; i < 8; i++)
+    {
+        snprintf(path, sizeof(path), "%s/fileio-bench-%d%s", directory, i, REPLAY_FILE_EXTENSION);
+        remove(path);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        snprintf(path, sizeof(path), "%s/fileio-bench-shard-%d.cvds", directory, i);
+        remove(path);
+    }
+
+    ReplayFree(&replay);
+    free(blocking.frameMs);
+    free(service.frameMs);
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*******************************************************************************************
+*
+*   C-volley - hybrid frame limiter
+*
+*   Per frame: clock_nanosleep() to (deadline - margin), then spin with a pause instruction
+*   until the deadline. The margin tracks a high percentile of the sleep overshoot (actual
+*   wakeup - requested wakeup): it grows by 1/16 whenever a sleep overshoots it and shrinks by
+*   1/256 whenever not, which settles where about 6% of the sleeps overshoot. A preempted
+*   wakeup of several milliseconds moves it one step like any other, where a mean and
+*   deviation estimate would be thrown off for seconds. On Linux the thread's timer slack
+*   is set to 1 ns first, the default 50 us would otherwise be added to every sleep.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "framelimiter.h"
+#include "raylib.h"
+
+#include <stdint.h>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__) && !defined(PLATFORM_WEB)
+    #include <errno.h>
+    #include <time.h>
+    #define FRAME_LIMITER_SUPPORTED
+#endif
+
+#if defined(__linux__) && defined(FRAME_LIMITER_SUPPORTED)
+    #include <sys/prctl.h>
+#endif
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #define CpuRelax() _mm_pause()
+#elif defined(__aarch64__)
+    #define CpuRelax() __asm__ __volatile__("yield")
+#else
+    #define CpuRelax() ((void)0)
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define MARGIN_INITIAL_NS 1000000       // Until some sleeps were measured
+#define MARGIN_MIN_NS 20000
+#define MARGIN_MAX_NS 2000000
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+#if defined(FRAME_LIMITER_SUPPORTED)
+static bool limiterActive = false;
+static int64_t period = 0;
+static int64_t deadline = 0;            // Of the frame being waited for, 0 before the first one
+static int64_t margin = MARGIN_INITIAL_NS;
+
+static unsigned long long frames = 0, waited = 0, missed = 0, late = 0;
+static int64_t errorSum = 0, errorMax = 0;
+static int64_t sleepTotal = 0, spinTotal = 0;
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+#if defined(FRAME_LIMITER_SUPPORTED)
+static int64_t NowNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec*1000000000 + now.tv_nsec;
+}
+
+static void SleepUntil(int64_t time)
+{
+    struct timespec until = { (time_t)(time/1000000000), (long)(time%1000000000) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR) { }
+}
+
+static void UpdateMargin(int64_t overshoot)
+{
+    if (overshoot > margin) margin += margin/16;
+    else margin -= margin/256;
+
+    if (margin < MARGIN_MIN_NS) margin = MARGIN_MIN_NS;
+    if (margin > MARGIN_MAX_NS) margin = MARGIN_MAX_NS;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool InitFrameLimiter(double targetFps)
+{
+#if defined(FRAME_LIMITER_SUPPORTED)
+    if (targetFps <= 0) return false;
+
+#if defined(__linux__)
+    prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+
+    period = (int64_t)(1000000000.0/targetFps + 0.5);
+    deadline = 0;
+    margin = MARGIN_INITIAL_NS;
+    frames = waited = missed = late = 0;
+    errorSum = errorMax = sleepTotal = spinTotal = 0;
+
+    SetTargetFPS(0);
+    limiterActive = true;
+
+    TraceLog(LOG_INFO, "LIMITER: %.0f fps, sleep then spin to each frame deadline", targetFps);
+    return true;
+#else
+    (void)targetFps;
+    return false;
+#endif
+}
+
+void WaitFrameLimiter(void)
+{
+#if defined(FRAME_LIMITER_SUPPORTED)
+    if (!limiterActive) return;
+
+    int64_t now = NowNs();
+
+    if (deadline == 0)
+    {
+        deadline = now;
+        return;
+    }
+
+    frames++;
+    deadline += period;
+
+    if (now >= deadline)
+    {
+        missed++;
+        if (now - deadline > period) deadline = now;        // Start over rather than rush
+        return;
+    }
+
+    int64_t wake = deadline - margin;
+    int64_t spinStart = now;
+
+    if (wake > now)
+    {
+        SleepUntil(wake);
+        spinStart = NowNs();
+        UpdateMargin(spinStart - wake);
+        sleepTotal += spinStart - now;
+    }
+
+    while ((now = NowNs()) < deadline) CpuRelax();
+
+    if (spinStart < deadline) spinTotal += now - spinStart;
+
+    // Past the deadline already when the sleep returned: the error is all overshoot
+    int64_t error = now - deadline;
+    waited++;
+    errorSum += error;
+    if (error > errorMax) errorMax = error;
+    if (error > (int64_t)(FRAME_LIMITER_TOLERANCE_MS*1000000.0)) late++;
+#endif
+}
+
+FrameLimiterStats GetFrameLimiterStats(void)
+{
+    FrameLimiterStats stats = { 0 };
+
+#if defined(FRAME_LIMITER_SUPPORTED)
+    stats.frames = frames;
+    stats.missed = missed;
+    stats.late = late;
+    stats.meanErrorMs = (waited > 0) ? errorSum/1000000.0/waited : 0.0;
+    stats.maxErrorMs = errorMax/1000000.0;
+    stats.marginMs = margin/1000000.0;
+    stats.spinShare = (sleepTotal + spinTotal > 0) ? (double)spinTotal/(sleepTotal + spinTotal) : 0.0;
+#endif
+
+    return stats;
+}
+
+void CloseFrameLimiter(void)
+{
+#if defined(FRAME_LIMITER_SUPPORTED)
+    if (!limiterActive || (frames == 0)) return;
+
+    FrameLimiterStats stats = GetFrameLimiterStats();
+
+    TraceLog(LOG_INFO, "LIMITER: %llu frames, %llu missed (frame work past the deadline), %llu woke more than %.1f ms late",
+             stats.frames, stats.missed, stats.late, FRAME_LIMITER_TOLERANCE_MS);
+    TraceLog(LOG_INFO, "LIMITER: Deadline error mean %.3f ms, max %.3f ms, spin margin %.3f ms, %.1f%% of the wait spinning",
+             stats.meanErrorMs, stats.maxErrorMs, stats.marginMs, 100.0*stats.spinShare);
+
+    limiterActive = false;
+#endif
+}
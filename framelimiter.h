@@ -0,0 +1,49 @@
+/*******************************************************************************************
+*
+*   C-volley - hybrid frame limiter
+*
+*   SetTargetFPS() waits in EndDrawing() either with a plain sleep, which oversleeps by the
+*   OS timer granularity and costs frames, or by busy waiting, which keeps a core at 100%.
+*   The frame limiter sleeps on an absolute monotonic deadline until shortly before the next
+*   frame is due and spins only for the rest. The spin margin follows the measured sleep
+*   overshoot (mean plus four mean deviations), so a quiet machine spins for tens of
+*   microseconds and a loaded one for as long as its wakeups need.
+*
+*   Deadlines are absolute (one period after the previous one), a late frame is made up by
+*   the next; a frame more than a whole period late restarts the schedule instead of
+*   rushing catch-up frames.
+*
+*   POSIX only; InitFrameLimiter() returns false elsewhere, SetTargetFPS() stays in charge.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef FRAMELIMITER_H
+#define FRAMELIMITER_H
+
+#include <stdbool.h>
+
+#define FRAME_LIMITER_TOLERANCE_MS 0.2  // Wakeups later than this past the deadline count as late
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct FrameLimiterStats {
+    unsigned long long frames;
+    unsigned long long missed;          // Frame work ran past its deadline, no wait
+    unsigned long long late;            // Woke more than FRAME_LIMITER_TOLERANCE_MS after the deadline
+    double meanErrorMs;                 // Wakeup after the deadline, frames that waited
+    double maxErrorMs;
+    double marginMs;                    // Current spin margin before the deadline
+    double spinShare;                   // Part of the waiting time spent spinning, 0..1
+} FrameLimiterStats;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool InitFrameLimiter(double targetFps);        // Replaces SetTargetFPS(), which it sets to 0
+void WaitFrameLimiter(void);                    // Once per frame, after EndDrawing()
+FrameLimiterStats GetFrameLimiterStats(void);
+void CloseFrameLimiter(void);                   // Logs the stats
+
+#endif // FRAMELIMITER_H
@@ -0,0 +1,319 @@
+/*******************************************************************************************
+*
+*   C-volley - dead reckoning state sync for server/client play
+*
+*   The server applies its own messages to the replica through the same decoder clients use,
+*   so after every tick replica == truth and the replica always equals what a client that
+*   received every message predicts.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "netsync.h"
+
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+static inline uint8_t *PutBytes(uint8_t *out, const void *value, int size)
+{
+    memcpy(out, value, size);
+    return out + size;
+}
+
+static inline const uint8_t *GetBytes(const uint8_t *in, void *value, int size)
+{
+    memcpy(value, in, size);
+    return in + size;
+}
+
+static bool VectorEqual(Vector2 a, Vector2 b)
+{
+    return (a.x == b.x) && (a.y == b.y);
+}
+
+static bool BallEqual(const SimBall *a, const SimBall *b)
+{
+    return VectorEqual(a->position, b->position) && VectorEqual(a->velocity, b->velocity) && (a->rotation == b->rotation);
+}
+
+static bool BlobEqual(const SimBlob *a, const SimBlob *b)
+{
+    return VectorEqual(a->position, b->position) && VectorEqual(a->velocity, b->velocity) && (a->onGround == b->onGround);
+}
+
+static bool MatchEqual(const SimState *a, const SimState *b)
+{
+    return (a->blobs[0].score == b->blobs[0].score) && (a->blobs[1].score == b->blobs[1].score) &&
+           (a->servingSide == b->servingSide) && (a->gameOver == b->gameOver) && (a->scoreDelay == b->scoreDelay) &&
+           (a->aiJumpCooldown[0] == b->aiJumpCooldown[0]) && (a->aiJumpCooldown[1] == b->aiJumpCooldown[1]) &&
+           (a->rng == b->rng);
+}
+
+static int Encode(const SimState *state, const unsigned char held[2], unsigned int mask, uint8_t *message)
+{
+    uint8_t *out = message;
+    uint32_t tick = (uint32_t)state->tick;
+    uint8_t mask8 = (uint8_t)mask;
+
+    out = PutBytes(out, &tick, 4);
+    out = PutBytes(out, &mask8, 1);
+
+    if (mask & NETSYNC_BALL)
+    {
+        out = PutBytes(out, &state->ball.position, 8);
+        out = PutBytes(out, &state->ball.velocity, 8);
+        out = PutBytes(out, &state->ball.rotation, 4);
+    }
+
+    for (int side = 0; side < 2; side++)
+    {
+        if (!(mask & (NETSYNC_BLOB_LEFT << side))) continue;
+
+        const SimBlob *blob = &state->blobs[side];
+        uint8_t flags[2] = { held[side], blob->onGround };
+
+        out = PutBytes(out, &blob->position, 8);
+        out = PutBytes(out, &blob->velocity, 8);
+        out = PutBytes(out, flags, 2);
+    }
+
+    if (mask & NETSYNC_MATCH)
+    {
+        uint8_t bytes[4] = { (uint8_t)state->blobs[0].score, (uint8_t)state->blobs[1].score, (uint8_t)state->servingSide, state->gameOver };
+        uint16_t scoreDelay = (uint16_t)state->scoreDelay;
+        uint8_t cooldown[2] = { (uint8_t)state->aiJumpCooldown[0], (uint8_t)state->aiJumpCooldown[1] };
+
+        out = PutBytes(out, bytes, 4);
+        out = PutBytes(out, &scoreDelay, 2);
+        out = PutBytes(out, cooldown, 2);
+        out = PutBytes(out, &state->rng, 4);
+    }
+
+    return (int)(out - message);
+}
+
+static int MessageSize(unsigned int mask)
+{
+    int size = NETSYNC_HEADER_SIZE;
+    if (mask & NETSYNC_BALL) size += 20;
+    if (mask & NETSYNC_BLOB_LEFT) size += 18;
+    if (mask & NETSYNC_BLOB_RIGHT) size += 18;
+    if (mask & NETSYNC_MATCH) size += 12;
+
+    return size;
+}
+
+// Overwrite the parts present in the message, the caller checked size and tick
+static void Apply(SimState *state, unsigned char held[2], const uint8_t *message)
+{
+    const uint8_t *in = message + 4;
+    uint8_t mask = 0;
+    in = GetBytes(in, &mask, 1);
+
+    if (mask & NETSYNC_BALL)
+    {
+        in = GetBytes(in, &state->ball.position, 8);
+        in = GetBytes(in, &state->ball.velocity, 8);
+        in = GetBytes(in, &state->ball.rotation, 4);
+    }
+
+    for (int side = 0; side < 2; side++)
+    {
+        if (!(mask & (NETSYNC_BLOB_LEFT << side))) continue;
+
+        SimBlob *blob = &state->blobs[side];
+        uint8_t flags[2];
+
+        in = GetBytes(in, &blob->position, 8);
+        in = GetBytes(in, &blob->velocity, 8);
+        in = GetBytes(in, flags, 2);
+
+        held[side] = flags[0];
+        blob->onGround = (flags[1] != 0);
+    }
+
+    if (mask & NETSYNC_MATCH)
+    {
+        uint8_t bytes[4];
+        uint16_t scoreDelay;
+        uint8_t cooldown[2];
+
+        in = GetBytes(in, bytes, 4);
+        in = GetBytes(in, &scoreDelay, 2);
+        in = GetBytes(in, cooldown, 2);
+        in = GetBytes(in, &state->rng, 4);
+
+        state->blobs[0].score = bytes[0];
+        state->blobs[1].score = bytes[1];
+        state->servingSide = bytes[2];
+        state->gameOver = (bytes[3] != 0);
+        state->scoreDelay = scoreDelay;
+        state->aiJumpCooldown[0] = cooldown[0];
+        state->aiJumpCooldown[1] = cooldown[1];
+    }
+}
+
+// One predicted tick, counted even over a predicted game over since a late message may undo it
+static unsigned int PredictTick(NetSyncClient *client)
+{
+    unsigned int events = 0;
+
+    if (client->predicted.gameOver) client->predicted.tick++;
+    else events = SimStep(&client->predicted, client->held);
+
+    client->history[client->predicted.tick%NETSYNC_HISTORY] = client->predicted;
+
+    return events;
+}
+
+static void AddError(Vector2 *error, Vector2 before, Vector2 after)
+{
+    error->x += before.x - after.x;
+    error->y += before.y - after.y;
+
+    if (sqrtf(error->x*error->x + error->y*error->y) > NETSYNC_SNAP_DISTANCE) *error = (Vector2){ 0, 0 };
+}
+
+static void DecayError(Vector2 *error)
+{
+    error->x *= NETSYNC_ERROR_DECAY;
+    error->y *= NETSYNC_ERROR_DECAY;
+
+    if (fabsf(error->x) < 0.05f) error->x = 0;
+    if (fabsf(error->y) < 0.05f) error->y = 0;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+void NetSyncServerInit(NetSyncServer *server, const SimState *initial, int keyframeInterval)
+{
+    memset(server, 0, sizeof(NetSyncServer));
+    server->replica = *initial;
+    server->keyframeInterval = keyframeInterval;
+}
+
+int NetSyncServerUpdate(NetSyncServer *server, const SimState *truth, const unsigned char actions[2], uint8_t *message)
+{
+    if (truth->tick == server->replica.tick) return 0;     // Nothing simulated (game over)
+
+    server->stats.ticks++;
+
+    SimStep(&server->replica, server->held);
+
+    // Keyframe on schedule, or when the caller skipped ticks and the replica fell out of step
+    bool keyframe = (server->replica.tick != truth->tick) ||
+                    ((server->keyframeInterval > 0) && (truth->tick%server->keyframeInterval == 0));
+
+    unsigned int mask = 0;
+    unsigned char held[2];
+
+    if (keyframe || !BallEqual(&server->replica.ball, &truth->ball)) mask |= NETSYNC_BALL;
+
+    for (int side = 0; side < 2; side++)
+    {
+        held[side] = actions[side] & ~ACTION_JUMP;
+
+        if (keyframe || (held[side] != server->held[side]) || !BlobEqual(&server->replica.blobs[side], &truth->blobs[side]))
+        {
+            mask |= (NETSYNC_BLOB_LEFT << side);
+        }
+    }
+
+    if (keyframe || !MatchEqual(&server->replica, truth)) mask |= NETSYNC_MATCH;
+
+    if (mask == 0) return 0;
+
+    int size = Encode(truth, held, mask, message);
+
+    server->replica.tick = truth->tick;
+    Apply(&server->replica, server->held, message);
+
+    server->stats.messages++;
+    server->stats.bytes += size;
+    if (mask & NETSYNC_BALL) server->stats.ballUpdates++;
+    if (mask & NETSYNC_BLOB_LEFT) server->stats.blobUpdates++;
+    if (mask & NETSYNC_BLOB_RIGHT) server->stats.blobUpdates++;
+    if (mask & NETSYNC_MATCH) server->stats.matchUpdates++;
+
+    return size;
+}
+
+int NetSyncEncodeFull(const SimState *state, const unsigned char actions[2], uint8_t *message)
+{
+    return Encode(state, actions, NETSYNC_BALL | NETSYNC_BLOB_LEFT | NETSYNC_BLOB_RIGHT | NETSYNC_MATCH, message);
+}
+
+void NetSyncClientInit(NetSyncClient *client, const SimState *initial)
+{
+    memset(client, 0, sizeof(NetSyncClient));
+    client->predicted = *initial;
+    client->history[initial->tick%NETSYNC_HISTORY] = *initial;
+}
+
+unsigned int NetSyncClientStep(NetSyncClient *client)
+{
+    unsigned int events = PredictTick(client);
+
+    DecayError(&client->ballError);
+    DecayError(&client->blobError[0]);
+    DecayError(&client->blobError[1]);
+
+    return events;
+}
+
+bool NetSyncClientReceive(NetSyncClient *client, const uint8_t *message, int size)
+{
+    if (size < NETSYNC_HEADER_SIZE) return false;
+
+    uint32_t tick32;
+    memcpy(&tick32, message, 4);
+    if (size != MessageSize(message[4])) return false;
+
+    int tick = (int)tick32;
+    int now = client->predicted.tick;
+
+    // Early message: predict up to its tick first
+    while (client->predicted.tick < tick) NetSyncClientStep(client);
+
+    if (tick > now) now = client->predicted.tick;
+    else if (tick <= now - NETSYNC_HISTORY) return false;     // Too late to rewind, the next keyframe fixes it
+
+    Vector2 ballBefore = client->predicted.ball.position;
+    Vector2 blobBefore[2] = { client->predicted.blobs[0].position, client->predicted.blobs[1].position };
+
+    // Correct the state of that tick, then predict forward again to where we were
+    SimState *state = &client->history[tick%NETSYNC_HISTORY];
+    if (tick < now)
+    {
+        client->rewinds++;
+        client->predicted = *state;
+    }
+
+    Apply(&client->predicted, client->held, message);
+    client->predicted.tick = tick;
+    *state = client->predicted;
+
+    while (client->predicted.tick < now) PredictTick(client);
+
+    AddError(&client->ballError, ballBefore, client->predicted.ball.position);
+    AddError(&client->blobError[0], blobBefore[0], client->predicted.blobs[0].position);
+    AddError(&client->blobError[1], blobBefore[1], client->predicted.blobs[1].position);
+
+    return true;
+}
+
+Vector2 NetSyncClientBallPosition(const NetSyncClient *client)
+{
+    return (Vector2){ client->predicted.ball.position.x + client->ballError.x, client->predicted.ball.position.y + client->ballError.y };
+}
+
+Vector2 NetSyncClientBlobPosition(const NetSyncClient *client, int side)
+{
+    const SimBlob *blob = &client->predicted.blobs[side];
+    return (Vector2){ blob->position.x + client->blobError[side].x, blob->position.y + client->blobError[side].y };
+}
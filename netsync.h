@@ -0,0 +1,94 @@
+/*******************************************************************************************
+*
+*   C-volley - dead reckoning state sync for server/client play
+*
+*   Instead of a snapshot every tick the server only sends what clients cannot predict.
+*   Clients run SimStep() on their own copy of the match, holding the last known action of
+*   each side (jump is an edge and is never held). The server keeps a replica of exactly that
+*   prediction and, after each authoritative tick, sends:
+*     - the ball, when the replica ball differs (blob touches, resets, anything off-prediction)
+*     - a blob and its new held action, when the input changed or the replica blob differs
+*     - scores/serve/timers/AI state, when they differ
+*   Free flight, wall/ceiling/net/ground bounces and blob walking/jumping under a held input
+*   are predicted exactly, so a rally costs a few messages per touch instead of 60/s.
+*
+*   Clients rewind over a short history when a message arrives late, and keep a display
+*   offset that decays after corrections so objects do not visibly jump.
+*
+*   Messages are host byte order (all supported targets are little-endian):
+*     uint32 tick, uint8 mask, then per set bit in mask order:
+*       ball  (NETSYNC_BALL):   float x, y, vx, vy, rotation                         20 bytes
+*       blob  (NETSYNC_BLOB_*): float x, y, vx, vy, uint8 action, uint8 onGround     18 bytes
+*       match (NETSYNC_MATCH):  uint8 score[2], servingSide, gameOver, uint16 scoreDelay,
+*                               uint8 aiJumpCooldown[2], uint32 rng                  12 bytes
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef NETSYNC_H
+#define NETSYNC_H
+
+#include "sim.h"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define NETSYNC_BALL        0x01
+#define NETSYNC_BLOB_LEFT   0x02
+#define NETSYNC_BLOB_RIGHT  0x04
+#define NETSYNC_MATCH       0x08
+
+#define NETSYNC_HEADER_SIZE 5
+#define NETSYNC_MAX_MESSAGE (NETSYNC_HEADER_SIZE + 20 + 2*18 + 12)
+#define NETSYNC_HISTORY 64                  // Ticks a late message can be rewound over
+#define NETSYNC_DEFAULT_KEYFRAME 600        // Full state every 10 s, bounds cross-platform float drift
+#define NETSYNC_ERROR_DECAY 0.85f           // Display offset kept per tick after a correction
+#define NETSYNC_SNAP_DISTANCE 80.0f         // Larger corrections are shown immediately
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct NetSyncStats {
+    uint64_t ticks;
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t ballUpdates;
+    uint64_t blobUpdates;
+    uint64_t matchUpdates;
+} NetSyncStats;
+
+typedef struct NetSyncServer {
+    SimState replica;               // What every client predicts right now
+    unsigned char held[2];          // Actions clients extrapolate with
+    int keyframeInterval;           // 0 disables keyframes
+    NetSyncStats stats;
+} NetSyncServer;
+
+typedef struct NetSyncClient {
+    SimState predicted;
+    unsigned char held[2];
+    SimState history[NETSYNC_HISTORY];      // Predicted state after tick t at t%NETSYNC_HISTORY
+    Vector2 ballError;                      // Display offsets, see NetSyncClientBallPosition()
+    Vector2 blobError[2];
+    uint64_t rewinds;                       // Late messages replayed over history
+} NetSyncClient;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+
+// Server: call after every authoritative SimStep(truth, actions), returns message size, 0 = nothing to send
+void NetSyncServerInit(NetSyncServer *server, const SimState *initial, int keyframeInterval);
+int NetSyncServerUpdate(NetSyncServer *server, const SimState *truth, const unsigned char actions[2], uint8_t *message);
+int NetSyncEncodeFull(const SimState *state, const unsigned char actions[2], uint8_t *message);   // Fixed-rate snapshot
+
+// Client: step once per tick, feed messages in order as they arrive
+void NetSyncClientInit(NetSyncClient *client, const SimState *initial);
+unsigned int NetSyncClientStep(NetSyncClient *client);                      // Returns SIM_EVENT_* of the prediction
+bool NetSyncClientReceive(NetSyncClient *client, const uint8_t *message, int size);
+Vector2 NetSyncClientBallPosition(const NetSyncClient *client);             // Prediction plus decaying correction
+Vector2 NetSyncClientBlobPosition(const NetSyncClient *client, int side);
+
+#endif // NETSYNC_H
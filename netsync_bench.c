@@ -0,0 +1,171 @@
+/*******************************************************************************************
+*
+*   C-volley - dead reckoning bandwidth comparison
+*
+*   Usage:
+*     netsync_bench [matches] [--latency TICKS] [--keyframe TICKS]
+*
+*   Plays whole matches headless (scripted human-like players against the built-in AI and
+*   against each other), feeds the server messages to a client through a fixed latency and reports bytes per
+*   match against fixed-rate full snapshots at 60 Hz and 20 Hz, with and without 28 bytes
+*   of UDP/IPv4 header per packet. At the end of every match the client prediction must be
+*   bit-identical to the server state.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "netsync.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UDP_OVERHEAD 28
+#define MAX_LATENCY 60
+#define MAX_MATCH_TICKS (60*60*30)
+
+typedef struct PendingMessage {
+    int size;
+    uint8_t data[NETSYNC_MAX_MESSAGE];
+} PendingMessage;
+
+typedef struct Totals {
+    uint64_t ticks;
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t fullBytes60;
+    uint64_t fullBytes20;
+    uint64_t rewinds;
+    double displayError;
+    double maxDisplayError;
+    int mismatches;
+} Totals;
+
+static void PlayMatch(uint32_t seed, int scriptedSides, int latency, int keyframe, Totals *totals)
+{
+    SimState truth;
+    SimInit(&truth, seed);
+
+    // Separate generators for the scripted players so they do not disturb the AI's
+    SimScript script[2];
+    SimScriptInit(&script[0], seed*2654435761u + 1);
+    SimScriptInit(&script[1], seed*2654435761u + 2);
+
+    NetSyncServer server;
+    NetSyncClient client;
+    NetSyncServerInit(&server, &truth, keyframe);
+    NetSyncClientInit(&client, &truth);
+
+    static PendingMessage pending[MAX_LATENCY + 1];
+    for (int i = 0; i <= latency; i++) pending[i].size = 0;
+
+    while (!truth.gameOver && (truth.tick < MAX_MATCH_TICKS))
+    {
+        unsigned char actions[2] = { ACTION_AI, ACTION_AI };
+        for (int side = 0; side < scriptedSides; side++) actions[side] = SimScriptAction(&script[side], &truth, side);
+
+        SimStep(&truth, actions);
+
+        // Outgoing message of this tick, sent by the server 'latency' ticks before the client sees it
+        PendingMessage *slot = &pending[truth.tick%(latency + 1)];
+        slot->size = NetSyncServerUpdate(&server, &truth, actions, slot->data);
+
+        uint8_t full[NETSYNC_MAX_MESSAGE];
+        int fullSize = NetSyncEncodeFull(&truth, actions, full);
+        totals->fullBytes60 += fullSize + UDP_OVERHEAD;
+        if (truth.tick%3 == 0) totals->fullBytes20 += fullSize + UDP_OVERHEAD;
+
+        NetSyncClientStep(&client);
+
+        // Message sent 'latency' ticks ago arrives now
+        PendingMessage *arriving = &pending[(truth.tick + 1)%(latency + 1)];
+        if ((latency == 0) && (slot->size > 0)) NetSyncClientReceive(&client, slot->data, slot->size);
+        else if ((latency > 0) && (arriving->size > 0))
+        {
+            NetSyncClientReceive(&client, arriving->data, arriving->size);
+            arriving->size = 0;
+        }
+
+        Vector2 shown = NetSyncClientBallPosition(&client);
+        float error = hypotf(shown.x - truth.ball.position.x, shown.y - truth.ball.position.y);
+        totals->displayError += error;
+        if (error > totals->maxDisplayError) totals->maxDisplayError = error;
+    }
+
+    // Deliver what is still in flight, the prediction must then match the server exactly
+    for (int i = 1; i <= latency; i++)
+    {
+        PendingMessage *arriving = &pending[(truth.tick + 1 + i)%(latency + 1)];
+        if (arriving->size > 0) NetSyncClientReceive(&client, arriving->data, arriving->size);
+    }
+
+    const SimState *predicted = &client.predicted;
+    bool same = (predicted->tick == truth.tick) && (memcmp(&predicted->ball, &truth.ball, sizeof(SimBall)) == 0);
+    for (int side = 0; side < 2; side++)
+    {
+        same = same && (predicted->blobs[side].position.x == truth.blobs[side].position.x) &&
+               (predicted->blobs[side].position.y == truth.blobs[side].position.y) &&
+               (predicted->blobs[side].score == truth.blobs[side].score);
+    }
+    if (!same) totals->mismatches++;
+
+    totals->ticks += server.stats.ticks;
+    totals->messages += server.stats.messages;
+    totals->bytes += server.stats.bytes + server.stats.messages*UDP_OVERHEAD;
+    totals->rewinds += client.rewinds;
+}
+
+static void Report(const char *name, int matches, const Totals *totals)
+{
+    double ticks = (double)totals->ticks/matches;
+    double bytes = (double)totals->bytes/matches;
+    double payload = (double)(totals->bytes - totals->messages*UDP_OVERHEAD)/matches;
+
+    printf("%s: %d matches, %.0f ticks/match, %.1f messages/match (%.2f per second)\n", name, matches, ticks,
+           (double)totals->messages/matches, totals->messages/(totals->ticks/60.0));
+    printf("  dead reckoning  %9.0f bytes/match (%.0f payload)\n", bytes, payload);
+    printf("  fixed 60 Hz     %9.0f bytes/match  %6.1fx more\n", (double)totals->fullBytes60/matches, totals->fullBytes60/(double)totals->bytes);
+    printf("  fixed 20 Hz     %9.0f bytes/match  %6.1fx more\n", (double)totals->fullBytes20/matches, totals->fullBytes20/(double)totals->bytes);
+    printf("  client: %llu rewinds, ball display error mean %.3f px, max %.1f px, %d final mismatches\n",
+           (unsigned long long)totals->rewinds, totals->displayError/totals->ticks, totals->maxDisplayError, totals->mismatches);
+}
+
+int main(int argc, char *argv[])
+{
+    int matches = 50;
+    int latency = 0;
+    int keyframe = NETSYNC_DEFAULT_KEYFRAME;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--latency") == 0) && (i + 1 < argc)) latency = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--keyframe") == 0) && (i + 1 < argc)) keyframe = atoi(argv[++i]);
+        else if (argv[i][0] != '-') matches = atoi(argv[i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [matches] [--latency TICKS] [--keyframe TICKS]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (latency < 0) latency = 0;
+    if (latency > MAX_LATENCY) latency = MAX_LATENCY;
+
+    printf("latency %d ticks, keyframe every %d ticks, %d byte full snapshot\n", latency, keyframe, NETSYNC_MAX_MESSAGE);
+
+    // NOTE: AI vs AI is not useful here, the first serve drops straight onto the idle left
+    // blob and the two AIs juggle it vertically forever
+    Totals ai = { 0 };
+    Totals human = { 0 };
+    for (int i = 0; i < matches; i++)
+    {
+        PlayMatch(1000 + i, 1, latency, keyframe, &ai);
+        PlayMatch(5000 + i, 2, latency, keyframe, &human);
+    }
+
+    Report("scripted vs AI", matches, &ai);
+    Report("scripted vs scripted", matches, &human);
+
+    return ((ai.mismatches + human.mismatches) > 0) ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+/*******************************************************************************************
+*
+*   C-volley - draw call and batch statistics
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "renderstats.h"
+
+#if defined(RENDER_STATS)
+
+#include "raylib.h"
+#include "atlas.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define MAX_STATS_SECTIONS 32
+#define MAX_STATS_DEPTH 8
+#define STATS_CSV_FILE "render_stats.csv"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct StatsCounters {
+    int drawCalls;
+    int vertices;
+    int textureSwitches;
+    int flushes;
+} StatsCounters;
+
+typedef struct StatsSection {
+    const char *name;
+    StatsCounters current;
+    StatsCounters previous;     // Last completed frame, shown by the overlay
+} StatsSection;
+
+//----------------------------------------------------------------------------------
+// Module state
+//----------------------------------------------------------------------------------
+static StatsSection sections[MAX_STATS_SECTIONS] = { 0 };
+static int sectionCount = 0;
+
+static int sectionStack[MAX_STATS_DEPTH] = { 0 };
+static int stackDepth = 0;
+
+static StatsCounters frameTotal = { 0 };
+static StatsCounters previousTotal = { 0 };
+static unsigned int frameIndex = 0;
+
+static unsigned int boundTexture = 0;   // Texture of the open draw call, 0 after a flush
+static bool paused = false;             // Overlay drawing is not counted
+
+static bool overlayVisible = false;
+
+// CSV lines collected in memory while logging and saved in one SaveFileData() when it stops,
+// which the I/O service (fileio.h) takes off the frame
+static bool csvLogging = false;
+static char *csvText = NULL;
+static int csvSize = 0;
+static int csvCapacity = 0;
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+static int FindSection(const char *name)
+{
+    for (int i = 0; i < sectionCount; i++)
+    {
+        if (sections[i].name == name) return i;
+    }
+
+    if (sectionCount == MAX_STATS_SECTIONS) return 0;
+
+    sections[sectionCount].name = name;
+    return sectionCount++;
+}
+
+static StatsCounters *CurrentCounters(void)
+{
+    return &sections[sectionStack[stackDepth - 1]].current;
+}
+
+static void CsvAppend(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    if (csvSize + length + 1 > csvCapacity)
+    {
+        int capacity = (csvCapacity > 0) ? csvCapacity : 65536;
+        while (capacity < csvSize + length + 1) capacity *= 2;
+
+        char *grown = (char *)realloc(csvText, capacity);
+        if (grown == NULL) return;
+
+        csvText = grown;
+        csvCapacity = capacity;
+    }
+
+    va_start(args, format);
+    vsnprintf(csvText + csvSize, csvCapacity - csvSize, format, args);
+    va_end(args);
+    csvSize += length;
+}
+
+//----------------------------------------------------------------------------------
+// Module functions definition
+//----------------------------------------------------------------------------------
+void RenderStatsFrameBegin(void)
+{
+    for (int i = 0; i < sectionCount; i++) sections[i].current = (StatsCounters){ 0 };
+    frameTotal = (StatsCounters){ 0 };
+    boundTexture = 0;
+
+    // Anything drawn outside an explicit section lands in "Frame"
+    stackDepth = 0;
+    sectionStack[stackDepth++] = FindSection("Frame");
+}
+
+void RenderStatsFrameEnd(void)
+{
+    // EndDrawing() always flushes the batch
+    CurrentCounters()->flushes++;
+    frameTotal.flushes++;
+
+    if (csvLogging)
+    {
+        for (int i = 0; i < sectionCount; i++)
+        {
+            StatsCounters c = sections[i].current;
+            CsvAppend("%u,%s,%d,%d,%d,%d\n", frameIndex, sections[i].name,
+                      c.drawCalls, c.vertices, c.textureSwitches, c.flushes);
+        }
+    }
+
+    for (int i = 0; i < sectionCount; i++) sections[i].previous = sections[i].current;
+    previousTotal = frameTotal;
+    frameIndex++;
+}
+
+void RenderStatsBegin(const char *section)
+{
+    if (stackDepth < MAX_STATS_DEPTH) sectionStack[stackDepth++] = FindSection(section);
+}
+
+void RenderStatsEnd(void)
+{
+    if (stackDepth > 1) stackDepth--;
+}
+
+void RenderStatsPrimitive(unsigned int textureId, int vertexCount, bool flushed)
+{
+    if (paused || (stackDepth == 0)) return;
+
+    StatsCounters *counters = CurrentCounters();
+
+    if (flushed)
+    {
+        counters->flushes++;
+        frameTotal.flushes++;
+        boundTexture = 0;
+    }
+
+    if (textureId != boundTexture)
+    {
+        if (boundTexture != 0)
+        {
+            counters->textureSwitches++;
+            frameTotal.textureSwitches++;
+        }
+        counters->drawCalls++;
+        frameTotal.drawCalls++;
+        boundTexture = textureId;
+    }
+
+    counters->vertices += vertexCount;
+    frameTotal.vertices += vertexCount;
+}
+
+void UpdateRenderStats(void)
+{
+    if (IsKeyPressed(KEY_F3)) overlayVisible = !overlayVisible;
+
+    if (IsKeyPressed(KEY_F4))
+    {
+        if (!csvLogging)
+        {
+            csvLogging = true;
+            csvSize = 0;
+            CsvAppend("frame,section,draw_calls,vertices,texture_switches,flushes\n");
+            TraceLog(LOG_INFO, "STATS: Logging render stats to %s", STATS_CSV_FILE);
+        }
+        else CloseRenderStats();
+    }
+}
+
+void DrawRenderStats(void)
+{
+    if (!overlayVisible) return;
+
+    paused = true;
+
+    int x = 10;
+    int y = 10;
+    int rows = 0;
+    for (int i = 0; i < sectionCount; i++) if (sections[i].previous.vertices > 0) rows++;
+
+    AtlasDrawRectangle((float)x - 5, (float)y - 5, 430, (float)(rows + 3)*14 + 10, Fade(BLACK, 0.7f));
+    AtlasDrawText(TextFormat("frame %u  draws %d  verts %d  switches %d  flushes %d",
+                             frameIndex, previousTotal.drawCalls, previousTotal.vertices,
+                             previousTotal.textureSwitches, previousTotal.flushes),
+                  x, y, 10, GREEN);
+    y += 20;
+    AtlasDrawText("section              draws   verts  switch  flush", x, y, 10, LIGHTGRAY);
+    y += 14;
+
+    for (int i = 0; i < sectionCount; i++)
+    {
+        StatsCounters c = sections[i].previous;
+        if (c.vertices == 0) continue;
+
+        AtlasDrawText(TextFormat("%-20s %5d %7d %7d %6d", sections[i].name,
+                                 c.drawCalls, c.vertices, c.textureSwitches, c.flushes),
+                      x, y, 10, WHITE);
+        y += 14;
+    }
+
+    paused = false;
+}
+
+void CloseRenderStats(void)
+{
+    if (csvLogging)
+    {
+        if ((csvText == NULL) || !SaveFileData(STATS_CSV_FILE, csvText, csvSize)) TraceLog(LOG_WARNING, "STATS: Could not write %s", STATS_CSV_FILE);
+        csvLogging = false;
+    }
+
+    free(csvText);
+    csvText = NULL;
+    csvSize = csvCapacity = 0;
+}
+
+#endif // RENDER_STATS
@@ -0,0 +1,57 @@
+/*******************************************************************************************
+*
+*   C-volley - draw call and batch statistics
+*
+*   Counts draw calls, vertices, texture switches and batch flushes per Draw* section,
+*   mirroring rlgl batching rules: a new draw call opens whenever the bound texture changes
+*   or the batch was flushed. F3 toggles the overlay, F4 toggles per-frame CSV logging (the
+*   file is written when logging stops).
+*
+*   Everything here compiles out when NDEBUG is defined (make release).
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#if !defined(NDEBUG)
+    #define RENDER_STATS
+#endif
+
+#if defined(RENDER_STATS)
+
+#include <stdbool.h>
+
+void RenderStatsFrameBegin(void);
+void RenderStatsFrameEnd(void);                 // Call after EndDrawing(), accounts its flush
+void RenderStatsBegin(const char *section);     // Section names must be string literals
+void RenderStatsEnd(void);
+void RenderStatsPrimitive(unsigned int textureId, int vertexCount, bool flushed);
+void UpdateRenderStats(void);                   // Handles the toggle keys
+void DrawRenderStats(void);                     // Overlay, shows the previous frame
+void CloseRenderStats(void);
+
+#define RENDER_STATS_FRAME_BEGIN()                  RenderStatsFrameBegin()
+#define RENDER_STATS_FRAME_END()                    RenderStatsFrameEnd()
+#define RENDER_STATS_BEGIN(section)                 RenderStatsBegin(section)
+#define RENDER_STATS_END()                          RenderStatsEnd()
+#define RENDER_STATS_PRIMITIVE(tex, verts, flushed) RenderStatsPrimitive(tex, verts, flushed)
+#define RENDER_STATS_UPDATE()                       UpdateRenderStats()
+#define RENDER_STATS_DRAW()                         DrawRenderStats()
+#define RENDER_STATS_CLOSE()                        CloseRenderStats()
+
+#else
+
+#define RENDER_STATS_FRAME_BEGIN()                  ((void)0)
+#define RENDER_STATS_FRAME_END()                    ((void)0)
+#define RENDER_STATS_BEGIN(section)                 ((void)0)
+#define RENDER_STATS_END()                          ((void)0)
+#define RENDER_STATS_PRIMITIVE(tex, verts, flushed) ((void)(flushed))
+#define RENDER_STATS_UPDATE()                       ((void)0)
+#define RENDER_STATS_DRAW()                         ((void)0)
+#define RENDER_STATS_CLOSE()                        ((void)0)
+
+#endif
+
+#endif // RENDERSTATS_H
@@ -0,0 +1,398 @@
+/*******************************************************************************************
+*
+*   C-volley - match replays
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char replayMagic[4] = { 'C', 'V', 'R', 'P' };
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+static inline uint8_t *PutBytes(uint8_t *out, const void *value, int size)
+{
+    memcpy(out, value, size);
+    return out + size;
+}
+
+static inline const uint8_t *GetBytes(const uint8_t *in, void *value, int size)
+{
+    memcpy(value, in, size);
+    return in + size;
+}
+
+// Every field of SimState explicitly, so the file does not depend on struct padding
+static void WriteState(const SimState *state, uint8_t *out)
+{
+    for (int side = 0; side < 2; side++)
+    {
+        const SimBlob *blob = &state->blobs[side];
+        int32_t score = blob->score;
+        uint8_t onGround = blob->onGround;
+
+        out = PutBytes(out, &blob->position, 8);
+        out = PutBytes(out, &blob->velocity, 8);
+        out = PutBytes(out, &score, 4);
+        out = PutBytes(out, &onGround, 1);
+    }
+
+    int32_t ints[5] = { state->tick, state->servingSide, state->scoreDelay, state->aiJumpCooldown[0], state->aiJumpCooldown[1] };
+    uint8_t gameOver = state->gameOver;
+
+    out = PutBytes(out, &state->ball.position, 8);
+    out = PutBytes(out, &state->ball.velocity, 8);
+    out = PutBytes(out, &state->ball.rotation, 4);
+    out = PutBytes(out, ints, 20);
+    out = PutBytes(out, &state->rng, 4);
+    out = PutBytes(out, &gameOver, 1);
+}
+
+static void ReadState(SimState *state, const uint8_t *in)
+{
+    memset(state, 0, sizeof(SimState));
+
+    for (int side = 0; side < 2; side++)
+    {
+        SimBlob *blob = &state->blobs[side];
+        int32_t score;
+        uint8_t onGround;
+
+        in = GetBytes(in, &blob->position, 8);
+        in = GetBytes(in, &blob->velocity, 8);
+        in = GetBytes(in, &score, 4);
+        in = GetBytes(in, &onGround, 1);
+
+        blob->score = score;
+        blob->onGround = (onGround != 0);
+    }
+
+    int32_t ints[5];
+    uint8_t gameOver;
+
+    in = GetBytes(in, &state->ball.position, 8);
+    in = GetBytes(in, &state->ball.velocity, 8);
+    in = GetBytes(in, &state->ball.rotation, 4);
+    in = GetBytes(in, ints, 20);
+    in = GetBytes(in, &state->rng, 4);
+    in = GetBytes(in, &gameOver, 1);
+
+    state->tick = ints[0];
+    state->servingSide = ints[1];
+    state->scoreDelay = ints[2];
+    state->aiJumpCooldown[0] = ints[3];
+    state->aiJumpCooldown[1] = ints[4];
+    state->gameOver = (gameOver != 0);
+}
+
+// Keyframe due before the next action pair
+static bool KeyframeNext(const ReplayDecoder *decoder)
+{
+    int ticks = decoder->replay.tickCount;
+
+    return (decoder->version >= 2) && (decoder->replay.keyframeCount < ticks/REPLAY_KEYFRAME_TICKS);
+}
+
+// Header and start state in pending: checks them and sizes the buffers for the whole replay
+static bool DecodeHeader(ReplayDecoder *decoder)
+{
+    uint32_t version = 0;
+    uint32_t ticks = 0;
+    uint8_t source[4];
+
+    if (memcmp(decoder->pending, replayMagic, 4) != 0) return false;
+
+    const uint8_t *in = GetBytes(decoder->pending + 4, &version, 4);
+    in = GetBytes(in, source, 4);
+    in = GetBytes(in, &ticks, 4);
+
+    if ((version < 1) || (version > REPLAY_VERSION) || (ticks > 0x7FFFFFFF/2)) return false;
+
+    Replay *replay = &decoder->replay;
+    ReadState(&replay->start, in);
+    replay->source[0] = source[0];
+    replay->source[1] = source[1];
+
+    if (ticks > 0)
+    {
+        replay->actions = (unsigned char *)malloc((size_t)ticks*2);
+        if (replay->actions == NULL) return false;
+        replay->capacity = (int)ticks;
+    }
+
+    int keyframes = (version >= 2) ? (int)ticks/REPLAY_KEYFRAME_TICKS : 0;
+    if (keyframes > 0)
+    {
+        replay->keyframes = (SimState *)malloc((size_t)keyframes*sizeof(SimState));
+        if (replay->keyframes == NULL) return false;
+    }
+
+    decoder->version = (int)version;
+    decoder->totalTicks = (int)ticks;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+void ReplayBegin(Replay *replay, const SimState *start, const unsigned char source[2])
+{
+    replay->start = *start;
+    replay->source[0] = source[0];
+    replay->source[1] = source[1];
+    replay->tickCount = 0;
+    replay->keyframeCount = 0;
+}
+
+void ReplayRecord(Replay *replay, const unsigned char actions[2], const SimState *state)
+{
+    if (replay->tickCount >= replay->capacity)
+    {
+        int capacity = (replay->capacity > 0) ? replay->capacity*2 : 60*60*5;     // 5 minutes, then doubling
+        unsigned char *grown = (unsigned char *)realloc(replay->actions, (size_t)capacity*2);
+        if (grown == NULL) return;
+        replay->actions = grown;
+
+        SimState *keyframes = (SimState *)realloc(replay->keyframes, (size_t)(capacity/REPLAY_KEYFRAME_TICKS + 1)*sizeof(SimState));
+        if (keyframes == NULL) return;
+        replay->keyframes = keyframes;
+
+        replay->capacity = capacity;
+    }
+
+    replay->actions[replay->tickCount*2] = actions[0];
+    replay->actions[replay->tickCount*2 + 1] = actions[1];
+    replay->tickCount++;
+
+    // Taken from the live state so ReplayEncode() does not have to play the match again
+    if ((state != NULL) && (replay->tickCount%REPLAY_KEYFRAME_TICKS == 0) &&
+        (replay->keyframeCount == replay->tickCount/REPLAY_KEYFRAME_TICKS - 1))
+    {
+        replay->keyframes[replay->keyframeCount++] = *state;
+    }
+}
+
+void ReplayFree(Replay *replay)
+{
+    free(replay->actions);
+    free(replay->keyframes);
+    memset(replay, 0, sizeof(Replay));
+}
+
+uint8_t *ReplayEncode(const Replay *replay, int *size)
+{
+    uint32_t version = REPLAY_VERSION;
+    uint32_t ticks = (uint32_t)replay->tickCount;
+    uint8_t source[4] = { replay->source[0], replay->source[1], 0, 0 };
+    int keyframes = replay->tickCount/REPLAY_KEYFRAME_TICKS;
+
+    *size = REPLAY_HEADER_SIZE + REPLAY_STATE_SIZE + (int)ticks*2 + keyframes*REPLAY_STATE_SIZE;
+    uint8_t *data = (uint8_t *)malloc((size_t)*size);
+    if (data == NULL) return NULL;
+
+    uint8_t *out = PutBytes(data, replayMagic, 4);
+    out = PutBytes(out, &version, 4);
+    out = PutBytes(out, source, 4);
+    out = PutBytes(out, &ticks, 4);
+    WriteState(&replay->start, out);
+    out += REPLAY_STATE_SIZE;
+
+    // Keyframes as recorded, only a replay recorded without states (or read from version 1)
+    // plays the rest again
+    SimState state = replay->start;
+
+    for (int tick = 0; tick < replay->tickCount; tick += REPLAY_KEYFRAME_TICKS)
+    {
+        int count = replay->tickCount - tick;
+        if (count > REPLAY_KEYFRAME_TICKS) count = REPLAY_KEYFRAME_TICKS;
+
+        out = PutBytes(out, &replay->actions[tick*2], count*2);
+
+        if (count == REPLAY_KEYFRAME_TICKS)
+        {
+            int keyframe = tick/REPLAY_KEYFRAME_TICKS;
+            if (keyframe < replay->keyframeCount) state = replay->keyframes[keyframe];
+            else
+            {
+                for (int i = 0; i < count; i++) SimStep(&state, &replay->actions[(tick + i)*2]);
+            }
+
+            WriteState(&state, out);
+            out += REPLAY_STATE_SIZE;
+        }
+    }
+
+    return data;
+}
+
+bool ReplaySave(const Replay *replay, const char *fileName)
+{
+    int size = 0;
+    uint8_t *data = ReplayEncode(replay, &size);
+    if (data == NULL) return false;
+
+    FILE *file = fopen(fileName, "wb");
+    bool written = (file != NULL) && (fwrite(data, (size_t)size, 1, file) == 1);
+    if (file != NULL) written = (fclose(file) == 0) && written;
+
+    free(data);
+    return written;
+}
+
+bool ReplayLoad(Replay *replay, const char *fileName)
+{
+    memset(replay, 0, sizeof(Replay));
+
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+
+    // Through the decoder in file-sized chunks
+    ReplayDecoder decoder;
+    ReplayDecoderInit(&decoder);
+
+    uint8_t chunk[16384];
+    size_t read = 0;
+    while (!ReplayDecoderComplete(&decoder) && ((read = fread(chunk, 1, sizeof(chunk), file)) > 0))
+    {
+        if (!ReplayDecode(&decoder, chunk, (int)read)) break;
+    }
+
+    fclose(file);
+
+    if (!ReplayDecoderComplete(&decoder))
+    {
+        ReplayDecoderFree(&decoder);
+        return false;
+    }
+
+    *replay = decoder.replay;
+
+    return true;
+}
+
+int ReplaySeek(const Replay *replay, int tick, SimState *state)
+{
+    if (tick < 0) tick = 0;
+    if (tick > replay->tickCount) tick = replay->tickCount;
+
+    int keyframe = tick/REPLAY_KEYFRAME_TICKS;
+    if (keyframe > replay->keyframeCount) keyframe = replay->keyframeCount;
+
+    int from = keyframe*REPLAY_KEYFRAME_TICKS;
+    *state = (keyframe > 0) ? replay->keyframes[keyframe - 1] : replay->start;
+    for (int i = from; i < tick; i++) SimStep(state, &replay->actions[i*2]);
+
+    return tick;
+}
+
+void ReplayDecoderInit(ReplayDecoder *decoder)
+{
+    memset(decoder, 0, sizeof(ReplayDecoder));
+    decoder->totalTicks = -1;
+}
+
+bool ReplayDecode(ReplayDecoder *decoder, const uint8_t *data, int size)
+{
+    Replay *replay = &decoder->replay;
+
+    while ((size > 0) && !decoder->failed && !ReplayDecoderComplete(decoder))
+    {
+        bool header = (decoder->totalTicks < 0);
+
+        // Action pairs straight from the chunk up to the next keyframe, an odd byte waits in pending
+        if (!header && !KeyframeNext(decoder))
+        {
+            unsigned char *out = &replay->actions[replay->tickCount*2];
+
+            if (decoder->pendingSize == 1)
+            {
+                out[0] = decoder->pending[0];
+                out[1] = data[0];
+                decoder->pendingSize = 0;
+                replay->tickCount++;
+                data++;
+                size--;
+                continue;
+            }
+
+            int pairs = decoder->totalTicks - replay->tickCount;
+            if (decoder->version >= 2) pairs = REPLAY_KEYFRAME_TICKS - replay->tickCount%REPLAY_KEYFRAME_TICKS;
+            if (pairs > decoder->totalTicks - replay->tickCount) pairs = decoder->totalTicks - replay->tickCount;
+            if (pairs > size/2) pairs = size/2;
+
+            if (pairs == 0)
+            {
+                decoder->pending[0] = data[0];
+                decoder->pendingSize = 1;
+                data++;
+                size--;
+                continue;
+            }
+
+            memcpy(out, data, (size_t)pairs*2);
+            replay->tickCount += pairs;
+            data += pairs*2;
+            size -= pairs*2;
+            continue;
+        }
+
+        // Header and start state or a keyframe, gathered in pending
+        int recordSize = header ? REPLAY_HEADER_SIZE + REPLAY_STATE_SIZE : REPLAY_STATE_SIZE;
+        int take = recordSize - decoder->pendingSize;
+        if (take > size) take = size;
+
+        memcpy(decoder->pending + decoder->pendingSize, data, take);
+        decoder->pendingSize += take;
+        data += take;
+        size -= take;
+
+        if (decoder->pendingSize < recordSize) break;
+        decoder->pendingSize = 0;
+
+        if (header) decoder->failed = !DecodeHeader(decoder);
+        else ReadState(&replay->keyframes[replay->keyframeCount++], decoder->pending);
+    }
+
+    return !decoder->failed;
+}
+
+bool ReplayDecoderComplete(const ReplayDecoder *decoder)
+{
+    return !decoder->failed && (decoder->totalTicks >= 0) && (decoder->replay.tickCount == decoder->totalTicks) &&
+           !KeyframeNext(decoder);
+}
+
+void ReplayDecoderFree(ReplayDecoder *decoder)
+{
+    ReplayFree(&decoder->replay);
+    ReplayDecoderInit(decoder);
+}
+
+int ReplayDecoderSeek(const ReplayDecoder *decoder, int tick, SimState *state)
+{
+    return ReplaySeek(&decoder->replay, tick, state);
+}
+
+bool ReplayDecoderSync(const ReplayDecoder *decoder, int tick, SimState *state)
+{
+    const Replay *replay = &decoder->replay;
+    int keyframe = tick/REPLAY_KEYFRAME_TICKS;
+    if ((tick == 0) || (tick%REPLAY_KEYFRAME_TICKS != 0) || (keyframe > replay->keyframeCount)) return true;
+
+    // Compared as stored, struct padding is not part of the state
+    uint8_t stored[REPLAY_STATE_SIZE], current[REPLAY_STATE_SIZE];
+    WriteState(&replay->keyframes[keyframe - 1], stored);
+    WriteState(state, current);
+
+    *state = replay->keyframes[keyframe - 1];
+
+    return memcmp(stored, current, REPLAY_STATE_SIZE) == 0;
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************************
+*
+*   C-volley - match replays
+*
+*   SimStep() only depends on the state and the two action bytes, so a match is stored as the
+*   state it started from plus one pair of action bytes per tick (ACTION_AI where the built-in
+*   AI played, its random generator is part of the state). Replaying the actions through
+*   SimStep() reproduces every frame bit for bit on the same build.
+*
+*   Actions are collected in memory, with the state every REPLAY_KEYFRAME_TICKS as it is
+*   played, and written at the end of the match. File layout, host
+*   byte order (all supported targets are little-endian):
+*     char magic[4] "CVRP", uint32 version, uint8 source[2], uint8 reserved[2], uint32 ticks,
+*     start state (REPLAY_STATE_SIZE bytes, see WriteState() in replay.c),
+*     uint8 actions[ticks][2], in version 2 followed after every REPLAY_KEYFRAME_TICKS pairs
+*     by the state they lead to (a keyframe)
+*
+*   Keyframes let a reader that has only part of the file, a download still streaming in,
+*   seek anywhere in that part with at most REPLAY_KEYFRAME_TICKS steps, and put a build that
+*   simulates slightly differently (another compiler, WebAssembly) back on track every ten
+*   seconds. They cost 87 bytes per 1200 of actions. Version 1 files still load.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "sim.h"
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define REPLAY_VERSION 2
+#define REPLAY_KEYFRAME_TICKS 600       // Version 2
+#define REPLAY_HEADER_SIZE 16
+#define REPLAY_STATE_SIZE 87
+#define REPLAY_FILE_EXTENSION ".cvr"
+
+// Who produced a side's actions
+#define REPLAY_SOURCE_AI        0
+#define REPLAY_SOURCE_KEYBOARD  1
+#define REPLAY_SOURCE_BOT       2
+#define REPLAY_SOURCE_AGENT     3       // Agent plug-in (agent.h)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Replay {
+    SimState start;             // State the first action pair is applied to
+    unsigned char source[2];    // REPLAY_SOURCE_* per side
+    int tickCount;
+    int capacity;
+    unsigned char *actions;     // tickCount pairs, left then right
+    SimState *keyframes;        // keyframes[k]: state after (k + 1)*REPLAY_KEYFRAME_TICKS ticks
+    int keyframeCount;
+} Replay;
+
+// Reads a replay file from chunks as they arrive, any size and split
+typedef struct ReplayDecoder {
+    Replay replay;              // Start state once the header is in, then the actions and keyframes so far
+    int totalTicks;             // From the header, -1 until it is in
+    int version;
+    uint8_t pending[REPLAY_HEADER_SIZE + REPLAY_STATE_SIZE];    // Record split across chunks
+    int pendingSize;
+    bool failed;                // Not a replay, or a version this build does not read
+} ReplayDecoder;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+void ReplayBegin(Replay *replay, const SimState *start, const unsigned char source[2]);
+void ReplayRecord(Replay *replay, const unsigned char actions[2], const SimState *state);   // Actions passed to SimStep() and the state it returned
+void ReplayFree(Replay *replay);
+
+uint8_t *ReplayEncode(const Replay *replay, int *size);                // File contents (malloc), ReplaySave() writes them
+bool ReplaySave(const Replay *replay, const char *fileName);
+bool ReplayLoad(Replay *replay, const char *fileName);                 // ReplayFree() when done
+
+// State after the first 'tick' action pairs (clamped to the replay), from the nearest keyframe
+// before it, returns the tick reached
+int ReplaySeek(const Replay *replay, int tick, SimState *state);
+
+void ReplayDecoderInit(ReplayDecoder *decoder);
+bool ReplayDecode(ReplayDecoder *decoder, const uint8_t *data, int size);   // false once failed, bytes past the end are ignored
+bool ReplayDecoderComplete(const ReplayDecoder *decoder);
+void ReplayDecoderFree(ReplayDecoder *decoder);
+
+// As ReplaySeek() within what has arrived
+int ReplayDecoderSeek(const ReplayDecoder *decoder, int tick, SimState *state);
+
+// At a keyframe tick, sets state to the keyframe; false if it was not the same state
+bool ReplayDecoderSync(const ReplayDecoder *decoder, int tick, SimState *state);
+
+#endif // REPLAY_H
@@ -0,0 +1,207 @@
+/*******************************************************************************************
+*
+*   C-volley - local HTTP server for the web build and its streaming replays (POSIX)
+*
+*   Usage:
+*     replay_server [DIR] [--port N] [--rate BYTES_PER_SEC]
+*
+*   Serves the files under DIR (./build/web by default) on 127.0.0.1:PORT (8080) with the
+*   MIME types the browser needs for WebAssembly. Replays (REPLAY_FILE_EXTENSION) are sent
+*   in 512 byte pieces at --rate bytes per second (4096 by default, 0: as fast as possible),
+*   so a five minute match takes about ten seconds to arrive and the viewer can be seen
+*   playing and seeking while it is still downloading:
+*     http://127.0.0.1:8080/index.html?replay=match.cvr
+*
+*   For testing only: GET only, one forked process per request, no keep-alive.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+
+#define REPLAY_FILE_EXTENSION ".cvr"    // As in replay.h, which needs the simulation headers
+#define THROTTLE_PIECE 512
+#define REQUEST_MAX 4096
+
+typedef struct MimeType {
+    const char *extension;
+    const char *type;
+} MimeType;
+
+static const MimeType mimeTypes[] = {
+    { ".html", "text/html; charset=utf-8" },
+    { ".js", "text/javascript" },
+    { ".wasm", "application/wasm" },
+    { ".data", "application/octet-stream" },
+    { REPLAY_FILE_EXTENSION, "application/octet-stream" },
+};
+
+static bool EndsWith(const char *text, const char *suffix)
+{
+    size_t length = strlen(text), suffixLength = strlen(suffix);
+    return (length >= suffixLength) && (strcmp(text + length - suffixLength, suffix) == 0);
+}
+
+static const char *MimeTypeOf(const char *path)
+{
+    for (size_t i = 0; i < sizeof(mimeTypes)/sizeof(mimeTypes[0]); i++)
+    {
+        if (EndsWith(path, mimeTypes[i].extension)) return mimeTypes[i].type;
+    }
+
+    return "application/octet-stream";
+}
+
+static bool SendAll(int fd, const void *data, size_t size)
+{
+    const char *bytes = (const char *)data;
+
+    while (size > 0)
+    {
+        ssize_t sent = send(fd, bytes, size, MSG_NOSIGNAL);
+        if ((sent < 0) && (errno == EINTR)) continue;
+        if (sent <= 0) return false;
+
+        bytes += sent;
+        size -= (size_t)sent;
+    }
+
+    return true;
+}
+
+static void SendStatus(int fd, const char *status)
+{
+    char response[256];
+    int length = snprintf(response, sizeof(response), "HTTP/1.1 %s\r\nContent-Type: text/plain\r\n"
+                          "Content-Length: %d\r\nConnection: close\r\n\r\n%s\n", status, (int)strlen(status) + 1, status);
+    SendAll(fd, response, (size_t)length);
+}
+
+// Answers one request on fd, in its own process
+static void Serve(int fd, const char *root, int rate)
+{
+    char request[REQUEST_MAX];
+    size_t used = 0;
+
+    while ((used < sizeof(request) - 1) && (memmem(request, used, "\r\n\r\n", 4) == NULL))
+    {
+        ssize_t got = recv(fd, request + used, sizeof(request) - 1 - used, 0);
+        if ((got < 0) && (errno == EINTR)) continue;
+        if (got <= 0) return;
+        used += (size_t)got;
+    }
+    request[used] = '\0';
+
+    char method[8], target[1024];
+    if (sscanf(request, "%7s %1023s", method, target) != 2) { SendStatus(fd, "400 Bad Request"); return; }
+    if (strcmp(method, "GET") != 0) { SendStatus(fd, "405 Method Not Allowed"); return; }
+
+    target[strcspn(target, "?#")] = '\0';
+    if ((target[0] != '/') || (strstr(target, "..") != NULL)) { SendStatus(fd, "400 Bad Request"); return; }
+
+    char path[2048];
+    snprintf(path, sizeof(path), "%s%s%s", root, target, EndsWith(target, "/") ? "index.html" : "");
+
+    struct stat info;
+    FILE *file = ((stat(path, &info) == 0) && S_ISREG(info.st_mode)) ? fopen(path, "rb") : NULL;
+    if (file == NULL) { SendStatus(fd, "404 Not Found"); return; }
+
+    bool throttled = EndsWith(path, REPLAY_FILE_EXTENSION) && (rate > 0);
+
+    char header[512];
+    int length = snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %lld\r\n"
+                          "Cache-Control: no-store\r\nConnection: close\r\n\r\n", MimeTypeOf(path), (long long)info.st_size);
+    bool sending = SendAll(fd, header, (size_t)length);
+
+    char buffer[65536];
+    size_t piece = throttled ? THROTTLE_PIECE : sizeof(buffer);
+    long long pauseNs = throttled ? 1000000000LL*THROTTLE_PIECE/rate : 0;
+    struct timespec pause = { (time_t)(pauseNs/1000000000LL), (long)(pauseNs%1000000000LL) };
+    size_t got = 0;
+
+    while (sending && ((got = fread(buffer, 1, piece, file)) > 0))
+    {
+        sending = SendAll(fd, buffer, got);
+        if (throttled && sending) nanosleep(&pause, NULL);
+    }
+
+    fclose(file);
+    printf("%s %s%s\n", sending ? "200" : "---", target, throttled ? " (throttled)" : "");
+}
+
+static int Usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [DIR] [--port N] [--rate BYTES_PER_SEC]\n", program);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *root = "./build/web";
+    int port = 8080;
+    int rate = 4096;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--port") == 0) && (i + 1 < argc)) port = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--rate") == 0) && (i + 1 < argc)) rate = atoi(argv[++i]);
+        else if (argv[i][0] != '-') root = argv[i];
+        else return Usage(argv[0]);
+    }
+
+    if ((port <= 0) || (port > 65535) || (rate < 0)) return Usage(argv[0]);
+
+    signal(SIGCHLD, SIG_IGN);       // Children reaped automatically
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port) };
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &(int){ 1 }, sizeof(int));
+
+    if ((listener < 0) || (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0) || (listen(listener, 64) != 0))
+    {
+        fprintf(stderr, "replay_server: could not listen on port %d\n", port);
+        return 1;
+    }
+
+    printf("Serving %s on http://127.0.0.1:%d/, replays at %d bytes/s\n", root, port, rate);
+    fflush(stdout);
+
+    while (true)
+    {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        pid_t child = fork();
+        if (child == 0)
+        {
+            close(listener);
+            Serve(fd, root, rate);
+            fflush(stdout);
+            close(fd);
+            _exit(0);
+        }
+
+        close(fd);
+    }
+
+    close(listener);
+    return 0;
+}
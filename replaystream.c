@@ -0,0 +1,208 @@
+/*******************************************************************************************
+*
+*   C-volley - replays played while they download
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "replaystream.h"
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PLATFORM_WEB) || defined(__EMSCRIPTEN__)
+    #include <emscripten/fetch.h>
+    #define REPLAY_STREAM_FETCH
+#endif
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+#if defined(REPLAY_STREAM_FETCH)
+// Called between frames on the main thread, only appends; dataOffset skips what a browser
+// hands over twice (the last chunk again on success)
+static void AppendFetched(emscripten_fetch_t *fetch)
+{
+    ReplayStream *stream = (ReplayStream *)fetch->userData;
+    if ((stream == NULL) || (fetch->data == NULL) || (fetch->numBytes == 0)) return;
+
+    long long end = (long long)fetch->dataOffset + (long long)fetch->numBytes;
+    if (end <= stream->bytes) return;
+
+    if ((long long)fetch->dataOffset > stream->bytes)
+    {
+        stream->failed = true;      // A chunk went missing
+        return;
+    }
+
+    int skip = (int)(stream->bytes - (long long)fetch->dataOffset);
+    int size = (int)fetch->numBytes - skip;
+
+    if (stream->receivedSize + size > stream->receivedCapacity)
+    {
+        int capacity = (stream->receivedCapacity > 0) ? stream->receivedCapacity : 16384;
+        while (capacity < stream->receivedSize + size) capacity *= 2;
+
+        unsigned char *grown = (unsigned char *)realloc(stream->received, capacity);
+        if (grown == NULL)
+        {
+            stream->failed = true;
+            return;
+        }
+
+        stream->received = grown;
+        stream->receivedCapacity = capacity;
+    }
+
+    memcpy(stream->received + stream->receivedSize, fetch->data + skip, size);
+    stream->receivedSize += size;
+    stream->bytes = end;
+}
+
+static void OnFetchProgress(emscripten_fetch_t *fetch)
+{
+    if (fetch->status == 200) AppendFetched(fetch);
+}
+
+static void OnFetchSuccess(emscripten_fetch_t *fetch)
+{
+    ReplayStream *stream = (ReplayStream *)fetch->userData;
+
+    if (stream != NULL)
+    {
+        AppendFetched(fetch);
+        stream->finished = true;
+        stream->source = NULL;
+    }
+
+    emscripten_fetch_close(fetch);
+}
+
+static void OnFetchError(emscripten_fetch_t *fetch)
+{
+    ReplayStream *stream = (ReplayStream *)fetch->userData;
+
+    if (stream != NULL)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Download failed, HTTP status %d", fetch->status);
+        stream->finished = stream->failed = true;
+        stream->source = NULL;
+    }
+
+    emscripten_fetch_close(fetch);
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool ReplayStreamOpen(ReplayStream *stream, const char *location)
+{
+    memset(stream, 0, sizeof(ReplayStream));
+    ReplayDecoderInit(&stream->decoder);
+
+#if defined(REPLAY_STREAM_FETCH)
+    emscripten_fetch_attr_t attr;
+    emscripten_fetch_attr_init(&attr);
+    strcpy(attr.requestMethod, "GET");
+    attr.attributes = EMSCRIPTEN_FETCH_STREAM_DATA;
+    attr.onprogress = OnFetchProgress;
+    attr.onsuccess = OnFetchSuccess;
+    attr.onerror = OnFetchError;
+    attr.userData = stream;
+
+    stream->source = emscripten_fetch(&attr, location);
+#else
+    if (!FileReadAsync(location, &stream->read)) stream->source = fopen(location, "rb");
+#endif
+
+    if ((stream->source == NULL) && (stream->read.state == FILE_READ_IDLE))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Could not open %s", location);
+        stream->finished = stream->failed = true;
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "REPLAY: Streaming %s", location);
+    return true;
+}
+
+void ReplayStreamUpdate(ReplayStream *stream)
+{
+#if defined(REPLAY_STREAM_FETCH)
+    const unsigned char *data = stream->received;
+    int size = stream->receivedSize;
+    stream->receivedSize = 0;
+#else
+    unsigned char chunk[REPLAY_STREAM_FILE_CHUNK];
+    const unsigned char *data = chunk;
+    int size = 0;
+    int state = GetFileReadState(&stream->read);
+
+    if (!stream->finished && (state == FILE_READ_FAILED))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Could not read the file");
+        stream->finished = stream->failed = true;
+    }
+    else if (!stream->finished && (state == FILE_READ_DONE))
+    {
+        data = stream->read.data + stream->bytes;
+        size = stream->read.size - (int)stream->bytes;
+        if (size > REPLAY_STREAM_FILE_CHUNK) size = REPLAY_STREAM_FILE_CHUNK;
+
+        stream->bytes += size;
+        stream->finished = (stream->bytes == stream->read.size);
+    }
+    else if (!stream->finished && (stream->source != NULL))
+    {
+        size = (int)fread(chunk, 1, sizeof(chunk), (FILE *)stream->source);
+        stream->bytes += size;
+
+        if (size < (int)sizeof(chunk))
+        {
+            stream->finished = true;
+            stream->failed = (ferror((FILE *)stream->source) != 0);
+            fclose((FILE *)stream->source);
+            stream->source = NULL;
+        }
+    }
+#endif
+
+    if ((size > 0) && !stream->failed && !ReplayDecode(&stream->decoder, data, size))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Not a replay this build can play");
+        stream->failed = true;
+    }
+
+    if (stream->finished && !stream->failed && !ReplayDecoderComplete(&stream->decoder))
+    {
+        if (stream->decoder.totalTicks < 0) TraceLog(LOG_WARNING, "REPLAY: Ended before the header, %lld bytes", stream->bytes);
+        else TraceLog(LOG_WARNING, "REPLAY: Ended after %d of %d ticks", stream->decoder.replay.tickCount, stream->decoder.totalTicks);
+        stream->failed = true;
+    }
+}
+
+void ReplayStreamClose(ReplayStream *stream)
+{
+#if defined(REPLAY_STREAM_FETCH)
+    // Aborts it, no callback may touch the stream afterwards
+    if (stream->source != NULL)
+    {
+        emscripten_fetch_t *fetch = (emscripten_fetch_t *)stream->source;
+        fetch->userData = NULL;
+        emscripten_fetch_close(fetch);
+    }
+    free(stream->received);
+#else
+    if (stream->source != NULL) fclose((FILE *)stream->source);
+
+    // The I/O thread fills the read in, a replay takes well under a millisecond
+    while (GetFileReadState(&stream->read) == FILE_READ_PENDING) WaitTime(0.0005);
+    if (stream->read.data != NULL) UnloadFileData(stream->read.data);
+#endif
+
+    ReplayDecoderFree(&stream->decoder);
+    memset(stream, 0, sizeof(ReplayStream));
+}
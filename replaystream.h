@@ -0,0 +1,48 @@
+/*******************************************************************************************
+*
+*   C-volley - replays played while they download
+*
+*   On the web a replay is fetched with the Fetch API in streaming mode: chunks are appended
+*   by the fetch callbacks as the browser hands them over and decoded (replay.h) in the next
+*   frame, so playback starts as soon as the header is in and seeking works within whatever
+*   has arrived, from the nearest keyframe. Nothing waits on the network in the frame
+*   callback. Elsewhere the location is a file the I/O service (fileio.h) reads, decoded a
+*   chunk per frame the same way; without the service it is read a chunk per frame.
+*
+*   Web builds need -sFETCH=1 -sFETCH_STREAMING=1; without FETCH_STREAMING the whole file
+*   arrives in one chunk when the download completes.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef REPLAYSTREAM_H
+#define REPLAYSTREAM_H
+
+#include "replay.h"
+#include "fileio.h"
+
+#define REPLAY_STREAM_FILE_CHUNK 4096   // Bytes decoded per frame from a file
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ReplayStream {
+    ReplayDecoder decoder;
+    void *source;               // FILE without the I/O service, or the fetch on the web
+    FileRead read;              // The whole file, through the I/O service
+    unsigned char *received;    // Arrived, not decoded yet (web)
+    int receivedSize;
+    int receivedCapacity;
+    long long bytes;            // Arrived so far
+    bool finished;              // Nothing more will arrive
+    bool failed;                // Download or file error, or not a replay
+} ReplayStream;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+bool ReplayStreamOpen(ReplayStream *stream, const char *location);     // URL on the web, file name elsewhere
+void ReplayStreamUpdate(ReplayStream *stream);                          // Once per frame, decodes what arrived
+void ReplayStreamClose(ReplayStream *stream);                           // Cancels a download still running
+
+#endif // REPLAYSTREAM_H
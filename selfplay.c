@@ -0,0 +1,96 @@
+/*******************************************************************************************
+*
+*   C-volley - headless self-play matches
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "selfplay.h"
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+void SelfPlayStart(SelfPlayLane *lane, const SelfPlayConfig *config, int match)
+{
+    uint32_t id = config->seed + (uint32_t)match;
+
+    SimInit(&lane->sim, 1000u + id);
+    SimScriptInit(&lane->script[0], id*2654435761u + 1);
+    SimScriptInit(&lane->script[1], id*2654435761u + 2);
+    lane->match = match;
+    lane->serving = true;
+
+    lane->decided[0] = lane->decided[1] = 0;
+
+    // The AI serves onto its own blob standing right under the ball and juggles it straight
+    // up forever, random start spots make matches with the AI (or a port of it) actually end
+    if ((config->agents[0] != AGENT_SCRIPTED) || (config->agents[1] != AGENT_SCRIPTED))
+    {
+        lane->sim.blobs[0].position.x += SimRandom(&lane->sim, -150, 150);
+        lane->sim.blobs[1].position.x += SimRandom(&lane->sim, -150, 150);
+    }
+}
+
+// One tick of a lane, or the dead time up to its next interactive frame
+int SelfPlayStep(SelfPlayLane *lane, const SelfPlayConfig *config, uint64_t *skipped)
+{
+    SimState *sim = &lane->sim;
+    int ticks = sim->tick;
+    unsigned int events = 0;
+    bool idle = (sim->scoreDelay > 0) || (config->idleServe && lane->serving);
+
+    int jumped = (idle && config->skipDeadTime) ? SimSkipDeadTime(sim, config->idleServe, &events) : 0;
+    *skipped += jumped;
+
+    // Nothing to skip (contact due next frame, blobs still moving): step the idle frame
+    if (jumped == 0)
+    {
+        unsigned char actions[2] = { 0, 0 };
+        if (!idle)
+        {
+            for (int side = 0; side < 2; side++)
+            {
+                if (config->agents[side] == AGENT_AI) actions[side] = ACTION_AI;
+                else if (config->agents[side] == AGENT_PLUGIN) actions[side] = lane->decided[side];
+                else actions[side] = SimScriptAction(&lane->script[side], sim, side);
+            }
+        }
+
+        events = SimStep(sim, actions);
+    }
+
+    if (events & SIM_EVENT_RESET) lane->serving = true;
+    if (events & (SIM_EVENT_BLOB_LEFT | SIM_EVENT_BLOB_RIGHT | SIM_EVENT_GROUND)) lane->serving = false;
+
+    return sim->tick - ticks;
+}
+
+// Same idle rule as SelfPlayStep(): agents send nothing during the score delay (and idle serves)
+bool SelfPlayNeedsDecision(const SelfPlayLane *lane, const SelfPlayConfig *config)
+{
+    return (lane->sim.scoreDelay == 0) && !(config->idleServe && lane->serving);
+}
+
+bool SelfPlayDone(const SelfPlayLane *lane)
+{
+    return lane->sim.gameOver || (lane->sim.tick >= SELFPLAY_MAX_TICKS);
+}
+
+MatchResult SelfPlayResult(const SelfPlayLane *lane)
+{
+    MatchResult result = { 0 };
+    result.score[0] = (uint8_t)lane->sim.blobs[0].score;
+    result.score[1] = (uint8_t)lane->sim.blobs[1].score;
+    result.ticks = (uint32_t)lane->sim.tick;
+
+    return result;
+}
+
+uint64_t SelfPlayResultHash(int match, MatchResult result)
+{
+    uint64_t x = ((uint64_t)match << 32) ^ ((uint64_t)result.score[0] << 24) ^ ((uint64_t)result.score[1] << 16) ^ result.ticks;
+    x *= 0x9E3779B97F4A7C15ull;
+
+    return x ^ (x >> 29);
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************************
+*
+*   C-volley - headless self-play matches
+*
+*   The match loop shared by the batch runner and the distributed workers. Each side is a
+*   scripted player (SimScriptAction()), the built-in AI or an agent plug-in (agent.h). Plug-in
+*   decisions are made by the caller, batched over all lanes: for every lane where
+*   SelfPlayNeedsDecision() it stores the action in lane->decided[side] before SelfPlayStep().
+*   Match m of a seed always gets the
+*   same start state and scripts, so results do not depend on which process, thread or lane
+*   plays it, and SelfPlayResultHash() sums to the same checksum for any split of the work.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include "sim.h"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define SELFPLAY_MAX_TICKS (60*60*30)       // Matches still running after 30 minutes are cut
+
+#define AGENT_SCRIPTED 0
+#define AGENT_AI 1
+#define AGENT_PLUGIN 2
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SelfPlayConfig {
+    uint32_t seed;              // Match m starts from seed + m
+    uint8_t agents[2];          // AGENT_* per side
+    bool idleServe;             // Players also wait from the serve until the ball is first touched
+    bool skipDeadTime;          // Jump over idle frames with SimSkipDeadTime(), same results
+} SelfPlayConfig;
+
+// One running match
+typedef struct SelfPlayLane {
+    SimState sim;
+    SimScript script[2];
+    int match;
+    bool serving;               // Ball not touched since it was put up
+    unsigned char decided[2];   // Actions of AGENT_PLUGIN sides for the next step
+} SelfPlayLane;
+
+typedef struct MatchResult {
+    uint8_t score[2];
+    uint16_t reserved;
+    uint32_t ticks;
+} MatchResult;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+void SelfPlayStart(SelfPlayLane *lane, const SelfPlayConfig *config, int match);
+int SelfPlayStep(SelfPlayLane *lane, const SelfPlayConfig *config, uint64_t *skipped);    // Returns frames advanced
+bool SelfPlayNeedsDecision(const SelfPlayLane *lane, const SelfPlayConfig *config);   // Agents act on the next step
+bool SelfPlayDone(const SelfPlayLane *lane);
+MatchResult SelfPlayResult(const SelfPlayLane *lane);
+
+// Summing these over all matches gives an order independent checksum
+uint64_t SelfPlayResultHash(int match, MatchResult result);
+
+#endif // SELFPLAY_H
@@ -0,0 +1,481 @@
+/*******************************************************************************************
+*
+*   C-volley - low latency sound effects output
+*
+*   Game thread -> mixer thread triggers go through a lock-free SPSC queue, the mixer picks
+*   them up at every period boundary, so the worst case delay from PlaySfx() to the sound
+*   leaving the PCM is one period plus whatever is already queued in the buffer.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "sfxmixer.h"
+#include "raylib.h"
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <dlfcn.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define SFX_QUEUE_SIZE 64               // Power of two
+#define SFX_CLICK_ID SFX_MAX_SAMPLES    // Internal slot for the calibration click
+#define SFX_MIXER_PRIORITY 70           // SCHED_FIFO priority of the mixer thread
+
+#define SFX_CALIBRATION_MAX 64
+#define SFX_ONSET_THRESHOLD 8000        // Capture amplitude that counts as the click
+#define SFX_ONSET_QUIET_FRAMES (SFX_SAMPLE_RATE/20)
+
+// Subset of the ALSA API, resolved from libasound at runtime
+typedef struct snd_pcm_ snd_pcm_t;
+typedef unsigned long snd_pcm_uframes_t;
+typedef long snd_pcm_sframes_t;
+
+#define SND_PCM_STREAM_PLAYBACK 0
+#define SND_PCM_STREAM_CAPTURE 1
+#define SND_PCM_FORMAT_S16_LE 2
+#define SND_PCM_ACCESS_RW_INTERLEAVED 3
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct AlsaApi {
+    void *library;
+    int (*open)(snd_pcm_t **pcm, const char *name, int stream, int mode);
+    int (*setParams)(snd_pcm_t *pcm, int format, int access, unsigned int channels,
+                     unsigned int rate, int softResample, unsigned int latencyUs);
+    int (*getParams)(snd_pcm_t *pcm, snd_pcm_uframes_t *bufferSize, snd_pcm_uframes_t *periodSize);
+    snd_pcm_sframes_t (*writei)(snd_pcm_t *pcm, const void *buffer, snd_pcm_uframes_t size);
+    snd_pcm_sframes_t (*readi)(snd_pcm_t *pcm, void *buffer, snd_pcm_uframes_t size);
+    int (*recover)(snd_pcm_t *pcm, int err, int silent);
+    int (*delay)(snd_pcm_t *pcm, snd_pcm_sframes_t *delay);
+    int (*close)(snd_pcm_t *pcm);
+    const char *(*strerror)(int errnum);
+} AlsaApi;
+
+typedef struct SfxSample {
+    short *data;
+    unsigned int frames;
+} SfxSample;
+
+typedef struct SfxVoice {
+    const SfxSample *sample;
+    unsigned int position;
+} SfxVoice;
+
+//----------------------------------------------------------------------------------
+// Module state
+//----------------------------------------------------------------------------------
+static AlsaApi alsa = { 0 };
+
+static snd_pcm_t *playbackPcm = NULL;
+static snd_pcm_uframes_t periodFrames = 0;
+static pthread_t mixerThread;
+static int running = 0;
+static int queuedFrames = 0;
+
+static SfxSample samples[SFX_MAX_SAMPLES + 1] = { 0 };
+static int sampleCount = 0;
+static SfxVoice voices[SFX_MAX_VOICES] = { 0 };    // Mixer thread only
+
+static int triggerQueue[SFX_QUEUE_SIZE] = { 0 };
+static unsigned int triggerHead = 0;               // Game thread
+static unsigned int triggerTail = 0;               // Mixer thread
+
+static snd_pcm_t *capturePcm = NULL;
+static pthread_t captureThread;
+static int capturing = 0;
+static double onsetTimes[SFX_CALIBRATION_MAX] = { 0 };
+static int onsetCount = 0;
+static double flashTimes[SFX_CALIBRATION_MAX] = { 0 };
+static int flashCount = 0;
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec*1e-9;
+}
+
+static bool LoadAlsa(void)
+{
+    if (alsa.library != NULL) return true;
+
+    alsa.library = dlopen("libasound.so.2", RTLD_NOW | RTLD_LOCAL);
+    if (alsa.library == NULL) return false;
+
+    *(void **)&alsa.open = dlsym(alsa.library, "snd_pcm_open");
+    *(void **)&alsa.setParams = dlsym(alsa.library, "snd_pcm_set_params");
+    *(void **)&alsa.getParams = dlsym(alsa.library, "snd_pcm_get_params");
+    *(void **)&alsa.writei = dlsym(alsa.library, "snd_pcm_writei");
+    *(void **)&alsa.readi = dlsym(alsa.library, "snd_pcm_readi");
+    *(void **)&alsa.recover = dlsym(alsa.library, "snd_pcm_recover");
+    *(void **)&alsa.delay = dlsym(alsa.library, "snd_pcm_delay");
+    *(void **)&alsa.close = dlsym(alsa.library, "snd_pcm_close");
+    *(void **)&alsa.strerror = dlsym(alsa.library, "snd_strerror");
+
+    if (!alsa.open || !alsa.setParams || !alsa.getParams || !alsa.writei || !alsa.readi ||
+        !alsa.recover || !alsa.delay || !alsa.close || !alsa.strerror)
+    {
+        dlclose(alsa.library);
+        alsa.library = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+static snd_pcm_t *OpenPcm(const char *device, int stream, int bufferFrames)
+{
+    snd_pcm_t *pcm = NULL;
+    unsigned int latencyUs = (unsigned int)((long long)bufferFrames*1000000/SFX_SAMPLE_RATE);
+
+    int result = alsa.open(&pcm, device, stream, 0);
+    if (result < 0)
+    {
+        TraceLog(LOG_WARNING, "SFX: Could not open ALSA device %s: %s", device, alsa.strerror(result));
+        return NULL;
+    }
+
+    result = alsa.setParams(pcm, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED, 1, SFX_SAMPLE_RATE, 1, latencyUs);
+    if (result < 0)
+    {
+        TraceLog(LOG_WARNING, "SFX: Could not configure ALSA device %s: %s", device, alsa.strerror(result));
+        alsa.close(pcm);
+        return NULL;
+    }
+
+    return pcm;
+}
+
+static void RaiseThreadPriority(const char *name)
+{
+    struct sched_param param = { .sched_priority = SFX_MIXER_PRIORITY };
+
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0)
+    {
+        TraceLog(LOG_INFO, "SFX: %s thread running SCHED_FIFO priority %d", name, SFX_MIXER_PRIORITY);
+    }
+    else TraceLog(LOG_INFO, "SFX: %s thread running at normal priority (no real-time permission)", name);
+}
+
+static void StartVoice(int id)
+{
+    int slot = 0;
+    unsigned int fewestLeft = UINT_MAX;
+
+    // Free voice, otherwise steal the one with the fewest frames left to play
+    for (int i = 0; i < SFX_MAX_VOICES; i++)
+    {
+        if (voices[i].sample == NULL) { slot = i; break; }
+
+        unsigned int left = voices[i].sample->frames - voices[i].position;
+        if (left < fewestLeft)
+        {
+            fewestLeft = left;
+            slot = i;
+        }
+    }
+
+    voices[slot].sample = &samples[id];
+    voices[slot].position = 0;
+}
+
+static void *MixerThread(void *arg)
+{
+    (void)arg;
+    RaiseThreadPriority("Mixer");
+
+    int *mix = (int *)malloc(periodFrames*sizeof(int));
+    short *out = (short *)malloc(periodFrames*sizeof(short));
+
+    while (__atomic_load_n(&running, __ATOMIC_ACQUIRE))
+    {
+        unsigned int head = __atomic_load_n(&triggerHead, __ATOMIC_ACQUIRE);
+        while (triggerTail != head)
+        {
+            StartVoice(triggerQueue[triggerTail%SFX_QUEUE_SIZE]);
+            triggerTail++;
+        }
+        __atomic_store_n(&triggerTail, triggerTail, __ATOMIC_RELEASE);
+
+        memset(mix, 0, periodFrames*sizeof(int));
+
+        for (int i = 0; i < SFX_MAX_VOICES; i++)
+        {
+            SfxVoice *voice = &voices[i];
+            if (voice->sample == NULL) continue;
+
+            unsigned int count = voice->sample->frames - voice->position;
+            if (count > periodFrames) count = (unsigned int)periodFrames;
+
+            const short *src = voice->sample->data + voice->position;
+            for (unsigned int f = 0; f < count; f++) mix[f] += src[f];
+
+            voice->position += count;
+            if (voice->position >= voice->sample->frames) voice->sample = NULL;
+        }
+
+        for (snd_pcm_uframes_t f = 0; f < periodFrames; f++)
+        {
+            int value = mix[f];
+            out[f] = (short)((value > 32767) ? 32767 : (value < -32768) ? -32768 : value);
+        }
+
+        // Blocks until there is room for one period, this is what paces the thread
+        snd_pcm_sframes_t written = alsa.writei(playbackPcm, out, periodFrames);
+        if (written < 0) alsa.recover(playbackPcm, (int)written, 1);
+
+        snd_pcm_sframes_t delay = 0;
+        if (alsa.delay(playbackPcm, &delay) == 0) __atomic_store_n(&queuedFrames, (int)delay, __ATOMIC_RELAXED);
+    }
+
+    free(mix);
+    free(out);
+
+    return NULL;
+}
+
+// Records the capture device and timestamps the first loud sample after a quiet stretch
+static void *CaptureThread(void *arg)
+{
+    (void)arg;
+    RaiseThreadPriority("Capture");
+
+    short *in = (short *)malloc(periodFrames*sizeof(short));
+    int quietFrames = 0;
+
+    while (__atomic_load_n(&capturing, __ATOMIC_ACQUIRE))
+    {
+        snd_pcm_sframes_t count = alsa.readi(capturePcm, in, periodFrames);
+        if (count < 0)
+        {
+            alsa.recover(capturePcm, (int)count, 1);
+            continue;
+        }
+
+        double now = NowSeconds();
+        snd_pcm_sframes_t delay = 0;
+        alsa.delay(capturePcm, &delay);
+
+        for (snd_pcm_sframes_t i = 0; i < count; i++)
+        {
+            int amplitude = abs(in[i]);
+
+            if ((amplitude > SFX_ONSET_THRESHOLD) && (quietFrames > SFX_ONSET_QUIET_FRAMES))
+            {
+                int index = __atomic_load_n(&onsetCount, __ATOMIC_RELAXED);
+                if (index < SFX_CALIBRATION_MAX)
+                {
+                    // Sample i was captured (delay + count - i) frames before now
+                    onsetTimes[index] = now - (double)(delay + count - i)/SFX_SAMPLE_RATE;
+                    __atomic_store_n(&onsetCount, index + 1, __ATOMIC_RELEASE);
+                }
+                quietFrames = 0;
+            }
+            else if (amplitude < SFX_ONSET_THRESHOLD/4) quietFrames++;
+        }
+    }
+
+    free(in);
+
+    return NULL;
+}
+
+//----------------------------------------------------------------------------------
+// Module functions definition
+//----------------------------------------------------------------------------------
+bool InitSfxMixer(const char *device, int bufferFrames)
+{
+    if (running) return true;
+
+    if (!LoadAlsa())
+    {
+        TraceLog(LOG_WARNING, "SFX: libasound not available, using raylib audio");
+        return false;
+    }
+
+    playbackPcm = OpenPcm(device, SND_PCM_STREAM_PLAYBACK, bufferFrames);
+    if (playbackPcm == NULL) return false;
+
+    snd_pcm_uframes_t bufferSize = 0;
+    alsa.getParams(playbackPcm, &bufferSize, &periodFrames);
+    if (periodFrames == 0) periodFrames = (snd_pcm_uframes_t)bufferFrames/4;
+
+    running = 1;
+    if (pthread_create(&mixerThread, NULL, MixerThread, NULL) != 0)
+    {
+        running = 0;
+        alsa.close(playbackPcm);
+        playbackPcm = NULL;
+        return false;
+    }
+
+    // Calibration click: 2ms full scale burst
+    unsigned int clickFrames = SFX_SAMPLE_RATE/500;
+    samples[SFX_CLICK_ID].data = (short *)malloc(clickFrames*sizeof(short));
+    for (unsigned int i = 0; i < clickFrames; i++) samples[SFX_CLICK_ID].data[i] = ((i/24)%2) ? 30000 : -30000;
+    samples[SFX_CLICK_ID].frames = clickFrames;
+
+    TraceLog(LOG_INFO, "SFX: Low latency output on %s: buffer %lu frames, period %lu frames (%.2f ms)",
+             device, bufferSize, periodFrames, periodFrames*1000.0/SFX_SAMPLE_RATE);
+
+    return true;
+}
+
+void CloseSfxMixer(void)
+{
+    EndSfxCalibration();
+
+    if (running)
+    {
+        __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+        pthread_join(mixerThread, NULL);
+        alsa.close(playbackPcm);
+        playbackPcm = NULL;
+    }
+
+    for (int i = 0; i <= SFX_MAX_SAMPLES; i++)
+    {
+        free(samples[i].data);
+        samples[i] = (SfxSample){ 0 };
+    }
+    sampleCount = 0;
+
+    if (alsa.library != NULL) dlclose(alsa.library);
+    alsa = (AlsaApi){ 0 };
+}
+
+bool IsSfxMixerReady(void)
+{
+    return running;
+}
+
+int GetSfxMixerLatencyFrames(void)
+{
+    return __atomic_load_n(&queuedFrames, __ATOMIC_RELAXED);
+}
+
+int LoadSfx(const char *fileName)
+{
+    if (!running || (sampleCount == SFX_MAX_SAMPLES)) return -1;
+
+    Wave wave = LoadWave(fileName);
+    if (wave.data == NULL) return -1;
+
+    WaveFormat(&wave, SFX_SAMPLE_RATE, 16, 1);
+
+    SfxSample *sample = &samples[sampleCount];
+    sample->frames = wave.frameCount;
+    sample->data = (short *)malloc(wave.frameCount*sizeof(short));
+    memcpy(sample->data, wave.data, wave.frameCount*sizeof(short));
+
+    UnloadWave(wave);
+
+    return sampleCount++;
+}
+
+void PlaySfx(int id)
+{
+    if (!running || (id < 0) || (id > SFX_MAX_SAMPLES)) return;
+
+    // Queue full means the mixer is stalled, dropping the sound is the right call
+    unsigned int head = triggerHead;
+    if (head - __atomic_load_n(&triggerTail, __ATOMIC_ACQUIRE) >= SFX_QUEUE_SIZE) return;
+
+    triggerQueue[head%SFX_QUEUE_SIZE] = id;
+    __atomic_store_n(&triggerHead, head + 1, __ATOMIC_RELEASE);
+}
+
+bool BeginSfxCalibration(const char *captureDevice)
+{
+    if (!running || capturing) return false;
+
+    capturePcm = OpenPcm(captureDevice, SND_PCM_STREAM_CAPTURE, (int)periodFrames*4);
+    if (capturePcm == NULL) return false;
+
+    onsetCount = 0;
+    flashCount = 0;
+    capturing = 1;
+
+    if (pthread_create(&captureThread, NULL, CaptureThread, NULL) != 0)
+    {
+        capturing = 0;
+        alsa.close(capturePcm);
+        capturePcm = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void PlaySfxCalibrationClick(void)
+{
+    PlaySfx(SFX_CLICK_ID);
+}
+
+void MarkSfxCalibrationFlash(void)
+{
+    if (flashCount < SFX_CALIBRATION_MAX) flashTimes[flashCount++] = NowSeconds();
+}
+
+// Pair every flash with the first click onset that follows it
+SfxCalibrationResult GetSfxCalibrationResult(void)
+{
+    SfxCalibrationResult result = { 0 };
+    int onsets = __atomic_load_n(&onsetCount, __ATOMIC_ACQUIRE);
+    int next = 0;
+
+    for (int i = 0; i < flashCount; i++)
+    {
+        while ((next < onsets) && (onsetTimes[next] < flashTimes[i] - 0.05)) next++;
+        if ((next == onsets) || (onsetTimes[next] > flashTimes[i] + 0.5)) continue;
+
+        double offsetMs = (onsetTimes[next] - flashTimes[i])*1000.0;
+        if ((result.samples == 0) || (offsetMs < result.minOffsetMs)) result.minOffsetMs = offsetMs;
+        if ((result.samples == 0) || (offsetMs > result.maxOffsetMs)) result.maxOffsetMs = offsetMs;
+        result.meanOffsetMs += offsetMs;
+        result.samples++;
+        next++;
+    }
+
+    if (result.samples > 0) result.meanOffsetMs /= result.samples;
+
+    return result;
+}
+
+void EndSfxCalibration(void)
+{
+    if (!capturing) return;
+
+    __atomic_store_n(&capturing, 0, __ATOMIC_RELEASE);
+    pthread_join(captureThread, NULL);
+    alsa.close(capturePcm);
+    capturePcm = NULL;
+}
+
+#else
+
+bool InitSfxMixer(const char *device, int bufferFrames) { (void)device; (void)bufferFrames; return false; }
+void CloseSfxMixer(void) { }
+bool IsSfxMixerReady(void) { return false; }
+int GetSfxMixerLatencyFrames(void) { return 0; }
+int LoadSfx(const char *fileName) { (void)fileName; return -1; }
+void PlaySfx(int id) { (void)id; }
+bool BeginSfxCalibration(const char *captureDevice) { (void)captureDevice; return false; }
+void PlaySfxCalibrationClick(void) { }
+void MarkSfxCalibrationFlash(void) { }
+SfxCalibrationResult GetSfxCalibrationResult(void) { return (SfxCalibrationResult){ 0 }; }
+void EndSfxCalibration(void) { }
+
+#endif
@@ -0,0 +1,50 @@
+/*******************************************************************************************
+*
+*   C-volley - low latency sound effects output
+*
+*   raylib mixes sounds inside miniaudio's device callback with a period size fixed at raylib
+*   build time, which on some cabinets puts contact sounds several frames behind the picture.
+*   This module plays short effects on its own ALSA PCM (libasound loaded at runtime) with a
+*   configurable buffer size, mixed by a dedicated thread running at real-time priority when
+*   allowed. Music keeps going through raylib.
+*
+*   Calibration plays a click together with a white flash frame and records it back from a
+*   capture device (loopback cable, ALSA loopback or a monitor source), reporting the offset
+*   between the frame being presented and the click arriving at the capture input.
+*
+*   Linux only; InitSfxMixer() returns false elsewhere and callers keep using PlaySound().
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef SFXMIXER_H
+#define SFXMIXER_H
+
+#include <stdbool.h>
+
+#define SFX_SAMPLE_RATE 48000
+#define SFX_MAX_SAMPLES 16
+#define SFX_MAX_VOICES 16
+
+typedef struct SfxCalibrationResult {
+    int samples;                // Matched flash/click pairs
+    double meanOffsetMs;        // Positive: audio arrives after the frame is presented
+    double minOffsetMs;
+    double maxOffsetMs;
+} SfxCalibrationResult;
+
+bool InitSfxMixer(const char *device, int bufferFrames);   // bufferFrames: total PCM buffer, period is 1/4
+void CloseSfxMixer(void);
+bool IsSfxMixerReady(void);
+int GetSfxMixerLatencyFrames(void);                        // Current playback queue depth
+
+int LoadSfx(const char *fileName);                         // Returns id or -1, call before PlaySfx()
+void PlaySfx(int id);                                      // Lock-free, safe from the game thread
+
+bool BeginSfxCalibration(const char *captureDevice);
+void PlaySfxCalibrationClick(void);                        // Same tick as the flash frame
+void MarkSfxCalibrationFlash(void);                        // Right after the flash frame is presented
+SfxCalibrationResult GetSfxCalibrationResult(void);
+void EndSfxCalibration(void);
+
+#endif // SFXMIXER_H
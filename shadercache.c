@@ -0,0 +1,429 @@
+/*******************************************************************************************
+*
+*   C-volley - shader program binary cache
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "shadercache.h"
+#include "rlgl.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__) && !defined(PLATFORM_WEB)
+    #define SHADER_CACHE_SUPPORTED
+#endif
+
+#define SHADER_BINARY_MAGIC "CVSB"
+#define SHADER_BINARY_VERSION 1
+#define MAX_WARMUP_SHADERS 32
+
+// GL enums and entry points, raylib does not export its loader
+#define GL_VENDOR 0x1F00
+#define GL_RENDERER 0x1F01
+#define GL_VERSION 0x1F02
+#define GL_LINK_STATUS 0x8B82
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+typedef const unsigned char *(*GetStringFunc)(unsigned int name);
+typedef void (*GetIntegervFunc)(unsigned int name, int *data);
+typedef unsigned int (*CreateProgramFunc)(void);
+typedef void (*GetProgramivFunc)(unsigned int program, unsigned int name, int *params);
+typedef void (*GetProgramBinaryFunc)(unsigned int program, int bufSize, int *length, unsigned int *format, void *binary);
+typedef void (*ProgramBinaryFunc)(unsigned int program, unsigned int format, const void *binary, int length);
+
+typedef void *(*GetProcAddressFunc)(const char *name);
+
+#if defined(SHADER_CACHE_SUPPORTED)
+// Weak: each resolves only if the raylib platform linked that library in (static or shared)
+extern void *glfwGetProcAddress(const char *name) __attribute__((weak));
+extern void *eglGetProcAddress(const char *name) __attribute__((weak));
+extern void *SDL_GL_GetProcAddress(const char *name) __attribute__((weak));
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Cache file: this header, then the binary
+typedef struct ShaderBinaryHeader {
+    char magic[4];              // SHADER_BINARY_MAGIC
+    uint32_t version;
+    uint64_t key;               // Driver and sources, see ShaderKey()
+    uint32_t format;            // As returned by glGetProgramBinary
+    uint32_t length;
+} ShaderBinaryHeader;
+
+typedef struct ShaderCacheStats {
+    int hits;
+    int misses;                 // Compiled from source
+    int rejected;               // Binary refused by the driver, compiled
+    int saved;
+    double hitSeconds;
+    double missSeconds;
+} ShaderCacheStats;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static char cacheDirectory[512] = { 0 };
+static bool cacheEnabled = false;
+static uint64_t driverKey = 0;
+static ShaderCacheStats stats = { 0 };
+
+static CachedShader *warmupQueue[MAX_WARMUP_SHADERS] = { 0 };
+static int warmupCount = 0;
+
+static struct {
+    CreateProgramFunc CreateProgram;
+    GetProgramivFunc GetProgramiv;
+    GetProgramBinaryFunc GetProgramBinary;
+    ProgramBinaryFunc ProgramBinary;
+} gl = { 0 };
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// Strings hashed with their terminator, so "ab" + "c" and "a" + "bc" differ; NULL is its own value
+static uint64_t HashString(uint64_t hash, const char *text)
+{
+    if (text == NULL) return HashBytes(hash, "\xff", 1);
+
+    return HashBytes(hash, text, strlen(text) + 1);
+}
+
+static uint64_t ShaderKey(const CachedShader *shader)
+{
+    uint64_t key = HashString(driverKey, shader->vsCode);
+
+    return HashString(key, shader->fsCode);
+}
+
+static void GetCachePath(const CachedShader *shader, char *path, int size)
+{
+    snprintf(path, size, "%s/%s-%016llx.bin", cacheDirectory, shader->name, (unsigned long long)ShaderKey(shader));
+}
+
+#if defined(SHADER_CACHE_SUPPORTED)
+// Whichever loader the raylib platform linked in
+static GetProcAddressFunc FindGetProcAddress(void)
+{
+    if (glfwGetProcAddress != NULL) return glfwGetProcAddress;
+    if (eglGetProcAddress != NULL) return eglGetProcAddress;
+    if (SDL_GL_GetProcAddress != NULL) return SDL_GL_GetProcAddress;
+
+    return NULL;
+}
+#endif
+
+// Attribute and uniform locations as LoadShaderFromMemory() sets them
+static void SetDefaultLocations(Shader *shader)
+{
+    shader->locs = (int *)malloc(RL_MAX_SHADER_LOCATIONS*sizeof(int));
+    for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader->locs[i] = -1;
+
+    shader->locs[SHADER_LOC_VERTEX_POSITION] = GetShaderLocationAttrib(*shader, RL_DEFAULT_SHADER_ATTRIB_NAME_POSITION);
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD01] = GetShaderLocationAttrib(*shader, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD);
+    shader->locs[SHADER_LOC_VERTEX_TEXCOORD02] = GetShaderLocationAttrib(*shader, RL_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD2);
+    shader->locs[SHADER_LOC_VERTEX_NORMAL] = GetShaderLocationAttrib(*shader, RL_DEFAULT_SHADER_ATTRIB_NAME_NORMAL);
+    shader->locs[SHADER_LOC_VERTEX_TANGENT] = GetShaderLocationAttrib(*shader, RL_DEFAULT_SHADER_ATTRIB_NAME_TANGENT);
+    shader->locs[SHADER_LOC_VERTEX_COLOR] = GetShaderLocationAttrib(*shader, RL_DEFAULT_SHADER_ATTRIB_NAME_COLOR);
+
+    shader->locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_UNIFORM_NAME_MVP);
+    shader->locs[SHADER_LOC_MATRIX_VIEW] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_UNIFORM_NAME_VIEW);
+    shader->locs[SHADER_LOC_MATRIX_PROJECTION] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_UNIFORM_NAME_PROJECTION);
+    shader->locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_UNIFORM_NAME_MODEL);
+    shader->locs[SHADER_LOC_MATRIX_NORMAL] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_UNIFORM_NAME_NORMAL);
+
+    shader->locs[SHADER_LOC_COLOR_DIFFUSE] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_UNIFORM_NAME_COLOR);
+    shader->locs[SHADER_LOC_MAP_DIFFUSE] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE0);
+    shader->locs[SHADER_LOC_MAP_SPECULAR] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE1);
+    shader->locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(*shader, RL_DEFAULT_SHADER_SAMPLER2D_NAME_TEXTURE2);
+}
+
+// Program from the contents of a cache file, 0 when the driver refuses it (the program is
+// compiled and its binary saved over the file)
+static unsigned int ProgramFromBinary(const CachedShader *shader, const unsigned char *data, int size)
+{
+    ShaderBinaryHeader header;
+    unsigned int program = 0;
+    bool valid = (size >= (int)sizeof(header));
+
+    if (valid)
+    {
+        memcpy(&header, data, sizeof(header));
+        valid = (memcmp(header.magic, SHADER_BINARY_MAGIC, 4) == 0) && (header.version == SHADER_BINARY_VERSION) &&
+                (header.key == ShaderKey(shader)) && (header.length == (uint32_t)(size - (int)sizeof(header)));
+    }
+
+    if (valid)
+    {
+        program = gl.CreateProgram();
+        gl.ProgramBinary(program, header.format, data + sizeof(header), (int)header.length);
+
+        int linked = 0;
+        gl.GetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            rlUnloadShaderProgram(program);
+            program = 0;
+            valid = false;
+        }
+    }
+
+    if (!valid)
+    {
+        TraceLog(LOG_INFO, "SHADERCACHE: [%s] Cached binary rejected, recompiling", shader->name);
+        stats.rejected++;
+    }
+
+    return program;
+}
+
+// Program from a cache file, read ahead by QueueShaderWarmup() or now, 0 when there is none
+static unsigned int LoadProgramBinary(CachedShader *shader, const char *path)
+{
+    int state = GetFileReadState(&shader->prefetch);
+
+    // Not read ahead: the I/O thread still does the reading, this one waits for it
+    if ((state == FILE_READ_IDLE) && FileReadAsync(path, &shader->prefetch)) state = GetFileReadState(&shader->prefetch);
+
+    while (state == FILE_READ_PENDING)
+    {
+        WaitTime(0.0005);
+        state = GetFileReadState(&shader->prefetch);
+    }
+
+    unsigned char *data = NULL;
+    int size = 0;
+
+    if (state == FILE_READ_DONE)
+    {
+        data = shader->prefetch.data;
+        size = shader->prefetch.size;
+    }
+    else if ((state == FILE_READ_IDLE) && FileExists(path)) data = LoadFileData(path, &size);     // No I/O service
+
+    shader->prefetch.state = FILE_READ_IDLE;
+    shader->prefetch.data = NULL;
+    if (data == NULL) return 0;
+
+    unsigned int program = ProgramFromBinary(shader, data, size);
+    UnloadFileData(data);
+
+    return program;
+}
+
+static void SaveProgramBinary(const CachedShader *shader, const char *path)
+{
+    int length = 0;
+    gl.GetProgramiv(shader->shader.id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    unsigned char *data = (unsigned char *)malloc(sizeof(ShaderBinaryHeader) + length);
+    if (data == NULL) return;
+
+    ShaderBinaryHeader header = { .version = SHADER_BINARY_VERSION, .key = ShaderKey(shader) };
+    memcpy(header.magic, SHADER_BINARY_MAGIC, 4);
+
+    int written = 0;
+    gl.GetProgramBinary(shader->shader.id, length, &written, &header.format, data + sizeof(header));
+    header.length = (uint32_t)written;
+    memcpy(data, &header, sizeof(header));
+
+    if ((written > 0) && SaveFileData(path, data, (int)(sizeof(header) + written))) stats.saved++;
+
+    free(data);
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void InitShaderCache(const char *directory)
+{
+    cacheEnabled = false;
+    memset(&stats, 0, sizeof(stats));
+    warmupCount = 0;
+
+    if (directory == NULL) return;
+
+#if defined(SHADER_CACHE_SUPPORTED)
+    GetProcAddressFunc getProc = FindGetProcAddress();
+    if (getProc == NULL)
+    {
+        TraceLog(LOG_INFO, "SHADERCACHE: No GL loader found, shaders are compiled from source");
+        return;
+    }
+
+    GetStringFunc getString;
+    GetIntegervFunc getIntegerv;
+    *(void **)&getString = getProc("glGetString");
+    *(void **)&getIntegerv = getProc("glGetIntegerv");
+    *(void **)&gl.CreateProgram = getProc("glCreateProgram");
+    *(void **)&gl.GetProgramiv = getProc("glGetProgramiv");
+    *(void **)&gl.GetProgramBinary = getProc("glGetProgramBinary");
+    *(void **)&gl.ProgramBinary = getProc("glProgramBinary");
+
+    int formats = 0;
+    if ((getString != NULL) && (getIntegerv != NULL) && (gl.CreateProgram != NULL) && (gl.GetProgramiv != NULL) &&
+        (gl.GetProgramBinary != NULL) && (gl.ProgramBinary != NULL)) getIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+    if (formats <= 0)
+    {
+        TraceLog(LOG_INFO, "SHADERCACHE: Driver has no program binary formats, shaders are compiled from source");
+        return;
+    }
+
+    if (!DirectoryExists(directory) && (MakeDirectory(directory) != 0))
+    {
+        TraceLog(LOG_WARNING, "SHADERCACHE: Could not create %s, shaders are compiled from source", directory);
+        return;
+    }
+
+    const char *vendor = (const char *)getString(GL_VENDOR);
+    const char *renderer = (const char *)getString(GL_RENDERER);
+    const char *version = (const char *)getString(GL_VERSION);
+
+    driverKey = 0xcbf29ce484222325ull;
+    driverKey = HashString(driverKey, vendor);
+    driverKey = HashString(driverKey, renderer);
+    driverKey = HashString(driverKey, version);
+    driverKey = HashString(driverKey, RAYLIB_VERSION);
+
+    snprintf(cacheDirectory, sizeof(cacheDirectory), "%s", directory);
+    cacheEnabled = true;
+
+    TraceLog(LOG_INFO, "SHADERCACHE: %s (%s, %s), %d binary format(s)", directory, renderer ? renderer : "?",
+             version ? version : "?", formats);
+#else
+    TraceLog(LOG_INFO, "SHADERCACHE: Not supported on this platform, shaders are compiled from source");
+#endif
+}
+
+void CloseShaderCache(void)
+{
+    if ((stats.hits + stats.misses) > 0)
+    {
+        TraceLog(LOG_INFO, "SHADERCACHE: %d from cache (%.1f ms), %d compiled (%.1f ms), %d rejected, %d saved",
+                 stats.hits, stats.hitSeconds*1000, stats.misses, stats.missSeconds*1000, stats.rejected, stats.saved);
+    }
+
+    warmupCount = 0;
+    cacheEnabled = false;
+}
+
+bool LoadCachedShader(CachedShader *shader)
+{
+    if (shader->loaded) return !shader->failed;
+
+    double start = GetTime();
+    char path[640] = { 0 };
+    unsigned int program = 0;
+
+    if (cacheEnabled)
+    {
+        GetCachePath(shader, path, sizeof(path));
+        program = LoadProgramBinary(shader, path);
+    }
+
+    if (program != 0)
+    {
+        shader->shader.id = program;
+        SetDefaultLocations(&shader->shader);
+        stats.hits++;
+        stats.hitSeconds += GetTime() - start;
+    }
+    else
+    {
+        shader->shader = LoadShaderFromMemory(shader->vsCode, shader->fsCode);
+        shader->failed = (shader->shader.id == rlGetShaderIdDefault());
+        if (cacheEnabled && !shader->failed) SaveProgramBinary(shader, path);
+        stats.misses++;
+        stats.missSeconds += GetTime() - start;
+    }
+
+    shader->loaded = true;
+    if (shader->failed) TraceLog(LOG_WARNING, "SHADERCACHE: [%s] Does not compile, using the default shader", shader->name);
+
+    return !shader->failed;
+}
+
+void UnloadCachedShader(CachedShader *shader)
+{
+    for (int i = 0; i < warmupCount; i++)
+    {
+        if (warmupQueue[i] != shader) continue;
+
+        memmove(&warmupQueue[i], &warmupQueue[i + 1], (warmupCount - i - 1)*sizeof(CachedShader *));
+        warmupCount--;
+        break;
+    }
+
+    // Not queued any more, but the I/O thread may still fill in the read
+    while (GetFileReadState(&shader->prefetch) == FILE_READ_PENDING) WaitTime(0.0005);
+    if (shader->prefetch.data != NULL) UnloadFileData(shader->prefetch.data);
+    shader->prefetch = (FileRead){ 0 };
+
+    if (shader->loaded && !shader->failed) UnloadShader(shader->shader);
+    shader->loaded = false;
+    shader->failed = false;
+    shader->shader = (Shader){ 0 };
+}
+
+void QueueShaderWarmup(CachedShader *shader)
+{
+    if (shader->loaded) return;
+
+    if (warmupCount == MAX_WARMUP_SHADERS)
+    {
+        LoadCachedShader(shader);
+        return;
+    }
+
+    warmupQueue[warmupCount++] = shader;
+
+    // The I/O thread reads the cache file meanwhile (see fileio.h), a failed read is a miss
+    if (cacheEnabled)
+    {
+        char path[640] = { 0 };
+        GetCachePath(shader, path, sizeof(path));
+        FileReadAsync(path, &shader->prefetch);
+    }
+}
+
+void UpdateShaderWarmup(double budgetSeconds)
+{
+    double start = GetTime();
+    int done = 0;
+
+    // At least one per call, a program cannot be split, none while the next file is read
+    while ((done < warmupCount) && ((done == 0) || (GetTime() - start < budgetSeconds)))
+    {
+        if (GetFileReadState(&warmupQueue[done]->prefetch) == FILE_READ_PENDING) break;
+
+        LoadCachedShader(warmupQueue[done]);
+        done++;
+    }
+
+    if (done == 0) return;
+
+    memmove(&warmupQueue[0], &warmupQueue[done], (warmupCount - done)*sizeof(CachedShader *));
+    warmupCount -= done;
+}
@@ -0,0 +1,62 @@
+/*******************************************************************************************
+*
+*   C-volley - shader program binary cache
+*
+*   Compiling and linking GLSL takes tens of milliseconds per program on embedded GPUs. The
+*   first run links from source as usual and saves the driver's program binary
+*   (glGetProgramBinary); later runs load it with glProgramBinary and skip the compiler. Cache
+*   files are keyed by the GL vendor, renderer and version strings, the raylib version and a
+*   hash of both sources, so a driver update or an edited shader misses and recompiles. A
+*   binary the driver refuses (link status false) is replaced by the one of the program
+*   compiled from source.
+*
+*   Shaders the first frame does not need are queued with QueueShaderWarmup() and loaded by
+*   UpdateShaderWarmup() between frames, a time budget per frame, once the first frame is
+*   up. raylib owns the only GL context and it is current on the game thread, so that is
+*   where warmup runs; a shader used before its turn is loaded right away by LoadCachedShader().
+*   Cache files are read and written by the I/O service when it runs (fileio.h), queued
+*   shaders have theirs read ahead.
+*
+*   Needs program binaries (GL 4.1, ARB_get_program_binary or GLES 3.0) and a GL loader
+*   (GLFW, EGL or SDL); otherwise, and on the web and Windows, every program is compiled from
+*   source as if there were no cache.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include "raylib.h"
+#include "fileio.h"
+
+#include <stdbool.h>
+
+#define SHADER_WARMUP_BUDGET 0.002      // Seconds per frame, at least one program is loaded
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct CachedShader {
+    const char *name;           // Part of the cache file name, also in logs
+    const char *vsCode;         // NULL for raylib's default vertex shader
+    const char *fsCode;         // NULL for raylib's default fragment shader
+    Shader shader;              // Valid once loaded
+    bool loaded;
+    bool failed;                // Does not compile, shader is raylib's default
+    FileRead prefetch;          // Cache file read ahead for warmup
+} CachedShader;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+void InitShaderCache(const char *directory);        // After InitWindow(), NULL compiles everything from source
+void CloseShaderCache(void);                        // Logs hits, misses and load times
+
+bool LoadCachedShader(CachedShader *shader);        // Now, from the cache or compiled; no-op once loaded
+void UnloadCachedShader(CachedShader *shader);
+
+void QueueShaderWarmup(CachedShader *shader);       // Loaded by UpdateShaderWarmup() unless used first
+void UpdateShaderWarmup(double budgetSeconds);      // Once per frame, after the frame is drawn
+
+#endif // SHADERCACHE_H
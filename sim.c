@@ -0,0 +1,726 @@
+/*******************************************************************************************
+*
+*   C-volley - match simulation
+*
+*   Step order (kept from the original UpdateGame(), changing it changes matches):
+*     1. actions/AI for the left then the right blob
+*     2. blob integration, gravity, ground
+*     3. score delay countdown, ball reset when it expires
+*     4. ball integration, walls, ceiling
+*     5. net, left blob, right blob contacts (blobs skipped during the score delay)
+*     6. ground bounce and scoring
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "sim.h"
+
+// No fused multiply-add: a fused and an unfused path through the same formula (MoveBall() and
+// SimAdvanceBall()) would round differently, and replays would depend on the compiler's choice
+#if defined(__clang__)
+    #pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+    #pragma GCC optimize ("fp-contract=off")
+#endif
+
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+
+// Same tests as raylib's CheckCollisionCircles()/CheckCollisionCircleRec(), kept here so the
+// simulation does not depend on the raylib build it is linked with
+static bool CirclesOverlap(Vector2 center1, float radius1, Vector2 center2, float radius2)
+{
+    float dx = center2.x - center1.x;
+    float dy = center2.y - center1.y;
+    float radiusSum = radius1 + radius2;
+
+    return ((dx*dx + dy*dy) <= (radiusSum*radiusSum));
+}
+
+static bool CircleOverlapsRec(Vector2 center, float radius, Rectangle rec)
+{
+    float dx = fabsf(center.x - (rec.x + rec.width/2.0f));
+    float dy = fabsf(center.y - (rec.y + rec.height/2.0f));
+
+    if (dx > (rec.width/2.0f + radius)) return false;
+    if (dy > (rec.height/2.0f + radius)) return false;
+    if (dx <= (rec.width/2.0f)) return true;
+    if (dy <= (rec.height/2.0f)) return true;
+
+    float cornerDistanceSq = (dx - rec.width/2.0f)*(dx - rec.width/2.0f) + (dy - rec.height/2.0f)*(dy - rec.height/2.0f);
+    return (cornerDistanceSq <= (radius*radius));
+}
+
+static void StepBlob(SimBlob *blob)
+{
+    blob->position.x += blob->velocity.x;
+    blob->position.y += blob->velocity.y;
+    blob->velocity.y += PLAYER_GRAVITY;
+
+    // Clamp max velocity
+    if (blob->velocity.y > PLAYER_MAX_VELOCITY_Y) blob->velocity.y = PLAYER_MAX_VELOCITY_Y;
+
+    // Ground collision
+    if (blob->position.y + PLAYER_RADIUS >= GROUND_LEVEL)
+    {
+        blob->position.y = GROUND_LEVEL - PLAYER_RADIUS;
+        blob->velocity.y = 0;
+        blob->onGround = true;
+    }
+    else blob->onGround = false;
+}
+
+// Integration, walls and ceiling
+static unsigned int MoveBall(SimBall *ball)
+{
+    unsigned int events = 0;
+
+    ball->position.x += ball->velocity.x;
+    ball->position.y += ball->velocity.y;
+    ball->velocity.y += BALL_GRAVITY;
+
+    // NOTE: Air resistance, turns out not very useful now
+    //ball->velocity.x *= BALL_AIR_RESISTANCE;
+
+    // NOTE: ball rotation based on speed
+    float speed = sqrtf(ball->velocity.x*ball->velocity.x);
+    ball->rotation += (speed/BALL_RADIUS)*35.0f;
+
+    if (ball->position.x - BALL_RADIUS <= 0)
+    {
+        ball->position.x = BALL_RADIUS;
+        ball->velocity.x *= -BALL_BOUNCE_DAMPING;
+        events |= SIM_EVENT_WALL;
+    }
+    if (ball->position.x + BALL_RADIUS >= SCREEN_WIDTH)
+    {
+        ball->position.x = SCREEN_WIDTH - BALL_RADIUS;
+        ball->velocity.x *= -BALL_BOUNCE_DAMPING;
+        events |= SIM_EVENT_WALL;
+    }
+
+    if (ball->position.y - BALL_RADIUS <= 0)
+    {
+        ball->position.y = BALL_RADIUS;
+        ball->velocity.y *= -BALL_BOUNCE_DAMPING;
+        events |= SIM_EVENT_CEILING;
+    }
+
+    return events;
+}
+
+static unsigned int BounceBallOffNet(SimBall *ball)
+{
+    Rectangle netRect = { NET_X - NET_WIDTH/2, GROUND_LEVEL - NET_HEIGHT, NET_WIDTH, NET_HEIGHT };
+
+    if (!CircleOverlapsRec(ball->position, BALL_RADIUS, netRect)) return 0;
+
+    // Realistic net collision with energy loss
+    ball->velocity.x *= -BALL_BOUNCE_DAMPING;
+    ball->velocity.y *= 0.9f;  // Slight vertical damping on net hit
+
+    // Push ball out of net
+    if (ball->position.x < NET_X) ball->position.x = netRect.x - BALL_RADIUS;
+    else ball->position.x = netRect.x + netRect.width + BALL_RADIUS;
+
+    return SIM_EVENT_NET;
+}
+
+static bool BounceBallOffBlob(SimBall *ball, const SimBlob *blob)
+{
+    if (!CirclesOverlap(ball->position, BALL_RADIUS, blob->position, PLAYER_RADIUS)) return false;
+
+    // Collision normal
+    Vector2 normal = { ball->position.x - blob->position.x, ball->position.y - blob->position.y };
+
+    float length = sqrtf(normal.x*normal.x + normal.y*normal.y);
+    if (length > 0)
+    {
+        normal.x /= length;
+        normal.y /= length;
+    }
+
+    // Reflect ball velocity with realistic energy retention
+    float dotProduct = ball->velocity.x*normal.x + ball->velocity.y*normal.y;
+    ball->velocity.x = ball->velocity.x - 2*dotProduct*normal.x;
+    ball->velocity.y = ball->velocity.y - 2*dotProduct*normal.y;
+
+    // Apply slight energy loss on collision
+    ball->velocity.x *= 0.95f;
+    ball->velocity.y *= 0.95f;
+
+    // Add player's velocity influence
+    ball->velocity.x += blob->velocity.x*0.7f;
+    ball->velocity.y += blob->velocity.y*0.5f;
+
+    // Special case: if blob is jumping, add upward boost
+    if (blob->velocity.y < -5.0f) ball->velocity.y -= 3.0f;
+
+    // Clamp ball speed
+    float speed = sqrtf(ball->velocity.x*ball->velocity.x + ball->velocity.y*ball->velocity.y);
+    if (speed > BALL_MAX_SPEED)
+    {
+        ball->velocity.x = (ball->velocity.x/speed)*BALL_MAX_SPEED;
+        ball->velocity.y = (ball->velocity.y/speed)*BALL_MAX_SPEED;
+    }
+
+    // Push ball out of blob
+    ball->position.x = blob->position.x + normal.x*(PLAYER_RADIUS + BALL_RADIUS);
+    ball->position.y = blob->position.y + normal.y*(PLAYER_RADIUS + BALL_RADIUS);
+
+    return true;
+}
+
+static unsigned int BounceBallOffGround(SimBall *ball)
+{
+    if (ball->position.y + BALL_RADIUS < GROUND_LEVEL) return 0;
+
+    ball->position.y = GROUND_LEVEL - BALL_RADIUS;
+    ball->velocity.y *= -BALL_BOUNCE_DAMPING;
+
+    return SIM_EVENT_GROUND;
+}
+
+// One frame of a blob whose side sends action 0, true when it is at rest and later idle
+// frames cannot change it any more
+static bool StepIdleBlob(SimState *sim, int side)
+{
+    SimBlob *blob = &sim->blobs[side];
+
+    SimApplyAction(sim, side, 0);
+    StepBlob(blob);
+
+    return blob->onGround && (blob->velocity.x == 0) && (blob->velocity.y == 0) &&
+           (blob->position.y == GROUND_LEVEL - PLAYER_RADIUS);
+}
+
+// Idle frames leave the blob exactly as it is
+static bool BlobAtRest(const SimState *sim, int side)
+{
+    SimState next = *sim;
+    SimApplyAction(&next, side, 0);
+    StepBlob(&next.blobs[side]);
+
+    const SimBlob *a = &sim->blobs[side];
+    const SimBlob *b = &next.blobs[side];
+
+    return (a->position.x == b->position.x) && (a->position.y == b->position.y) &&
+           (a->velocity.x == b->velocity.x) && (a->velocity.y == b->velocity.y) && (a->onGround == b->onGround);
+}
+
+//----------------------------------------------------------------------------------
+// Event-driven ball flight
+//
+// Between contacts the ball follows y(n) = y + n*vy + g*n*(n - 1)/2 and x(n) = x + n*vx
+// after n frames. Solved in double precision this gives the first frame on which a wall,
+// the ceiling, the net, the ground or a blob region could be reached. Frames before that
+// run the bare integration with the same float operations as MoveBall() (bit-identical
+// results), frames around it run every test. Margins absorb the difference between the
+// closed form and float accumulation; a too early estimate only costs a few tested frames.
+//----------------------------------------------------------------------------------
+#define FLIGHT_MARGIN_FRAMES 2
+#define FLIGHT_MARGIN_DISTANCE 1.0
+#define FLIGHT_MAX_CHUNK 1024           // Keeps float drift from the closed form small
+#define FLIGHT_TESTED_FRAMES (2*FLIGHT_MARGIN_FRAMES + 2)
+#define FLIGHT_NEVER 0x7FFFFFFF
+
+// First n >= 0 with y(n) >= limit (y convex in n), FLIGHT_NEVER if the ball never gets there
+static double FirstFrameBelow(double y, double vy, double limit)
+{
+    if (y >= limit) return 0;
+
+    double a = BALL_GRAVITY/2.0;
+    double b = vy - BALL_GRAVITY/2.0;
+    double c = y - limit;
+
+    return (-b + sqrt(b*b - 4*a*c))/(2*a);      // c < 0: one positive root
+}
+
+// First n >= 0 with y(n) <= limit, FLIGHT_NEVER if the apex stays below it
+static double FirstFrameAbove(double y, double vy, double limit)
+{
+    if (y <= limit) return 0;
+
+    double a = BALL_GRAVITY/2.0;
+    double b = vy - BALL_GRAVITY/2.0;
+    double c = y - limit;
+    double discriminant = b*b - 4*a*c;
+
+    if ((b >= 0) || (discriminant < 0)) return FLIGHT_NEVER;
+
+    return (-b - sqrt(discriminant))/(2*a);
+}
+
+// First n >= 0 inside [left, right] with y(n) >= top, FLIGHT_NEVER if none
+static double FirstFrameInColumn(double x, double vx, double y, double vy, double left, double right, double top)
+{
+    double enter = 0, leave = FLIGHT_NEVER;
+
+    if (vx > 0)
+    {
+        if (x > right) return FLIGHT_NEVER;
+        enter = (x < left) ? (left - x)/vx : 0;
+        leave = (right - x)/vx;
+    }
+    else if (vx < 0)
+    {
+        if (x < left) return FLIGHT_NEVER;
+        enter = (x > right) ? (right - x)/vx : 0;
+        leave = (left - x)/vx;
+    }
+    else if ((x < left) || (x > right)) return FLIGHT_NEVER;
+
+    // y(n) >= top holds outside the roots of y(n) = top
+    double a = BALL_GRAVITY/2.0;
+    double b = vy - BALL_GRAVITY/2.0;
+    double c = y - top;
+    double discriminant = b*b - 4*a*c;
+    if (discriminant < 0) return enter;
+
+    double low = (-b - sqrt(discriminant))/(2*a);
+    double high = (-b + sqrt(discriminant))/(2*a);
+
+    if (enter <= low) return enter;
+    if (leave >= high) return (enter > high) ? enter : high;
+
+    return FLIGHT_NEVER;
+}
+
+// Frames the ball surely flies without any test in MoveBall()/BounceBallOff*() or the blob
+// regions triggering
+static int SafeFlightFrames(const SimBall *ball, const Rectangle *blobRegions, int regionCount, int limit)
+{
+    const double margin = FLIGHT_MARGIN_DISTANCE;
+    double x = ball->position.x, y = ball->position.y;
+    double vx = ball->velocity.x, vy = ball->velocity.y;
+
+    // Frame n tests the position after n moves, the contact frame is the first n at or past the estimate
+    double first = FirstFrameBelow(y, vy, GROUND_LEVEL - BALL_RADIUS - margin);
+
+    // No ceiling when falling and clear of it after the next move, the float y only grows from
+    // there (exact without margin, also right after a ceiling bounce)
+    if ((ball->velocity.y <= 0) || (ball->position.y + ball->velocity.y - BALL_RADIUS <= 0))
+    {
+        double ceiling = FirstFrameAbove(y, vy, BALL_RADIUS + margin);
+        if (ceiling < first) first = ceiling;
+    }
+
+    if (vx < 0)
+    {
+        double wall = (x - BALL_RADIUS - margin)/-vx;
+        if (wall < first) first = wall;
+    }
+    else if (vx > 0)
+    {
+        double wall = (SCREEN_WIDTH - BALL_RADIUS - margin - x)/vx;
+        if (wall < first) first = wall;
+    }
+
+    double netReach = NET_WIDTH/2 + BALL_RADIUS + margin;
+    double net = FirstFrameInColumn(x, vx, y, vy, NET_X - netReach, NET_X + netReach, GROUND_LEVEL - NET_HEIGHT - BALL_RADIUS - margin);
+    if (net < first) first = net;
+
+    double blobReach = PLAYER_RADIUS + BALL_RADIUS + margin;
+    for (int i = 0; i < regionCount; i++)
+    {
+        const Rectangle *region = &blobRegions[i];
+        double blob = FirstFrameInColumn(x, vx, y, vy, region->x - blobReach, region->x + region->width + blobReach, region->y - blobReach);
+        if (blob < first) first = blob;
+    }
+
+    if (first >= limit + FLIGHT_MARGIN_FRAMES) return limit;
+
+    int safe = (int)first - FLIGHT_MARGIN_FRAMES;
+
+    return (safe > 0) ? safe : 0;
+}
+
+// Could the ball at this position touch a blob anywhere in the regions
+static bool BallReachesRegions(Vector2 position, const Rectangle *blobRegions, int regionCount)
+{
+    for (int i = 0; i < regionCount; i++)
+    {
+        if (CircleOverlapsRec(position, BALL_RADIUS + PLAYER_RADIUS + 0.5f, blobRegions[i])) return true;
+    }
+
+    return false;
+}
+
+// xorshift32, deterministic across platforms unlike rand()
+static int NextRandom(uint32_t *state, int min, int max)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return min + (int)(x%(uint32_t)(max - min + 1));
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+
+void SimInit(SimState *sim, uint32_t seed)
+{
+    memset(sim, 0, sizeof(SimState));
+
+    sim->blobs[0].position = (Vector2){ SCREEN_WIDTH/4, GROUND_LEVEL - PLAYER_RADIUS };
+    sim->blobs[1].position = (Vector2){ SCREEN_WIDTH*3/4, GROUND_LEVEL - PLAYER_RADIUS };
+    sim->blobs[0].onGround = true;
+    sim->blobs[1].onGround = true;
+
+    sim->rng = (seed != 0) ? seed : 0x9E3779B9u;    // xorshift state must not be zero
+
+    SimResetBall(sim);
+}
+
+void SimResetMatch(SimState *sim)
+{
+    sim->blobs[0].score = 0;
+    sim->blobs[1].score = 0;
+    sim->tick = 0;
+    sim->scoreDelay = 0;
+    sim->gameOver = false;
+
+    SimResetBall(sim);
+}
+
+void SimResetBall(SimState *sim)
+{
+    if (sim->servingSide == 0) sim->ball.position = (Vector2){ SCREEN_WIDTH/4, 100 };
+    else sim->ball.position = (Vector2){ SCREEN_WIDTH*3/4, 100 };
+
+    sim->ball.velocity = (Vector2){ 0, 0 };
+    sim->ball.rotation = 0;
+}
+
+// Move/jump a blob according to an action and keep it on its side of the net
+void SimApplyAction(SimState *sim, int side, unsigned char action)
+{
+    SimBlob *blob = &sim->blobs[side];
+
+    if (action & ACTION_LEFT)
+    {
+        blob->position.x -= PLAYER_MOVE_SPEED;
+        blob->velocity.x = -PLAYER_MOVE_SPEED;
+    }
+    else if (action & ACTION_RIGHT)
+    {
+        blob->position.x += PLAYER_MOVE_SPEED;
+        blob->velocity.x = PLAYER_MOVE_SPEED;
+    }
+    else blob->velocity.x = 0;
+
+    if ((action & ACTION_JUMP) && blob->onGround)
+    {
+        blob->velocity.y = PLAYER_JUMP_FORCE;
+        blob->onGround = false;
+    }
+
+    float minX = (side == 0) ? 0 : NET_X + NET_WIDTH/2;
+    float maxX = (side == 0) ? NET_X - NET_WIDTH/2 : SCREEN_WIDTH;
+
+    if (blob->position.x - PLAYER_RADIUS < minX) blob->position.x = minX + PLAYER_RADIUS;
+    if (blob->position.x + PLAYER_RADIUS > maxX) blob->position.x = maxX - PLAYER_RADIUS;
+}
+
+// Built-in AI, written for the right side and mirrored for the left one
+// NOTE: for the right side every operation matches the original single player AI exactly
+void SimUpdateAI(SimState *sim, int side)
+{
+    SimBlob *blob = &sim->blobs[side];
+    const SimBall *ball = &sim->ball;
+    bool mirrored = (side == 0);
+
+    // Right side coordinates
+    float ballX = mirrored ? SCREEN_WIDTH - ball->position.x : ball->position.x;
+    float ballVX = mirrored ? -ball->velocity.x : ball->velocity.x;
+    float blobX = mirrored ? SCREEN_WIDTH - blob->position.x : blob->position.x;
+    float blobVX = 0;
+
+    if (sim->aiJumpCooldown[side] > 0) sim->aiJumpCooldown[side]--;
+
+    // Only react if ball is on AI's side or coming toward it
+    bool ballComingToward = (ballVX > 0 && ballX < NET_X) || (ballX >= NET_X);
+
+    if (!ballComingToward)
+    {
+        // Return to center of side
+        float targetX = NET_X + (SCREEN_WIDTH - NET_X)/2;
+        if (blobX < targetX - AI_POSITION_TOLERANCE) blobX += PLAYER_MOVE_SPEED*0.6f;
+        else if (blobX > targetX + AI_POSITION_TOLERANCE) blobX -= PLAYER_MOVE_SPEED*0.6f;
+
+        blob->position.x = mirrored ? SCREEN_WIDTH - blobX : blobX;
+        blob->velocity.x = 0;
+        return;
+    }
+
+    // Move toward ball's X position
+    float distanceX = ballX - blobX;
+
+    if (distanceX < -AI_POSITION_TOLERANCE)
+    {
+        blobX -= PLAYER_MOVE_SPEED*0.8f;
+        blobVX = -PLAYER_MOVE_SPEED*0.8f;
+    }
+    else if (distanceX > AI_POSITION_TOLERANCE)
+    {
+        blobX += PLAYER_MOVE_SPEED*0.8f;
+        blobVX = PLAYER_MOVE_SPEED*0.8f;
+    }
+
+    // Keep AI on their side
+    if (blobX - PLAYER_RADIUS < NET_X + NET_WIDTH/2) blobX = NET_X + NET_WIDTH/2 + PLAYER_RADIUS;
+    if (blobX + PLAYER_RADIUS > SCREEN_WIDTH) blobX = SCREEN_WIDTH - PLAYER_RADIUS;
+
+    blob->position.x = mirrored ? SCREEN_WIDTH - blobX : blobX;
+    blob->velocity.x = mirrored ? -blobVX : blobVX;
+
+    // Jump decision
+    float distanceY = blob->position.y - ball->position.y;
+    float horizontalDist = fabsf(distanceX);
+
+    bool shouldJump = (horizontalDist < AI_REACTION_DISTANCE) &&
+                      (distanceY > -AI_JUMP_THRESHOLD) &&
+                      (distanceY < 100.0f) &&
+                      (sim->aiJumpCooldown[side] == 0) &&
+                      (blob->onGround);
+
+    // Add randomness to make AI beatable (20% chance to miss)
+    if (shouldJump && SimRandom(sim, 0, 100) > 20)
+    {
+        blob->velocity.y = PLAYER_JUMP_FORCE*0.9f;
+        blob->onGround = false;
+        sim->aiJumpCooldown[side] = AI_JUMP_COOLDOWN;
+    }
+}
+
+int SimRandom(SimState *sim, int min, int max)
+{
+    return NextRandom(&sim->rng, min, max);
+}
+
+void SimMirror(const SimState *sim, SimState *mirrored)
+{
+    *mirrored = *sim;
+
+    for (int side = 0; side < 2; side++)
+    {
+        const SimBlob *blob = &sim->blobs[1 - side];
+        SimBlob *out = &mirrored->blobs[side];
+
+        *out = *blob;
+        out->position.x = SCREEN_WIDTH - blob->position.x;
+        out->velocity.x = -blob->velocity.x;
+        mirrored->aiJumpCooldown[side] = sim->aiJumpCooldown[1 - side];
+    }
+
+    mirrored->ball.position.x = SCREEN_WIDTH - sim->ball.position.x;
+    mirrored->ball.velocity.x = -sim->ball.velocity.x;
+    mirrored->ball.rotation = -sim->ball.rotation;
+    mirrored->servingSide = 1 - sim->servingSide;
+}
+
+unsigned char SimMirrorAction(unsigned char action)
+{
+    unsigned char moves = action & (ACTION_LEFT | ACTION_RIGHT);
+    unsigned char swapped = ((moves & ACTION_LEFT) ? ACTION_RIGHT : 0) | ((moves & ACTION_RIGHT) ? ACTION_LEFT : 0);
+
+    return (action & ~(ACTION_LEFT | ACTION_RIGHT)) | swapped;
+}
+
+void SimScriptInit(SimScript *script, uint32_t seed)
+{
+    memset(script, 0, sizeof(SimScript));
+    script->rng = (seed != 0) ? seed : 0x9E3779B9u;
+}
+
+// Re-decides every few ticks, mostly walks under the ball, sometimes wanders, jumps at it now and then
+unsigned char SimScriptAction(SimScript *script, const SimState *sim, int side)
+{
+    const SimBlob *blob = &sim->blobs[side];
+    const SimBall *ball = &sim->ball;
+
+    if (--script->holdTicks <= 0)
+    {
+        script->holdTicks = NextRandom(&script->rng, 6, 25);
+
+        float dx = ball->position.x - blob->position.x;
+        if (NextRandom(&script->rng, 0, 9) < 7) script->holdAction = (dx < -20.0f) ? ACTION_LEFT : (dx > 20.0f) ? ACTION_RIGHT : 0;
+        else script->holdAction = (unsigned char)NextRandom(&script->rng, 0, 2);
+    }
+
+    unsigned char action = script->holdAction;
+    float dy = blob->position.y - ball->position.y;
+    if (blob->onGround && (fabsf(ball->position.x - blob->position.x) < 80.0f) && (dy > 0.0f) && (dy < 180.0f) &&
+        (NextRandom(&script->rng, 0, 3) == 0)) action |= ACTION_JUMP;
+
+    return action;
+}
+
+unsigned int SimStepBallFlight(SimBall *ball)
+{
+    unsigned int events = MoveBall(ball);
+    events |= BounceBallOffNet(ball);
+    events |= BounceBallOffGround(ball);
+
+    return events;
+}
+
+int SimAdvanceBall(SimBall *ball, const Rectangle *blobRegions, int regionCount, bool stopAtGround, int maxFrames, unsigned int *events)
+{
+    int frames = 0;
+
+    while (frames < maxFrames)
+    {
+        int chunk = maxFrames - frames;
+        if (chunk > FLIGHT_MAX_CHUNK) chunk = FLIGHT_MAX_CHUNK;
+
+        // MoveBall() without the tests, horizontal speed and so the spin are constant in flight
+        int safe = SafeFlightFrames(ball, blobRegions, regionCount, chunk);
+        float speed = sqrtf(ball->velocity.x*ball->velocity.x);
+
+        for (int i = 0; i < safe; i++)
+        {
+            ball->position.x += ball->velocity.x;
+            ball->position.y += ball->velocity.y;
+            ball->velocity.y += BALL_GRAVITY;
+            ball->rotation += (speed/BALL_RADIUS)*35.0f;
+        }
+        frames += safe;
+
+        // Around the estimated contact: fully tested frames, a new estimate after a bounce
+        for (int i = 0; (i < FLIGHT_TESTED_FRAMES) && (frames < maxFrames); i++)
+        {
+            SimBall next = *ball;
+            unsigned int flight = MoveBall(&next);
+            flight |= BounceBallOffNet(&next);
+
+            if (BallReachesRegions(next.position, blobRegions, regionCount)) return frames;
+            if (stopAtGround && (next.position.y + BALL_RADIUS >= GROUND_LEVEL)) return frames;
+
+            flight |= BounceBallOffGround(&next);
+
+            *ball = next;
+            *events |= flight;
+            frames++;
+
+            if (flight) break;
+        }
+    }
+
+    return frames;
+}
+
+unsigned int SimStep(SimState *sim, const unsigned char actions[2])
+{
+    if (sim->gameOver) return 0;
+
+    unsigned int events = 0;
+
+    sim->tick++;
+
+    for (int side = 0; side < 2; side++)
+    {
+        if (actions[side] & ACTION_AI) SimUpdateAI(sim, side);
+        else SimApplyAction(sim, side, actions[side]);
+    }
+
+    StepBlob(&sim->blobs[0]);
+    StepBlob(&sim->blobs[1]);
+
+    if (sim->scoreDelay > 0)
+    {
+        sim->scoreDelay--;
+        if (sim->scoreDelay == 0)
+        {
+            SimResetBall(sim);
+            events |= SIM_EVENT_RESET;
+        }
+    }
+
+    events |= MoveBall(&sim->ball);
+    events |= BounceBallOffNet(&sim->ball);
+
+    if (sim->scoreDelay == 0)
+    {
+        if (BounceBallOffBlob(&sim->ball, &sim->blobs[0])) events |= SIM_EVENT_BLOB_LEFT;
+        if (BounceBallOffBlob(&sim->ball, &sim->blobs[1])) events |= SIM_EVENT_BLOB_RIGHT;
+    }
+
+    unsigned int ground = BounceBallOffGround(&sim->ball);
+    events |= ground;
+
+    if (ground && (sim->scoreDelay == 0))
+    {
+        // Ball landed on the left side, right player scores; winner gets the serve
+        int scorer = (sim->ball.position.x < NET_X) ? 1 : 0;
+        sim->blobs[scorer].score++;
+        sim->servingSide = scorer;
+        events |= SIM_EVENT_SCORE;
+
+        if ((sim->blobs[0].score >= WIN_SCORE) || (sim->blobs[1].score >= WIN_SCORE))
+        {
+            sim->gameOver = true;
+            events |= SIM_EVENT_GAMEOVER;
+        }
+        else sim->scoreDelay = SCORE_DELAY_FRAMES;
+    }
+
+    return events;
+}
+
+int SimSkipDeadTime(SimState *sim, bool agentsIdle, unsigned int *events)
+{
+    int frames = 0;
+    *events = 0;
+
+    if (sim->gameOver) return 0;
+
+    if (sim->scoreDelay > 0)
+    {
+        // Nothing of the ball survives the reset, only blobs settling on the ground matter
+        bool resting[2] = { false, false };
+        while (sim->scoreDelay > 1)
+        {
+            if (resting[0] && resting[1])
+            {
+                frames += sim->scoreDelay - 1;
+                sim->tick += sim->scoreDelay - 1;
+                sim->scoreDelay = 1;
+                break;
+            }
+
+            for (int side = 0; side < 2; side++) if (!resting[side]) resting[side] = StepIdleBlob(sim, side);
+            sim->tick++;
+            sim->scoreDelay--;
+            frames++;
+        }
+
+        // Serve frame: reset plus the ball's first move
+        const unsigned char idle[2] = { 0, 0 };
+        *events |= SimStep(sim, idle);
+        frames++;
+    }
+
+    if (agentsIdle && (sim->scoreDelay == 0) && !(*events & (SIM_EVENT_BLOB_LEFT | SIM_EVENT_BLOB_RIGHT | SIM_EVENT_GROUND)) &&
+        BlobAtRest(sim, 0) && BlobAtRest(sim, 1))
+    {
+        Rectangle resting[2] = {
+            { sim->blobs[0].position.x, sim->blobs[0].position.y, 0, 0 },
+            { sim->blobs[1].position.x, sim->blobs[1].position.y, 0, 0 }
+        };
+
+        int flight = SimAdvanceBall(&sim->ball, resting, 2, true, FLIGHT_NEVER, events);
+        sim->tick += flight;
+        frames += flight;
+    }
+
+    return frames;
+}
@@ -0,0 +1,155 @@
+/*******************************************************************************************
+*
+*   C-volley - match simulation
+*
+*   Rules, physics and the built-in AI of a match, without rendering, sound or input. The game
+*   drives it once per frame and reacts to the returned SIM_EVENT_* bits (sounds, particles,
+*   state changes); headless tools drive it directly. A step only depends on the SimState
+*   and the two action bytes, the AI uses the state's own random generator, so the same
+*   seed and action sequence always replays the same match.
+*
+*   No raylib calls, only its Vector2 type: tools using this module build without a window.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "raylib.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+
+// Court size is the screen size
+#define SCREEN_WIDTH 1024
+#define SCREEN_HEIGHT 768
+
+// Physics constants
+#define PLAYER_GRAVITY 0.8f
+#define BALL_GRAVITY 0.4f
+#define BALL_AIR_RESISTANCE 0.99f  // Horizontal velocity damping per frame
+#define BALL_BOUNCE_DAMPING 1.0f   // Energy loss on wall/ceiling bounce
+#define GROUND_LEVEL (SCREEN_HEIGHT - 50)
+#define PLAYER_RADIUS 50.0f
+#define BALL_RADIUS 35.0f
+
+// Movement constants
+#define PLAYER_MOVE_SPEED 4.0f
+#define PLAYER_JUMP_FORCE -12.0f
+#define PLAYER_MAX_VELOCITY_Y 15.0f
+#define BALL_INITIAL_SPEED_X 4.0f
+#define BALL_INITIAL_SPEED_Y -6.0f
+#define BALL_MAX_SPEED 15.0f
+
+// Court layout
+#define NET_X (SCREEN_WIDTH / 2)
+#define NET_HEIGHT 140.0f
+#define NET_WIDTH 10.0f
+
+// Game rules
+#define WIN_SCORE 10
+#define SCORE_DELAY_FRAMES 120     // 2 seconds at 60fps between a point and the next serve
+
+// AI constants
+#define AI_REACTION_DISTANCE 150.0f
+#define AI_JUMP_THRESHOLD 60.0f
+#define AI_POSITION_TOLERANCE 20.0f
+#define AI_JUMP_COOLDOWN 30
+
+// Player action bitfield (keyboard, bots, replays)
+#define ACTION_LEFT  0x01
+#define ACTION_RIGHT 0x02
+#define ACTION_JUMP  0x04
+#define ACTION_AI    0x80          // Built-in AI drives the blob, other bits ignored
+
+// Step events
+#define SIM_EVENT_WALL        0x0001
+#define SIM_EVENT_CEILING     0x0002
+#define SIM_EVENT_NET         0x0004
+#define SIM_EVENT_BLOB_LEFT   0x0008
+#define SIM_EVENT_BLOB_RIGHT  0x0010
+#define SIM_EVENT_GROUND      0x0020
+#define SIM_EVENT_SCORE       0x0040
+#define SIM_EVENT_GAMEOVER    0x0080
+#define SIM_EVENT_RESET       0x0100    // Ball put back for the serve after the score delay
+
+// Events after which the ball no longer follows free flight from its previous state
+#define SIM_EVENT_BALL_CONTACT (SIM_EVENT_NET | SIM_EVENT_BLOB_LEFT | SIM_EVENT_BLOB_RIGHT | SIM_EVENT_RESET)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SimBlob {
+    Vector2 position;
+    Vector2 velocity;
+    int score;
+    bool onGround;
+} SimBlob;
+
+typedef struct SimBall {
+    Vector2 position;
+    Vector2 velocity;
+    float rotation;             // Degrees, visual only
+} SimBall;
+
+typedef struct SimState {
+    SimBlob blobs[2];           // 0 left, 1 right
+    SimBall ball;
+    int tick;                   // Frames since the match started
+    int servingSide;
+    int scoreDelay;             // Frames left before the next serve, 0 while the rally is live
+    int aiJumpCooldown[2];
+    uint32_t rng;               // AI random generator state
+    bool gameOver;
+} SimState;
+
+// Scripted stand-in for a human player (benchmarks, batch self-play), own random generator
+typedef struct SimScript {
+    uint32_t rng;
+    int holdTicks;              // Ticks until the next decision
+    unsigned char holdAction;   // Movement kept between decisions
+} SimScript;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+void SimInit(SimState *sim, uint32_t seed);                 // Blobs at their spots, left serves
+void SimResetMatch(SimState *sim);                          // Scores, tick and serve back to start
+void SimResetBall(SimState *sim);                           // Ball above the serving side
+unsigned int SimStep(SimState *sim, const unsigned char actions[2]);    // One frame, returns SIM_EVENT_* bits
+
+void SimApplyAction(SimState *sim, int side, unsigned char action);
+void SimUpdateAI(SimState *sim, int side);
+int SimRandom(SimState *sim, int min, int max);             // Inclusive range, like GetRandomValue()
+
+// Left-right mirror around the net (x -> SCREEN_WIDTH - x, blobs and their actions swapped),
+// the same float expression as SimUpdateAI(): exact for x >= NET_X, within half an ulp below
+void SimMirror(const SimState *sim, SimState *mirrored);
+unsigned char SimMirrorAction(unsigned char action);        // Swaps ACTION_LEFT and ACTION_RIGHT
+
+void SimScriptInit(SimScript *script, uint32_t seed);
+unsigned char SimScriptAction(SimScript *script, const SimState *sim, int side);
+
+// Headless fast-forward to the next frame where input can matter, same state as stepping with
+// both actions 0: the rest of a score delay (the ball is put back anyway) and, when agents
+// stay idle for the serve, the ball's flight until it can reach a blob or the ground.
+// Returns frames advanced, *events gets what SimStep() would report except ball bounces
+// during the delay. Only for callers whose agents send nothing in these intervals.
+int SimSkipDeadTime(SimState *sim, bool agentsIdle, unsigned int *events);
+
+// Ball free flight: gravity, walls and ceiling only, same float operations as SimStep()
+unsigned int SimStepBallFlight(SimBall *ball);
+
+// Up to maxFrames of SimStepBallFlight() with bit-identical results, jumping between the frames
+// where a wall, ceiling, net or ground contact can happen (solved in closed form) instead of
+// testing every frame. Stops before the first frame on which the ball could touch a blob whose
+// center stays within one of blobRegions, or the ground with stopAtGround (no regions: the frame
+// before an untouched ball lands, for lookahead). Returns frames advanced
+int SimAdvanceBall(SimBall *ball, const Rectangle *blobRegions, int regionCount, bool stopAtGround, int maxFrames, unsigned int *events);
+
+#endif // SIM_H
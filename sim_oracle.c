@@ -0,0 +1,343 @@
+/*******************************************************************************************
+*
+*   C-volley - float simulation and fast paths against the double precision reference
+*
+*   Usage:
+*     sim_oracle [matches] [--threads N] [--seed N]
+*
+*   Every match is first played with scripted players on SimStep() (the seeds batchsim uses),
+*   recording both action bytes of every frame. That input stream is then replayed through
+*   the double reference (simref.h) and through each variant in the table below, which
+*   advance one or more frames at a time; after each advance the variant's state is compared
+*   to the reference at the same frame. Per variant it reports:
+*
+*     - drift: largest ball and blob position error over the first DRIFT_WINDOW frames,
+*       sampled wherever the variant returns (every frame for SimStep())
+*     - divergence: share of matches where a point went the other way than in the reference,
+*       mean and earliest frame it was seen (points are further apart than any advance, so
+*       none is missed; the ball itself re-converges at every serve and is no good for this)
+*     - outcome: matches ending with the same score and the same winner as the reference
+*     - exact: matches whose final state is bit-identical to plain SimStep()
+*
+*   Small float errors grow through every blob contact, so "float" diverging after some
+*   seconds is expected; what a new fast path must not do is diverge earlier or change
+*   outcomes more often than "float", and if it claims exactness, "exact" must stay 100%.
+*   New fast paths get a row in the variant table.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "simref.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS 256
+#define MAX_MATCH_TICKS (60*60*30)
+#define DRIFT_WINDOW 600                // 10 seconds
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+
+// Advances up to count frames of the stream, returns how many
+typedef int (*AdvanceFunc)(SimState *sim, const unsigned char *actions, int count);
+
+typedef struct Variant {
+    const char *name;
+    AdvanceFunc advance;
+} Variant;
+
+typedef struct VariantStats {
+    int matches;
+    int diverged;
+    long long divergenceFrames;         // Sum over diverged matches
+    int firstDivergence;
+    int sameScore;
+    int sameWinner;
+    int exact;
+    double ballDriftSum;
+    double ballDriftMax;
+    double blobDriftSum;
+    double blobDriftMax;
+} VariantStats;
+
+static int AdvanceStep(SimState *sim, const unsigned char *actions, int count);
+static int AdvanceSkipDeadTime(SimState *sim, const unsigned char *actions, int count);
+
+static const Variant variants[] = {
+    { "float SimStep", AdvanceStep },
+    { "SimSkipDeadTime", AdvanceSkipDeadTime },
+};
+
+#define VARIANT_COUNT ((int)(sizeof(variants)/sizeof(variants[0])))
+
+typedef struct Worker {
+    pthread_t thread;
+    unsigned char *stream;              // 2 bytes per frame
+    VariantStats stats[VARIANT_COUNT];
+} Worker;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+static int matchCount = 2000;
+static uint32_t seed = 0;
+static int nextMatch = 0;               // Shared work counter
+
+//----------------------------------------------------------------------------------
+// Variants
+//----------------------------------------------------------------------------------
+static int AdvanceStep(SimState *sim, const unsigned char *actions, int count)
+{
+    (void)count;
+    SimStep(sim, actions);
+
+    return 1;
+}
+
+// The recorded players send nothing during the score delay, that part is jumped over
+static int AdvanceSkipDeadTime(SimState *sim, const unsigned char *actions, int count)
+{
+    if (sim->scoreDelay > 0)
+    {
+        SimState ahead = *sim;
+        unsigned int events = 0;
+        int jumped = SimSkipDeadTime(&ahead, false, &events);
+
+        if ((jumped > 0) && (jumped <= count))
+        {
+            *sim = ahead;
+            return jumped;
+        }
+    }
+
+    SimStep(sim, actions);
+    return 1;
+}
+
+//----------------------------------------------------------------------------------
+// Comparison
+//----------------------------------------------------------------------------------
+static double Distance(Vector2 a, RefVector b)
+{
+    return hypot(a.x - b.x, a.y - b.y);
+}
+
+static bool SameState(const SimState *a, const SimState *b)
+{
+    for (int side = 0; side < 2; side++)
+    {
+        const SimBlob *x = &a->blobs[side], *y = &b->blobs[side];
+        if ((x->position.x != y->position.x) || (x->position.y != y->position.y) || (x->velocity.x != y->velocity.x) ||
+            (x->velocity.y != y->velocity.y) || (x->score != y->score) || (x->onGround != y->onGround)) return false;
+    }
+
+    return (a->ball.position.x == b->ball.position.x) && (a->ball.position.y == b->ball.position.y) &&
+           (a->ball.velocity.x == b->ball.velocity.x) && (a->ball.velocity.y == b->ball.velocity.y) &&
+           (a->tick == b->tick) && (a->scoreDelay == b->scoreDelay) && (a->gameOver == b->gameOver);
+}
+
+// Winner or leader: -1 for a tie
+static int Leader(int left, int right)
+{
+    return (left > right) ? 0 : (right > left) ? 1 : -1;
+}
+
+// Scripted match on SimStep(), returns frames recorded
+static int RecordStream(int match, SimState *start, SimState *end, unsigned char *stream)
+{
+    uint32_t id = seed + (uint32_t)match;
+
+    SimScript script[2];
+    SimInit(start, 1000u + id);
+    SimScriptInit(&script[0], id*2654435761u + 1);
+    SimScriptInit(&script[1], id*2654435761u + 2);
+
+    SimState sim = *start;
+    int frames = 0;
+
+    while (!sim.gameOver && (frames < MAX_MATCH_TICKS))
+    {
+        unsigned char *actions = &stream[frames*2];
+        actions[0] = actions[1] = 0;
+
+        if (sim.scoreDelay == 0)
+        {
+            actions[0] = SimScriptAction(&script[0], &sim, 0);
+            actions[1] = SimScriptAction(&script[1], &sim, 1);
+        }
+
+        SimStep(&sim, actions);
+        frames++;
+    }
+
+    *end = sim;
+    return frames;
+}
+
+static void RunVariant(const Variant *variant, const SimState *start, const SimState *floatEnd,
+                       const unsigned char *stream, int frames, VariantStats *stats)
+{
+    SimState sim = *start;
+    RefState ref;
+    RefFromSim(&ref, start);
+
+    double ballDrift = 0, blobDrift = 0;
+    int divergence = -1;
+
+    for (int frame = 0; frame < frames; )
+    {
+        int advanced = variant->advance(&sim, &stream[frame*2], frames - frame);
+        for (int i = 0; i < advanced; i++) RefStep(&ref, &stream[(frame + i)*2]);
+        frame += advanced;
+
+        double ball = Distance(sim.ball.position, ref.ball.position);
+        double blob = fmax(Distance(sim.blobs[0].position, ref.blobs[0].position), Distance(sim.blobs[1].position, ref.blobs[1].position));
+
+        if (frame <= DRIFT_WINDOW)
+        {
+            if (ball > ballDrift) ballDrift = ball;
+            if (blob > blobDrift) blobDrift = blob;
+        }
+
+        if ((divergence < 0) && ((sim.blobs[0].score != ref.blobs[0].score) || (sim.blobs[1].score != ref.blobs[1].score))) divergence = frame;
+    }
+
+    stats->matches++;
+    if (divergence >= 0)
+    {
+        stats->diverged++;
+        stats->divergenceFrames += divergence;
+        if ((stats->firstDivergence == 0) || (divergence < stats->firstDivergence)) stats->firstDivergence = divergence;
+    }
+
+    if ((sim.blobs[0].score == ref.blobs[0].score) && (sim.blobs[1].score == ref.blobs[1].score)) stats->sameScore++;
+    if (Leader(sim.blobs[0].score, sim.blobs[1].score) == Leader(ref.blobs[0].score, ref.blobs[1].score)) stats->sameWinner++;
+    if (SameState(&sim, floatEnd)) stats->exact++;
+
+    stats->ballDriftSum += ballDrift;
+    stats->blobDriftSum += blobDrift;
+    if (ballDrift > stats->ballDriftMax) stats->ballDriftMax = ballDrift;
+    if (blobDrift > stats->blobDriftMax) stats->blobDriftMax = blobDrift;
+}
+
+static void *WorkerThread(void *data)
+{
+    Worker *worker = (Worker *)data;
+
+    for (;;)
+    {
+        int match = __atomic_fetch_add(&nextMatch, 1, __ATOMIC_RELAXED);
+        if (match >= matchCount) break;
+
+        SimState start, floatEnd;
+        int frames = RecordStream(match, &start, &floatEnd, worker->stream);
+
+        for (int v = 0; v < VARIANT_COUNT; v++) RunVariant(&variants[v], &start, &floatEnd, worker->stream, frames, &worker->stats[v]);
+    }
+
+    return NULL;
+}
+
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec/1e9;
+}
+
+//----------------------------------------------------------------------------------
+// Program main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) threads = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (argv[i][0] != '-') matchCount = atoi(argv[i]);
+        else matchCount = -1;
+    }
+
+    if (matchCount <= 0)
+    {
+        fprintf(stderr, "usage: %s [matches] [--threads N] [--seed N]\n", argv[0]);
+        return 1;
+    }
+
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    if (threads > matchCount) threads = matchCount;
+
+    Worker *workers = (Worker *)calloc(threads, sizeof(Worker));
+    if (workers == NULL) return 1;
+
+    double start = NowSeconds();
+
+    for (int i = 0; i < threads; i++)
+    {
+        workers[i].stream = (unsigned char *)malloc(MAX_MATCH_TICKS*2);
+        if (workers[i].stream == NULL)
+        {
+            fprintf(stderr, "sim_oracle: out of memory\n");
+            return 1;
+        }
+        pthread_create(&workers[i].thread, NULL, WorkerThread, &workers[i]);
+    }
+
+    VariantStats total[VARIANT_COUNT] = { 0 };
+
+    for (int i = 0; i < threads; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+
+        for (int v = 0; v < VARIANT_COUNT; v++)
+        {
+            const VariantStats *stats = &workers[i].stats[v];
+            VariantStats *sum = &total[v];
+
+            sum->matches += stats->matches;
+            sum->diverged += stats->diverged;
+            sum->divergenceFrames += stats->divergenceFrames;
+            if ((stats->firstDivergence > 0) && ((sum->firstDivergence == 0) || (stats->firstDivergence < sum->firstDivergence))) sum->firstDivergence = stats->firstDivergence;
+            sum->sameScore += stats->sameScore;
+            sum->sameWinner += stats->sameWinner;
+            sum->exact += stats->exact;
+            sum->ballDriftSum += stats->ballDriftSum;
+            sum->blobDriftSum += stats->blobDriftSum;
+            sum->ballDriftMax = fmax(sum->ballDriftMax, stats->ballDriftMax);
+            sum->blobDriftMax = fmax(sum->blobDriftMax, stats->blobDriftMax);
+        }
+
+        free(workers[i].stream);
+    }
+
+    printf("%d scripted matches against the double reference, %d threads, %.1f s\n", matchCount, threads, NowSeconds() - start);
+    printf("%-16s  %-21s  %-21s  %15s  %10s  %9s  %8s  %8s  %6s\n", "variant", "ball drift 10s (px)", "blob drift 10s (px)",
+           "points diverged", "mean frame", "earliest", "score", "winner", "exact");
+
+    for (int v = 0; v < VARIANT_COUNT; v++)
+    {
+        const VariantStats *stats = &total[v];
+        double n = stats->matches;
+
+        printf("%-16s  %9.2e / %9.2e  %9.2e / %9.2e  %14.1f%%  %10.0f  %9d  %7.1f%%  %7.1f%%  %5.1f%%\n", variants[v].name,
+               stats->ballDriftSum/n, stats->ballDriftMax, stats->blobDriftSum/n, stats->blobDriftMax,
+               100.0*stats->diverged/n, (stats->diverged > 0) ? (double)stats->divergenceFrames/stats->diverged : 0.0,
+               stats->firstDivergence, 100.0*stats->sameScore/n, 100.0*stats->sameWinner/n, 100.0*stats->exact/n);
+    }
+    printf("drift: mean / max over matches of the largest error in the first %d frames\n", DRIFT_WINDOW);
+
+    free(workers);
+
+    return 0;
+}
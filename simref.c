@@ -0,0 +1,256 @@
+/*******************************************************************************************
+*
+*   C-volley - double precision reference simulation
+*
+*   Line by line the same as sim.c, see there for the comments on the physics.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "simref.h"
+
+#include <math.h>
+
+//----------------------------------------------------------------------------------
+// Module internal functions
+//----------------------------------------------------------------------------------
+static bool RefCirclesOverlap(RefVector center1, double radius1, RefVector center2, double radius2)
+{
+    double dx = center2.x - center1.x;
+    double dy = center2.y - center1.y;
+    double radiusSum = radius1 + radius2;
+
+    return ((dx*dx + dy*dy) <= (radiusSum*radiusSum));
+}
+
+static bool RefCircleOverlapsRec(RefVector center, double radius, double x, double y, double width, double height)
+{
+    double dx = fabs(center.x - (x + width/2.0));
+    double dy = fabs(center.y - (y + height/2.0));
+
+    if (dx > (width/2.0 + radius)) return false;
+    if (dy > (height/2.0 + radius)) return false;
+    if (dx <= (width/2.0)) return true;
+    if (dy <= (height/2.0)) return true;
+
+    double cornerDistanceSq = (dx - width/2.0)*(dx - width/2.0) + (dy - height/2.0)*(dy - height/2.0);
+    return (cornerDistanceSq <= (radius*radius));
+}
+
+static void RefApplyAction(RefBlob *blob, int side, unsigned char action)
+{
+    if (action & ACTION_LEFT)
+    {
+        blob->position.x -= PLAYER_MOVE_SPEED;
+        blob->velocity.x = -PLAYER_MOVE_SPEED;
+    }
+    else if (action & ACTION_RIGHT)
+    {
+        blob->position.x += PLAYER_MOVE_SPEED;
+        blob->velocity.x = PLAYER_MOVE_SPEED;
+    }
+    else blob->velocity.x = 0;
+
+    if ((action & ACTION_JUMP) && blob->onGround)
+    {
+        blob->velocity.y = PLAYER_JUMP_FORCE;
+        blob->onGround = false;
+    }
+
+    double minX = (side == 0) ? 0 : NET_X + NET_WIDTH/2.0;
+    double maxX = (side == 0) ? NET_X - NET_WIDTH/2.0 : SCREEN_WIDTH;
+
+    if (blob->position.x - PLAYER_RADIUS < minX) blob->position.x = minX + PLAYER_RADIUS;
+    if (blob->position.x + PLAYER_RADIUS > maxX) blob->position.x = maxX - PLAYER_RADIUS;
+}
+
+static void RefStepBlob(RefBlob *blob)
+{
+    blob->position.x += blob->velocity.x;
+    blob->position.y += blob->velocity.y;
+    blob->velocity.y += PLAYER_GRAVITY;
+
+    if (blob->velocity.y > PLAYER_MAX_VELOCITY_Y) blob->velocity.y = PLAYER_MAX_VELOCITY_Y;
+
+    if (blob->position.y + PLAYER_RADIUS >= GROUND_LEVEL)
+    {
+        blob->position.y = GROUND_LEVEL - PLAYER_RADIUS;
+        blob->velocity.y = 0;
+        blob->onGround = true;
+    }
+    else blob->onGround = false;
+}
+
+static unsigned int RefMoveBall(RefBall *ball)
+{
+    unsigned int events = 0;
+
+    ball->position.x += ball->velocity.x;
+    ball->position.y += ball->velocity.y;
+    ball->velocity.y += BALL_GRAVITY;
+
+    if (ball->position.x - BALL_RADIUS <= 0)
+    {
+        ball->position.x = BALL_RADIUS;
+        ball->velocity.x *= -BALL_BOUNCE_DAMPING;
+        events |= SIM_EVENT_WALL;
+    }
+    if (ball->position.x + BALL_RADIUS >= SCREEN_WIDTH)
+    {
+        ball->position.x = SCREEN_WIDTH - BALL_RADIUS;
+        ball->velocity.x *= -BALL_BOUNCE_DAMPING;
+        events |= SIM_EVENT_WALL;
+    }
+
+    if (ball->position.y - BALL_RADIUS <= 0)
+    {
+        ball->position.y = BALL_RADIUS;
+        ball->velocity.y *= -BALL_BOUNCE_DAMPING;
+        events |= SIM_EVENT_CEILING;
+    }
+
+    return events;
+}
+
+static unsigned int RefBounceBallOffNet(RefBall *ball)
+{
+    double netX = NET_X - NET_WIDTH/2.0;
+    double netY = GROUND_LEVEL - NET_HEIGHT;
+
+    if (!RefCircleOverlapsRec(ball->position, BALL_RADIUS, netX, netY, NET_WIDTH, NET_HEIGHT)) return 0;
+
+    ball->velocity.x *= -BALL_BOUNCE_DAMPING;
+    ball->velocity.y *= 0.9f;
+
+    if (ball->position.x < NET_X) ball->position.x = netX - BALL_RADIUS;
+    else ball->position.x = netX + NET_WIDTH + BALL_RADIUS;
+
+    return SIM_EVENT_NET;
+}
+
+static bool RefBounceBallOffBlob(RefBall *ball, const RefBlob *blob)
+{
+    if (!RefCirclesOverlap(ball->position, BALL_RADIUS, blob->position, PLAYER_RADIUS)) return false;
+
+    RefVector normal = { ball->position.x - blob->position.x, ball->position.y - blob->position.y };
+
+    double length = sqrt(normal.x*normal.x + normal.y*normal.y);
+    if (length > 0)
+    {
+        normal.x /= length;
+        normal.y /= length;
+    }
+
+    double dotProduct = ball->velocity.x*normal.x + ball->velocity.y*normal.y;
+    ball->velocity.x = ball->velocity.x - 2*dotProduct*normal.x;
+    ball->velocity.y = ball->velocity.y - 2*dotProduct*normal.y;
+
+    ball->velocity.x *= 0.95f;
+    ball->velocity.y *= 0.95f;
+
+    ball->velocity.x += blob->velocity.x*0.7f;
+    ball->velocity.y += blob->velocity.y*0.5f;
+
+    if (blob->velocity.y < -5.0) ball->velocity.y -= 3.0;
+
+    double speed = sqrt(ball->velocity.x*ball->velocity.x + ball->velocity.y*ball->velocity.y);
+    if (speed > BALL_MAX_SPEED)
+    {
+        ball->velocity.x = (ball->velocity.x/speed)*BALL_MAX_SPEED;
+        ball->velocity.y = (ball->velocity.y/speed)*BALL_MAX_SPEED;
+    }
+
+    ball->position.x = blob->position.x + normal.x*(PLAYER_RADIUS + BALL_RADIUS);
+    ball->position.y = blob->position.y + normal.y*(PLAYER_RADIUS + BALL_RADIUS);
+
+    return true;
+}
+
+static unsigned int RefBounceBallOffGround(RefBall *ball)
+{
+    if (ball->position.y + BALL_RADIUS < GROUND_LEVEL) return 0;
+
+    ball->position.y = GROUND_LEVEL - BALL_RADIUS;
+    ball->velocity.y *= -BALL_BOUNCE_DAMPING;
+
+    return SIM_EVENT_GROUND;
+}
+
+static void RefResetBall(RefState *ref)
+{
+    ref->ball.position = (RefVector){ (ref->servingSide == 0) ? SCREEN_WIDTH/4 : SCREEN_WIDTH*3/4, 100 };
+    ref->ball.velocity = (RefVector){ 0, 0 };
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+void RefFromSim(RefState *ref, const SimState *sim)
+{
+    for (int side = 0; side < 2; side++)
+    {
+        const SimBlob *blob = &sim->blobs[side];
+        ref->blobs[side] = (RefBlob){ { blob->position.x, blob->position.y }, { blob->velocity.x, blob->velocity.y }, blob->score, blob->onGround };
+    }
+
+    ref->ball.position = (RefVector){ sim->ball.position.x, sim->ball.position.y };
+    ref->ball.velocity = (RefVector){ sim->ball.velocity.x, sim->ball.velocity.y };
+    ref->tick = sim->tick;
+    ref->servingSide = sim->servingSide;
+    ref->scoreDelay = sim->scoreDelay;
+    ref->gameOver = sim->gameOver;
+}
+
+unsigned int RefStep(RefState *ref, const unsigned char actions[2])
+{
+    if (ref->gameOver) return 0;
+
+    unsigned int events = 0;
+
+    ref->tick++;
+
+    RefApplyAction(&ref->blobs[0], 0, actions[0]);
+    RefApplyAction(&ref->blobs[1], 1, actions[1]);
+
+    RefStepBlob(&ref->blobs[0]);
+    RefStepBlob(&ref->blobs[1]);
+
+    if (ref->scoreDelay > 0)
+    {
+        ref->scoreDelay--;
+        if (ref->scoreDelay == 0)
+        {
+            RefResetBall(ref);
+            events |= SIM_EVENT_RESET;
+        }
+    }
+
+    events |= RefMoveBall(&ref->ball);
+    events |= RefBounceBallOffNet(&ref->ball);
+
+    if (ref->scoreDelay == 0)
+    {
+        if (RefBounceBallOffBlob(&ref->ball, &ref->blobs[0])) events |= SIM_EVENT_BLOB_LEFT;
+        if (RefBounceBallOffBlob(&ref->ball, &ref->blobs[1])) events |= SIM_EVENT_BLOB_RIGHT;
+    }
+
+    unsigned int ground = RefBounceBallOffGround(&ref->ball);
+    events |= ground;
+
+    if (ground && (ref->scoreDelay == 0))
+    {
+        int scorer = (ref->ball.position.x < NET_X) ? 1 : 0;
+        ref->blobs[scorer].score++;
+        ref->servingSide = scorer;
+        events |= SIM_EVENT_SCORE;
+
+        if ((ref->blobs[0].score >= WIN_SCORE) || (ref->blobs[1].score >= WIN_SCORE))
+        {
+            ref->gameOver = true;
+            events |= SIM_EVENT_GAMEOVER;
+        }
+        else ref->scoreDelay = SCORE_DELAY_FRAMES;
+    }
+
+    return events;
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************************
+*
+*   C-volley - double precision reference simulation
+*
+*   The rules and physics of SimStep() in double precision, for measuring how far the float
+*   simulation and its fast paths (SimSkipDeadTime(), ...) drift from the
+*   model. Same constants (the float values from sim.h), same order of operations, only the
+*   arithmetic is wider. Blobs take explicit actions only, ACTION_AI is not modelled: the AI
+*   is driven by the state it sees, so it would not replay the same input stream.
+*
+*   Slow on purpose, never used by the game.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef SIMREF_H
+#define SIMREF_H
+
+#include "sim.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct RefVector {
+    double x;
+    double y;
+} RefVector;
+
+typedef struct RefBlob {
+    RefVector position;
+    RefVector velocity;
+    int score;
+    bool onGround;
+} RefBlob;
+
+typedef struct RefBall {
+    RefVector position;
+    RefVector velocity;
+} RefBall;
+
+typedef struct RefState {
+    RefBlob blobs[2];
+    RefBall ball;
+    int tick;
+    int servingSide;
+    int scoreDelay;
+    bool gameOver;
+} RefState;
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+void RefFromSim(RefState *ref, const SimState *sim);                    // Widens a float state
+unsigned int RefStep(RefState *ref, const unsigned char actions[2]);    // One frame, SIM_EVENT_* bits
+
+#endif // SIMREF_H
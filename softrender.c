@@ -0,0 +1,756 @@
+/*******************************************************************************************
+*
+*   C-volley - multithreaded tile-based software rasterizer
+*
+*   Frame flow:
+*     SoftBeginFrame()  resets the command list
+*     SoftDraw*()       append one command each, bounds clipped to the framebuffer
+*     SoftEndFrame()    bins commands into 64x64 tiles, then the caller and the worker threads
+*                       pull tiles from a shared counter; each tile is cleared and rasterized
+*                       start to finish by one thread, so no locking on pixels is needed
+*
+*   Coverage is point sampled at pixel centers, textures are point filtered (same as the atlas
+*   on the GPU path) and blending matches rlgl's BLEND_ALPHA on every channel.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "softrender.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------
+#define SOFT_TILE_SIZE 64
+#define SOFT_MAX_THREADS 32
+
+typedef enum {
+    SOFT_RECTANGLE = 0,
+    SOFT_ELLIPSE,
+    SOFT_CIRCLE_GRADIENT,
+    SOFT_RING,
+    SOFT_QUAD,
+    SOFT_TEXTURE
+} SoftCommandType;
+
+typedef struct SoftCommand {
+    SoftCommandType type;
+    int minX, minY, maxX, maxY;     // Pixel bounds, max exclusive, clipped to the framebuffer
+    Color color;
+    Color color2;                   // Right/outer color of gradients
+    float x, y;                     // Rectangle/quad origin, ellipse center
+    float width, height;            // Rectangle size, ellipse radii, ring inner/outer radius
+    float dsdx, dsdy, dtdx, dtdy;   // Quad: screen offset from origin to edge parameters s,t
+    float u0, v0, du, dv;           // Quad: texel rectangle
+    const SoftTexture *texture;     // NULL for solid quads
+} SoftCommand;
+
+//----------------------------------------------------------------------------------
+// Module state
+//----------------------------------------------------------------------------------
+static Color *frame = NULL;
+static int frameWidth = 0;
+static int frameHeight = 0;
+static Color clearColor = { 0 };
+
+static int tilesX = 0;
+static int tilesY = 0;
+
+static SoftCommand *commands = NULL;
+static int commandCount = 0;
+static int commandCapacity = 0;
+
+static int *binStart = NULL;        // tilesX*tilesY + 1 offsets into binCommands
+static int *binCommands = NULL;
+static int binCapacity = 0;
+
+static pthread_t workers[SOFT_MAX_THREADS];
+static int workerCount = 0;
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolStart = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t poolDone = PTHREAD_COND_INITIALIZER;
+static unsigned int poolGeneration = 0;
+static int poolBusy = 0;
+static bool poolQuit = false;
+static int nextTile = 0;            // Shared tile counter, atomic
+
+//----------------------------------------------------------------------------------
+// Pixel operations
+//----------------------------------------------------------------------------------
+
+// Exact round(x/255) for x <= 255*255
+static inline unsigned char Div255(unsigned int x)
+{
+    x += 128;
+    return (unsigned char)((x + (x >> 8)) >> 8);
+}
+
+static inline Color Modulate(Color texel, Color tint)
+{
+    return (Color){ Div255(texel.r*tint.r), Div255(texel.g*tint.g), Div255(texel.b*tint.b), Div255(texel.a*tint.a) };
+}
+
+// BLEND_ALPHA: src*a + dst*(1 - a), alpha channel included
+static inline void BlendPixel(Color *dst, Color src)
+{
+    if (src.a == 255) { *dst = src; return; }
+    if (src.a == 0) return;
+
+    unsigned int a = src.a;
+    unsigned int ia = 255 - a;
+    dst->r = Div255(src.r*a + dst->r*ia);
+    dst->g = Div255(src.g*a + dst->g*ia);
+    dst->b = Div255(src.b*a + dst->b*ia);
+    dst->a = Div255(src.a*a + dst->a*ia);
+}
+
+static inline Color LerpColor(Color a, Color b, float t)
+{
+    return (Color){
+        (unsigned char)(a.r + (b.r - a.r)*t + 0.5f),
+        (unsigned char)(a.g + (b.g - a.g)*t + 0.5f),
+        (unsigned char)(a.b + (b.b - a.b)*t + 0.5f),
+        (unsigned char)(a.a + (b.a - a.a)*t + 0.5f)
+    };
+}
+
+#if defined(__SSE2__)
+// Per 16-bit lane round(x/255), lanes hold at most 255*255
+static inline __m128i Div255x8(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+// Overwrite a run of pixels, also used to clear tiles
+static void FillSpan(Color *dst, int count, Color color)
+{
+#if defined(__SSE2__)
+    uint32_t packed;
+    memcpy(&packed, &color, sizeof(packed));
+    __m128i fill = _mm_set1_epi32((int)packed);
+
+    for (; count >= 4; count -= 4, dst += 4) _mm_storeu_si128((__m128i *)dst, fill);
+#endif
+
+    for (; count > 0; count--, dst++) *dst = color;
+}
+
+// Blend one color over a run of pixels, 4 pixels per iteration with SSE2
+static void BlendSpanSolid(Color *dst, int count, Color color)
+{
+    if ((count <= 0) || (color.a == 0)) return;
+
+    if (color.a == 255)
+    {
+        FillSpan(dst, count, color);
+        return;
+    }
+
+#if defined(__SSE2__)
+    unsigned short a = color.a;
+    __m128i zero = _mm_setzero_si128();
+    __m128i src = _mm_set_epi16(color.a*a, color.b*a, color.g*a, color.r*a, color.a*a, color.b*a, color.g*a, color.r*a);
+    __m128i inverseAlpha = _mm_set1_epi16(255 - a);
+
+    for (; count >= 4; count -= 4, dst += 4)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i *)dst);
+        __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+        __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+
+        lo = Div255x8(_mm_add_epi16(_mm_mullo_epi16(lo, inverseAlpha), src));
+        hi = Div255x8(_mm_add_epi16(_mm_mullo_epi16(hi, inverseAlpha), src));
+
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; count > 0; count--, dst++) BlendPixel(dst, color);
+}
+
+#if defined(__SSE2__)
+// Modulate two pixels (16-bit lanes) by the tint and blend them over the destination
+static inline __m128i BlendTexels2(__m128i texels, __m128i pixels, __m128i tint)
+{
+    texels = Div255x8(_mm_mullo_epi16(texels, tint));
+
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(texels, 0xFF), 0xFF);
+    __m128i inverseAlpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+    return Div255x8(_mm_add_epi16(_mm_mullo_epi16(texels, alpha), _mm_mullo_epi16(pixels, inverseAlpha)));
+}
+#endif
+
+// Tinted texel row over a run of pixels, per pixel alpha
+static void BlendSpanTexels(Color *dst, const Color *src, int count, Color tint)
+{
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i tint16 = _mm_set_epi16(tint.a, tint.b, tint.g, tint.r, tint.a, tint.b, tint.g, tint.r);
+
+    for (; count >= 4; count -= 4, dst += 4, src += 4)
+    {
+        __m128i texels = _mm_loadu_si128((const __m128i *)src);
+        __m128i pixels = _mm_loadu_si128((const __m128i *)dst);
+
+        __m128i lo = BlendTexels2(_mm_unpacklo_epi8(texels, zero), _mm_unpacklo_epi8(pixels, zero), tint16);
+        __m128i hi = BlendTexels2(_mm_unpackhi_epi8(texels, zero), _mm_unpackhi_epi8(pixels, zero), tint16);
+
+        _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; count > 0; count--, dst++, src++) BlendPixel(dst, Modulate(*src, tint));
+}
+
+//----------------------------------------------------------------------------------
+// Per tile rasterization, (x0, y0)-(x1, y1) is the tile clipped to the command bounds
+//----------------------------------------------------------------------------------
+
+static void RasterRectangle(const SoftCommand *cmd, int x0, int y0, int x1, int y1)
+{
+    bool solid = (memcmp(&cmd->color, &cmd->color2, sizeof(Color)) == 0);
+
+    for (int y = y0; y < y1; y++)
+    {
+        Color *row = &frame[y*frameWidth];
+
+        if (solid) BlendSpanSolid(&row[x0], x1 - x0, cmd->color);
+        else
+        {
+            for (int x = x0; x < x1; x++)
+            {
+                float t = (x + 0.5f - cmd->x)/cmd->width;
+                BlendPixel(&row[x], LerpColor(cmd->color, cmd->color2, t));
+            }
+        }
+    }
+}
+
+// Pixel range [*start, *end) whose centers fall inside the ellipse on row y, false if none
+static inline bool EllipseSpan(float cx, float cy, float rx, float ry, int y, int *start, int *end)
+{
+    if ((rx <= 0.0f) || (ry <= 0.0f)) return false;
+
+    float dy = (y + 0.5f - cy)/ry;
+    if (dy*dy >= 1.0f) return false;
+
+    float half = rx*sqrtf(1.0f - dy*dy);
+    *start = (int)ceilf(cx - half - 0.5f);
+    *end = (int)floorf(cx + half - 0.5f) + 1;
+
+    return (*end > *start);
+}
+
+static void RasterEllipse(const SoftCommand *cmd, int x0, int y0, int x1, int y1)
+{
+    for (int y = y0; y < y1; y++)
+    {
+        int start, end;
+        if (!EllipseSpan(cmd->x, cmd->y, cmd->width, cmd->height, y, &start, &end)) continue;
+
+        if (start < x0) start = x0;
+        if (end > x1) end = x1;
+        BlendSpanSolid(&frame[y*frameWidth + start], end - start, cmd->color);
+    }
+}
+
+static void RasterCircleGradient(const SoftCommand *cmd, int x0, int y0, int x1, int y1)
+{
+    float radius = cmd->width;
+
+    for (int y = y0; y < y1; y++)
+    {
+        int start, end;
+        if (!EllipseSpan(cmd->x, cmd->y, radius, radius, y, &start, &end)) continue;
+
+        if (start < x0) start = x0;
+        if (end > x1) end = x1;
+
+        float dy = y + 0.5f - cmd->y;
+        Color *row = &frame[y*frameWidth];
+
+        for (int x = start; x < end; x++)
+        {
+            float dx = x + 0.5f - cmd->x;
+            float t = sqrtf(dx*dx + dy*dy)/radius;
+            if (t > 1.0f) t = 1.0f;
+
+            BlendPixel(&row[x], LerpColor(cmd->color, cmd->color2, t));
+        }
+    }
+}
+
+// Outer disc span minus inner disc span, up to two runs per row
+static void RasterRing(const SoftCommand *cmd, int x0, int y0, int x1, int y1)
+{
+    float inner = cmd->width;
+    float outer = cmd->height;
+
+    for (int y = y0; y < y1; y++)
+    {
+        int start, end;
+        if (!EllipseSpan(cmd->x, cmd->y, outer, outer, y, &start, &end)) continue;
+
+        int holeStart, holeEnd;
+        if (!EllipseSpan(cmd->x, cmd->y, inner, inner, y, &holeStart, &holeEnd)) holeStart = holeEnd = end;
+
+        Color *row = &frame[y*frameWidth];
+        int runs[2][2] = { { start, holeStart }, { holeEnd, end } };
+
+        for (int i = 0; i < 2; i++)
+        {
+            int runStart = (runs[i][0] < x0) ? x0 : runs[i][0];
+            int runEnd = (runs[i][1] > x1) ? x1 : runs[i][1];
+            BlendSpanSolid(&row[runStart], runEnd - runStart, cmd->color);
+        }
+    }
+}
+
+// Clip [*lo, *hi) on x to where 0 <= base + x*slope < 1
+static inline void ClipParameter(float base, float slope, float *lo, float *hi)
+{
+    if (slope == 0.0f)
+    {
+        if ((base < 0.0f) || (base >= 1.0f)) *hi = *lo;
+        return;
+    }
+
+    float a = -base/slope;
+    float b = (1.0f - base)/slope;
+    if (a > b) { float tmp = a; a = b; b = tmp; }
+
+    if (a > *lo) *lo = a;
+    if (b < *hi) *hi = b;
+}
+
+// Parallelogram: p = origin + s*edgeS + t*edgeT, inside for s,t in [0, 1)
+static void RasterQuad(const SoftCommand *cmd, int x0, int y0, int x1, int y1)
+{
+    const SoftTexture *texture = cmd->texture;
+
+    for (int y = y0; y < y1; y++)
+    {
+        float py = y + 0.5f - cmd->y;
+        float sRow = (0.5f - cmd->x)*cmd->dsdx + py*cmd->dsdy;     // s at x = 0
+        float tRow = (0.5f - cmd->x)*cmd->dtdx + py*cmd->dtdy;
+
+        float lo = (float)x0;
+        float hi = (float)x1;
+        ClipParameter(sRow, cmd->dsdx, &lo, &hi);
+        ClipParameter(tRow, cmd->dtdx, &lo, &hi);
+
+        int start = (int)ceilf(lo);
+        int end = (int)ceilf(hi);
+        if (start < x0) start = x0;
+        if (end > x1) end = x1;
+        if (end <= start) continue;
+
+        Color *row = &frame[y*frameWidth];
+
+        if (texture == NULL)
+        {
+            BlendSpanSolid(&row[start], end - start, cmd->color);
+            continue;
+        }
+
+        for (int x = start; x < end; x++)
+        {
+            float s = sRow + x*cmd->dsdx;
+            float t = tRow + x*cmd->dtdx;
+            int u = (int)(cmd->u0 + s*cmd->du);
+            int v = (int)(cmd->v0 + t*cmd->dv);
+
+            if (u < 0) u = 0; else if (u >= texture->width) u = texture->width - 1;
+            if (v < 0) v = 0; else if (v >= texture->height) v = texture->height - 1;
+
+            BlendPixel(&row[x], Modulate(texture->pixels[v*texture->width + u], cmd->color));
+        }
+    }
+}
+
+static void RasterTexture(const SoftCommand *cmd, int x0, int y0, int x1, int y1)
+{
+    const SoftTexture *texture = cmd->texture;
+    int posX = (int)cmd->x;
+    int posY = (int)cmd->y;
+
+    for (int y = y0; y < y1; y++)
+    {
+        const Color *src = &texture->pixels[(y - posY)*texture->width + (x0 - posX)];
+        BlendSpanTexels(&frame[y*frameWidth + x0], src, x1 - x0, cmd->color);
+    }
+}
+
+static void RasterTile(int tile)
+{
+    int tileX = (tile%tilesX)*SOFT_TILE_SIZE;
+    int tileY = (tile/tilesX)*SOFT_TILE_SIZE;
+    int tileEndX = (tileX + SOFT_TILE_SIZE < frameWidth) ? tileX + SOFT_TILE_SIZE : frameWidth;
+    int tileEndY = (tileY + SOFT_TILE_SIZE < frameHeight) ? tileY + SOFT_TILE_SIZE : frameHeight;
+
+    for (int y = tileY; y < tileEndY; y++) FillSpan(&frame[y*frameWidth + tileX], tileEndX - tileX, clearColor);
+
+    for (int i = binStart[tile]; i < binStart[tile + 1]; i++)
+    {
+        const SoftCommand *cmd = &commands[binCommands[i]];
+
+        int x0 = (cmd->minX > tileX) ? cmd->minX : tileX;
+        int y0 = (cmd->minY > tileY) ? cmd->minY : tileY;
+        int x1 = (cmd->maxX < tileEndX) ? cmd->maxX : tileEndX;
+        int y1 = (cmd->maxY < tileEndY) ? cmd->maxY : tileEndY;
+
+        switch (cmd->type)
+        {
+            case SOFT_RECTANGLE: RasterRectangle(cmd, x0, y0, x1, y1); break;
+            case SOFT_ELLIPSE: RasterEllipse(cmd, x0, y0, x1, y1); break;
+            case SOFT_CIRCLE_GRADIENT: RasterCircleGradient(cmd, x0, y0, x1, y1); break;
+            case SOFT_RING: RasterRing(cmd, x0, y0, x1, y1); break;
+            case SOFT_QUAD: RasterQuad(cmd, x0, y0, x1, y1); break;
+            case SOFT_TEXTURE: RasterTexture(cmd, x0, y0, x1, y1); break;
+        }
+    }
+}
+
+static void RasterTiles(void)
+{
+    int tileCount = tilesX*tilesY;
+
+    for (;;)
+    {
+        int tile = __atomic_fetch_add(&nextTile, 1, __ATOMIC_RELAXED);
+        if (tile >= tileCount) break;
+
+        RasterTile(tile);
+    }
+}
+
+static void *WorkerMain(void *arg)
+{
+    unsigned int seenGeneration = (unsigned int)(uintptr_t)arg;     // Generation at creation time
+
+    for (;;)
+    {
+        pthread_mutex_lock(&poolLock);
+        while ((poolGeneration == seenGeneration) && !poolQuit) pthread_cond_wait(&poolStart, &poolLock);
+        seenGeneration = poolGeneration;
+        bool quit = poolQuit;
+        pthread_mutex_unlock(&poolLock);
+
+        if (quit) break;
+
+        RasterTiles();
+
+        pthread_mutex_lock(&poolLock);
+        if (--poolBusy == 0) pthread_cond_signal(&poolDone);
+        pthread_mutex_unlock(&poolLock);
+    }
+
+    return NULL;
+}
+
+// Sort command indices into per tile lists, counting pass then fill pass
+static bool BinCommands(void)
+{
+    int tileCount = tilesX*tilesY;
+    int total = 0;
+
+    memset(binStart, 0, (tileCount + 1)*sizeof(int));
+
+    for (int i = 0; i < commandCount; i++)
+    {
+        const SoftCommand *cmd = &commands[i];
+        for (int ty = cmd->minY/SOFT_TILE_SIZE; ty <= (cmd->maxY - 1)/SOFT_TILE_SIZE; ty++)
+        {
+            for (int tx = cmd->minX/SOFT_TILE_SIZE; tx <= (cmd->maxX - 1)/SOFT_TILE_SIZE; tx++) binStart[ty*tilesX + tx + 1]++;
+        }
+    }
+
+    for (int tile = 0; tile < tileCount; tile++)
+    {
+        total += binStart[tile + 1];
+        binStart[tile + 1] = total;
+    }
+
+    if (total > binCapacity)
+    {
+        int *resized = (int *)realloc(binCommands, total*sizeof(int));
+        if (resized == NULL) return false;
+
+        binCommands = resized;
+        binCapacity = total;
+    }
+
+    // binStart[tile] doubles as the fill cursor, shifted back afterwards
+    for (int i = 0; i < commandCount; i++)
+    {
+        const SoftCommand *cmd = &commands[i];
+        for (int ty = cmd->minY/SOFT_TILE_SIZE; ty <= (cmd->maxY - 1)/SOFT_TILE_SIZE; ty++)
+        {
+            for (int tx = cmd->minX/SOFT_TILE_SIZE; tx <= (cmd->maxX - 1)/SOFT_TILE_SIZE; tx++) binCommands[binStart[ty*tilesX + tx]++] = i;
+        }
+    }
+
+    for (int tile = tileCount; tile > 0; tile--) binStart[tile] = binStart[tile - 1];
+    binStart[0] = 0;
+
+    return true;
+}
+
+// Reserve a command with the given float bounds, NULL when fully clipped
+static SoftCommand *PushCommand(SoftCommandType type, float minX, float minY, float maxX, float maxY)
+{
+    if ((frame == NULL) || !(maxX > 0.0f) || !(maxY > 0.0f) || !(minX < frameWidth) || !(minY < frameHeight)) return NULL;
+
+    SoftCommand cmd = { 0 };
+    cmd.type = type;
+    cmd.minX = (minX > 0.0f) ? (int)floorf(minX) : 0;
+    cmd.minY = (minY > 0.0f) ? (int)floorf(minY) : 0;
+    cmd.maxX = (maxX < frameWidth) ? (int)ceilf(maxX) : frameWidth;
+    cmd.maxY = (maxY < frameHeight) ? (int)ceilf(maxY) : frameHeight;
+    if ((cmd.maxX <= cmd.minX) || (cmd.maxY <= cmd.minY)) return NULL;
+
+    if (commandCount == commandCapacity)
+    {
+        int capacity = (commandCapacity > 0) ? commandCapacity*2 : 256;
+        SoftCommand *resized = (SoftCommand *)realloc(commands, capacity*sizeof(SoftCommand));
+        if (resized == NULL) return NULL;
+
+        commands = resized;
+        commandCapacity = capacity;
+    }
+
+    commands[commandCount] = cmd;
+    return &commands[commandCount++];
+}
+
+//----------------------------------------------------------------------------------
+// Module functions definition
+//----------------------------------------------------------------------------------
+
+bool InitSoftRenderer(int width, int height, int threads)
+{
+    CloseSoftRenderer();
+
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads < 1) threads = 1;
+    if (threads > SOFT_MAX_THREADS + 1) threads = SOFT_MAX_THREADS + 1;
+
+    tilesX = (width + SOFT_TILE_SIZE - 1)/SOFT_TILE_SIZE;
+    tilesY = (height + SOFT_TILE_SIZE - 1)/SOFT_TILE_SIZE;
+
+    if (posix_memalign((void **)&frame, 64, (size_t)width*height*sizeof(Color)) != 0) frame = NULL;
+    binStart = (int *)calloc(tilesX*tilesY + 1, sizeof(int));
+
+    if ((frame == NULL) || (binStart == NULL))
+    {
+        TraceLog(LOG_WARNING, "SOFTRENDER: Could not allocate %ix%i framebuffer", width, height);
+        CloseSoftRenderer();
+        return false;
+    }
+
+    frameWidth = width;
+    frameHeight = height;
+    memset(frame, 0, (size_t)width*height*sizeof(Color));
+
+    // The calling thread rasterizes too, so one thread less in the pool
+    poolQuit = false;
+    for (workerCount = 0; workerCount < threads - 1; workerCount++)
+    {
+        if (pthread_create(&workers[workerCount], NULL, WorkerMain, (void *)(uintptr_t)poolGeneration) != 0) break;
+    }
+
+    TraceLog(LOG_INFO, "SOFTRENDER: %ix%i framebuffer, %i tiles, %i threads", width, height, tilesX*tilesY, workerCount + 1);
+
+    return true;
+}
+
+void CloseSoftRenderer(void)
+{
+    pthread_mutex_lock(&poolLock);
+    poolQuit = true;
+    pthread_cond_broadcast(&poolStart);
+    pthread_mutex_unlock(&poolLock);
+
+    for (int i = 0; i < workerCount; i++) pthread_join(workers[i], NULL);
+    workerCount = 0;
+
+    free(frame);
+    free(commands);
+    free(binStart);
+    free(binCommands);
+
+    frame = NULL;
+    commands = NULL;
+    binStart = NULL;
+    binCommands = NULL;
+    commandCount = commandCapacity = binCapacity = 0;
+    frameWidth = frameHeight = 0;
+}
+
+bool IsSoftRendererReady(void)
+{
+    return (frame != NULL);
+}
+
+void SoftBeginFrame(Color clear)
+{
+    clearColor = clear;
+    commandCount = 0;
+}
+
+void SoftEndFrame(void)
+{
+    if ((frame == NULL) || !BinCommands()) return;
+
+    __atomic_store_n(&nextTile, 0, __ATOMIC_RELAXED);
+
+    if (workerCount > 0)
+    {
+        pthread_mutex_lock(&poolLock);
+        poolBusy = workerCount;
+        poolGeneration++;
+        pthread_cond_broadcast(&poolStart);
+        pthread_mutex_unlock(&poolLock);
+    }
+
+    RasterTiles();
+
+    if (workerCount > 0)
+    {
+        pthread_mutex_lock(&poolLock);
+        while (poolBusy > 0) pthread_cond_wait(&poolDone, &poolLock);
+        pthread_mutex_unlock(&poolLock);
+    }
+}
+
+const Color *SoftGetPixels(void)
+{
+    return frame;
+}
+
+// Binary PPM, alpha dropped
+bool SoftExportPPM(const char *fileName)
+{
+    if (frame == NULL) return false;
+
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", frameWidth, frameHeight);
+    for (int i = 0; i < frameWidth*frameHeight; i++)
+    {
+        unsigned char rgb[3] = { frame[i].r, frame[i].g, frame[i].b };
+        fwrite(rgb, 1, 3, file);
+    }
+
+    return (fclose(file) == 0);
+}
+
+void SoftDrawRectangleGradientH(float x, float y, float width, float height, Color left, Color right)
+{
+    // Pixel centers inside [x, x + width) x [y, y + height)
+    SoftCommand *cmd = PushCommand(SOFT_RECTANGLE, ceilf(x - 0.5f), ceilf(y - 0.5f), ceilf(x + width - 0.5f), ceilf(y + height - 0.5f));
+    if (cmd == NULL) return;
+
+    cmd->color = left;
+    cmd->color2 = right;
+    cmd->x = x;
+    cmd->width = width;
+}
+
+void SoftDrawEllipse(Vector2 center, float radiusH, float radiusV, Color color)
+{
+    SoftCommand *cmd = PushCommand(SOFT_ELLIPSE, center.x - radiusH, center.y - radiusV, center.x + radiusH, center.y + radiusV);
+    if (cmd == NULL) return;
+
+    cmd->color = color;
+    cmd->x = center.x;
+    cmd->y = center.y;
+    cmd->width = radiusH;
+    cmd->height = radiusV;
+}
+
+void SoftDrawCircleGradient(Vector2 center, float radius, Color inner, Color outer)
+{
+    SoftCommand *cmd = PushCommand(SOFT_CIRCLE_GRADIENT, center.x - radius, center.y - radius, center.x + radius, center.y + radius);
+    if (cmd == NULL) return;
+
+    cmd->color = inner;
+    cmd->color2 = outer;
+    cmd->x = center.x;
+    cmd->y = center.y;
+    cmd->width = radius;
+}
+
+void SoftDrawRing(Vector2 center, float innerRadius, float outerRadius, Color color)
+{
+    SoftCommand *cmd = PushCommand(SOFT_RING, center.x - outerRadius, center.y - outerRadius, center.x + outerRadius, center.y + outerRadius);
+    if (cmd == NULL) return;
+
+    cmd->color = color;
+    cmd->x = center.x;
+    cmd->y = center.y;
+    cmd->width = innerRadius;
+    cmd->height = outerRadius;
+}
+
+void SoftDrawQuad(const SoftTexture *texture, Vector2 topLeft, Vector2 bottomLeft, Vector2 topRight, Rectangle uv, Color tint)
+{
+    float sx = topRight.x - topLeft.x;
+    float sy = topRight.y - topLeft.y;
+    float tx = bottomLeft.x - topLeft.x;
+    float ty = bottomLeft.y - topLeft.y;
+    float det = sx*ty - sy*tx;
+    if (fabsf(det) < 1e-6f) return;
+
+    float bottomRightX = bottomLeft.x + sx;
+    float bottomRightY = bottomLeft.y + sy;
+    float minX = fminf(fminf(topLeft.x, topRight.x), fminf(bottomLeft.x, bottomRightX));
+    float minY = fminf(fminf(topLeft.y, topRight.y), fminf(bottomLeft.y, bottomRightY));
+    float maxX = fmaxf(fmaxf(topLeft.x, topRight.x), fmaxf(bottomLeft.x, bottomRightX));
+    float maxY = fmaxf(fmaxf(topLeft.y, topRight.y), fmaxf(bottomLeft.y, bottomRightY));
+
+    SoftCommand *cmd = PushCommand(SOFT_QUAD, minX, minY, maxX, maxY);
+    if (cmd == NULL) return;
+
+    // Inverse of [edgeS edgeT]
+    cmd->color = tint;
+    cmd->x = topLeft.x;
+    cmd->y = topLeft.y;
+    cmd->dsdx = ty/det;
+    cmd->dsdy = -tx/det;
+    cmd->dtdx = -sy/det;
+    cmd->dtdy = sx/det;
+    cmd->texture = ((texture != NULL) && (texture->pixels != NULL)) ? texture : NULL;
+    cmd->u0 = uv.x;
+    cmd->v0 = uv.y;
+    cmd->du = uv.width;
+    cmd->dv = uv.height;
+}
+
+void SoftDrawTexture(const SoftTexture *texture, int posX, int posY, Color tint)
+{
+    if ((texture == NULL) || (texture->pixels == NULL)) return;
+
+    SoftCommand *cmd = PushCommand(SOFT_TEXTURE, (float)posX, (float)posY, (float)(posX + texture->width), (float)(posY + texture->height));
+    if (cmd == NULL) return;
+
+    cmd->color = tint;
+    cmd->x = (float)posX;
+    cmd->y = (float)posY;
+    cmd->texture = texture;
+}
@@ -0,0 +1,46 @@
+/*******************************************************************************************
+*
+*   C-volley - multithreaded tile-based software rasterizer
+*
+*   CPU backend for the primitives the game draws (see atlas.h): rectangles with horizontal
+*   gradients, filled/gradient circles and ellipses, one pixel rings, textured parallelogram
+*   quads (sprites, glyphs, thick lines) and texture blits. Draw calls only record commands;
+*   SoftEndFrame() splits the framebuffer into 64x64 tiles and rasterizes them on a pool of
+*   worker threads, every tile replaying the commands that touch it in submission order.
+*   Solid spans are blended with SSE2 when available.
+*
+*   No dependency on a window or GL context: the framebuffer is plain memory in raylib's
+*   RGBA8 Color layout, usable for headless replay rendering and screenshot tests.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#ifndef SOFTRENDER_H
+#define SOFTRENDER_H
+
+#include "raylib.h"
+
+typedef struct SoftTexture {
+    const Color *pixels;        // Not owned
+    int width;
+    int height;
+} SoftTexture;
+
+bool InitSoftRenderer(int width, int height, int threads);     // threads <= 0: one per core
+void CloseSoftRenderer(void);
+bool IsSoftRendererReady(void);
+
+void SoftBeginFrame(Color clear);
+void SoftEndFrame(void);                                        // Rasterizes everything recorded
+const Color *SoftGetPixels(void);
+bool SoftExportPPM(const char *fileName);
+
+void SoftDrawRectangleGradientH(float x, float y, float width, float height, Color left, Color right);
+void SoftDrawEllipse(Vector2 center, float radiusH, float radiusV, Color color);
+void SoftDrawCircleGradient(Vector2 center, float radius, Color inner, Color outer);
+void SoftDrawRing(Vector2 center, float innerRadius, float outerRadius, Color color);
+void SoftDrawQuad(const SoftTexture *texture, Vector2 topLeft, Vector2 bottomLeft, Vector2 topRight,
+                  Rectangle uv, Color tint);                     // Parallelogram, uv in texels
+void SoftDrawTexture(const SoftTexture *texture, int posX, int posY, Color tint);
+
+#endif // SOFTRENDER_H
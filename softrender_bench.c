@@ -0,0 +1,180 @@
+/*******************************************************************************************
+*
+*   C-volley - software rasterizer benchmark
+*
+*   Usage:
+*     softrender_bench [frames] [--threads N] [--out frame.ppm]
+*
+*   Renders a 1024x768 scene with the same primitive mix as a gameplay frame (full screen
+*   background, ground/net rectangles, two blobs with shadows and highlights, rotated ball,
+*   trail, particles and score text) without opening a window. Textures are generated, the
+*   atlas is not needed. Without --threads it sweeps 1, 2, 4... up to the core count.
+*
+*   Copyright: 2025 (c) Dmitry R. <public@falsetrue.io>
+********************************************************************************************/
+
+#include "softrender.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FRAME_WIDTH 1024
+#define FRAME_HEIGHT 768
+#define PARTICLE_COUNT 100
+#define TRAIL_LENGTH 10
+
+static Color backgroundPixels[1024*1024];
+static Color spritePixels[128*64];      // Ball disc at [0,0], glyph blocks at [64,0]
+static SoftTexture background = { backgroundPixels, 1024, 1024 };
+static SoftTexture sprites = { spritePixels, 128, 64 };
+
+static double NowSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec/1e9;
+}
+
+static void GenTextures(void)
+{
+    for (int y = 0; y < 1024; y++)
+    {
+        for (int x = 0; x < 1024; x++) backgroundPixels[y*1024 + x] = (Color){ (unsigned char)(x/4), (unsigned char)(y/4), 200, 255 };
+    }
+
+    for (int y = 0; y < 64; y++)
+    {
+        for (int x = 0; x < 64; x++)
+        {
+            float dx = x + 0.5f - 32.0f;
+            float dy = y + 0.5f - 32.0f;
+            bool inside = (dx*dx + dy*dy) < 32.0f*32.0f;
+            bool checker = ((x/8) + (y/8))%2;
+            spritePixels[y*128 + x] = inside ? (checker ? (Color){ 240, 240, 240, 255 } : (Color){ 200, 40, 40, 255 }) : (Color){ 0 };
+        }
+
+        for (int x = 64; x < 128; x++) spritePixels[y*128 + x] = ((x*7 + y*3)%5 < 2) ? WHITE : (Color){ 0 };
+    }
+}
+
+static void DrawScene(int frame)
+{
+    float t = frame/60.0f;
+
+    SoftBeginFrame(RAYWHITE);
+    SoftDrawTexture(&background, 0, 0, GRAY);
+
+    // Ground and net
+    SoftDrawRectangleGradientH(0, 668, 1024, 100, (Color){ 60, 120, 60, 255 }, (Color){ 90, 160, 90, 255 });
+    SoftDrawRectangleGradientH(0, 668, 1024, 4, DARKGREEN, DARKGREEN);
+    SoftDrawRectangleGradientH(508, 440, 8, 228, DARKGRAY, DARKGRAY);
+    SoftDrawRing((Vector2){ 512, 440 }, 7.5f, 8.5f, BLACK);
+
+    // Blobs
+    for (int side = 0; side < 2; side++)
+    {
+        Vector2 position = { 256.0f + side*512.0f + 120.0f*sinf(t + side), 600.0f - fabsf(90.0f*sinf(2.0f*t + side)) };
+        Color color = side ? (Color){ 0, 121, 241, 200 } : (Color){ 230, 41, 55, 200 };
+
+        SoftDrawEllipse((Vector2){ position.x, 672 }, 45, 10, (Color){ 0, 0, 0, 80 });
+        SoftDrawEllipse(position, 50, 60, color);
+        SoftDrawCircleGradient((Vector2){ position.x - 15, position.y - 20 }, 20, (Color){ 255, 255, 255, 120 }, (Color){ 255, 255, 255, 0 });
+        SoftDrawRing(position, 49.5f, 50.5f, (Color){ 0, 0, 0, 160 });
+        SoftDrawEllipse((Vector2){ position.x - 12, position.y - 15 }, 7, 9, WHITE);
+        SoftDrawEllipse((Vector2){ position.x + 12, position.y - 15 }, 7, 9, WHITE);
+        SoftDrawEllipse((Vector2){ position.x - 10, position.y - 14 }, 3, 4, BLACK);
+        SoftDrawEllipse((Vector2){ position.x + 14, position.y - 14 }, 3, 4, BLACK);
+    }
+
+    // Ball trail and rotated ball
+    Vector2 ballPosition = { 512.0f + 350.0f*sinf(0.7f*t), 300.0f + 200.0f*cosf(1.3f*t) };
+    for (int i = 0; i < TRAIL_LENGTH; i++)
+    {
+        Vector2 trail = { ballPosition.x - i*8.0f*cosf(0.7f*t), ballPosition.y + i*6.0f*sinf(1.3f*t) };
+        SoftDrawEllipse(trail, 30.0f - i*2.0f, 30.0f - i*2.0f, (Color){ 255, 255, 255, (unsigned char)(100 - i*10) });
+    }
+
+    float angle = t*4.0f;
+    float c = cosf(angle)*30.0f;
+    float s = sinf(angle)*30.0f;
+    SoftDrawQuad(&sprites, (Vector2){ ballPosition.x - c + s, ballPosition.y - s - c },
+                 (Vector2){ ballPosition.x - c - s, ballPosition.y - s + c },
+                 (Vector2){ ballPosition.x + c + s, ballPosition.y + s - c }, (Rectangle){ 0, 0, 64, 64 }, WHITE);
+
+    // Particles
+    for (int i = 0; i < PARTICLE_COUNT; i++)
+    {
+        float x = fmodf(i*97.0f + frame*3.0f, 1024.0f);
+        float y = 640.0f - fmodf(i*31.0f + frame*2.0f, 120.0f);
+        SoftDrawQuad(&sprites, (Vector2){ x, y }, (Vector2){ x, y + 8 }, (Vector2){ x + 8, y }, (Rectangle){ 0, 0, 64, 64 },
+                     (Color){ 200, 180, 120, 160 });
+    }
+
+    // Score and timer text
+    for (int i = 0; i < 40; i++)
+    {
+        float x = 40.0f + (i%20)*20.0f + (i/20)*600.0f;
+        float y = 30.0f;
+        SoftDrawQuad(&sprites, (Vector2){ x, y }, (Vector2){ x, y + 20 }, (Vector2){ x + 16, y },
+                     (Rectangle){ 64 + (i%8)*8, 0, 8, 10 }, WHITE);
+    }
+
+    SoftEndFrame();
+}
+
+static double RunFrames(int threads, int frames)
+{
+    if (!InitSoftRenderer(FRAME_WIDTH, FRAME_HEIGHT, threads)) return -1.0;
+
+    for (int i = 0; i < 10; i++) DrawScene(i);     // Warm up caches and worker threads
+
+    double start = NowSeconds();
+    for (int i = 0; i < frames; i++) DrawScene(i);
+    double elapsed = NowSeconds() - start;
+
+    printf("threads %2d  %8.3f ms/frame  %8.1f fps\n", threads, elapsed*1000.0/frames, frames/elapsed);
+    printf("BENCH softrender.threads%d.ms_per_frame %.4f lower\n", threads, elapsed*1000.0/frames);      // For benchgate
+    return elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 500;
+    int threads = 0;
+    const char *outFileName = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) threads = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--out") == 0) && (i + 1 < argc)) outFileName = argv[++i];
+        else if (argv[i][0] != '-') frames = atoi(argv[i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [frames] [--threads N] [--out frame.ppm]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    GenTextures();
+
+    if (threads > 0) RunFrames(threads, frames);
+    else
+    {
+        int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        for (int count = 1; count < cores; count *= 2) RunFrames(count, frames);
+        RunFrames(cores, frames);
+    }
+
+    if (outFileName != NULL)
+    {
+        if (SoftExportPPM(outFileName)) printf("wrote %s\n", outFileName);
+        else fprintf(stderr, "could not write %s\n", outFileName);
+    }
+
+    CloseSoftRenderer();
+    return 0;
+}